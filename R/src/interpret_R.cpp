@@ -6,6 +6,9 @@
 #include <limits> // std::numeric_limits
 #include <cstring> // memcpy, strcmp
 #include <algorithm> // std::min, std::max
+#include <thread> // std::thread
+#include <atomic> // std::atomic
+#include <new> // placement new
 
 #include "ebm_native.h"
 #include "logging.h"
@@ -207,6 +210,22 @@ bool ConvertDoublesToIndexes(const SEXP items, size_t * const pcItems, const Int
    return false;
 }
 
+bool ConvertSingleDoubleToIndex(const SEXP item, IntEbmType * const pRet) {
+   EBM_ASSERT(nullptr != item);
+   EBM_ASSERT(nullptr != pRet);
+   if(!IsSingleDoubleVector(item)) {
+      LOG_0(TraceLevelError, "ERROR ConvertSingleDoubleToIndex !IsSingleDoubleVector(item)");
+      return true;
+   }
+   const double val = REAL(item)[0];
+   if(!IsDoubleToIntEbmTypeIndexValid(val)) {
+      LOG_0(TraceLevelError, "ERROR ConvertSingleDoubleToIndex !IsDoubleToIntEbmTypeIndexValid(val)");
+      return true;
+   }
+   *pRet = static_cast<IntEbmType>(val);
+   return false;
+}
+
 IntEbmType CountDoubles(const SEXP items) {
    EBM_ASSERT(nullptr != items);
    if(REALSXP != TYPEOF(items)) {
@@ -1618,6 +1637,743 @@ SEXP FreeInteractionDetector_R(
    return R_NilValue;
 }
 
+// everything the outer bag threads need.  The threads never touch R objects or call the R API since R is single
+// threaded, so all of the memory here is allocated with R_alloc on the calling thread before the threads start
+struct OuterBagsShared final {
+   const void * m_pDataSet;
+   size_t m_cSamples;
+   size_t m_cOuterBags;
+   const SeedEbmType * m_aSeeds;
+   const BagEbmType * m_aBags;
+   IntEbmType m_countTerms;
+   const IntEbmType * m_acTermDimensions;
+   const IntEbmType * m_aiTermFeatures;
+   const size_t * m_aiTermScoresFirst;
+   size_t m_cTermScoresTotal;
+   IntEbmType m_countInnerBags;
+   double m_learningRate;
+   IntEbmType m_countSamplesRequiredForChildSplitMin;
+   const IntEbmType * m_aLeavesMax;
+   double m_earlyStoppingRounds;
+   double m_earlyStoppingTolerance;
+   double m_maxRounds;
+
+   double * m_aTermScoresBags;
+   ErrorEbmType * m_aErrors;
+   std::atomic<size_t> m_iNextOuterBag;
+};
+
+static ErrorEbmType BoostOuterBag(const OuterBagsShared * const pShared, const size_t iOuterBag) {
+   BoosterHandle boosterHandle = nullptr;
+   ErrorEbmType error = CreateBooster(
+      pShared->m_aSeeds[iOuterBag],
+      pShared->m_pDataSet,
+      &pShared->m_aBags[iOuterBag * pShared->m_cSamples],
+      nullptr,
+      pShared->m_countTerms,
+      pShared->m_acTermDimensions,
+      pShared->m_aiTermFeatures,
+      pShared->m_countInnerBags,
+      CreateBoosterFlags_Default,
+      nullptr,
+      &boosterHandle
+   );
+   if(Error_None != error) {
+      return error;
+   }
+
+   // this is the same early stopping that cyclic_gradient_boost in booster.R uses
+   double minMetric = std::numeric_limits<double>::infinity();
+   double bpMetric = std::numeric_limits<double>::infinity();
+   double noChangeRunLength = 0;
+   for(double iRound = 0; iRound < pShared->m_maxRounds; ++iRound) {
+      for(IntEbmType iTerm = 0; iTerm < pShared->m_countTerms; ++iTerm) {
+         double avgGain;
+         error = GenerateTermUpdate(
+            boosterHandle,
+            iTerm,
+            GenerateUpdateOptions_Default,
+            pShared->m_learningRate,
+            pShared->m_countSamplesRequiredForChildSplitMin,
+            pShared->m_aLeavesMax,
+            &avgGain
+         );
+         if(Error_None != error) {
+            FreeBooster(boosterHandle);
+            return error;
+         }
+
+         double validationMetric;
+         error = ApplyTermUpdate(boosterHandle, &validationMetric);
+         if(Error_None != error) {
+            FreeBooster(boosterHandle);
+            return error;
+         }
+         minMetric = std::min(minMetric, validationMetric);
+      }
+
+      if(0 == noChangeRunLength) {
+         bpMetric = minMetric;
+      }
+      if(minMetric + pShared->m_earlyStoppingTolerance < bpMetric) {
+         noChangeRunLength = 0;
+      } else {
+         ++noChangeRunLength;
+      }
+      if(0 <= pShared->m_earlyStoppingRounds && pShared->m_earlyStoppingRounds <= noChangeRunLength) {
+         break;
+      }
+   }
+
+   double * const aTermScores = &pShared->m_aTermScoresBags[iOuterBag * pShared->m_cTermScoresTotal];
+   for(IntEbmType iTerm = 0; iTerm < pShared->m_countTerms; ++iTerm) {
+      error = GetBestTermScores(boosterHandle, iTerm, &aTermScores[pShared->m_aiTermScoresFirst[iTerm]]);
+      if(Error_None != error) {
+         break;
+      }
+   }
+   FreeBooster(boosterHandle);
+   return error;
+}
+
+static void BoostOuterBagsThread(OuterBagsShared * const pShared) {
+   // each thread takes the next outer bag until there are none left, so a slow bag doesn't hold up the others
+   while(true) {
+      const size_t iOuterBag = pShared->m_iNextOuterBag.fetch_add(1);
+      if(pShared->m_cOuterBags <= iOuterBag) {
+         break;
+      }
+      pShared->m_aErrors[iOuterBag] = BoostOuterBag(pShared, iOuterBag);
+   }
+}
+
+SEXP BoostOuterBags_R(
+   SEXP randomSeed,
+   SEXP countTargetClasses,
+   SEXP featuresBinCount,
+   SEXP dimensionCounts,
+   SEXP featureIndexes,
+   SEXP binnedData,
+   SEXP targets,
+   SEXP countValidationSamples,
+   SEXP countOuterBags,
+   SEXP countInnerBags,
+   SEXP learningRate,
+   SEXP countSamplesRequiredForChildSplitMin,
+   SEXP leavesMax,
+   SEXP earlyStoppingRounds,
+   SEXP earlyStoppingTolerance,
+   SEXP maxRounds,
+   SEXP countThreads
+) {
+   EBM_ASSERT(nullptr != randomSeed);
+   EBM_ASSERT(nullptr != countTargetClasses);
+   EBM_ASSERT(nullptr != featuresBinCount);
+   EBM_ASSERT(nullptr != dimensionCounts);
+   EBM_ASSERT(nullptr != featureIndexes);
+   EBM_ASSERT(nullptr != binnedData);
+   EBM_ASSERT(nullptr != targets);
+   EBM_ASSERT(nullptr != countValidationSamples);
+   EBM_ASSERT(nullptr != countOuterBags);
+   EBM_ASSERT(nullptr != countInnerBags);
+   EBM_ASSERT(nullptr != learningRate);
+   EBM_ASSERT(nullptr != countSamplesRequiredForChildSplitMin);
+   EBM_ASSERT(nullptr != leavesMax);
+   EBM_ASSERT(nullptr != earlyStoppingRounds);
+   EBM_ASSERT(nullptr != earlyStoppingTolerance);
+   EBM_ASSERT(nullptr != maxRounds);
+   EBM_ASSERT(nullptr != countThreads);
+
+   ErrorEbmType error;
+
+   if(!IsSingleIntVector(randomSeed)) {
+      LOG_0(TraceLevelError, "ERROR BoostOuterBags_R !IsSingleIntVector(randomSeed)");
+      return R_NilValue;
+   }
+   SeedEbmType randomSeedLocal = INTEGER(randomSeed)[0];
+
+   IntEbmType countTargetClassesLocal;
+   if(ConvertSingleDoubleToIndex(countTargetClasses, &countTargetClassesLocal)) {
+      // we've already logged any errors
+      return R_NilValue;
+   }
+   if(IsConvertError<ptrdiff_t>(countTargetClassesLocal)) {
+      LOG_0(TraceLevelError, "ERROR BoostOuterBags_R IsConvertError<ptrdiff_t>(countTargetClassesLocal)");
+      return R_NilValue;
+   }
+   const size_t cScores = GetVectorLength(static_cast<ptrdiff_t>(countTargetClassesLocal));
+
+   size_t cFeatures;
+   const IntEbmType * aFeaturesBinCount;
+   if(ConvertDoublesToIndexes(featuresBinCount, &cFeatures, &aFeaturesBinCount)) {
+      // we've already logged any errors
+      return R_NilValue;
+   }
+
+   size_t cTerms;
+   const IntEbmType * acTermDimensions;
+   if(ConvertDoublesToIndexes(dimensionCounts, &cTerms, &acTermDimensions)) {
+      // we've already logged any errors
+      return R_NilValue;
+   }
+   const size_t cTotalDimensionsCheck = CountTotalDimensions(cTerms, acTermDimensions);
+   if(SIZE_MAX == cTotalDimensionsCheck) {
+      // we've already logged any errors
+      return R_NilValue;
+   }
+   size_t cTotalDimensionsActual;
+   const IntEbmType * aiTermFeatures;
+   if(ConvertDoublesToIndexes(featureIndexes, &cTotalDimensionsActual, &aiTermFeatures)) {
+      // we've already logged any errors
+      return R_NilValue;
+   }
+   if(cTotalDimensionsActual != cTotalDimensionsCheck) {
+      LOG_0(TraceLevelError, "ERROR BoostOuterBags_R cTotalDimensionsActual != cTotalDimensionsCheck");
+      return R_NilValue;
+   }
+
+   size_t cSamples;
+   const IntEbmType * aTargets;
+   if(ConvertDoublesToIndexes(targets, &cSamples, &aTargets)) {
+      // we've already logged any errors
+      return R_NilValue;
+   }
+   const IntEbmType countSamples = static_cast<IntEbmType>(cSamples);
+
+   // binnedData is a column-major (FORTRAN ordered) matrix, so each feature's bins are contiguous
+   size_t cBinnedData;
+   const IntEbmType * aBinnedData;
+   if(ConvertDoublesToIndexes(binnedData, &cBinnedData, &aBinnedData)) {
+      // we've already logged any errors
+      return R_NilValue;
+   }
+   if(IsMultiplyError(cSamples, cFeatures)) {
+      LOG_0(TraceLevelError, "ERROR BoostOuterBags_R IsMultiplyError(cSamples, cFeatures)");
+      return R_NilValue;
+   }
+   if(cSamples * cFeatures != cBinnedData) {
+      LOG_0(TraceLevelError, "ERROR BoostOuterBags_R cSamples * cFeatures != cBinnedData");
+      return R_NilValue;
+   }
+
+   IntEbmType countValidationSamplesLocal;
+   if(ConvertSingleDoubleToIndex(countValidationSamples, &countValidationSamplesLocal)) {
+      // we've already logged any errors
+      return R_NilValue;
+   }
+   if(countSamples < countValidationSamplesLocal) {
+      LOG_0(TraceLevelError, "ERROR BoostOuterBags_R countSamples < countValidationSamplesLocal");
+      return R_NilValue;
+   }
+
+   if(!IsSingleIntVector(countOuterBags)) {
+      LOG_0(TraceLevelError, "ERROR BoostOuterBags_R !IsSingleIntVector(countOuterBags)");
+      return R_NilValue;
+   }
+   const int countOuterBagsInt = INTEGER(countOuterBags)[0];
+   if(countOuterBagsInt <= 0) {
+      LOG_0(TraceLevelError, "ERROR BoostOuterBags_R countOuterBagsInt <= 0");
+      return R_NilValue;
+   }
+   const size_t cOuterBags = static_cast<size_t>(countOuterBagsInt);
+
+   if(!IsSingleIntVector(countInnerBags)) {
+      LOG_0(TraceLevelError, "ERROR BoostOuterBags_R !IsSingleIntVector(countInnerBags)");
+      return R_NilValue;
+   }
+   const IntEbmType countInnerBagsLocal = static_cast<IntEbmType>(INTEGER(countInnerBags)[0]);
+
+   if(!IsSingleDoubleVector(learningRate)) {
+      LOG_0(TraceLevelError, "ERROR BoostOuterBags_R !IsSingleDoubleVector(learningRate)");
+      return R_NilValue;
+   }
+   IntEbmType countSamplesRequiredForChildSplitMinLocal;
+   if(ConvertSingleDoubleToIndex(countSamplesRequiredForChildSplitMin, &countSamplesRequiredForChildSplitMinLocal)) {
+      // we've already logged any errors
+      return R_NilValue;
+   }
+   IntEbmType leavesMaxLocal;
+   if(ConvertSingleDoubleToIndex(leavesMax, &leavesMaxLocal)) {
+      // we've already logged any errors
+      return R_NilValue;
+   }
+   if(!IsSingleDoubleVector(earlyStoppingRounds)) {
+      LOG_0(TraceLevelError, "ERROR BoostOuterBags_R !IsSingleDoubleVector(earlyStoppingRounds)");
+      return R_NilValue;
+   }
+   if(!IsSingleDoubleVector(earlyStoppingTolerance)) {
+      LOG_0(TraceLevelError, "ERROR BoostOuterBags_R !IsSingleDoubleVector(earlyStoppingTolerance)");
+      return R_NilValue;
+   }
+   if(!IsSingleDoubleVector(maxRounds)) {
+      LOG_0(TraceLevelError, "ERROR BoostOuterBags_R !IsSingleDoubleVector(maxRounds)");
+      return R_NilValue;
+   }
+   if(!IsSingleIntVector(countThreads)) {
+      LOG_0(TraceLevelError, "ERROR BoostOuterBags_R !IsSingleIntVector(countThreads)");
+      return R_NilValue;
+   }
+   const int countThreadsInt = INTEGER(countThreads)[0];
+
+   // build the native dataset once and share it between all the outer bags
+   IntEbmType countBytes = SizeDataSetHeader(static_cast<IntEbmType>(cFeatures), 0, 1);
+   if(countBytes < 0) {
+      return R_NilValue;
+   }
+   for(size_t iFeature = 0; iFeature < cFeatures; ++iFeature) {
+      const IntEbmType countFeatureBytes = SizeFeature(
+         aFeaturesBinCount[iFeature], EBM_TRUE, EBM_FALSE, EBM_FALSE, countSamples, &aBinnedData[iFeature * cSamples]);
+      if(countFeatureBytes < 0) {
+         return R_NilValue;
+      }
+      countBytes += countFeatureBytes;
+   }
+   const IntEbmType countTargetBytes = SizeClassificationTarget(countTargetClassesLocal, countSamples, aTargets);
+   if(countTargetBytes < 0) {
+      return R_NilValue;
+   }
+   countBytes += countTargetBytes;
+   if(IsConvertError<size_t>(countBytes)) {
+      LOG_0(TraceLevelError, "ERROR BoostOuterBags_R IsConvertError<size_t>(countBytes)");
+      return R_NilValue;
+   }
+
+   void * const pDataSet = R_alloc(static_cast<size_t>(countBytes), 1);
+   EBM_ASSERT(nullptr != pDataSet); // R_alloc doesn't return nullptr
+   error = FillDataSetHeader(static_cast<IntEbmType>(cFeatures), 0, 1, countBytes, pDataSet);
+   if(Error_None != error) {
+      return R_NilValue;
+   }
+   for(size_t iFeature = 0; iFeature < cFeatures; ++iFeature) {
+      error = FillFeature(aFeaturesBinCount[iFeature], EBM_TRUE, EBM_FALSE, EBM_FALSE, countSamples, 
+         &aBinnedData[iFeature * cSamples], countBytes, pDataSet);
+      if(Error_None != error) {
+         return R_NilValue;
+      }
+   }
+   error = FillClassificationTarget(countTargetClassesLocal, countSamples, aTargets, countBytes, pDataSet);
+   if(Error_None != error) {
+      return R_NilValue;
+   }
+
+   // the term tensors of every bag go back to back so that each thread writes to its own region
+   size_t * const aiTermScoresFirst = reinterpret_cast<size_t *>(R_alloc(cTerms + 1, static_cast<int>(sizeof(size_t))));
+   size_t cTermScoresTotal = 0;
+   size_t cDimensionsMax = 1;
+   const IntEbmType * piTermFeature = aiTermFeatures;
+   for(size_t iTerm = 0; iTerm < cTerms; ++iTerm) {
+      aiTermScoresFirst[iTerm] = cTermScoresTotal;
+      const size_t cDimensions = static_cast<size_t>(acTermDimensions[iTerm]);
+      cDimensionsMax = std::max(cDimensionsMax, cDimensions);
+      size_t cTensorScores = cScores;
+      for(size_t iDimension = 0; iDimension < cDimensions; ++iDimension) {
+         const IntEbmType iFeature = *piTermFeature;
+         ++piTermFeature;
+         if(static_cast<IntEbmType>(cFeatures) <= iFeature) {
+            LOG_0(TraceLevelError, "ERROR BoostOuterBags_R featureIndexes contains an illegal feature");
+            return R_NilValue;
+         }
+         const size_t cBins = static_cast<size_t>(aFeaturesBinCount[iFeature]);
+         if(IsMultiplyError(cTensorScores, cBins)) {
+            LOG_0(TraceLevelError, "ERROR BoostOuterBags_R IsMultiplyError(cTensorScores, cBins)");
+            return R_NilValue;
+         }
+         cTensorScores *= cBins;
+      }
+      if(IsAddError(cTermScoresTotal, cTensorScores)) {
+         LOG_0(TraceLevelError, "ERROR BoostOuterBags_R IsAddError(cTermScoresTotal, cTensorScores)");
+         return R_NilValue;
+      }
+      cTermScoresTotal += cTensorScores;
+   }
+   aiTermScoresFirst[cTerms] = cTermScoresTotal;
+   if(IsMultiplyError(sizeof(double), cTermScoresTotal, cOuterBags) || IsMultiplyError(cSamples, cOuterBags)) {
+      LOG_0(TraceLevelError, "ERROR BoostOuterBags_R IsMultiplyError(sizeof(double), cTermScoresTotal, cOuterBags)");
+      return R_NilValue;
+   }
+
+   IntEbmType * const aLeavesMax = 
+      reinterpret_cast<IntEbmType *>(R_alloc(cDimensionsMax, static_cast<int>(sizeof(IntEbmType))));
+   for(size_t iDimension = 0; iDimension < cDimensionsMax; ++iDimension) {
+      aLeavesMax[iDimension] = leavesMaxLocal;
+   }
+
+   // the seeds and the bags come from the same sequence that ebm_classify used when it looped over the bags in R
+   SeedEbmType * const aSeeds = 
+      reinterpret_cast<SeedEbmType *>(R_alloc(cOuterBags, static_cast<int>(sizeof(SeedEbmType))));
+   BagEbmType * const aBags = 
+      reinterpret_cast<BagEbmType *>(R_alloc(cSamples * cOuterBags, static_cast<int>(sizeof(BagEbmType))));
+   for(size_t iOuterBag = 0; iOuterBag < cOuterBags; ++iOuterBag) {
+      randomSeedLocal = GenerateDeterministicSeed(randomSeedLocal, 1416147523);
+      aSeeds[iOuterBag] = randomSeedLocal;
+      error = SampleWithoutReplacement(
+         EBM_TRUE,
+         randomSeedLocal,
+         countSamples - countValidationSamplesLocal,
+         countValidationSamplesLocal,
+         &aBags[iOuterBag * cSamples]
+      );
+      if(Error_None != error) {
+         return R_NilValue;
+      }
+   }
+
+   OuterBagsShared shared;
+   shared.m_pDataSet = pDataSet;
+   shared.m_cSamples = cSamples;
+   shared.m_cOuterBags = cOuterBags;
+   shared.m_aSeeds = aSeeds;
+   shared.m_aBags = aBags;
+   shared.m_countTerms = static_cast<IntEbmType>(cTerms);
+   shared.m_acTermDimensions = acTermDimensions;
+   shared.m_aiTermFeatures = aiTermFeatures;
+   shared.m_aiTermScoresFirst = aiTermScoresFirst;
+   shared.m_cTermScoresTotal = cTermScoresTotal;
+   shared.m_countInnerBags = countInnerBagsLocal;
+   shared.m_learningRate = REAL(learningRate)[0];
+   shared.m_countSamplesRequiredForChildSplitMin = countSamplesRequiredForChildSplitMinLocal;
+   shared.m_aLeavesMax = aLeavesMax;
+   shared.m_earlyStoppingRounds = REAL(earlyStoppingRounds)[0];
+   shared.m_earlyStoppingTolerance = REAL(earlyStoppingTolerance)[0];
+   shared.m_maxRounds = REAL(maxRounds)[0];
+   shared.m_aTermScoresBags = 
+      reinterpret_cast<double *>(R_alloc(cTermScoresTotal * cOuterBags, static_cast<int>(sizeof(double))));
+   shared.m_aErrors = 
+      reinterpret_cast<ErrorEbmType *>(R_alloc(cOuterBags, static_cast<int>(sizeof(ErrorEbmType))));
+   shared.m_iNextOuterBag = 0;
+
+   size_t cThreads = countThreadsInt <= 0 ? 
+      static_cast<size_t>(std::thread::hardware_concurrency()) : static_cast<size_t>(countThreadsInt);
+   cThreads = std::max(size_t { 1 }, std::min(cThreads, cOuterBags));
+
+   // the calling thread boosts too.  If a thread fails to start, the remaining threads pick up its bags
+   std::thread * const aThreads = 
+      reinterpret_cast<std::thread *>(R_alloc(cThreads, static_cast<int>(sizeof(std::thread))));
+   size_t cThreadsStarted = 0;
+   for(size_t iThread = 1; iThread < cThreads; ++iThread) {
+      try {
+         new(&aThreads[cThreadsStarted]) std::thread(BoostOuterBagsThread, &shared);
+         ++cThreadsStarted;
+      } catch(...) {
+         LOG_0(TraceLevelWarning, "WARNING BoostOuterBags_R thread start failed");
+         break;
+      }
+   }
+   BoostOuterBagsThread(&shared);
+   for(size_t iThread = 0; iThread < cThreadsStarted; ++iThread) {
+      aThreads[iThread].join();
+      aThreads[iThread].~thread();
+   }
+
+   for(size_t iOuterBag = 0; iOuterBag < cOuterBags; ++iOuterBag) {
+      if(Error_None != shared.m_aErrors[iOuterBag]) {
+         LOG_0(TraceLevelWarning, "WARNING BoostOuterBags_R boosting an outer bag returned an error code");
+         return R_NilValue;
+      }
+   }
+
+   // average the bags into one tensor per term
+   SEXP ret = PROTECT(allocVector(VECSXP, static_cast<R_xlen_t>(cTerms)));
+   for(size_t iTerm = 0; iTerm < cTerms; ++iTerm) {
+      const size_t iTermScoresFirst = aiTermScoresFirst[iTerm];
+      const size_t cTensorScores = aiTermScoresFirst[iTerm + 1] - iTermScoresFirst;
+      SEXP termScores = allocVector(REALSXP, static_cast<R_xlen_t>(cTensorScores));
+      SET_VECTOR_ELT(ret, static_cast<R_xlen_t>(iTerm), termScores);
+      double * const aTermScores = REAL(termScores);
+      for(size_t iScore = 0; iScore < cTensorScores; ++iScore) {
+         double sum = 0.0;
+         for(size_t iOuterBag = 0; iOuterBag < cOuterBags; ++iOuterBag) {
+            sum += shared.m_aTermScoresBags[iOuterBag * cTermScoresTotal + iTermScoresFirst + iScore];
+         }
+         aTermScores[iScore] = sum / static_cast<double>(cOuterBags);
+      }
+   }
+   UNPROTECT(1);
+   return ret;
+}
+
+// Predictor holds the cuts and mains scores of an ebm_model in native memory so that ebm_predict_proba can score
+// the whole matrix in C++.  It is freed by PredictorFinalizer when R garbage collects the external pointer
+struct PredictorFeature final {
+   size_t m_cCuts;
+   const double * m_aCuts;
+   const double * m_aScores; // m_cCuts + 2 scores since bin 0 is the missing bin
+};
+
+struct Predictor final {
+   size_t m_cFeatures;
+   PredictorFeature * m_aFeatures;
+   double * m_aValues;
+};
+
+void PredictorFinalizer(SEXP predictorWrapped) {
+   EBM_ASSERT(nullptr != predictorWrapped); // shouldn't be possible
+   if(EXTPTRSXP == TYPEOF(predictorWrapped)) {
+      Predictor * const pPredictor = static_cast<Predictor *>(R_ExternalPtrAddr(predictorWrapped));
+      if(nullptr != pPredictor) {
+         free(pPredictor->m_aValues);
+         free(pPredictor->m_aFeatures);
+         free(pPredictor);
+         R_ClearExternalPtr(predictorWrapped);
+      }
+   }
+}
+
+SEXP CreatePredictor_R(
+   SEXP cuts,
+   SEXP termScores
+) {
+   EBM_ASSERT(nullptr != cuts);
+   EBM_ASSERT(nullptr != termScores);
+
+   if(VECSXP != TYPEOF(cuts)) {
+      LOG_0(TraceLevelError, "ERROR CreatePredictor_R VECSXP != TYPEOF(cuts)");
+      return R_NilValue;
+   }
+   if(VECSXP != TYPEOF(termScores)) {
+      LOG_0(TraceLevelError, "ERROR CreatePredictor_R VECSXP != TYPEOF(termScores)");
+      return R_NilValue;
+   }
+   const R_xlen_t countFeaturesR = xlength(cuts);
+   if(xlength(termScores) != countFeaturesR) {
+      LOG_0(TraceLevelError, "ERROR CreatePredictor_R xlength(termScores) != countFeaturesR");
+      return R_NilValue;
+   }
+   if(IsConvertError<size_t>(countFeaturesR)) {
+      LOG_0(TraceLevelError, "ERROR CreatePredictor_R IsConvertError<size_t>(countFeaturesR)");
+      return R_NilValue;
+   }
+   const size_t cFeatures = static_cast<size_t>(countFeaturesR);
+
+   size_t cValues = 0;
+   for(size_t iFeature = 0; iFeature < cFeatures; ++iFeature) {
+      const IntEbmType countCuts = CountDoubles(VECTOR_ELT(cuts, static_cast<R_xlen_t>(iFeature)));
+      if(countCuts < 0) {
+         // we've already logged any errors
+         return R_NilValue;
+      }
+      const IntEbmType countScores = CountDoubles(VECTOR_ELT(termScores, static_cast<R_xlen_t>(iFeature)));
+      if(countScores < 0) {
+         // we've already logged any errors
+         return R_NilValue;
+      }
+      const size_t cCuts = static_cast<size_t>(countCuts);
+      const size_t cScores = static_cast<size_t>(countScores);
+      if(cScores < 2 || cCuts != cScores - 2) {
+         LOG_0(TraceLevelError, "ERROR CreatePredictor_R cCuts != cScores - 2");
+         return R_NilValue;
+      }
+      if(IsAddError(cValues, cCuts + cScores)) {
+         LOG_0(TraceLevelError, "ERROR CreatePredictor_R IsAddError(cValues, cCuts + cScores)");
+         return R_NilValue;
+      }
+      cValues += cCuts + cScores;
+   }
+
+   Predictor * const pPredictor = EbmMalloc<Predictor>();
+   if(nullptr == pPredictor) {
+      LOG_0(TraceLevelWarning, "WARNING CreatePredictor_R nullptr == pPredictor");
+      return R_NilValue;
+   }
+   pPredictor->m_cFeatures = cFeatures;
+   pPredictor->m_aFeatures = EbmMalloc<PredictorFeature>(cFeatures);
+   pPredictor->m_aValues = EbmMalloc<double>(cValues);
+   if(nullptr == pPredictor->m_aFeatures || nullptr == pPredictor->m_aValues) {
+      LOG_0(TraceLevelWarning, "WARNING CreatePredictor_R out of memory");
+      free(pPredictor->m_aValues);
+      free(pPredictor->m_aFeatures);
+      free(pPredictor);
+      return R_NilValue;
+   }
+
+   double * pValue = pPredictor->m_aValues;
+   for(size_t iFeature = 0; iFeature < cFeatures; ++iFeature) {
+      const SEXP featureCuts = VECTOR_ELT(cuts, static_cast<R_xlen_t>(iFeature));
+      const SEXP featureScores = VECTOR_ELT(termScores, static_cast<R_xlen_t>(iFeature));
+      const size_t cCuts = static_cast<size_t>(xlength(featureCuts));
+      const size_t cScores = cCuts + 2;
+
+      PredictorFeature * const pFeature = &pPredictor->m_aFeatures[iFeature];
+      pFeature->m_cCuts = cCuts;
+      if(0 != cCuts) {
+         memcpy(pValue, REAL(featureCuts), sizeof(double) * cCuts);
+      }
+      pFeature->m_aCuts = pValue;
+      pValue += cCuts;
+      memcpy(pValue, REAL(featureScores), sizeof(double) * cScores);
+      pFeature->m_aScores = pValue;
+      pValue += cScores;
+   }
+
+   // makes an EXTPTRSXP
+   SEXP predictorWrapped = R_MakeExternalPtr(static_cast<void *>(pPredictor), R_NilValue, R_NilValue);
+   PROTECT(predictorWrapped);
+
+   R_RegisterCFinalizerEx(predictorWrapped, &PredictorFinalizer, Rboolean::TRUE);
+
+   UNPROTECT(1);
+   return predictorWrapped;
+}
+
+// rows are scored in chunks small enough that the binned chunk of one feature stays in the L1 cache
+static constexpr size_t k_cPredictChunkSamples = 1024;
+
+struct PredictShared final {
+   const Predictor * m_pPredictor;
+   size_t m_cSamples;
+   size_t m_cChunks;
+   const double * m_aX; // column-major, as R stores matrices
+   double * m_aScoresOut;
+   std::atomic<size_t> m_iNextChunk;
+};
+
+static void PredictThread(PredictShared * const pShared, IntEbmType * const aBins, ErrorEbmType * const pErrorOut) {
+   // like the outer bags, each thread takes the next chunk of rows until there are none left.  The threads only
+   // touch memory allocated before they start and never call into R
+   const Predictor * const pPredictor = pShared->m_pPredictor;
+   const size_t cSamples = pShared->m_cSamples;
+   ErrorEbmType error = Error_None;
+   while(true) {
+      const size_t iChunk = pShared->m_iNextChunk.fetch_add(1);
+      if(pShared->m_cChunks <= iChunk) {
+         break;
+      }
+      const size_t iSampleFirst = iChunk * k_cPredictChunkSamples;
+      const size_t cChunkSamples = std::min(k_cPredictChunkSamples, cSamples - iSampleFirst);
+      double * const aScores = &pShared->m_aScoresOut[iSampleFirst];
+      for(size_t iSample = 0; iSample < cChunkSamples; ++iSample) {
+         aScores[iSample] = 0.0;
+      }
+      for(size_t iFeature = 0; iFeature < pPredictor->m_cFeatures; ++iFeature) {
+         const PredictorFeature * const pFeature = &pPredictor->m_aFeatures[iFeature];
+         error = Discretize(
+            static_cast<IntEbmType>(cChunkSamples),
+            &pShared->m_aX[iFeature * cSamples + iSampleFirst],
+            static_cast<IntEbmType>(pFeature->m_cCuts),
+            pFeature->m_aCuts,
+            aBins
+         );
+         if(Error_None != error) {
+            *pErrorOut = error;
+            return;
+         }
+         const double * const aFeatureScores = pFeature->m_aScores;
+         for(size_t iSample = 0; iSample < cChunkSamples; ++iSample) {
+            EBM_ASSERT(static_cast<size_t>(aBins[iSample]) < pFeature->m_cCuts + 2);
+            aScores[iSample] += aFeatureScores[static_cast<size_t>(aBins[iSample])];
+         }
+      }
+   }
+   *pErrorOut = error;
+}
+
+SEXP PredictScores_R(
+   SEXP predictorWrapped,
+   SEXP X,
+   SEXP countSamples,
+   SEXP countThreads
+) {
+   EBM_ASSERT(nullptr != predictorWrapped);
+   EBM_ASSERT(nullptr != X);
+   EBM_ASSERT(nullptr != countSamples);
+   EBM_ASSERT(nullptr != countThreads);
+
+   if(EXTPTRSXP != TYPEOF(predictorWrapped)) {
+      LOG_0(TraceLevelError, "ERROR PredictScores_R EXTPTRSXP != TYPEOF(predictorWrapped)");
+      return R_NilValue;
+   }
+   const Predictor * const pPredictor = static_cast<const Predictor *>(R_ExternalPtrAddr(predictorWrapped));
+   if(nullptr == pPredictor) {
+      // this can happen if the predictor was saved and then reloaded since R doesn't serialize external pointers
+      LOG_0(TraceLevelError, "ERROR PredictScores_R nullptr == pPredictor");
+      return R_NilValue;
+   }
+
+   IntEbmType countSamplesLocal;
+   if(ConvertSingleDoubleToIndex(countSamples, &countSamplesLocal)) {
+      // we've already logged any errors
+      return R_NilValue;
+   }
+   const size_t cSamples = static_cast<size_t>(countSamplesLocal);
+
+   const IntEbmType countX = CountDoubles(X);
+   if(countX < 0) {
+      // we've already logged any errors
+      return R_NilValue;
+   }
+   if(IsMultiplyError(cSamples, pPredictor->m_cFeatures)) {
+      LOG_0(TraceLevelError, "ERROR PredictScores_R IsMultiplyError(cSamples, pPredictor->m_cFeatures)");
+      return R_NilValue;
+   }
+   if(cSamples * pPredictor->m_cFeatures != static_cast<size_t>(countX)) {
+      LOG_0(TraceLevelError, "ERROR PredictScores_R cSamples * pPredictor->m_cFeatures != countX");
+      return R_NilValue;
+   }
+
+   if(!IsSingleIntVector(countThreads)) {
+      LOG_0(TraceLevelError, "ERROR PredictScores_R !IsSingleIntVector(countThreads)");
+      return R_NilValue;
+   }
+   const int countThreadsInt = INTEGER(countThreads)[0];
+
+   SEXP ret = PROTECT(allocVector(REALSXP, static_cast<R_xlen_t>(cSamples)));
+   if(0 == cSamples) {
+      UNPROTECT(1);
+      return ret;
+   }
+
+   PredictShared shared;
+   shared.m_pPredictor = pPredictor;
+   shared.m_cSamples = cSamples;
+   shared.m_cChunks = (cSamples + k_cPredictChunkSamples - 1) / k_cPredictChunkSamples;
+   shared.m_aX = REAL(X);
+   shared.m_aScoresOut = REAL(ret);
+   shared.m_iNextChunk = 0;
+
+   size_t cThreads = countThreadsInt <= 0 ? 
+      static_cast<size_t>(std::thread::hardware_concurrency()) : static_cast<size_t>(countThreadsInt);
+   cThreads = std::max(size_t { 1 }, std::min(cThreads, shared.m_cChunks));
+
+   IntEbmType * const aBins = reinterpret_cast<IntEbmType *>(
+      R_alloc(k_cPredictChunkSamples * cThreads, static_cast<int>(sizeof(IntEbmType))));
+   ErrorEbmType * const aErrors = 
+      reinterpret_cast<ErrorEbmType *>(R_alloc(cThreads, static_cast<int>(sizeof(ErrorEbmType))));
+   for(size_t iThread = 0; iThread < cThreads; ++iThread) {
+      aErrors[iThread] = Error_None;
+   }
+
+   // the calling thread predicts too.  If a thread fails to start, the remaining threads pick up its chunks
+   std::thread * const aThreads = 
+      reinterpret_cast<std::thread *>(R_alloc(cThreads, static_cast<int>(sizeof(std::thread))));
+   size_t cThreadsStarted = 0;
+   for(size_t iThread = 1; iThread < cThreads; ++iThread) {
+      try {
+         new(&aThreads[cThreadsStarted]) std::thread(
+            PredictThread, &shared, &aBins[iThread * k_cPredictChunkSamples], &aErrors[iThread]);
+         ++cThreadsStarted;
+      } catch(...) {
+         LOG_0(TraceLevelWarning, "WARNING PredictScores_R thread start failed");
+         break;
+      }
+   }
+   PredictThread(&shared, aBins, &aErrors[0]);
+   for(size_t iThread = 0; iThread < cThreadsStarted; ++iThread) {
+      aThreads[iThread].join();
+      aThreads[iThread].~thread();
+   }
+
+   for(size_t iThread = 0; iThread < cThreads; ++iThread) {
+      if(Error_None != aErrors[iThread]) {
+         LOG_0(TraceLevelWarning, "WARNING PredictScores_R Discretize returned an error code");
+         UNPROTECT(1);
+         return R_NilValue;
+      }
+   }
+
+   UNPROTECT(1);
+   return ret;
+}
+
 static const R_CallMethodDef g_exposedFunctions[] = {
    { "GenerateDeterministicSeed_R", (DL_FUNC)&GenerateDeterministicSeed_R, 2 },
    { "CutQuantile_R", (DL_FUNC)&CutQuantile_R, 4 },
@@ -1634,6 +2390,9 @@ static const R_CallMethodDef g_exposedFunctions[] = {
    { "CreateRegressionInteractionDetector_R", (DL_FUNC)&CreateRegressionInteractionDetector_R, 6 },
    { "CalcInteractionStrength_R", (DL_FUNC)&CalcInteractionStrength_R, 3 },
    { "FreeInteractionDetector_R", (DL_FUNC)&FreeInteractionDetector_R, 1 },
+   { "BoostOuterBags_R", (DL_FUNC)&BoostOuterBags_R, 17 },
+   { "CreatePredictor_R", (DL_FUNC)&CreatePredictor_R, 2 },
+   { "PredictScores_R", (DL_FUNC)&PredictScores_R, 4 },
    { NULL, NULL, 0 }
 };
 
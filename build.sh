@@ -231,6 +231,32 @@ copy_asm_files() {
    fi
 }
 
+build_bench() {
+   l10_compiler="$1"
+   l10_compiler_args_sanitized="$2"
+   l10_linker_args_sanitized="$3"
+   l10_src_path_unsanitized="$4"
+   l10_obj_path_unsanitized="$5"
+   l10_bin_path_unsanitized="$6"
+   l10_lib_full_file_unsanitized="$7"
+
+   # the benchmark links against the shared library that we just built so that it measures exactly what we ship
+   g_all_object_files_sanitized=""
+   g_compile_out_full=""
+
+   make_initial_paths_simple "$l10_obj_path_unsanitized" "$l10_bin_path_unsanitized"
+   compile_directory_cpp "$l10_compiler" "$l10_compiler_args_sanitized" "$l10_src_path_unsanitized" "$l10_obj_path_unsanitized" 0 "bench"
+   link_file "$l10_compiler" "$l10_linker_args_sanitized" "$l10_bin_path_unsanitized" "ebm_native_bench"
+   printf "%s\n" "$g_compile_out_full"
+   printf "%s\n" "$g_compile_out_full" > "$g_log_file_unsanitized"
+
+   cp "$l10_lib_full_file_unsanitized" "$l10_bin_path_unsanitized/"
+   l10_ret_code=$?
+   if [ $l10_ret_code -ne 0 ]; then 
+      exit $l10_ret_code
+   fi
+}
+
 
 release_64=1
 debug_64=1
@@ -239,6 +265,7 @@ debug_32=0
 
 is_asm=0
 is_extra_debugging=0
+is_bench=0
 
 for arg in "$@"; do
    if [ "$arg" = "-no_release_64" ]; then
@@ -259,6 +286,9 @@ for arg in "$@"; do
    if [ "$arg" = "-extra_debugging" ]; then
       is_extra_debugging=1
    fi
+   if [ "$arg" = "-bench" ]; then
+      is_bench=1
+   fi
 done
 
 # TODO: this could be improved upon.  There is no perfect solution AFAIK for getting the script directory, and I'm not too sure how the CDPATH thing works
@@ -282,6 +312,7 @@ root_path_unsanitized="$script_path_unsanitized"
 tmp_path_unsanitized="$root_path_unsanitized/tmp"
 python_lib_unsanitized="$root_path_unsanitized/python/interpret-core/interpret/lib"
 staging_path_unsanitized="$root_path_unsanitized/staging"
+staging_path_sanitized=`sanitize "$staging_path_unsanitized"`
 src_path_unsanitized="$root_path_unsanitized/shared/ebm_native"
 src_path_sanitized=`sanitize "$src_path_unsanitized"`
 
@@ -329,6 +360,8 @@ compute_args="$compute_args -I$src_path_sanitized/compute"
 compute_args="$compute_args -I$src_path_sanitized/compute/loss_functions"
 compute_args="$compute_args -I$src_path_sanitized/compute/metrics"
 
+bench_args="-I$src_path_sanitized/inc"
+
 # add any other non-include options
 common_args="$common_args -Wno-format-nonliteral"
 
@@ -393,6 +426,17 @@ if [ "$os_type" = "Linux" ]; then
       printf "%s\n" "$g_compile_out_full" > "$g_log_file_unsanitized"
       copy_bin_files "$bin_path_unsanitized" "$bin_file" "$python_lib_unsanitized" "$staging_path_unsanitized"
       copy_asm_files "$obj_path_unsanitized" "$tmp_path_unsanitized" "$staging_path_unsanitized/$bin_file" "asm_release_64" "$is_asm"
+
+      if [ $is_bench -ne 0 ]; then 
+         printf "%s\n" "Compiling ebm_native_bench with $cpp_compiler for Linux release|x64"
+         bench_obj_path_unsanitized="$tmp_path_unsanitized/gcc/obj/release/linux/x64/ebm_native_bench"
+         bench_bin_path_unsanitized="$tmp_path_unsanitized/gcc/bin/release/linux/x64/ebm_native_bench"
+         g_log_file_unsanitized="$bench_obj_path_unsanitized/ebm_native_bench_release_linux_x64_build_log.txt"
+         bench_args_specific="$cpp_args $bench_args -Wall -Wextra -Wno-parentheses -Wshadow -Wformat=2 -march=core2 -m64 -DNDEBUG -O3"
+         # the linker wants to have the most dependent .o/.so/.dylib files listed FIRST
+         bench_link_args_specific="-l_ebm_native_linux_x64 -L$staging_path_sanitized -Wl,-rpath-link,$staging_path_sanitized -Wl,-rpath,'\$ORIGIN/' -static-libgcc -static-libstdc++ $bench_args_specific"
+         build_bench "$cpp_compiler" "$bench_args_specific" "$bench_link_args_specific" "$src_path_unsanitized/ebm_native_bench" "$bench_obj_path_unsanitized" "$bench_bin_path_unsanitized" "$staging_path_unsanitized/$bin_file"
+      fi
    fi
 
    if [ $debug_64 -eq 1 ]; then
@@ -543,6 +587,17 @@ elif [ "$os_type" = "Darwin" ]; then
       printf "%s\n" "$g_compile_out_full" > "$g_log_file_unsanitized"
       copy_bin_files "$bin_path_unsanitized" "$bin_file" "$python_lib_unsanitized" "$staging_path_unsanitized"
       copy_asm_files "$obj_path_unsanitized" "$tmp_path_unsanitized" "$staging_path_unsanitized/$bin_file" "asm_release_64" "$is_asm"
+
+      if [ $is_bench -ne 0 ]; then 
+         printf "%s\n" "Compiling ebm_native_bench with $cpp_compiler for macOS release|x64"
+         bench_obj_path_unsanitized="$tmp_path_unsanitized/clang/obj/release/mac/x64/ebm_native_bench"
+         bench_bin_path_unsanitized="$tmp_path_unsanitized/clang/bin/release/mac/x64/ebm_native_bench"
+         g_log_file_unsanitized="$bench_obj_path_unsanitized/ebm_native_bench_release_mac_x64_build_log.txt"
+         bench_args_specific="$cpp_args $bench_args -Wall -Wextra -Wno-parentheses -Wshadow -Wformat=2 -march=core2 -target x86_64-apple-macos10.12 -m64 -DNDEBUG -O3"
+         # the linker wants to have the most dependent .o/.so/.dylib files listed FIRST
+         bench_link_args_specific="-L$staging_path_sanitized -l_ebm_native_mac_x64 -Wl,-rpath,@loader_path $bench_args_specific"
+         build_bench "$cpp_compiler" "$bench_args_specific" "$bench_link_args_specific" "$src_path_unsanitized/ebm_native_bench" "$bench_obj_path_unsanitized" "$bench_bin_path_unsanitized" "$staging_path_unsanitized/$bin_file"
+      fi
    fi
 
    if [ $debug_64 -eq 1 ]; then
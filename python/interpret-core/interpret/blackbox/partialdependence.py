@@ -8,6 +8,33 @@ from ..utils import gen_name_from_class, gen_global_selector
 from ..utils import unify_data, unify_predict_fn
 
 
+def _ebm_ice_fn(predict_fn):
+    # EBMs can compute the ICE lines straight from their term tensors, which only looks up the terms that
+    # contain the feature instead of rebinning and rescoring all of X once per grid point
+    from ..glassbox.ebm.ebm import BaseEBM
+    from sklearn.base import is_classifier
+    from scipy.special import expit, softmax
+
+    model = getattr(predict_fn, "__self__", None)
+    if not isinstance(model, BaseEBM):
+        return None
+
+    name = getattr(predict_fn, "__name__", None)
+    if name == "decision_function" or name == "predict" and not is_classifier(model):
+        link = lambda scores: scores if scores.ndim == 2 else scores[..., 1]  # noqa: E731
+    elif name == "predict_proba":
+        # unify_predict_fn keeps the probability of the second class
+        link = lambda scores: expit(scores) if scores.ndim == 2 else softmax(scores, axis=-1)[..., 1]  # noqa: E731
+    else:
+        return None
+
+    def ice_fn(X, col_idx, grid_points):
+        _, _, ice = model.get_partial_dependence(X, col_idx, grid_points, is_ice=True)
+        return link(ice)
+
+    return ice_fn
+
+
 class PartialDependence(ExplainerMixin):
     """ Partial dependence plots as defined in Friedman's paper on "Greedy function approximation: a gradient boosting machine".
 
@@ -43,6 +70,7 @@ class PartialDependence(ExplainerMixin):
             data, None, feature_names, feature_types
         )
         self.predict_fn = unify_predict_fn(predict_fn, self.data)
+        self._ice_fn = _ebm_ice_fn(predict_fn)
         self.num_points = num_points
         self.std_coef = std_coef
 
@@ -77,6 +105,7 @@ class PartialDependence(ExplainerMixin):
         num_points=10,
         std_coef=1.0,
         num_ice_samples=10,
+        ice_fn=None,
     ):
 
         num_uniq_vals = len(np.unique(X[:, col_idx]))
@@ -89,11 +118,14 @@ class PartialDependence(ExplainerMixin):
             )
             counts, values = np.histogram(X[:, col_idx], bins="doane")
 
-        X_mut = X.copy()
-        ice_lines = np.zeros((X.shape[0], grid_points.shape[0]))
-        for idx, grid_point in enumerate(grid_points):
-            X_mut[:, col_idx] = grid_point
-            ice_lines[:, idx] = predict_fn(X_mut)
+        if ice_fn is None:
+            X_mut = X.copy()
+            ice_lines = np.zeros((X.shape[0], grid_points.shape[0]))
+            for idx, grid_point in enumerate(grid_points):
+                X_mut[:, col_idx] = grid_point
+                ice_lines[:, idx] = predict_fn(X_mut)
+        else:
+            ice_lines = ice_fn(X, col_idx, grid_points)
         mean = np.mean(ice_lines, axis=0)
         std = np.std(ice_lines, axis=0)
 
@@ -137,6 +169,7 @@ class PartialDependence(ExplainerMixin):
                 feature_type,
                 num_points=self.num_points,
                 std_coef=self.std_coef,
+                ice_fn=self._ice_fn,
             )
             feature_dict = {
                 "feature_values": pdp["values"],
@@ -29,7 +29,13 @@ try:
 except ImportError:
     _scipy_installed = False
 
-from .internal import Native
+try:
+    import pyarrow as pa
+    _pyarrow_installed = True
+except ImportError:
+    _pyarrow_installed = False
+
+from .internal import Native, SharedDataset, CategoricalEncoder
 from .utils import DPUtils, _deduplicate_bins
 
 # BIG TODO LIST:
@@ -517,26 +523,35 @@ def _encode_categorical_existing(X_col, nonmissings, categories):
     elif X_col.dtype.type is np.object_:
         X_col = _densify_object_ndarray(X_col)
 
-    uniques, indexes = np.unique(X_col, return_inverse=True)
+    if X_col.dtype.type is np.unicode_:
+        # strings are hashed natively in a single pass, which avoids the sort inside np.unique.  That
+        # matters most for high cardinality columns where nearly every sample is its own unique value
+        with CategoricalEncoder(categories) as encoder:
+            encoded, n_unknowns = encoder.encode(X_col)
+        is_unknown = 0 < n_unknowns
+        unknown_values = lambda: X_col[encoded < 0]
+    else:
+        uniques, indexes = np.unique(X_col, return_inverse=True)
 
-    if issubclass(X_col.dtype.type, np.floating):
-        uniques = uniques.astype(np.float64, copy=False)
-    uniques = uniques.astype(np.unicode_, copy=False)
+        if issubclass(X_col.dtype.type, np.floating):
+            uniques = uniques.astype(np.float64, copy=False)
+        uniques = uniques.astype(np.unicode_, copy=False)
 
-    mapping = np.fromiter((categories.get(val, -1) for val in uniques), dtype=np.int64, count=len(uniques))
-    encoded = mapping[indexes]
+        mapping = np.fromiter((categories.get(val, -1) for val in uniques), dtype=np.int64, count=len(uniques))
+        encoded = mapping[indexes]
+        is_unknown = (mapping < 0).any()
+        unknown_values = lambda: uniques[indexes[encoded < 0]]
 
-    if (mapping < 0).any():
+    if is_unknown:
         if nonmissings is not None:
             encoded_tmp = np.zeros(len(nonmissings), dtype=np.int64)
             np.place(encoded_tmp, nonmissings, encoded)
             bad = np.full(len(nonmissings), None, dtype=np.object_)
-            np.place(bad, encoded_tmp < 0, uniques[indexes[encoded < 0]])
+            np.place(bad, encoded_tmp < 0, unknown_values())
             encoded = encoded_tmp
         else:
             bad = np.full(len(encoded), None, dtype=np.object_)
-            unknowns = encoded < 0
-            np.place(bad, unknowns, uniques[indexes[unknowns]])
+            np.place(bad, encoded < 0, unknown_values())
     else:
         bad = None
         if nonmissings is not None:
@@ -847,7 +862,84 @@ def _process_numpy_column(X_col, categories, feature_type, min_unique_continuous
 
     return _process_ndarray(X_col, nonmissings, categories, feature_type, min_unique_continuous)
 
-def _process_pandas_column(X_col, categories, feature_type, min_unique_continuous):
+class _ArrowNumeric:
+    # an Arrow numeric column that is binned straight from its buffers by native.discretize_arrow.  Only
+    # unify_columns with go_fast yields these, and only for continuous features at predict time
+    __slots__ = ('values', 'validity')
+
+    def __init__(self, values, validity):
+        self.values = values
+        self.validity = validity
+
+    def __len__(self):
+        return len(self.values)
+
+def _arrow_validity(X_col):
+    # numpy view of the Arrow validity bitmap starting at the array offset, or None if there are no nulls
+    if X_col.null_count == 0:
+        return None
+    if X_col.offset % 8 == 0:
+        return np.frombuffer(X_col.buffers()[0], np.ubyte)[X_col.offset // 8:]
+    # the bitmap can only be shifted to an unaligned offset by rebuilding it
+    return np.packbits(X_col.is_valid().to_numpy(zero_copy_only=False), bitorder='little')
+
+def _process_arrow_column(X_col, categories, feature_type, min_unique_continuous, go_fast):
+    if isinstance(X_col, pa.ChunkedArray):
+        X_col = X_col.chunk(0) if X_col.num_chunks == 1 else X_col.combine_chunks()
+
+    arrow_type = X_col.type
+    if pa.types.is_integer(arrow_type) or pa.types.is_float32(arrow_type) or pa.types.is_float64(arrow_type):
+        # numeric buffers are read in place.  Null slots hold arbitrary values that the validity bitmap masks
+        values = np.frombuffer(X_col.buffers()[1], arrow_type.to_pandas_dtype())[X_col.offset:X_col.offset + len(X_col)]
+        if go_fast and feature_type == 'continuous':
+            # called under: predict
+            return 'continuous', _ArrowNumeric(values, _arrow_validity(X_col)), None, None
+
+        nonmissings = None
+        if X_col.null_count != 0:
+            nonmissings = X_col.is_valid().to_numpy(zero_copy_only=False)
+            values = values[nonmissings]
+        return _process_ndarray(values, nonmissings, categories, feature_type, min_unique_continuous)
+
+    if pa.types.is_dictionary(arrow_type) and categories is not None and (feature_type == 'nominal' or feature_type == 'ordinal'):
+        dictionary = X_col.dictionary
+        value_type = arrow_type.value_type
+        index_dtype = np.dtype(arrow_type.index_type.to_pandas_dtype())
+        if index_dtype.kind == 'u':
+            # the native code reads signed indexes.  Every valid index is below len(dictionary), so when the
+            # dictionary fits in the signed type of the same width we can reinterpret the buffer without a copy.
+            # Otherwise the index could look negative, so let pandas decode it below
+            signed_dtype = np.dtype(f'int{index_dtype.itemsize * 8}')
+            index_dtype = signed_dtype if len(dictionary) <= np.iinfo(signed_dtype).max else None
+        if index_dtype is not None and (pa.types.is_string(value_type) or pa.types.is_large_string(value_type)) and dictionary.null_count == 0:
+            # called under: predict
+            # each dictionary string is hashed once and the index buffer is mapped to bins natively
+            _, dictionary_offsets, dictionary_chars = dictionary.buffers()
+            offset_type = np.int64 if pa.types.is_large_string(value_type) else np.int32
+            dictionary_offsets = np.frombuffer(dictionary_offsets, offset_type)[dictionary.offset:dictionary.offset + len(dictionary) + 1]
+            dictionary_offsets = dictionary_offsets.astype(np.int64, copy=False)
+            dictionary_chars = np.empty(0, np.ubyte) if dictionary_chars is None else np.frombuffer(dictionary_chars, np.ubyte)
+            indexes = np.frombuffer(X_col.buffers()[1], index_dtype)[X_col.offset:X_col.offset + len(X_col)]
+
+            with CategoricalEncoder(categories) as encoder:
+                encoded, n_unknowns = encoder.encode_dictionary(dictionary_offsets, dictionary_chars, indexes, _arrow_validity(X_col))
+
+            bad = None
+            if 0 < n_unknowns:
+                unknowns = encoded < 0
+                bad = np.full(len(encoded), None, dtype=np.object_)
+                bad[unknowns] = dictionary.to_numpy(zero_copy_only=False)[indexes[unknowns]]
+            return feature_type, encoded, categories, bad
+
+    if _pandas_installed and pa.types.is_dictionary(arrow_type):
+        # pandas keeps the dictionary indexes as the categorical codes
+        return _process_pandas_column(pd.Series(X_col.to_pandas()), categories, feature_type, min_unique_continuous)
+
+    # strings, booleans and the remaining types have no numeric buffer we can read, so they go through numpy
+    X_col = X_col.to_numpy(zero_copy_only=False)
+    return _process_numpy_column(X_col, categories, feature_type, min_unique_continuous)
+
+def _process_pandas_column(X_col, categories, feature_type, min_unique_continuous, go_fast=False):
     if isinstance(X_col.dtype, np.dtype):
         if issubclass(X_col.dtype.type, np.floating) or issubclass(X_col.dtype.type, np.integer) or X_col.dtype.type is np.bool_:
             X_col = X_col.values
@@ -893,9 +985,11 @@ def _process_pandas_column(X_col, categories, feature_type, min_unique_continuou
         X_col = X_col.astype(dtype=X_col.dtype.type, copy=False)
         return _process_ndarray(X_col, nonmissings, categories, feature_type, min_unique_continuous)
 
+    elif _pyarrow_installed and callable(getattr(X_col.array, '__arrow_array__', None)):
+        # this handles pd.ArrowDtype and pd.StringDtype.  The Arrow backed ones hand over their buffers without a copy
+        return _process_arrow_column(X_col.array.__arrow_array__(), categories, feature_type, min_unique_continuous, go_fast)
+
     # TODO: implement pd.SparseDtype
-    # TODO: implement pd.StringDtype both the numpy and arrow versions
-    # https://pandas.pydata.org/pandas-docs/stable/reference/api/pandas.StringDtype.html#pandas.StringDtype
     msg = f"{type(X_col.dtype)} not supported"
     _log.error(msg)
     raise TypeError(msg)
@@ -920,15 +1014,17 @@ def _process_scipy_column(X_col, categories, feature_type, min_unique_continuous
 
     return _process_ndarray(X_col, nonmissings, categories, feature_type, min_unique_continuous)
 
-def _process_dict_column(X_col, categories, feature_type, min_unique_continuous):
+def _process_dict_column(X_col, categories, feature_type, min_unique_continuous, go_fast=False):
     if isinstance(X_col, np.ndarray): # this includes ma.masked_array
         pass
+    elif _pyarrow_installed and (isinstance(X_col, pa.Array) or isinstance(X_col, pa.ChunkedArray)):
+        return _process_arrow_column(X_col, categories, feature_type, min_unique_continuous, go_fast)
     elif _pandas_installed and isinstance(X_col, pd.Series):
-        return _process_pandas_column(X_col, categories, feature_type, min_unique_continuous)
+        return _process_pandas_column(X_col, categories, feature_type, min_unique_continuous, go_fast)
     elif _pandas_installed and isinstance(X_col, pd.DataFrame):
         if X_col.shape[1] == 1:
             X_col = X_col.iloc[:, 0]
-            return _process_pandas_column(X_col, categories, feature_type, min_unique_continuous)
+            return _process_pandas_column(X_col, categories, feature_type, min_unique_continuous, go_fast)
         elif X_col.shape[0] == 1:
             X_col = X_col.astype(np.object_, copy=False).values.reshape(-1)
         elif X_col.shape[1] == 0 or X_col.shape[0] == 0:
@@ -1082,7 +1178,7 @@ def unify_columns(X, requests, feature_names_in, feature_types=None, min_unique_
             col_idx = names_dict[feature_names_in[feature_idx]]
             X_col = X.iloc[:, col_idx]
             feature_type = None if feature_types is None else feature_types[feature_idx]
-            feature_type_in, X_col, categories, bad = _process_pandas_column(X_col, categories, feature_type, min_unique_continuous)
+            feature_type_in, X_col, categories, bad = _process_pandas_column(X_col, categories, feature_type, min_unique_continuous, go_fast)
             yield feature_type_in, X_col, categories, bad
     elif _scipy_installed and isinstance(X, sp.sparse.spmatrix):
         n_cols = X.shape[1]
@@ -1110,7 +1206,7 @@ def unify_columns(X, requests, feature_names_in, feature_types=None, min_unique_
         for feature_idx, categories in requests:
             X_col = X[feature_names_in[feature_idx]]
             feature_type = None if feature_types is None else feature_types[feature_idx]
-            feature_type_in, X_col, categories, bad = _process_dict_column(X_col, categories, feature_type, min_unique_continuous)
+            feature_type_in, X_col, categories, bad = _process_dict_column(X_col, categories, feature_type, min_unique_continuous, go_fast)
             yield feature_type_in, X_col, categories, bad
     else:
         msg = "internal error"
@@ -1363,6 +1459,9 @@ def clean_X(X):
         return X, X.shape[0]
     elif _scipy_installed and isinstance(X, sp.sparse.spmatrix):
         return X, X.shape[0]
+    elif _pyarrow_installed and isinstance(X, pa.Table):
+        # the columns are handed over as their Arrow arrays, so nothing is copied until they are binned
+        return dict(zip(X.column_names, X.columns)), X.num_rows
     elif isinstance(X, dict):
         for val in X.values():
             if isinstance(val, np.ndarray) and val.ndim == 0:
@@ -1473,36 +1572,47 @@ def clean_X(X):
     X = np.array(X, dtype=np.object_)
     return X, 1 if X.ndim == 1 else X.shape[0]
 
-def _cut_continuous(native, X_col, processing, binning, max_bins, min_samples_bin):
+_cut_methods = {
+    'quantile': Native.CutMethod_Quantile,
+    'rounded_quantile': Native.CutMethod_RoundedQuantile,
+    'uniform': Native.CutMethod_Uniform,
+    'winsorized': Native.CutMethod_Winsorized,
+}
+
+def _cut_continuous(native, X_cols, processings, binning, max_bins, min_samples_bin):
     # called under: fit
-      
-    if processing != 'quantile' and processing != 'rounded_quantile' and processing != 'uniform' and processing != 'winsorized' and not isinstance(processing, list) and not isinstance(processing, np.ndarray):
-        if isinstance(binning, list) or isinstance(binning, np.ndarray):
-            msg = f"illegal binning type {binning}"
-            _log.error(msg)
-            raise ValueError(msg)
-        processing = binning
 
-    if processing == 'quantile':
-        # one bin for missing, one bin for unknown, and # of cuts is one less again
-        cuts = native.cut_quantile(X_col, min_samples_bin, 0, max_bins - 3)
-    elif processing == 'rounded_quantile':
-        # one bin for missing, one bin for unknown, and # of cuts is one less again
-        cuts = native.cut_quantile(X_col, min_samples_bin, 1, max_bins - 3)
-    elif processing == 'uniform':
-        # one bin for missing, one bin for unknown, and # of cuts is one less again
-        cuts = native.cut_uniform(X_col, max_bins - 3)
-    elif processing == 'winsorized':
+    # the features that we cut ourselves are sent to native code together so that they get cut on
+    # separate threads instead of one after another
+    cuts = _none_list * len(X_cols)
+    native_idxs = []
+    native_methods = []
+    for idx, processing in enumerate(processings):
+        if processing != 'quantile' and processing != 'rounded_quantile' and processing != 'uniform' and processing != 'winsorized' and not isinstance(processing, list) and not isinstance(processing, np.ndarray):
+            if isinstance(binning, list) or isinstance(binning, np.ndarray):
+                msg = f"illegal binning type {binning}"
+                _log.error(msg)
+                raise ValueError(msg)
+            processing = binning
+
+        if isinstance(processing, np.ndarray):
+            cuts[idx] = processing.astype(dtype=np.float64, copy=False)
+        elif isinstance(processing, list):
+            cuts[idx] = np.array(processing, dtype=np.float64)
+        else:
+            cut_method = _cut_methods.get(processing, None) if isinstance(processing, str) else None
+            if cut_method is None:
+                msg = f"illegal binning type {processing}"
+                _log.error(msg)
+                raise ValueError(msg)
+            native_idxs.append(idx)
+            native_methods.append(cut_method)
+
+    if len(native_idxs) != 0:
         # one bin for missing, one bin for unknown, and # of cuts is one less again
-        cuts = native.cut_winsorized(X_col, max_bins - 3)
-    elif isinstance(processing, np.ndarray):
-        cuts = processing.astype(dtype=np.float64, copy=False)
-    elif isinstance(processing, list):
-        cuts = np.array(processing, dtype=np.float64)
-    else:
-        msg = f"illegal binning type {processing}"
-        _log.error(msg)
-        raise ValueError(msg)
+        native_cuts = native.cut_features([X_cols[idx] for idx in native_idxs], native_methods, min_samples_bin, max_bins - 3)
+        for idx, feature_cuts in zip(native_idxs, native_cuts):
+            cuts[idx] = feature_cuts
 
     return cuts
 
@@ -1605,6 +1715,9 @@ class EBMPreprocessor(BaseEstimator, TransformerMixin):
         native = Native.get_native_singleton()
         seed = self.random_state
         is_privacy_warning = False
+        continuous_idxs = []
+        continuous_cols = []
+        continuous_processings = []
         for feature_idx, (feature_type_in, X_col, categories, bad) in enumerate(unify_columns(X, zip(range(n_features), repeat(None)), feature_names_in, self.feature_types, self.min_unique_continuous, False)):
             if n_samples != len(X_col):
                 msg = "The columns of X are mismatched in the number of of samples"
@@ -1656,10 +1769,13 @@ class EBMPreprocessor(BaseEstimator, TransformerMixin):
                     min_val = np.nanmin(X_col)
                     max_val = np.nanmax(X_col)
                     feature_type_given = None if self.feature_types is None else self.feature_types[feature_idx]
-                    cuts = _cut_continuous(native, X_col, feature_type_given, self.binning, max_bins, self.min_samples_bin)
-                    discretized = native.discretize(X_col, cuts)
-                    feature_bin_weights = np.bincount(discretized, weights=sample_weight, minlength=len(cuts) + 3)
-                    feature_bin_weights = feature_bin_weights.astype(np.float64, copy=False)
+
+                    # the cuts and bin weights are filled in after the loop once all the continuous features are cut
+                    continuous_idxs.append(feature_idx)
+                    continuous_cols.append(X_col)
+                    continuous_processings.append(feature_type_given)
+                    cuts = None
+                    feature_bin_weights = None
 
                     n_cuts = native.get_histogram_cut_count(X_col)
                     histogram_cuts = native.cut_uniform(X_col, n_cuts)
@@ -1741,6 +1857,15 @@ class EBMPreprocessor(BaseEstimator, TransformerMixin):
                 bins[feature_idx] = categories
             bin_weights[feature_idx] = feature_bin_weights
 
+        if len(continuous_idxs) != 0:
+            max_bins = self.max_bins # TODO: in the future allow this to be per-feature
+            continuous_cuts = _cut_continuous(native, continuous_cols, continuous_processings, self.binning, max_bins, self.min_samples_bin)
+            for feature_idx, X_col, cuts in zip(continuous_idxs, continuous_cols, continuous_cuts):
+                discretized = native.discretize(X_col, cuts)
+                feature_bin_weights = np.bincount(discretized, weights=sample_weight, minlength=len(cuts) + 3)
+                bin_weights[feature_idx] = feature_bin_weights.astype(np.float64, copy=False)
+                bins[feature_idx] = cuts
+
         if is_privacy_warning:
             warn("Possible privacy violation: assuming min/max values per feature are public info. "
                     "Pass a privacy schema with known public ranges per feature to avoid this warning.")
@@ -1879,109 +2004,166 @@ def bin_native(
     sample_weight, 
     feature_names_in, 
     feature_types_in, 
+    shared=False,
+):
+    # called under: fit
+
+    return bin_native_levels(
+        n_classes,
+        feature_idxs, 
+        [bins_iter],
+        X, 
+        y, 
+        sample_weight, 
+        feature_names_in, 
+        feature_types_in, 
+        shared,
+    )[0]
+
+def bin_native_levels(
+    n_classes,
+    feature_idxs, 
+    bins_iters,
+    X, 
+    y, 
+    sample_weight, 
+    feature_names_in, 
+    feature_types_in, 
+    shared=False,
 ):
     # called under: fit
 
-    _log.info("Creating native dataset")
+    # Builds one native dataset per item in bins_iters from a single scan of X.  Each column is unified
+    # once and discretized once per distinct set of cuts, so datasets that share the same cuts for a
+    # feature (which _deduplicate_bins makes into the same object) also share the discretization.
+
+    _log.info("Creating native datasets")
 
     n_samples = len(y)
+    n_levels = len(bins_iters)
 
     native = Native.get_native_singleton()
 
-    responses = []
+    # continuous features are unified once for all the levels, but categoricals are unified per 
+    # distinct categories dictionary since unify_columns maps the categories to bin indexes
     requests = []
-    for request in zip(feature_idxs, bins_iter):
-        responses.append(request)
-        if not isinstance(request[1], dict):
-            # continuous feature.  Don't include the continuous definition
-            request = (request[0], None)
-        requests.append(request)
+    request_levels = []
+    for position, feature_idx in enumerate(feature_idxs):
+        continuous_levels = []
+        categorical_levels = dict()
+        for level_idx in range(n_levels):
+            feature_bins = bins_iters[level_idx][position]
+            if isinstance(feature_bins, dict):
+                levels = categorical_levels.get(id(feature_bins), None)
+                if levels is None:
+                    levels = []
+                    categorical_levels[id(feature_bins)] = levels
+                    requests.append((feature_idx, feature_bins))
+                    request_levels.append((position, levels))
+                levels.append(level_idx)
+            else:
+                continuous_levels.append(level_idx)
+        if len(continuous_levels) != 0:
+            requests.append((feature_idx, None))
+            request_levels.append((position, continuous_levels))
 
     n_weights = 0 if sample_weight is None else 1
 
-    n_bytes = native.size_dataset_header(len(requests), n_weights, 1)
-    for (feature_idx, feature_bins), (_, X_col, _, bad) in zip(responses, unify_columns(X, requests, feature_names_in, feature_types_in, None, False)):
-        if n_samples != len(X_col):
-            msg = "The columns of X are mismatched in the number of of samples"
-            _log.error(msg)
-            raise ValueError(msg)
+    # dense features take the same space regardless of their values, so size_feature gives the exact size
+    # without the binned data and we avoid discretizing every column an extra time just to measure it
+    n_bytes_all = []
+    for bins_iter in bins_iters:
+        n_bytes = native.size_dataset_header(len(bins_iter), n_weights, 1)
+        for feature_idx, feature_bins in zip(feature_idxs, bins_iter):
+            if isinstance(feature_bins, dict):
+                n_bins = 1 if len(feature_bins) == 0 else (max(feature_bins.values()) + 1)
+            else:
+                n_bins = len(feature_bins) + 2
+            n_bins += 1 # the unknown bin, if there is one, doesn't change the size
+            n_bytes += native.size_feature(n_bins, True, True, feature_types_in[feature_idx] == 'nominal', None, n_samples)
 
-        if not X_col.flags.c_contiguous:
-            # X_col could be a slice that has a stride.  We need contiguous for caling into C
-            X_col = X_col.copy()
+        if sample_weight is not None:
+            n_bytes += native.size_weight(sample_weight)
 
-        if isinstance(feature_bins, dict):
-            # categorical feature
-            n_bins = 1 if len(feature_bins) == 0 else (max(feature_bins.values()) + 1)
+        if 0 <= n_classes:
+            n_bytes += native.size_classification_target(n_classes, y)
         else:
-            # continuous feature
-            X_col = native.discretize(X_col, feature_bins)
-            n_bins = len(feature_bins) + 2
-
-        if bad is not None:
-            n_bins += 1
-            X_col[bad != _none_ndarray] = n_bins - 1
-
-        n_bytes += native.size_feature(
-            n_bins, 
-            np.count_nonzero(X_col) != len(X_col), 
-            bad is not None, 
-            feature_types_in[feature_idx] == 'nominal', 
-            X_col
-        )
-
-    if sample_weight is not None:
-        n_bytes += native.size_weight(sample_weight)
-    
-    if 0 <= n_classes:
-        n_bytes += native.size_classification_target(n_classes, y)
-    else:
-        n_bytes += native.size_regression_target(y)
-
-    dataset = np.empty(n_bytes, np.ubyte) # joblib loky doesn't support RawArray
-
-    native.fill_dataset_header(len(requests), n_weights, 1, dataset)
+            n_bytes += native.size_regression_target(y)
+        n_bytes_all.append(n_bytes)
+
+    shared_datasets = []
+    datasets = []
+    try:
+        for n_bytes in n_bytes_all:
+            if shared:
+                # joblib loky doesn't support RawArray, so fill a named shared memory segment in place. 
+                # Workers attach to it by name instead of receiving a pickled copy of the dataset
+                shared_dataset = SharedDataset(n_bytes)
+                shared_datasets.append(shared_dataset)
+                dataset = shared_dataset.view()
+            else:
+                dataset = np.empty(n_bytes, np.ubyte)
+            native.fill_dataset_header(len(feature_idxs), n_weights, 1, dataset)
+            datasets.append(dataset)
 
-    for (feature_idx, feature_bins), (_, X_col, _, bad) in zip(responses, unify_columns(X, requests, feature_names_in, feature_types_in, None, False)):
-        if n_samples != len(X_col):
-            msg = "The columns of X are mismatched in the number of of samples"
-            _log.error(msg)
-            raise ValueError(msg)
+        for (position, levels), (_, X_col, _, bad) in zip(request_levels, unify_columns(X, requests, feature_names_in, feature_types_in, None, False)):
+            if n_samples != len(X_col):
+                msg = "The columns of X are mismatched in the number of of samples"
+                _log.error(msg)
+                raise ValueError(msg)
 
-        if not X_col.flags.c_contiguous:
-            # X_col could be a slice that has a stride.  We need contiguous for caling into C
-            X_col = X_col.copy()
+            if not X_col.flags.c_contiguous:
+                # X_col could be a slice that has a stride.  We need contiguous for caling into C
+                X_col = X_col.copy()
 
-        if isinstance(feature_bins, dict):
-            # categorical feature
-            n_bins = 1 if len(feature_bins) == 0 else (max(feature_bins.values()) + 1)
-        else:
-            # continuous feature
-            X_col = native.discretize(X_col, feature_bins)
-            n_bins = len(feature_bins) + 2
-
-        if bad is not None:
-            n_bins += 1
-            X_col[bad != _none_ndarray] = n_bins - 1
-
-        native.fill_feature(
-            n_bins, 
-            np.count_nonzero(X_col) != len(X_col), 
-            bad is not None, 
-            feature_types_in[feature_idx] == 'nominal', 
-            X_col, 
-            dataset
-        )
+            feature_idx = feature_idxs[position]
+            discretized = dict()
+            for level_idx in levels:
+                feature_bins = bins_iters[level_idx][position]
+                binned = discretized.get(id(feature_bins), None)
+                if binned is None:
+                    if isinstance(feature_bins, dict):
+                        # categorical feature
+                        n_bins = 1 if len(feature_bins) == 0 else (max(feature_bins.values()) + 1)
+                        binned = X_col
+                    else:
+                        # continuous feature
+                        binned = native.discretize(X_col, feature_bins)
+                        n_bins = len(feature_bins) + 2
+
+                    if bad is not None:
+                        n_bins += 1
+                        if binned is X_col:
+                            binned = binned.copy()
+                        binned[bad != _none_ndarray] = n_bins - 1
+
+                    binned = (n_bins, binned)
+                    discretized[id(feature_bins)] = binned
+
+                n_bins, binned_data = binned
+                native.fill_feature(
+                    n_bins, 
+                    np.count_nonzero(binned_data) != len(binned_data), 
+                    bad is not None, 
+                    feature_types_in[feature_idx] == 'nominal', 
+                    binned_data, 
+                    datasets[level_idx]
+                )
 
-    if sample_weight is not None:
-        native.fill_weight(sample_weight, dataset)
+        for dataset in datasets:
+            if sample_weight is not None:
+                native.fill_weight(sample_weight, dataset)
 
-    if 0 <= n_classes:
-        native.fill_classification_target(n_classes, y, dataset)
-    else:
-        native.fill_regression_target(y, dataset)
+            if 0 <= n_classes:
+                native.fill_classification_target(n_classes, y, dataset)
+            else:
+                native.fill_regression_target(y, dataset)
+    except:
+        for shared_dataset in shared_datasets:
+            shared_dataset.close()
+        raise
 
-    return dataset
+    return datasets if not shared else shared_datasets
 
 def bin_native_by_dimension(
     n_classes,
@@ -1992,25 +2174,57 @@ def bin_native_by_dimension(
     sample_weight, 
     feature_names_in, 
     feature_types_in, 
+    shared=False,
+):
+    # called under: fit
+
+    return bin_native_by_dimensions(
+        n_classes,
+        [n_dimensions],
+        bins,
+        X, 
+        y, 
+        sample_weight, 
+        feature_names_in, 
+        feature_types_in, 
+        shared,
+    )[0]
+
+def bin_native_by_dimensions(
+    n_classes,
+    dimensions,
+    bins,
+    X, 
+    y, 
+    sample_weight, 
+    feature_names_in, 
+    feature_types_in, 
+    shared=False,
 ):
     # called under: fit
 
+    # returns one dataset per item in dimensions, built from a single scan of X
+
     feature_idxs = range(len(feature_names_in))
-    bins_iter = []
-    for feature_idx in feature_idxs:
-        bin_levels = bins[feature_idx]
-        feature_bins = bin_levels[min(len(bin_levels), n_dimensions) - 1]
-        bins_iter.append(feature_bins)
+    bins_iters = []
+    for n_dimensions in dimensions:
+        bins_iter = []
+        for feature_idx in feature_idxs:
+            bin_levels = bins[feature_idx]
+            feature_bins = bin_levels[min(len(bin_levels), n_dimensions) - 1]
+            bins_iter.append(feature_bins)
+        bins_iters.append(bins_iter)
 
-    return bin_native(
+    return bin_native_levels(
         n_classes,
         feature_idxs, 
-        bins_iter,
+        bins_iters,
         X, 
         y, 
         sample_weight, 
         feature_names_in, 
         feature_types_in, 
+        shared,
     )
 
 def eval_terms(X, n_samples, feature_names_in, feature_types_in, bins, term_features):
@@ -2065,7 +2279,10 @@ def eval_terms(X, n_samples, feature_names_in, feature_types_in, bins, term_feat
                 # TODO: we could pass out a bool array instead of objects for this function only
                 bad = bad != _none_ndarray
 
-            if not X_col.flags.c_contiguous:
+            if isinstance(X_col, _ArrowNumeric):
+                # Arrow buffers are already contiguous and are binned as they are
+                pass
+            elif not X_col.flags.c_contiguous:
                 # we requrested this feature, so at some point we're going to call discretize, 
                 # which requires contiguous memory
                 X_col = X_col.copy()
@@ -2084,7 +2301,10 @@ def eval_terms(X, n_samples, feature_names_in, feature_types_in, bins, term_feat
                             discretized = cuts_completed[level_idx]
                             if discretized is None:
                                 cuts = bin_levels[level_idx]
-                                discretized = native.discretize(X_col, cuts)
+                                if isinstance(X_col, _ArrowNumeric):
+                                    discretized = native.discretize_arrow(X_col.values, X_col.validity, cuts)
+                                else:
+                                    discretized = native.discretize(X_col, cuts)
                                 if bad is not None:
                                     discretized[bad] = -1
                                 cuts_completed[level_idx] = discretized
@@ -2143,6 +2363,16 @@ def ebm_decision_function(
 
     return sample_scores
 
+def ebm_term_binned(X, n_samples, feature_names_in, feature_types_in, bins, term_features):
+    # collects the binned data that eval_terms yields back into term order
+    if 0 < n_samples:
+        term_binned = _none_list * len(term_features)
+        for term_idx, binned_data in eval_terms(X, n_samples, feature_names_in, feature_types_in, bins, term_features):
+            term_binned[term_idx] = binned_data
+    else:
+        term_binned = [[np.empty(0, np.int64)] * len(feature_idxs) for feature_idxs in term_features]
+    return term_binned
+
 def ebm_decision_function_and_explain(
     X, 
     n_samples, 
@@ -2151,23 +2381,79 @@ def ebm_decision_function_and_explain(
     bins, 
     intercept, 
     term_scores, 
-    term_features
+    term_features,
+    n_top_terms=None
 ):
-    if type(intercept) is float or len(intercept) == 1:
-        sample_scores = np.full(n_samples, intercept, dtype=np.float64)
-        explanations = np.empty((n_samples, len(term_features)), dtype=np.float64)
-    else:
-        # TODO: add a test for multiclass calls to ebm_decision_function_and_explain
-        sample_scores = np.full((n_samples, len(intercept)), intercept, dtype=np.float64)
-        explanations = np.empty((n_samples, len(term_features), len(intercept)), dtype=np.float64)
+    # the scores and the contributions come out of a single native pass over the binned terms.  If n_top_terms
+    # is given then only that many contributions are kept per sample, largest first, and their term indexes are returned
+    term_binned = ebm_term_binned(X, n_samples, feature_names_in, feature_types_in, bins, term_features)
 
-    if 0 < n_samples:
-        for term_idx, binned_data in eval_terms(X, n_samples, feature_names_in, feature_types_in, bins, term_features):
-            scores = term_scores[term_idx][tuple(binned_data)]
-            sample_scores += scores
-            explanations[:, term_idx] = scores
+    native = Native.get_native_singleton()
+    sample_scores, explanations, term_indexes = native.compute_scores_and_contributions(
+        n_samples, 
+        intercept, 
+        term_scores, 
+        term_binned, 
+        0 if n_top_terms is None else n_top_terms
+    )
+
+    if n_top_terms is None:
+        return sample_scores, explanations
+
+    if term_indexes is None:
+        # every term was kept, so they are in their natural order
+        term_indexes = np.tile(np.arange(len(term_features), dtype=np.int64), (n_samples, 1))
+    return sample_scores, explanations, term_indexes
+
+def ebm_partial_dependence(
+    X, 
+    n_samples, 
+    feature_names_in, 
+    feature_types_in, 
+    bins, 
+    intercept, 
+    term_scores, 
+    term_features,
+    feature_idx,
+    grid_points,
+    sample_weight=None,
+    is_ice=False
+):
+    # only the terms that contain feature_idx change when it is moved, so the samples are binned and scored
+    # once and the grid points are binned on their own.  Repeating feature_idx once per dimension of a term
+    # bins the grid at the same bin level that the term uses
+    term_binned = ebm_term_binned(X, n_samples, feature_names_in, feature_types_in, bins, term_features)
 
-    return sample_scores, explanations
+    native = Native.get_native_singleton()
+    sample_scores, _, _ = native.compute_scores_and_contributions(
+        n_samples, 
+        intercept, 
+        term_scores, 
+        term_binned, 
+        0, 
+        False
+    )
+
+    n_grid = len(grid_points)
+    grid_term_idxs = [term_idx for term_idx, feature_idxs in enumerate(term_features) if feature_idx in feature_idxs]
+    grid_binned = _none_list * len(term_features)
+    if 0 < n_grid:
+        X_grid = {feature_names_in[feature_idx]: grid_points}
+        grid_terms = [(feature_idx,) * len(term_features[term_idx]) for term_idx in grid_term_idxs]
+        for grid_term_idx, binned_data in eval_terms(X_grid, n_grid, feature_names_in, feature_types_in, bins, grid_terms):
+            grid_binned[grid_term_idxs[grid_term_idx]] = binned_data
+
+    return native.compute_partial_dependence(
+        sample_scores, 
+        term_scores, 
+        term_binned, 
+        n_grid, 
+        grid_binned, 
+        term_features, 
+        feature_idx, 
+        sample_weight, 
+        is_ice
+    )
 
 def get_counts_and_weights(X, n_samples, sample_weight, feature_names_in, feature_types_in, bins, term_features):
     bin_counts = _none_list * len(term_features)
@@ -8,7 +8,7 @@ from interpret.provider.visualize import PreserveProvider
 from ...utils import gen_perf_dicts
 from .utils import DPUtils, EBMUtils
 from .utils import _process_terms, make_histogram_edges, _order_terms, _remove_unused_higher_bins, _deduplicate_bins, _generate_term_names, _generate_term_types
-from .bin import clean_X, clean_vector, construct_bins, bin_native_by_dimension, ebm_decision_function, ebm_decision_function_and_explain, make_boosting_weights, after_boosting, remove_last2, get_counts_and_weights, trim_tensor, unify_data2, eval_terms
+from .bin import clean_X, clean_vector, construct_bins, bin_native_by_dimensions, ebm_decision_function, ebm_decision_function_and_explain, ebm_term_binned, ebm_partial_dependence, make_boosting_weights, after_boosting, remove_last2, get_counts_and_weights, trim_tensor, unify_data2
 from .internal import Native
 from ...utils import unify_data, autogen_schema, unify_vector
 from ...api.base import ExplainerMixin
@@ -189,6 +189,8 @@ class BaseEBM(BaseEstimator):
         composition=None,
         bin_budget_frac=None,
         privacy_schema=None,
+        # Scheduling
+        term_scheduling=None,
     ):
         # Arguments for explainer
         self.feature_names = feature_names
@@ -208,6 +210,7 @@ class BaseEBM(BaseEstimator):
         if not is_private(self):
             self.early_stopping_tolerance = early_stopping_tolerance
             self.early_stopping_rounds = early_stopping_rounds
+            self.term_scheduling = term_scheduling
 
         # Arguments for internal EBM.
         self.learning_rate = learning_rate
@@ -378,6 +381,7 @@ class BaseEBM(BaseEstimator):
             early_stopping_rounds = -1
             early_stopping_tolerance = -1
             interactions = 0
+            term_scheduling = None
         else:
             noise_scale = None
             bin_data_weights = None
@@ -386,6 +390,7 @@ class BaseEBM(BaseEstimator):
             early_stopping_rounds = self.early_stopping_rounds
             early_stopping_tolerance = self.early_stopping_tolerance
             interactions = self.interactions
+            term_scheduling = self.term_scheduling
 
         native = Native.get_native_singleton()
         bagged_seed = init_seed
@@ -413,56 +418,6 @@ class BaseEBM(BaseEstimator):
                     bag_weights.append((bag[keep] * sample_weight[keep]).sum())
         bag_weights = np.array(bag_weights, np.float64)
 
-        provider = JobLibProvider(n_jobs=self.n_jobs)
-
-        dataset = bin_native_by_dimension(
-            n_classes, 
-            1,
-            bins,
-            X, 
-            y, 
-            sample_weight, 
-            feature_names_in, 
-            feature_types_in, 
-        )
-
-        bagged_seed = init_seed
-        parallel_args = []
-        for idx in range(self.outer_bags):
-            bagged_seed = native.generate_deterministic_seed(bagged_seed, 13098686)
-            parallel_args.append(
-                (
-                    dataset,
-                    bags[idx],
-                    None,
-                    term_features,
-                    inner_bags,
-                    boosting_flags,
-                    self.learning_rate,
-                    self.min_samples_leaf,
-                    self.max_leaves,
-                    early_stopping_rounds,
-                    early_stopping_tolerance,
-                    self.max_rounds,
-                    noise_scale,
-                    bin_data_weights,
-                    bagged_seed,
-                    None,
-                )
-            )
-
-        results = provider.parallel(EBMUtils.cyclic_gradient_boost, parallel_args)
-
-        # let python reclaim the dataset memory via reference counting
-        del parallel_args # parallel_args holds references to dataset, so must be deleted
-        del dataset
-
-        breakpoint_iteration = [[]]
-        models = []
-        for model, bag_breakpoint_iteration in results:
-            breakpoint_iteration[-1].append(bag_breakpoint_iteration)
-            models.append(after_boosting(term_features, model, main_bin_weights))
-
         if n_classes > 2:
             if isinstance(interactions, int):
                if interactions != 0:
@@ -471,110 +426,43 @@ class BaseEBM(BaseEstimator):
             elif len(interactions) != 0:
                 raise ValueError("Interactions are not supported for multiclass. Multiclass interactions work except for global visualizations, so this exception can be disabled if you know what you are doing.")
 
-        if isinstance(interactions, int) and 0 < interactions or not isinstance(interactions, int) and 0 < len(interactions):
-            initial_intercept = np.zeros(Native.get_count_scores_c(n_classes), np.float64)
-            scores_bags = []
-            for model in models:
-                # TODO: instead of going back to the original data in X, we 
-                # could use the compressed and already binned data in dataset
-                scores_bags.append(ebm_decision_function(
-                    X, 
-                    n_samples, 
-                    feature_names_in, 
-                    feature_types_in, 
-                    bins, 
-                    initial_intercept, 
-                    model, 
-                    term_features
-                ))
-
-            dataset = bin_native_by_dimension(
-                n_classes, 
-                2,
-                bins,
-                X, 
-                y, 
-                sample_weight, 
-                feature_names_in, 
-                feature_types_in, 
-            )
-            del y # we no longer need this, so allow the garbage collector to reclaim it
-
-            if isinstance(interactions, int):
-                _log.info("Estimating with FAST")
-
-                parallel_args = []
-                for idx in range(self.outer_bags):
-                    # TODO: the combinations below should be selected from the non-excluded features 
-                    parallel_args.append(
-                        (
-                            dataset,
-                            bags[idx],
-                            scores_bags[idx],
-                            combinations(range(n_features_in), 2),
-                            Native.InteractionOptions_Default, 
-                            self.min_samples_leaf,
-                            None,
-                        )
-                    )
-
-                # TODO: for now we're using only 1 job because FAST isn't memory optimized.  After
-                # the native code is done with compression of the data we can go back to using self.n_jobs
-                provider2 = JobLibProvider(n_jobs=1) 
-                bagged_interaction_indices = provider2.parallel(EBMUtils.calc_interaction_order, parallel_args)
-
-                # this holds references to dataset, bags, and scores_bags which we want python to reclaim later
-                del parallel_args 
-
-                # Select merged pairs
-                pair_ranks = {}
-                for n, interaction_indices in enumerate(bagged_interaction_indices):
-                    for rank, indices in enumerate(interaction_indices):
-                        old_mean = pair_ranks.get(indices, 0)
-                        pair_ranks[indices] = old_mean + ((rank - old_mean) / (n + 1))
-
-                final_ranks = []
-                total_interactions = 0
-                for indices in pair_ranks:
-                    heapq.heappush(final_ranks, (pair_ranks[indices], indices))
-                    total_interactions += 1
-
-                n_interactions = min(interactions, total_interactions)
-                boost_groups = [heapq.heappop(final_ranks)[1] for _ in range(n_interactions)]
-            else:
-                # Check and remove duplicate interaction terms
-                uniquifier = set()
-                boost_groups = []
-                max_dimensions = 0
-
-                for feature_idxs in interactions:
-                    # clean these up since we expose them publically inside self.term_features_ 
-                    feature_idxs = tuple(map(int, feature_idxs))
-
-                    max_dimensions = max(max_dimensions, len(feature_idxs))
-                    sorted_tuple = tuple(sorted(feature_idxs))
-                    if sorted_tuple not in uniquifier:
-                        uniquifier.add(sorted_tuple)
-                        boost_groups.append(feature_idxs)
+        is_interactions = isinstance(interactions, int) and 0 < interactions or not isinstance(interactions, int) and 0 < len(interactions)
 
-                # Warn the users that we have made change to the interactions list
-                if len(boost_groups) != len(interactions):
-                    warn("Detected duplicate interaction terms: removing duplicate interaction terms")
+        provider = JobLibProvider(n_jobs=self.n_jobs)
 
-                if 2 < max_dimensions:
-                    warn("Interactions with 3 or more terms are not graphed in global explanations. Local explanations are still available and exact.")
+        # when the outer bags run in separate worker processes, build the dataset in shared 
+        # memory so that joblib pickles the segment name instead of a copy of the dataset
+        share_dataset = self.n_jobs != 1 and 1 < self.outer_bags
 
+        # the pairs dataset is built in the same scan of X as the mains dataset, so it stays allocated
+        # while the mains are boosted and peak memory holds both datasets at once
+        datasets = bin_native_by_dimensions(
+            n_classes, 
+            [1, 2] if is_interactions else [1],
+            bins,
+            X, 
+            y, 
+            sample_weight, 
+            feature_names_in, 
+            feature_types_in, 
+            share_dataset,
+        )
+        # the success path closes each shared segment as soon as it is done with it, but an exception while
+        # boosting would otherwise leave the segments allocated until the interpreter exits
+        shared_datasets = list(datasets) if share_dataset else []
+        try:
+            dataset = datasets[0]
 
             bagged_seed = init_seed
             parallel_args = []
             for idx in range(self.outer_bags):
-                bagged_seed = native.generate_deterministic_seed(bagged_seed, 521040308)
+                bagged_seed = native.generate_deterministic_seed(bagged_seed, 13098686)
                 parallel_args.append(
                     (
                         dataset,
                         bags[idx],
-                        scores_bags[idx],
-                        boost_groups,
+                        None,
+                        term_features,
                         inner_bags,
                         boosting_flags,
                         self.learning_rate,
@@ -587,22 +475,151 @@ class BaseEBM(BaseEstimator):
                         bin_data_weights,
                         bagged_seed,
                         None,
+                        term_scheduling,
                     )
                 )
 
             results = provider.parallel(EBMUtils.cyclic_gradient_boost, parallel_args)
 
-            # allow python to reclaim these big memory items via reference counting
-            del parallel_args # this holds references to dataset, scores_bags, and bags
+            del parallel_args # parallel_args holds references to dataset
+
+            breakpoint_iteration = [[]]
+            models = []
+            for model, bag_breakpoint_iteration in results:
+                breakpoint_iteration[-1].append(bag_breakpoint_iteration)
+                models.append(after_boosting(term_features, model, main_bin_weights))
+
+            if is_interactions:
+                initial_intercept = np.zeros(Native.get_count_scores_c(n_classes), np.float64)
+                scores_bags = []
+                for model, _ in results:
+                    # the tensors straight out of boosting still match the bins inside dataset, so 
+                    # we can score the already binned data instead of re-discretizing X for each bag
+                    scores_bags.append(native.compute_scores_from_dataset(dataset, initial_intercept, model, term_features))
+
+            # let python reclaim the dataset memory via reference counting
+            if share_dataset:
+                dataset.close()
             del dataset
-            del scores_bags
+            del results
+            datasets[0] = None
+
+            if is_interactions:
+                dataset = datasets[1]
+                del datasets
+                del y # we no longer need this, so allow the garbage collector to reclaim it
+
+                if isinstance(interactions, int):
+                    _log.info("Estimating with FAST")
+
+                    parallel_args = []
+                    for idx in range(self.outer_bags):
+                        # TODO: the combinations below should be selected from the non-excluded features 
+                        parallel_args.append(
+                            (
+                                dataset,
+                                bags[idx],
+                                scores_bags[idx],
+                                combinations(range(n_features_in), 2),
+                                Native.InteractionOptions_Default, 
+                                self.min_samples_leaf,
+                                None,
+                            )
+                        )
 
-            breakpoint_iteration.append([])
-            for idx in range(self.outer_bags):
-                breakpoint_iteration[-1].append(results[idx][1])
-                models[idx].extend(after_boosting(boost_groups, results[idx][0], main_bin_weights))
+                    # TODO: for now we're using only 1 job because FAST isn't memory optimized.  After
+                    # the native code is done with compression of the data we can go back to using self.n_jobs
+                    provider2 = JobLibProvider(n_jobs=1) 
+                    bagged_interaction_indices = provider2.parallel(EBMUtils.calc_interaction_order, parallel_args)
+
+                    # this holds references to dataset, bags, and scores_bags which we want python to reclaim later
+                    del parallel_args 
+
+                    # Select merged pairs
+                    pair_ranks = {}
+                    for n, interaction_indices in enumerate(bagged_interaction_indices):
+                        for rank, indices in enumerate(interaction_indices):
+                            old_mean = pair_ranks.get(indices, 0)
+                            pair_ranks[indices] = old_mean + ((rank - old_mean) / (n + 1))
+
+                    final_ranks = []
+                    total_interactions = 0
+                    for indices in pair_ranks:
+                        heapq.heappush(final_ranks, (pair_ranks[indices], indices))
+                        total_interactions += 1
+
+                    n_interactions = min(interactions, total_interactions)
+                    boost_groups = [heapq.heappop(final_ranks)[1] for _ in range(n_interactions)]
+                else:
+                    # Check and remove duplicate interaction terms
+                    uniquifier = set()
+                    boost_groups = []
+                    max_dimensions = 0
+
+                    for feature_idxs in interactions:
+                        # clean these up since we expose them publically inside self.term_features_ 
+                        feature_idxs = tuple(map(int, feature_idxs))
+
+                        max_dimensions = max(max_dimensions, len(feature_idxs))
+                        sorted_tuple = tuple(sorted(feature_idxs))
+                        if sorted_tuple not in uniquifier:
+                            uniquifier.add(sorted_tuple)
+                            boost_groups.append(feature_idxs)
+
+                    # Warn the users that we have made change to the interactions list
+                    if len(boost_groups) != len(interactions):
+                        warn("Detected duplicate interaction terms: removing duplicate interaction terms")
+
+                    if 2 < max_dimensions:
+                        warn("Interactions with 3 or more terms are not graphed in global explanations. Local explanations are still available and exact.")
+
+
+                bagged_seed = init_seed
+                parallel_args = []
+                for idx in range(self.outer_bags):
+                    bagged_seed = native.generate_deterministic_seed(bagged_seed, 521040308)
+                    parallel_args.append(
+                        (
+                            dataset,
+                            bags[idx],
+                            scores_bags[idx],
+                            boost_groups,
+                            inner_bags,
+                            boosting_flags,
+                            self.learning_rate,
+                            self.min_samples_leaf,
+                            self.max_leaves,
+                            early_stopping_rounds,
+                            early_stopping_tolerance,
+                            self.max_rounds,
+                            noise_scale,
+                            bin_data_weights,
+                            bagged_seed,
+                            None,
+                            term_scheduling,
+                        )
+                    )
 
-            term_features.extend(boost_groups)
+                results = provider.parallel(EBMUtils.cyclic_gradient_boost, parallel_args)
+
+                # allow python to reclaim these big memory items via reference counting
+                del parallel_args # this holds references to dataset, scores_bags, and bags
+                if share_dataset:
+                    dataset.close()
+                del dataset
+                del scores_bags
+
+                breakpoint_iteration.append([])
+                for idx in range(self.outer_bags):
+                    breakpoint_iteration[-1].append(results[idx][1])
+                    models[idx].extend(after_boosting(boost_groups, results[idx][0], main_bin_weights))
+
+                term_features.extend(boost_groups)
+        finally:
+            # closing a SharedDataset a second time does nothing
+            for shared_dataset in shared_datasets:
+                shared_dataset.close()
+            del shared_datasets
 
         breakpoint_iteration = np.array(breakpoint_iteration, np.int64)
 
@@ -795,6 +812,9 @@ class BaseEBM(BaseEstimator):
             if hasattr(self, 'max_rounds'):
                 params['max_rounds'] = self.max_rounds
 
+            if getattr(self, 'term_scheduling', None) is not None:
+                params['term_scheduling'] = list(self.term_scheduling)
+
             if hasattr(self, 'early_stopping_tolerance'):
                 params['early_stopping_tolerance'] = self.early_stopping_tolerance
 
@@ -1308,19 +1328,8 @@ class BaseEBM(BaseEstimator):
                     }
                 data_dicts.append(data_dict)
 
-            for term_idx, binned_data in eval_terms(X, n_samples, self.feature_names_in_, self.feature_types_in_, self.bins_, self.term_features_):
-                scores = self.term_scores_[term_idx][tuple(binned_data)]
-                feature_idxs = self.term_features_[term_idx]
-                for row_idx in range(n_samples):
-                    term_name = term_names[term_idx]
-                    data_dicts[row_idx]["names"][term_idx] = term_name
-                    data_dicts[row_idx]["scores"][term_idx] = scores[row_idx]
-                    if len(feature_idxs) == 1:
-                        data_dicts[row_idx]["values"][term_idx] = X_unified[row_idx, feature_idxs[0]]
-                    else:
-                        data_dicts[row_idx]["values"][term_idx] = ""
-
-            sample_scores = ebm_decision_function(
+            # the scores and the per-term contributions come from the same pass over the binned data
+            sample_scores, explanations = ebm_decision_function_and_explain(
                 X, 
                 n_samples, 
                 self.feature_names_in_, 
@@ -1331,6 +1340,17 @@ class BaseEBM(BaseEstimator):
                 self.term_features_
             )
 
+            for term_idx, feature_idxs in enumerate(self.term_features_):
+                scores = explanations[:, term_idx]
+                for row_idx in range(n_samples):
+                    term_name = term_names[term_idx]
+                    data_dicts[row_idx]["names"][term_idx] = term_name
+                    data_dicts[row_idx]["scores"][term_idx] = scores[row_idx]
+                    if len(feature_idxs) == 1:
+                        data_dicts[row_idx]["values"][term_idx] = X_unified[row_idx, feature_idxs[0]]
+                    else:
+                        data_dicts[row_idx]["values"][term_idx] = ""
+
             if is_classifier(self):
                 # Handle binary classification case -- softmax only works with 0s appended
                 if sample_scores.ndim == 1:
@@ -1426,6 +1446,158 @@ class BaseEBM(BaseEstimator):
         else:
             raise ValueError(f"Unrecognized importance_type: {importance_type}")
 
+    def get_partial_dependence(self, X, feature_idx, grid_points, sample_weight=None, is_ice=False):
+        """ Provides the partial dependence of a feature, computed from the term tensors without calling predict
+
+        Args:
+            X: Numpy array for samples.
+            feature_idx: index of the feature to move across the grid
+            grid_points: values of the feature to evaluate
+            sample_weight: Optional array of weights per sample.
+            is_ice: also return the individual conditional expectation lines
+
+        Returns:
+            The mean score before the link function at each grid point, its standard deviation, and the
+            ICE scores per (sample, grid point) if is_ice is True, otherwise None
+        """
+        check_is_fitted(self, "has_fitted_")
+
+        X, n_samples = clean_X(X)
+        if sample_weight is not None:
+            sample_weight = clean_vector(sample_weight, False, "sample_weight")
+
+        return ebm_partial_dependence(
+            X,
+            n_samples,
+            self.feature_names_in_,
+            self.feature_types_in_,
+            self.bins_,
+            self.intercept_,
+            self.term_scores_,
+            self.term_features_,
+            feature_idx,
+            np.asarray(grid_points),
+            sample_weight,
+            is_ice
+        )
+
+    def get_permutation_importances(self, X, y, sample_weight=None, random_state=None):
+        """ Provides the permutation importance of each feature
+
+        Each feature is shuffled across the samples in turn, and only the terms that contain it are rescored.
+
+        Args:
+            X: Numpy array for samples.
+            y: Targets for the samples.
+            sample_weight: Optional array of weights per sample.
+            random_state: Random state for the shuffle.
+
+        Returns:
+            An array with the increase in log loss (classification) or mean squared error (regression)
+            for each feature
+        """
+        check_is_fitted(self, "has_fitted_")
+
+        X, n_samples = clean_X(X)
+
+        if is_classifier(self):
+            y = clean_vector(y, True, "y")
+            y = np.array([self._class_idx_[el] for el in y], dtype=np.int64)
+        else:
+            y = clean_vector(y, False, "y")
+
+        if n_samples != len(y):
+            msg = f"X has {n_samples} samples and y has {len(y)} samples"
+            _log.error(msg)
+            raise ValueError(msg)
+
+        if sample_weight is not None:
+            sample_weight = clean_vector(sample_weight, False, "sample_weight")
+
+        term_binned = ebm_term_binned(
+            X,
+            n_samples,
+            self.feature_names_in_,
+            self.feature_types_in_,
+            self.bins_,
+            self.term_features_
+        )
+
+        native = Native.get_native_singleton()
+        sample_scores, _, _ = native.compute_scores_and_contributions(
+            n_samples,
+            self.intercept_,
+            self.term_scores_,
+            term_binned,
+            0,
+            False
+        )
+
+        if is_classifier(self):
+            def metric(scores):
+                if scores.ndim == 1:
+                    scores = np.c_[np.zeros(scores.shape), scores]
+                return log_loss(y, softmax(scores), sample_weight=sample_weight, labels=np.arange(len(self.classes_)))
+        else:
+            def metric(scores):
+                return mean_squared_error(y, scores, sample_weight=sample_weight)
+
+        base_metric = metric(sample_scores)
+        permutation = np.random.RandomState(random_state).permutation(n_samples)
+
+        # every feature rescores against the same terms, so pack them for the native code only once
+        effect_terms = Native.flatten_effect_terms(n_samples, self.term_scores_, term_binned, self.term_features_)
+        del term_binned
+
+        importances = np.zeros(len(self.feature_names_in_), np.float64)
+        used_features = set(feature_idx for feature_idxs in self.term_features_ for feature_idx in feature_idxs)
+        for feature_idx in sorted(used_features):
+            permuted_scores = native.compute_permuted_scores(
+                sample_scores,
+                effect_terms,
+                feature_idx,
+                permutation
+            )
+            importances.itemset(feature_idx, metric(permuted_scores) - base_metric)
+        return importances
+
+    def get_shapley_values(self, X):
+        """ Provides the exact Shapley values of each sample, computed from the term tensors without calling predict
+
+        Each term is shared only between its own features, and the training bin weights are the background
+        distribution, so pairs are exact without sampling coalitions.
+
+        Args:
+            X: Numpy array for samples.
+
+        Returns:
+            The expected score before the link function, and the Shapley values per (sample, feature), with
+            a trailing class dimension for multiclass
+        """
+        check_is_fitted(self, "has_fitted_")
+
+        X, n_samples = clean_X(X)
+
+        term_binned = ebm_term_binned(
+            X,
+            n_samples,
+            self.feature_names_in_,
+            self.feature_types_in_,
+            self.bins_,
+            self.term_features_
+        )
+
+        native = Native.get_native_singleton()
+        return native.compute_shapley_values(
+            n_samples,
+            len(self.feature_names_in_),
+            self.term_scores_,
+            term_binned,
+            self.term_features_,
+            self.bin_weights_,
+            self.intercept_
+        )
+
 class ExplainableBoostingClassifier(BaseEBM, ClassifierMixin, ExplainerMixin):
     """ Explainable Boosting Classifier. The arguments will change in a future release, watch the changelog. """
 
@@ -1456,6 +1628,7 @@ class ExplainableBoostingClassifier(BaseEBM, ClassifierMixin, ExplainerMixin):
         early_stopping_rounds=50,
         early_stopping_tolerance=1e-4,
         max_rounds=5000,
+        term_scheduling=None,
         # Trees
         min_samples_leaf=2,
         max_leaves=3,
@@ -1482,6 +1655,9 @@ class ExplainableBoostingClassifier(BaseEBM, ClassifierMixin, ExplainerMixin):
             early_stopping_rounds: Number of rounds of no improvement to trigger early stopping.
             early_stopping_tolerance: Tolerance that dictates the smallest delta required to be considered an improvement.
             max_rounds: Number of rounds for boosting.
+            term_scheduling: None to boost every term every round, or a (gain_relative_min, recheck_rounds) tuple
+                to skip the terms whose recent gains fall below gain_relative_min times the best term's, re-checking
+                each of them every recheck_rounds rounds.
             min_samples_leaf: Minimum number of cases for tree splits used in boosting.
             max_leaves: Maximum leaf nodes used in boosting.
             n_jobs: Number of jobs to run in parallel.
@@ -1507,6 +1683,7 @@ class ExplainableBoostingClassifier(BaseEBM, ClassifierMixin, ExplainerMixin):
             early_stopping_rounds=early_stopping_rounds,
             early_stopping_tolerance=early_stopping_tolerance,
             max_rounds=max_rounds,
+            term_scheduling=term_scheduling,
             # Trees
             min_samples_leaf=min_samples_leaf,
             max_leaves=max_leaves,
@@ -1575,15 +1752,17 @@ class ExplainableBoostingClassifier(BaseEBM, ClassifierMixin, ExplainerMixin):
 
         return self.classes_[np.argmax(log_odds_vector, axis=1)]
 
-    def predict_and_contrib(self, X, output='probabilities'):
+    def predict_and_contrib(self, X, output='probabilities', n_top_terms=None):
         """Predicts on provided samples, returning predictions and explanations for each sample.
 
         Args:
             X: Numpy array for samples.
             output: Prediction type to output (i.e. one of 'probabilities', 'logits', 'labels')
+            n_top_terms: If set, only the n_top_terms largest contributions are returned per sample.
 
         Returns:
-            Predictions and local explanations for each sample.
+            Predictions and local explanations for each sample.  If n_top_terms is set, the term index
+            of each explanation is returned too.
         """
 
         check_is_fitted(self, "has_fitted_")
@@ -1596,7 +1775,7 @@ class ExplainableBoostingClassifier(BaseEBM, ClassifierMixin, ExplainerMixin):
 
         X, n_samples = clean_X(X)
 
-        scores, explanations = ebm_decision_function_and_explain(
+        scores, explanations, *term_indexes = ebm_decision_function_and_explain(
             X, 
             n_samples, 
             self.feature_names_in_, 
@@ -1604,7 +1783,8 @@ class ExplainableBoostingClassifier(BaseEBM, ClassifierMixin, ExplainerMixin):
             self.bins_, 
             self.intercept_, 
             self.term_scores_, 
-            self.term_features_
+            self.term_features_,
+            n_top_terms
         )
 
         if output == 'probabilities':
@@ -1618,7 +1798,7 @@ class ExplainableBoostingClassifier(BaseEBM, ClassifierMixin, ExplainerMixin):
         else:
             result = scores
 
-        return result, explanations
+        return (result, explanations, *term_indexes)
 
 class ExplainableBoostingRegressor(BaseEBM, RegressorMixin, ExplainerMixin):
     """ Explainable Boosting Regressor. The arguments will change in a future release, watch the changelog. """
@@ -1650,6 +1830,7 @@ class ExplainableBoostingRegressor(BaseEBM, RegressorMixin, ExplainerMixin):
         early_stopping_rounds=50,
         early_stopping_tolerance=1e-4,
         max_rounds=5000,
+        term_scheduling=None,
         # Trees
         min_samples_leaf=2,
         max_leaves=3,
@@ -1675,6 +1856,9 @@ class ExplainableBoostingRegressor(BaseEBM, RegressorMixin, ExplainerMixin):
             early_stopping_rounds: Number of rounds of no improvement to trigger early stopping.
             early_stopping_tolerance: Tolerance that dictates the smallest delta required to be considered an improvement.
             max_rounds: Number of rounds for boosting.
+            term_scheduling: None to boost every term every round, or a (gain_relative_min, recheck_rounds) tuple
+                to skip the terms whose recent gains fall below gain_relative_min times the best term's, re-checking
+                each of them every recheck_rounds rounds.
             min_samples_leaf: Minimum number of cases for tree splits used in boosting.
             max_leaves: Maximum leaf nodes used in boosting.
             n_jobs: Number of jobs to run in parallel.
@@ -1700,6 +1884,7 @@ class ExplainableBoostingRegressor(BaseEBM, RegressorMixin, ExplainerMixin):
             early_stopping_rounds=early_stopping_rounds,
             early_stopping_tolerance=early_stopping_tolerance,
             max_rounds=max_rounds,
+            term_scheduling=term_scheduling,
             # Trees
             min_samples_leaf=min_samples_leaf,
             max_leaves=max_leaves,
@@ -1732,14 +1917,16 @@ class ExplainableBoostingRegressor(BaseEBM, RegressorMixin, ExplainerMixin):
             self.term_features_
         )
 
-    def predict_and_contrib(self, X):
+    def predict_and_contrib(self, X, n_top_terms=None):
         """Predicts on provided samples, returning predictions and explanations for each sample.
 
         Args:
             X: Numpy array for samples.
+            n_top_terms: If set, only the n_top_terms largest contributions are returned per sample.
 
         Returns:
-            Predictions and local explanations for each sample.
+            Predictions and local explanations for each sample.  If n_top_terms is set, the term index
+            of each explanation is returned too.
         """
 
         check_is_fitted(self, "has_fitted_")
@@ -1754,7 +1941,8 @@ class ExplainableBoostingRegressor(BaseEBM, RegressorMixin, ExplainerMixin):
             self.bins_, 
             self.intercept_, 
             self.term_scores_, 
-            self.term_features_
+            self.term_features_,
+            n_top_terms
         )
 
 
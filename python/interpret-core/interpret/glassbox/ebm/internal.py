@@ -8,11 +8,20 @@ import numpy as np
 import os
 import struct
 import logging
+import threading
 from contextlib import AbstractContextManager
+from multiprocessing import shared_memory
 
 log = logging.getLogger(__name__)
 
 class Native:
+    """ Wraps the native library.
+
+    The native functions are safe to call concurrently from Python threads, and ctypes releases the GIL for
+    the duration of each call, so scoring or boosting from several threads runs in parallel.  Each booster or
+    interaction handle must only be used by one thread at a time.  Categorical encoders are read-only after
+    creation and can be shared between threads.
+    """
 
     # GenerateUpdateOptionsType
     GenerateUpdateOptions_Default               = 0x0000000000000000
@@ -25,6 +34,55 @@ class Native:
     InteractionOptions_Default                  = 0x0000000000000000
     InteractionOptions_Pure                     = 0x0000000000000001
 
+    # CreateBoosterFlagsType
+    CreateBoosterFlags_Default                  = 0x0000000000000000
+    CreateBoosterFlags_BinSortedLayout          = 0x0000000000000001
+
+    # PerfCounter
+    PerfCounter_BinBoosting                     = 0
+    PerfCounter_SumHistogramBuckets             = 1
+    PerfCounter_TensorTotalsBuild               = 2
+    PerfCounter_PartitionOneDimensionalBoosting = 3
+    PerfCounter_PartitionTwoDimensionalBoosting = 4
+    PerfCounter_PartitionRandomBoosting         = 5
+    PerfCounter_ApplyTermUpdateTraining         = 6
+    PerfCounter_ApplyTermUpdateValidation       = 7
+    PerfCounter_BinInteraction                  = 8
+    PerfCounter_CalculateInteractionScore       = 9
+    PerfCounter_PartitionCornerBoosting         = 10
+    PerfCounter_Count                           = 11
+
+    # ArrowType
+    ArrowType_Float64                           = 0
+    ArrowType_Float32                           = 1
+    ArrowType_Int64                             = 2
+    ArrowType_Int32                             = 3
+    ArrowType_Int16                             = 4
+    ArrowType_Int8                              = 5
+    ArrowType_UInt64                            = 6
+    ArrowType_UInt32                            = 7
+    ArrowType_UInt16                            = 8
+    ArrowType_UInt8                             = 9
+
+    # CutMethod
+    CutMethod_Quantile                          = 0
+    CutMethod_RoundedQuantile                   = 1
+    CutMethod_Uniform                           = 2
+    CutMethod_Winsorized                        = 3
+
+    _arrow_types = {
+        np.float64: ArrowType_Float64,
+        np.float32: ArrowType_Float32,
+        np.int64: ArrowType_Int64,
+        np.int32: ArrowType_Int32,
+        np.int16: ArrowType_Int16,
+        np.int8: ArrowType_Int8,
+        np.uint64: ArrowType_UInt64,
+        np.uint32: ArrowType_UInt32,
+        np.uint16: ArrowType_UInt16,
+        np.uint8: ArrowType_UInt8,
+    }
+
     # TraceLevel
     _TraceLevelOff = 0
     _TraceLevelError = 1
@@ -33,6 +91,7 @@ class Native:
     _TraceLevelVerbose = 4
 
     _native = None
+    _native_lock = threading.Lock()
     # if we supported win32 32-bit functions then this would need to be WINFUNCTYPE
     _LogFuncType = ct.CFUNCTYPE(None, ct.c_int32, ct.c_char_p)
 
@@ -43,10 +102,13 @@ class Native:
     @staticmethod
     def get_native_singleton(is_debug=False):
         if Native._native is None:
-            log.info("EBM lib loading.")
-            native = Native()
-            native._initialize(is_debug=is_debug)
-            Native._native = native
+            with Native._native_lock:
+                # another thread might have loaded the library while we waited for the lock
+                if Native._native is None:
+                    log.info("EBM lib loading.")
+                    native = Native()
+                    native._initialize(is_debug=is_debug)
+                    Native._native = native
         return Native._native
 
     @staticmethod
@@ -116,7 +178,14 @@ class Native:
         else:
             return 0
 
-    def set_logging(self, level=None):
+    def set_logging(self, level=None, is_buffered=False):
+        """ Sets the native trace level, and on first use, where native log messages go.
+
+        With is_buffered the native code keeps its messages in a lock-free ring buffer instead of
+        calling back into Python for each one, and drain_log_messages forwards them to Python logging.
+        The native library only accepts one log destination, so is_buffered only matters on the
+        first call that turns logging on.
+        """
         # NOTE: Not part of code coverage. It runs in tests, but isn't registered for some reason.
         def native_log(trace_level, message):  # pragma: no cover
             try:
@@ -155,13 +224,61 @@ class Native:
 
         trace_level = level_dict[level]
         if self._typed_log_func is None and trace_level != self._TraceLevelOff:
-            # it's critical that we put _LogFuncType(native_log) into 
-            # self._typed_log_func, otherwise it will be garbage collected
-            self._typed_log_func = self._LogFuncType(native_log)
+            if is_buffered:
+                self._typed_log_func = self._LogFuncType(ct.cast(self._unsafe.LogMessageToBuffer, ct.c_void_p).value)
+                self._is_log_buffered = True
+            else:
+                # it's critical that we put _LogFuncType(native_log) into 
+                # self._typed_log_func, otherwise it will be garbage collected
+                self._typed_log_func = self._LogFuncType(native_log)
             self._unsafe.SetLogMessageFunction(self._typed_log_func)
 
         self._unsafe.SetTraceLevel(trace_level)
 
+    def drain_log_messages(self):
+        """ Forwards the messages held in the native log buffer to Python logging.
+
+        Does nothing unless set_logging was called with is_buffered.
+        """
+        if not self._is_log_buffered:
+            return
+
+        trace_levels = np.empty(256, np.int32)
+        chars = ct.create_string_buffer(256 * 512)
+        count_messages = ct.c_int64(0)
+        count_dropped = ct.c_int64(0)
+        # the native buffer has a single reader
+        with self._drain_lock:
+            while True:
+                return_code = self._unsafe.DrainLogMessages(
+                    len(trace_levels),
+                    len(chars),
+                    Native._make_pointer(trace_levels, np.int32),
+                    chars,
+                    ct.byref(count_messages),
+                    ct.byref(count_dropped),
+                )
+                if return_code:  # pragma: no cover
+                    raise Native._get_native_exception(return_code, "DrainLogMessages")
+
+                if count_dropped.value != 0:
+                    log.warning(f"{count_dropped.value} native log messages were dropped because the log buffer was full")
+
+                messages = chars.raw.split(b"\0", count_messages.value)
+                for trace_level, message in zip(trace_levels[:count_messages.value], messages):
+                    message = message.decode("ascii", errors="replace")
+                    if trace_level == self._TraceLevelError:
+                        log.error(message)
+                    elif trace_level == self._TraceLevelWarning:
+                        log.warning(message)
+                    elif trace_level == self._TraceLevelInfo:
+                        log.info(message)
+                    elif trace_level == self._TraceLevelVerbose:
+                        log.debug(message)
+
+                if count_messages.value == 0:
+                    break
+
     def clean_float(self, val):
         # the EBM spec does not allow subnormal floats to be in the model definition, so flush them to zero
         val_array = np.array([val], np.float64)
@@ -305,6 +422,42 @@ class Native:
         )
         return cuts[:count_cuts]
 
+    def cut_features(self, cols, cut_methods, min_samples_bin, max_cuts, n_threads=0):
+        """ Cuts several features at once on native threads.
+
+        cols are C contiguous float64 arrays with the same number of samples, and cut_methods holds the
+        Native.CutMethod_* of each.  Each feature is cut exactly as cut_quantile, cut_uniform or
+        cut_winsorized would cut it.
+
+        Returns:
+            A list with the cuts of each feature
+        """
+
+        if max_cuts < 0:
+            raise Exception(f"max_cuts can't be negative: {max_cuts}.")
+
+        n_samples = len(cols[0]) if len(cols) != 0 else 0
+        pointers = np.fromiter((Native._make_pointer(col, np.float64) for col in cols), np.uintp, len(cols))
+        cut_methods = np.array(cut_methods, np.int64)
+        count_cuts = np.empty(len(cols), np.int64)
+        cuts = np.empty((len(cols), max_cuts), np.float64, order="C")
+
+        return_code = self._unsafe.CutFeatures(
+            len(cols),
+            n_samples,
+            Native._make_pointer(pointers, np.uintp),
+            Native._make_pointer(cut_methods, np.int64),
+            min_samples_bin,
+            max_cuts,
+            n_threads,
+            Native._make_pointer(count_cuts, np.int64),
+            Native._make_pointer(cuts, np.float64, 2),
+        )
+        if return_code:  # pragma: no cover
+            raise Native._get_native_exception(return_code, "CutFeatures")
+
+        return [feature_cuts[:n_cuts] for feature_cuts, n_cuts in zip(cuts, count_cuts)]
+
     def cut_winsorized(self, col_data, max_cuts):
         if max_cuts < 0:
             raise Exception(f"max_cuts can't be negative: {max_cuts}.")
@@ -366,6 +519,31 @@ class Native:
 
         return discretized
 
+    def discretize_arrow(self, values, validity, cuts):
+        """ Bins the values buffer of an Arrow numeric array in place, without converting it to float64 first.
+
+        values is a numpy view of the Arrow buffer, and validity is the Arrow validity bitmap as np.ubyte or None.
+
+        Returns:
+            The bin of each sample, with 0 for the nulls
+        """
+
+        arrow_type = Native._arrow_types[values.dtype.type]
+        discretized = np.empty(values.shape[0], dtype=np.int64, order="C")
+        return_code = self._unsafe.DiscretizeArrow(
+            values.shape[0],
+            arrow_type,
+            Native._make_pointer(values, values.dtype.type),
+            Native._make_pointer(validity, np.ubyte, 1, True),
+            cuts.shape[0],
+            Native._make_pointer(cuts, np.float64),
+            Native._make_pointer(discretized, np.int64),
+        )
+        if return_code:  # pragma: no cover
+            raise Native._get_native_exception(return_code, "DiscretizeArrow")
+
+        return discretized
+
 
     def size_dataset_header(self, n_features, n_weights, n_targets):
         n_bytes = self._unsafe.SizeDataSetHeader(n_features, n_weights, n_targets)
@@ -384,14 +562,16 @@ class Native:
         if return_code:  # pragma: no cover
             raise Native._get_native_exception(return_code, "FillDataSetHeader")
 
-    def size_feature(self, n_bins, missing, unknown, nominal, binned_data):
+    def size_feature(self, n_bins, missing, unknown, nominal, binned_data, n_samples=None):
+        # binned_data can be None, in which case the size is computed from n_samples alone.  Each sample
+        # takes the same space whatever its bin, so this is the exact size that fill_feature uses
         n_bytes = self._unsafe.SizeFeature(
             n_bins, 
             missing, 
             unknown, 
             nominal, 
-            len(binned_data), 
-            Native._make_pointer(binned_data, np.int64),
+            n_samples if binned_data is None else len(binned_data), 
+            Native._make_pointer(binned_data, np.int64, 1, True),
         )
         if n_bytes < 0:  # pragma: no cover
             raise Native._get_native_exception(n_bytes, "SizeFeature")
@@ -514,6 +694,416 @@ class Native:
 
         return class_counts
 
+    def compute_scores_from_dataset(self, dataset, intercept, term_scores, term_features, n_threads=0):
+        """ Sums the term tensors over the binned features already inside the native dataset.
+
+        The terms must use the same bins as the dataset, so this is for models straight out of boosting.
+        Returns scores for every sample in the dataset, including the ones excluded by a bag.
+        """
+
+        dataset = _dataset_view(dataset)
+
+        n_samples, _, _, n_targets = self.extract_dataset_header(dataset)
+        class_counts = self.extract_target_classes(dataset, n_targets)
+        n_scores = Native.get_count_scores_c(class_counts[0])
+
+        dimension_counts = np.empty(len(term_features), ct.c_int64)
+        feature_indexes = []
+        native_scores = []
+        for term_idx, feature_idxs in enumerate(term_features):
+            dimension_counts.itemset(term_idx, len(feature_idxs))
+            feature_indexes.extend(feature_idxs)
+
+            # python tensors have the first feature in the highest stride, but natively it is in the lowest stride
+            n_dimensions = len(feature_idxs)
+            temp_transpose = [*range(n_dimensions - 1, -1, -1)]
+            if n_scores > 1:
+                temp_transpose.append(n_dimensions)
+            native_scores.append(np.transpose(term_scores[term_idx], tuple(temp_transpose)).ravel())
+
+        feature_indexes = np.array(feature_indexes, ct.c_int64)
+        native_scores = np.concatenate(native_scores) if len(native_scores) != 0 else np.empty(0, np.float64)
+        native_scores = native_scores.astype(np.float64, copy=False)
+        intercept = np.ascontiguousarray(intercept, np.float64).ravel()
+
+        scores = np.empty(n_samples if n_scores == 1 else (n_samples, n_scores), np.float64, order="C")
+
+        return_code = self._unsafe.ComputeScoresFromDataSet(
+            Native._make_pointer(dataset, np.ubyte),
+            len(dimension_counts),
+            Native._make_pointer(dimension_counts, np.int64),
+            Native._make_pointer(feature_indexes, np.int64),
+            Native._make_pointer(native_scores, np.float64),
+            Native._make_pointer(intercept, np.float64),
+            n_threads,
+            Native._make_pointer(scores, np.float64, 1 if n_scores == 1 else 2),
+        )
+        if return_code:  # pragma: no cover
+            raise Native._get_native_exception(return_code, "ComputeScoresFromDataSet")
+
+        return scores
+
+
+    def compute_scores_and_contributions(self, n_samples, intercept, term_scores, term_binned, n_top_terms=0, is_contributions=True):
+        """ Sums the term tensors for data binned by eval_terms in a single native pass.
+
+        term_binned holds the list of binned dimensions for each term, in term order.  If n_top_terms is between
+        1 and the number of terms, only the largest n_top_terms contributions by absolute value are kept per sample.
+
+        Returns:
+            The scores, the contributions (or None), and the term index of each contribution when trimming (or None)
+        """
+
+        intercept = np.ascontiguousarray(intercept, np.float64).ravel()
+        n_scores = len(intercept)
+        n_terms = len(term_scores)
+        is_top_terms = 0 < n_top_terms and n_top_terms < n_terms
+        n_output_terms = n_top_terms if is_top_terms else n_terms
+
+        dimension_counts = np.empty(n_terms, ct.c_int64)
+        bin_counts = []
+        for term_idx, binned_data in enumerate(term_binned):
+            dimension_counts.itemset(term_idx, len(binned_data))
+            bin_counts.extend(term_scores[term_idx].shape[:len(binned_data)])
+        bin_counts = np.array(bin_counts, ct.c_int64)
+
+        binned = np.empty((len(bin_counts), n_samples), np.int64, order="C")
+        dimension_idx = 0
+        for binned_data in term_binned:
+            for dim_data in binned_data:
+                binned[dimension_idx, :] = dim_data
+                dimension_idx += 1
+
+        native_scores = [np.ascontiguousarray(scores, np.float64).ravel() for scores in term_scores]
+        native_scores = np.concatenate(native_scores) if len(native_scores) != 0 else np.empty(0, np.float64)
+
+        if n_scores == 1:
+            scores = np.empty(n_samples, np.float64, order="C")
+            contributions = np.empty((n_samples, n_output_terms), np.float64, order="C") if is_contributions else None
+        else:
+            scores = np.empty((n_samples, n_scores), np.float64, order="C")
+            contributions = np.empty((n_samples, n_output_terms, n_scores), np.float64, order="C") if is_contributions else None
+        term_indexes = np.empty((n_samples, n_output_terms), np.int64, order="C") if is_top_terms else None
+
+        return_code = self._unsafe.ComputeScoresAndContributions(
+            n_samples,
+            n_scores,
+            n_terms,
+            Native._make_pointer(dimension_counts, np.int64),
+            Native._make_pointer(bin_counts, np.int64),
+            Native._make_pointer(binned, np.int64, 2),
+            Native._make_pointer(native_scores, np.float64),
+            Native._make_pointer(intercept, np.float64),
+            n_output_terms if is_top_terms else 0,
+            Native._make_pointer(scores, np.float64, 1 if n_scores == 1 else 2),
+            Native._make_pointer(contributions, np.float64, 2 if n_scores == 1 else 3, True),
+            Native._make_pointer(term_indexes, np.int64, 2, True),
+        )
+        if return_code:  # pragma: no cover
+            raise Native._get_native_exception(return_code, "ComputeScoresAndContributions")
+
+        return scores, contributions, term_indexes
+
+    @staticmethod
+    def flatten_effect_terms(n_samples, term_scores, term_binned, term_features):
+        """ Packs the terms into the flat arrays that the per-feature effect functions take.
+
+        Callers that make several calls over the same terms, one per feature, can flatten once and
+        pass the result to each call.
+
+        Returns:
+            dimension_counts, bin_counts, dimension_features, binned and the concatenated term scores
+        """
+        dimension_counts = np.array([len(feature_idxs) for feature_idxs in term_features], ct.c_int64)
+        dimension_features = np.array([feature_idx for feature_idxs in term_features for feature_idx in feature_idxs], ct.c_int64)
+        bin_counts = []
+        for term_idx, feature_idxs in enumerate(term_features):
+            bin_counts.extend(term_scores[term_idx].shape[:len(feature_idxs)])
+        bin_counts = np.array(bin_counts, ct.c_int64)
+
+        binned = np.empty((len(bin_counts), n_samples), np.int64, order="C")
+        dimension_idx = 0
+        for binned_data in term_binned:
+            for dim_data in binned_data:
+                binned[dimension_idx, :] = dim_data
+                dimension_idx += 1
+
+        native_scores = [np.ascontiguousarray(scores, np.float64).ravel() for scores in term_scores]
+        native_scores = np.concatenate(native_scores) if len(native_scores) != 0 else np.empty(0, np.float64)
+
+        return dimension_counts, bin_counts, dimension_features, binned, native_scores
+
+    def compute_permuted_scores(self, sample_scores, effect_terms, feature_idx, permutation):
+        """ Rescores the samples as if feature_idx had been permuted, only looking up the terms that contain it.
+
+        sample_scores are the unaltered scores, and each sample takes the bins of sample permutation[i].
+        effect_terms is the result of flatten_effect_terms for the same samples.
+
+        Returns:
+            The permuted scores
+        """
+
+        sample_scores = np.ascontiguousarray(sample_scores, np.float64)
+        n_samples = sample_scores.shape[0]
+        n_scores = 1 if sample_scores.ndim == 1 else sample_scores.shape[1]
+        permutation = np.ascontiguousarray(permutation, np.int64)
+
+        dimension_counts, bin_counts, dimension_features, binned, native_scores = effect_terms
+
+        scores = np.empty(sample_scores.shape, np.float64, order="C")
+
+        return_code = self._unsafe.ComputePermutedScores(
+            n_samples,
+            n_scores,
+            len(dimension_counts),
+            Native._make_pointer(dimension_counts, np.int64),
+            Native._make_pointer(bin_counts, np.int64),
+            Native._make_pointer(dimension_features, np.int64),
+            Native._make_pointer(binned, np.int64, 2),
+            Native._make_pointer(native_scores, np.float64),
+            feature_idx,
+            Native._make_pointer(sample_scores, np.float64, sample_scores.ndim),
+            Native._make_pointer(permutation, np.int64),
+            Native._make_pointer(scores, np.float64, scores.ndim),
+        )
+        if return_code:  # pragma: no cover
+            raise Native._get_native_exception(return_code, "ComputePermutedScores")
+
+        return scores
+
+    def compute_partial_dependence(self, sample_scores, term_scores, term_binned, n_grid, grid_binned, term_features, feature_idx, sample_weight=None, is_ice=False):
+        """ Computes the partial dependence of feature_idx, only looking up the terms that contain it.
+
+        grid_binned holds the n_grid binned grid points for each term in the same layout as term_binned, or None
+        for the terms without feature_idx.  Only the dimensions of feature_idx are read.
+
+        Returns:
+            The partial dependence and its standard deviation at each grid point, and the ICE lines (or None)
+        """
+
+        sample_scores = np.ascontiguousarray(sample_scores, np.float64)
+        n_samples = sample_scores.shape[0]
+        n_scores = 1 if sample_scores.ndim == 1 else sample_scores.shape[1]
+        if sample_weight is not None:
+            sample_weight = np.ascontiguousarray(sample_weight, np.float64)
+
+        dimension_counts, bin_counts, dimension_features, binned, native_scores = Native.flatten_effect_terms(
+            n_samples, term_scores, term_binned, term_features
+        )
+
+        grid = np.zeros((len(bin_counts), n_grid), np.int64, order="C")
+        dimension_idx = 0
+        for feature_idxs, binned_data in zip(term_features, grid_binned):
+            if binned_data is not None:
+                for dim_idx, dim_data in enumerate(binned_data):
+                    grid[dimension_idx + dim_idx, :] = dim_data
+            dimension_idx += len(feature_idxs)
+
+        shape = (n_grid,) if n_scores == 1 else (n_grid, n_scores)
+        partial_dependence = np.empty(shape, np.float64, order="C")
+        stddev = np.empty(shape, np.float64, order="C")
+        ice = np.empty((n_samples,) + shape, np.float64, order="C") if is_ice else None
+
+        return_code = self._unsafe.ComputePartialDependence(
+            n_samples,
+            n_scores,
+            len(term_features),
+            Native._make_pointer(dimension_counts, np.int64),
+            Native._make_pointer(bin_counts, np.int64),
+            Native._make_pointer(dimension_features, np.int64),
+            Native._make_pointer(binned, np.int64, 2),
+            Native._make_pointer(native_scores, np.float64),
+            feature_idx,
+            Native._make_pointer(sample_scores, np.float64, sample_scores.ndim),
+            n_grid,
+            Native._make_pointer(grid, np.int64, 2),
+            Native._make_pointer(sample_weight, np.float64, 1, True),
+            Native._make_pointer(partial_dependence, np.float64, partial_dependence.ndim),
+            Native._make_pointer(stddev, np.float64, stddev.ndim),
+            Native._make_pointer(ice, np.float64, len(shape) + 1, True),
+        )
+        if return_code:  # pragma: no cover
+            raise Native._get_native_exception(return_code, "ComputePartialDependence")
+
+        return partial_dependence, stddev, ice
+
+    def compute_shapley_values(self, n_samples, n_features, term_scores, term_binned, term_features, bin_weights=None, intercept=None, n_threads=0):
+        """ Computes the exact Shapley values of each sample, with the bin weights as the background distribution.
+
+        Each term is shared only between its own features, so pairs and higher order terms are exact without
+        sampling.  If bin_weights is None every bin is equally likely.
+
+        Returns:
+            The expected value and the (sample, feature) or (sample, feature, score) Shapley values
+        """
+
+        n_scores = 1
+        if len(term_features) != 0 and len(term_features[0]) < term_scores[0].ndim:
+            n_scores = term_scores[0].shape[-1]
+
+        dimension_counts, bin_counts, dimension_features, binned, native_scores = Native.flatten_effect_terms(
+            n_samples, term_scores, term_binned, term_features
+        )
+
+        native_weights = None
+        if bin_weights is not None:
+            native_weights = [np.ascontiguousarray(weights, np.float64).ravel() for weights in bin_weights]
+            native_weights = np.concatenate(native_weights) if len(native_weights) != 0 else np.empty(0, np.float64)
+
+        if intercept is not None:
+            intercept = np.ascontiguousarray(intercept, np.float64).reshape(n_scores)
+
+        expected_value = np.empty(n_scores, np.float64, order="C")
+        shape = (n_samples, n_features) if n_scores == 1 else (n_samples, n_features, n_scores)
+        shapley = np.empty(shape, np.float64, order="C")
+
+        return_code = self._unsafe.ComputeShapleyValues(
+            n_samples,
+            n_scores,
+            n_features,
+            len(term_features),
+            Native._make_pointer(dimension_counts, np.int64),
+            Native._make_pointer(bin_counts, np.int64),
+            Native._make_pointer(dimension_features, np.int64),
+            Native._make_pointer(binned, np.int64, 2),
+            Native._make_pointer(native_scores, np.float64),
+            Native._make_pointer(native_weights, np.float64, 1, True),
+            Native._make_pointer(intercept, np.float64, 1, True),
+            n_threads,
+            Native._make_pointer(expected_value, np.float64),
+            Native._make_pointer(shapley, np.float64, shapley.ndim),
+        )
+        if return_code:  # pragma: no cover
+            raise Native._get_native_exception(return_code, "ComputeShapleyValues")
+
+        return (expected_value[0] if n_scores == 1 else expected_value), shapley
+
+    def aggregate_bagged_term_scores(self, bagged_scores, bag_weights, bin_weights, centering_weight, intercept):
+        """ Combines the outer bag tensors of one term in a single native pass.
+
+        Missing/unknown bins with zero weight are zeroed in every bag of bagged_scores.  If centering_weight
+        is not zero, the bin_weights weighted sum of the mean divided by centering_weight is moved from the
+        mean into intercept, which is updated in place.
+
+        Returns:
+            The zeroed bagged_scores, and the mean and standard deviation tensors
+        """
+
+        bagged_scores = np.ascontiguousarray(bagged_scores, np.float64)
+        bag_weights = np.ascontiguousarray(bag_weights, np.float64)
+        bin_weights = np.ascontiguousarray(bin_weights, np.float64)
+
+        bin_counts = np.array(bin_weights.shape, ct.c_int64)
+        n_scores = 1 if bagged_scores.ndim == bin_weights.ndim + 1 else bagged_scores.shape[-1]
+
+        mean = np.empty(bagged_scores.shape[1:], np.float64, order="C")
+        stddev = np.empty(bagged_scores.shape[1:], np.float64, order="C")
+
+        return_code = self._unsafe.AggregateBaggedTermScores(
+            bagged_scores.shape[0],
+            Native._make_pointer(bag_weights, np.float64),
+            len(bin_counts),
+            Native._make_pointer(bin_counts, np.int64),
+            n_scores,
+            Native._make_pointer(bin_weights, np.float64, bin_weights.ndim),
+            centering_weight,
+            Native._make_pointer(bagged_scores, np.float64, bagged_scores.ndim),
+            Native._make_pointer(mean, np.float64, mean.ndim),
+            Native._make_pointer(stddev, np.float64, stddev.ndim),
+            Native._make_pointer(intercept, np.float64),
+        )
+        if return_code:  # pragma: no cover
+            raise Native._get_native_exception(return_code, "AggregateBaggedTermScores")
+
+        return bagged_scores, mean, stddev
+
+    def harmonize_cuts(self, old_cuts, old_min, old_max, new_cuts, new_min, new_max):
+        """ Maps the bins of new_cuts onto the bins of old_cuts with a single merge of the sorted cuts.
+
+        Returns:
+            The old bin of each new bin, including the missing (0) and unknown (-1) bins, and the
+            fraction of the old bin's range that each new bin covers
+        """
+
+        old_cuts = np.ascontiguousarray(old_cuts, np.float64)
+        new_cuts = np.ascontiguousarray(new_cuts, np.float64)
+
+        lookup = np.empty(len(new_cuts) + 3, np.int64, order="C")
+        percentages = np.empty(len(new_cuts) + 3, np.float64, order="C")
+
+        return_code = self._unsafe.HarmonizeCuts(
+            len(old_cuts),
+            Native._make_pointer(old_cuts, np.float64),
+            old_min,
+            old_max,
+            len(new_cuts),
+            Native._make_pointer(new_cuts, np.float64),
+            new_min,
+            new_max,
+            Native._make_pointer(lookup, np.int64),
+            Native._make_pointer(percentages, np.float64),
+        )
+        if return_code:  # pragma: no cover
+            raise Native._get_native_exception(return_code, "HarmonizeCuts")
+
+        return lookup, percentages
+
+    def harmonize_tensors(self, old_tensors, old_bins, percentages, old_weights=None, n_threads=0):
+        """ Rebins a stack of tensors that share the same layout, like the outer bags of one term.
+
+        old_bins holds, for each dimension, a list with one tuple of old bins per new bin, and percentages holds
+        the matching fraction of each new bin.  If old_weights is None the tensors hold weights, which are summed
+        and scaled by the fractions, otherwise they hold scores, which are averaged using old_weights.
+
+        Returns:
+            The stack of harmonized tensors
+        """
+
+        old_tensors = np.ascontiguousarray(old_tensors, np.float64)
+        n_dimensions = len(old_bins)
+        old_shape = old_tensors.shape[1:1 + n_dimensions]
+        new_shape = tuple(len(dimension_bins) for dimension_bins in old_bins)
+        n_scores = 1 if old_tensors.ndim == n_dimensions + 1 else old_tensors.shape[-1]
+
+        old_bin_counts = np.array(old_shape, ct.c_int64)
+        new_bin_counts = np.array(new_shape, ct.c_int64)
+
+        offsets = []
+        flat_bins = []
+        for dimension_bins in old_bins:
+            for bins in dimension_bins:
+                offsets.append(len(flat_bins))
+                flat_bins.extend(bins)
+            offsets.append(len(flat_bins))
+        offsets = np.array(offsets, ct.c_int64)
+        flat_bins = np.array(flat_bins, ct.c_int64)
+        percentages = np.concatenate([np.asarray(x, np.float64) for x in percentages]) if n_dimensions != 0 else np.empty(0, np.float64)
+
+        if old_weights is not None:
+            old_weights = np.ascontiguousarray(old_weights, np.float64)
+
+        new_tensors = np.empty((old_tensors.shape[0],) + new_shape + old_tensors.shape[1 + n_dimensions:], np.float64, order="C")
+
+        return_code = self._unsafe.HarmonizeTensors(
+            old_tensors.shape[0],
+            n_dimensions,
+            Native._make_pointer(old_bin_counts, np.int64),
+            Native._make_pointer(new_bin_counts, np.int64),
+            len(flat_bins),
+            Native._make_pointer(offsets, np.int64),
+            Native._make_pointer(flat_bins, np.int64),
+            Native._make_pointer(percentages, np.float64),
+            n_scores,
+            Native._make_pointer(old_tensors, np.float64, old_tensors.ndim),
+            Native._make_pointer(old_weights, np.float64, old_weights.ndim if old_weights is not None else 1, True),
+            n_threads,
+            Native._make_pointer(new_tensors, np.float64, new_tensors.ndim),
+        )
+        if return_code:  # pragma: no cover
+            raise Native._get_native_exception(return_code, "HarmonizeTensors")
+
+        return new_tensors
+
 
     @staticmethod
     def _get_ebm_lib_path(debug=False):
@@ -557,6 +1147,8 @@ class Native:
         self.is_debug = is_debug
 
         self._typed_log_func = None
+        self._is_log_buffered = False
+        self._drain_lock = threading.Lock()
         self._unsafe = ct.cdll.LoadLibrary(Native._get_ebm_lib_path(debug=is_debug))
 
         self._unsafe.SetLogMessageFunction.argtypes = [
@@ -571,6 +1163,22 @@ class Native:
         ]
         self._unsafe.SetTraceLevel.restype = None
 
+        self._unsafe.DrainLogMessages.argtypes = [
+            # int64_t countMessagesMax
+            ct.c_int64,
+            # int64_t countCharsMax
+            ct.c_int64,
+            # int32_t * traceLevelsOut
+            ct.c_void_p,
+            # char * charsOut
+            ct.c_void_p,
+            # int64_t * countMessagesOut
+            ct.POINTER(ct.c_int64),
+            # int64_t * countDroppedOut
+            ct.POINTER(ct.c_int64),
+        ]
+        self._unsafe.DrainLogMessages.restype = ct.c_int32
+
         self._unsafe.CleanFloats.argtypes = [
             # int64_t count
             ct.c_int64,
@@ -687,6 +1295,28 @@ class Native:
         ]
         self._unsafe.CutWinsorized.restype = ct.c_int32
 
+        self._unsafe.CutFeatures.argtypes = [
+            # int64_t countFeatures
+            ct.c_int64,
+            # int64_t countSamples
+            ct.c_int64,
+            # double ** featureValues
+            ct.c_void_p,
+            # int64_t * cutMethods
+            ct.c_void_p,
+            # int64_t countSamplesPerBinMin
+            ct.c_int64,
+            # int64_t countCutsMax
+            ct.c_int64,
+            # int64_t countThreads
+            ct.c_int64,
+            # int64_t * countCutsOut
+            ct.c_void_p,
+            # double * cutsLowerBoundInclusiveOut
+            ct.c_void_p,
+        ]
+        self._unsafe.CutFeatures.restype = ct.c_int32
+
 
         self._unsafe.SuggestGraphBounds.argtypes = [
             # int64_t countCuts
@@ -721,6 +1351,24 @@ class Native:
         ]
         self._unsafe.Discretize.restype = ct.c_int32
 
+        self._unsafe.DiscretizeArrow.argtypes = [
+            # int64_t countSamples
+            ct.c_int64,
+            # int64_t arrowType
+            ct.c_int64,
+            # void * values
+            ct.c_void_p,
+            # uint8_t * validityBitmap
+            ct.c_void_p,
+            # int64_t countCuts
+            ct.c_int64,
+            # double * cutsLowerBoundInclusive
+            ct.c_void_p,
+            # int64_t * discretizedOut
+            ct.c_void_p,
+        ]
+        self._unsafe.DiscretizeArrow.restype = ct.c_int32
+
 
         self._unsafe.SizeDataSetHeader.argtypes = [
             # int64_t countFeatures
@@ -880,80 +1528,376 @@ class Native:
         ]
         self._unsafe.ExtractTargetClasses.restype = ct.c_int32
 
-
-        self._unsafe.CreateBooster.argtypes = [
-            # int32_t randomSeed
-            ct.c_int32,
+        self._unsafe.ComputeScoresFromDataSet.argtypes = [
             # void * dataSet
             ct.c_void_p,
-            # int8_t * bag
-            ct.c_void_p,
-            # double * initScores
-            ct.c_void_p,
             # int64_t countTerms
             ct.c_int64,
             # int64_t * dimensionCounts
             ct.c_void_p,
             # int64_t * featureIndexes
             ct.c_void_p,
-            # int64_t countInnerBags
+            # double * termScores
+            ct.c_void_p,
+            # double * intercept
+            ct.c_void_p,
+            # int64_t countThreads
             ct.c_int64,
-            # double * optionalTempParams
+            # double * scoresOut
             ct.c_void_p,
-            # BoosterHandle * boosterHandleOut
-            ct.POINTER(ct.c_void_p),
         ]
-        self._unsafe.CreateBooster.restype = ct.c_int32
+        self._unsafe.ComputeScoresFromDataSet.restype = ct.c_int32
 
-        self._unsafe.GenerateTermUpdate.argtypes = [
-            # void * boosterHandle
-            ct.c_void_p,
-            # int64_t indexTerm
+        self._unsafe.ComputeScoresAndContributions.argtypes = [
+            # int64_t countSamples
             ct.c_int64,
-            # GenerateUpdateOptionsType options 
+            # int64_t countScores
             ct.c_int64,
-            # double learningRate
-            ct.c_double,
-            # int64_t countSamplesRequiredForChildSplitMin
+            # int64_t countTerms
             ct.c_int64,
-            # int64_t * leavesMax
+            # int64_t * dimensionCounts
             ct.c_void_p,
-            # double * avgGainOut
-            ct.POINTER(ct.c_double),
-        ]
-        self._unsafe.GenerateTermUpdate.restype = ct.c_int32
-
-        self._unsafe.GetTermUpdateSplits.argtypes = [
-            # void * boosterHandle
+            # int64_t * binCounts
             ct.c_void_p,
-            # int64_t indexDimension
+            # int64_t * binnedData
+            ct.c_void_p,
+            # double * termScores
+            ct.c_void_p,
+            # double * intercept
+            ct.c_void_p,
+            # int64_t countTopTerms
             ct.c_int64,
-            # int64_t * countSplitsInOut
-            ct.POINTER(ct.c_int64),
-            # int64_t * splitIndexesOut
+            # double * scoresOut
             ct.c_void_p,
-        ]
-        self._unsafe.GetTermUpdateSplits.restype = ct.c_int32
-
-        self._unsafe.GetTermUpdateExpanded.argtypes = [
-            # void * boosterHandle
+            # double * contributionsOut
             ct.c_void_p,
-            # double * updateScoresTensorOut
+            # int64_t * termIndexesOut
             ct.c_void_p,
         ]
-        self._unsafe.GetTermUpdateExpanded.restype = ct.c_int32
+        self._unsafe.ComputeScoresAndContributions.restype = ct.c_int32
 
-        self._unsafe.SetTermUpdateExpanded.argtypes = [
-            # void * boosterHandle
+        self._unsafe.AggregateBaggedTermScores.argtypes = [
+            # int64_t countBags
+            ct.c_int64,
+            # double * bagWeights
             ct.c_void_p,
-            # int64_t indexTerm
+            # int64_t countDimensions
             ct.c_int64,
-            # double * updateScoresTensor
+            # int64_t * binCounts
+            ct.c_void_p,
+            # int64_t countScores
+            ct.c_int64,
+            # double * binWeights
+            ct.c_void_p,
+            # double centeringWeight
+            ct.c_double,
+            # double * bagScores
+            ct.c_void_p,
+            # double * meanOut
+            ct.c_void_p,
+            # double * stddevOut
+            ct.c_void_p,
+            # double * interceptInOut
             ct.c_void_p,
         ]
-        self._unsafe.SetTermUpdateExpanded.restype = ct.c_int32
+        self._unsafe.AggregateBaggedTermScores.restype = ct.c_int32
 
-        self._unsafe.ApplyTermUpdate.argtypes = [
+        self._unsafe.HarmonizeCuts.argtypes = [
+            # int64_t countOldCuts
+            ct.c_int64,
+            # double * oldCuts
+            ct.c_void_p,
+            # double oldMin
+            ct.c_double,
+            # double oldMax
+            ct.c_double,
+            # int64_t countNewCuts
+            ct.c_int64,
+            # double * newCuts
+            ct.c_void_p,
+            # double newMin
+            ct.c_double,
+            # double newMax
+            ct.c_double,
+            # int64_t * lookupOut
+            ct.c_void_p,
+            # double * percentagesOut
+            ct.c_void_p,
+        ]
+        self._unsafe.HarmonizeCuts.restype = ct.c_int32
+
+        self._unsafe.HarmonizeTensors.argtypes = [
+            # int64_t countTensors
+            ct.c_int64,
+            # int64_t countDimensions
+            ct.c_int64,
+            # int64_t * oldBinCounts
+            ct.c_void_p,
+            # int64_t * newBinCounts
+            ct.c_void_p,
+            # int64_t countOldBins
+            ct.c_int64,
+            # int64_t * oldBinOffsets
+            ct.c_void_p,
+            # int64_t * oldBins
+            ct.c_void_p,
+            # double * percentages
+            ct.c_void_p,
+            # int64_t countScores
+            ct.c_int64,
+            # double * oldTensors
+            ct.c_void_p,
+            # double * oldWeights
+            ct.c_void_p,
+            # int64_t countThreads
+            ct.c_int64,
+            # double * newTensorsOut
+            ct.c_void_p,
+        ]
+        self._unsafe.HarmonizeTensors.restype = ct.c_int32
+
+        self._unsafe.ComputePermutedScores.argtypes = [
+            # int64_t countSamples
+            ct.c_int64,
+            # int64_t countScores
+            ct.c_int64,
+            # int64_t countTerms
+            ct.c_int64,
+            # int64_t * dimensionCounts
+            ct.c_void_p,
+            # int64_t * binCounts
+            ct.c_void_p,
+            # int64_t * dimensionFeatures
+            ct.c_void_p,
+            # int64_t * binnedData
+            ct.c_void_p,
+            # double * termScores
+            ct.c_void_p,
+            # int64_t feature
+            ct.c_int64,
+            # double * sampleScores
+            ct.c_void_p,
+            # int64_t * permutation
+            ct.c_void_p,
+            # double * scoresOut
+            ct.c_void_p,
+        ]
+        self._unsafe.ComputePermutedScores.restype = ct.c_int32
+
+        self._unsafe.ComputePartialDependence.argtypes = [
+            # int64_t countSamples
+            ct.c_int64,
+            # int64_t countScores
+            ct.c_int64,
+            # int64_t countTerms
+            ct.c_int64,
+            # int64_t * dimensionCounts
+            ct.c_void_p,
+            # int64_t * binCounts
+            ct.c_void_p,
+            # int64_t * dimensionFeatures
+            ct.c_void_p,
+            # int64_t * binnedData
+            ct.c_void_p,
+            # double * termScores
+            ct.c_void_p,
+            # int64_t feature
+            ct.c_int64,
+            # double * sampleScores
+            ct.c_void_p,
+            # int64_t countGridPoints
+            ct.c_int64,
+            # int64_t * gridBinnedData
+            ct.c_void_p,
+            # double * sampleWeights
+            ct.c_void_p,
+            # double * partialDependenceOut
+            ct.c_void_p,
+            # double * stddevOut
+            ct.c_void_p,
+            # double * iceOut
+            ct.c_void_p,
+        ]
+        self._unsafe.ComputePartialDependence.restype = ct.c_int32
+
+        self._unsafe.ComputeShapleyValues.argtypes = [
+            # int64_t countSamples
+            ct.c_int64,
+            # int64_t countScores
+            ct.c_int64,
+            # int64_t countFeatures
+            ct.c_int64,
+            # int64_t countTerms
+            ct.c_int64,
+            # int64_t * dimensionCounts
+            ct.c_void_p,
+            # int64_t * binCounts
+            ct.c_void_p,
+            # int64_t * dimensionFeatures
+            ct.c_void_p,
+            # int64_t * binnedData
+            ct.c_void_p,
+            # double * termScores
+            ct.c_void_p,
+            # double * binWeights
+            ct.c_void_p,
+            # double * intercept
+            ct.c_void_p,
+            # int64_t countThreads
+            ct.c_int64,
+            # double * expectedValueOut
+            ct.c_void_p,
+            # double * shapleyOut
+            ct.c_void_p,
+        ]
+        self._unsafe.ComputeShapleyValues.restype = ct.c_int32
+
+        self._unsafe.CreateCategoricalEncoder.argtypes = [
+            # int64_t countCategories
+            ct.c_int64,
+            # int64_t * categoryOffsets
+            ct.c_void_p,
+            # char * categoryChars
+            ct.c_void_p,
+            # int64_t * categoryBins
+            ct.c_void_p,
+            # void * categoricalEncoderHandleOut
+            ct.c_void_p,
+        ]
+        self._unsafe.CreateCategoricalEncoder.restype = ct.c_int32
+
+        self._unsafe.EncodeCategorical.argtypes = [
+            # void * categoricalEncoderHandle
+            ct.c_void_p,
+            # int64_t countSamples
+            ct.c_int64,
+            # int64_t * offsets
+            ct.c_void_p,
+            # char * chars
+            ct.c_void_p,
+            # uint8_t * validityBitmap
+            ct.c_void_p,
+            # int64_t * binnedOut
+            ct.c_void_p,
+            # int64_t * countUnknownsOut
+            ct.c_void_p,
+        ]
+        self._unsafe.EncodeCategorical.restype = ct.c_int32
+
+        self._unsafe.EncodeCategoricalDictionary.argtypes = [
+            # void * categoricalEncoderHandle
+            ct.c_void_p,
+            # int64_t countDictionary
+            ct.c_int64,
+            # int64_t * dictionaryOffsets
+            ct.c_void_p,
+            # char * dictionaryChars
+            ct.c_void_p,
+            # int64_t countSamples
+            ct.c_int64,
+            # int64_t indexBytes
+            ct.c_int64,
+            # void * indexes
+            ct.c_void_p,
+            # uint8_t * validityBitmap
+            ct.c_void_p,
+            # int64_t * binnedOut
+            ct.c_void_p,
+            # int64_t * countUnknownsOut
+            ct.c_void_p,
+        ]
+        self._unsafe.EncodeCategoricalDictionary.restype = ct.c_int32
+
+        self._unsafe.FreeCategoricalEncoder.argtypes = [
+            # void * categoricalEncoderHandle
+            ct.c_void_p
+        ]
+        self._unsafe.FreeCategoricalEncoder.restype = None
+
+
+        self._unsafe.CreateBooster.argtypes = [
+            # int32_t randomSeed
+            ct.c_int32,
+            # void * dataSet
+            ct.c_void_p,
+            # int8_t * bag
+            ct.c_void_p,
+            # double * initScores
+            ct.c_void_p,
+            # int64_t countTerms
+            ct.c_int64,
+            # int64_t * dimensionCounts
+            ct.c_void_p,
+            # int64_t * featureIndexes
+            ct.c_void_p,
+            # int64_t countInnerBags
+            ct.c_int64,
+            # int64_t flags
+            ct.c_int64,
+            # double * optionalTempParams
+            ct.c_void_p,
+            # BoosterHandle * boosterHandleOut
+            ct.POINTER(ct.c_void_p),
+        ]
+        self._unsafe.CreateBooster.restype = ct.c_int32
+
+        self._unsafe.CreateBoosterView.argtypes = [
+            # void * boosterHandle
+            ct.c_void_p,
+            # BoosterHandle * boosterHandleViewOut
+            ct.POINTER(ct.c_void_p),
+        ]
+        self._unsafe.CreateBoosterView.restype = ct.c_int32
+
+        self._unsafe.GenerateTermUpdate.argtypes = [
+            # void * boosterHandle
+            ct.c_void_p,
+            # int64_t indexTerm
+            ct.c_int64,
+            # GenerateUpdateOptionsType options 
+            ct.c_int64,
+            # double learningRate
+            ct.c_double,
+            # int64_t countSamplesRequiredForChildSplitMin
+            ct.c_int64,
+            # int64_t * leavesMax
+            ct.c_void_p,
+            # double * avgGainOut
+            ct.POINTER(ct.c_double),
+        ]
+        self._unsafe.GenerateTermUpdate.restype = ct.c_int32
+
+        self._unsafe.GetTermUpdateSplits.argtypes = [
+            # void * boosterHandle
+            ct.c_void_p,
+            # int64_t indexDimension
+            ct.c_int64,
+            # int64_t * countSplitsInOut
+            ct.POINTER(ct.c_int64),
+            # int64_t * splitIndexesOut
+            ct.c_void_p,
+        ]
+        self._unsafe.GetTermUpdateSplits.restype = ct.c_int32
+
+        self._unsafe.GetTermUpdateExpanded.argtypes = [
+            # void * boosterHandle
+            ct.c_void_p,
+            # double * updateScoresTensorOut
+            ct.c_void_p,
+        ]
+        self._unsafe.GetTermUpdateExpanded.restype = ct.c_int32
+
+        self._unsafe.SetTermUpdateExpanded.argtypes = [
+            # void * boosterHandle
+            ct.c_void_p,
+            # int64_t indexTerm
+            ct.c_int64,
+            # double * updateScoresTensor
+            ct.c_void_p,
+        ]
+        self._unsafe.SetTermUpdateExpanded.restype = ct.c_int32
+
+        self._unsafe.ApplyTermUpdate.argtypes = [
             # void * boosterHandle
             ct.c_void_p,
             # double * validationMetricOut
@@ -961,6 +1905,16 @@ class Native:
         ]
         self._unsafe.ApplyTermUpdate.restype = ct.c_int32
 
+        self._unsafe.ApplyTermUpdates.argtypes = [
+            # int64_t countBoosterHandles
+            ct.c_int64,
+            # BoosterHandle * boosterHandles
+            ct.POINTER(ct.c_void_p),
+            # double * validationMetricOut
+            ct.POINTER(ct.c_double),
+        ]
+        self._unsafe.ApplyTermUpdates.restype = ct.c_int32
+
         self._unsafe.GetBestTermScores.argtypes = [
             # void * boosterHandle
             ct.c_void_p,
@@ -981,6 +1935,82 @@ class Native:
         ]
         self._unsafe.GetCurrentTermScores.restype = ct.c_int32
 
+        self._unsafe.SizeSerializedBooster.argtypes = [
+            # void * boosterHandle
+            ct.c_void_p,
+        ]
+        self._unsafe.SizeSerializedBooster.restype = ct.c_int64
+
+        self._unsafe.SerializeBooster.argtypes = [
+            # void * boosterHandle
+            ct.c_void_p,
+            # int64_t countBytesAllocated
+            ct.c_int64,
+            # void * fillMem
+            ct.c_void_p,
+        ]
+        self._unsafe.SerializeBooster.restype = ct.c_int32
+
+        self._unsafe.DeserializeBooster.argtypes = [
+            # void * boosterHandle
+            ct.c_void_p,
+            # int64_t countBytes
+            ct.c_int64,
+            # void * serialized
+            ct.c_void_p,
+        ]
+        self._unsafe.DeserializeBooster.restype = ct.c_int32
+
+        self._unsafe.GetBoosterPerfCounters.argtypes = [
+            # void * boosterHandle
+            ct.c_void_p,
+            # int64_t countPerfCounters
+            ct.c_int64,
+            # int64_t * callCountsOut
+            ct.c_void_p,
+            # double * secondsOut
+            ct.c_void_p,
+        ]
+        self._unsafe.GetBoosterPerfCounters.restype = ct.c_int32
+
+        self._unsafe.SetGradientSampling.argtypes = [
+            # void * boosterHandle
+            ct.c_void_p,
+            # double topRate
+            ct.c_double,
+            # double otherRate
+            ct.c_double,
+        ]
+        self._unsafe.SetGradientSampling.restype = ct.c_int32
+
+        self._unsafe.SetRowSubsampling.argtypes = [
+            # void * boosterHandle
+            ct.c_void_p,
+            # double rate
+            ct.c_double,
+        ]
+        self._unsafe.SetRowSubsampling.restype = ct.c_int32
+
+        self._unsafe.SetTermScheduling.argtypes = [
+            # void * boosterHandle
+            ct.c_void_p,
+            # double gainRelativeMin
+            ct.c_double,
+            # int64_t recheckRounds
+            ct.c_int64,
+        ]
+        self._unsafe.SetTermScheduling.restype = ct.c_int32
+
+        self._unsafe.ScheduleTerms.argtypes = [
+            # void * boosterHandle
+            ct.c_void_p,
+            # int64_t * countTermsOut
+            ct.POINTER(ct.c_int64),
+            # int64_t * termIndexesOut
+            ct.c_void_p,
+        ]
+        self._unsafe.ScheduleTerms.restype = ct.c_int32
+
         self._unsafe.FreeBooster.argtypes = [
             # void * boosterHandle
             ct.c_void_p
@@ -1018,12 +2048,213 @@ class Native:
         ]
         self._unsafe.CalcInteractionStrength.restype = ct.c_int32
 
+        self._unsafe.GetInteractionPerfCounters.argtypes = [
+            # void * interactionHandle
+            ct.c_void_p,
+            # int64_t countPerfCounters
+            ct.c_int64,
+            # int64_t * callCountsOut
+            ct.c_void_p,
+            # double * secondsOut
+            ct.c_void_p,
+        ]
+        self._unsafe.GetInteractionPerfCounters.restype = ct.c_int32
+
         self._unsafe.FreeInteractionDetector.argtypes = [
             # void * interactionHandle
             ct.c_void_p
         ]
         self._unsafe.FreeInteractionDetector.restype = None
 
+class SharedDataset:
+    """Binned native dataset allocated in a shared memory segment.
+
+    Pickling only transfers the segment name, so joblib workers attach to the
+    parent's memory instead of receiving a copy of the dataset.  The native 
+    CreateBooster and CreateInteractionDetector functions read the dataset 
+    in place, so attaching is zero-copy.  The process that created the segment 
+    owns it and must call close() after the workers are done.
+    """
+
+    def __init__(self, n_bytes):
+        self._shm = shared_memory.SharedMemory(create=True, size=max(1, n_bytes))
+        self._name = self._shm.name
+        self.nbytes = n_bytes
+        self._is_owner = True
+        self._pid = os.getpid()
+
+    def __getstate__(self):
+        return (self._name, self.nbytes, self._pid)
+
+    def __setstate__(self, state):
+        self._name, self.nbytes, self._pid = state
+        self._is_owner = False
+        try:
+            # python 3.13+ can skip the resource tracker for attached segments
+            self._shm = shared_memory.SharedMemory(name=self._name, track=False)
+        except TypeError:
+            self._shm = shared_memory.SharedMemory(name=self._name)
+            if os.name == 'posix' and self._pid != os.getpid():
+                # older versions register attached segments with the worker's resource tracker, 
+                # which would unlink the segment when the worker exits while the parent still uses it
+                from multiprocessing import resource_tracker
+                resource_tracker.unregister(self._shm._name, "shared_memory")
+
+    def view(self):
+        """ Returns an ndarray over the shared memory without copying.
+
+        Attached workers get a read-only view.  Do not hold onto the view 
+        past close() since it references the mapped memory.
+        """
+        dataset = np.ndarray((self.nbytes,), np.ubyte, buffer=self._shm.buf)
+        if not self._is_owner:
+            dataset.flags.writeable = False
+        return dataset
+
+    def close(self):
+        """ Unmaps the segment, and if this process created it, releases it. """
+        shm = getattr(self, "_shm", None)
+        if shm is not None:
+            self._shm = None
+            if self._is_owner:
+                shm.unlink()
+            try:
+                shm.close()
+            except BufferError:
+                # a view is still alive, so the mapping is released when the last view is collected
+                pass
+
+def _dataset_view(dataset):
+    if isinstance(dataset, SharedDataset):
+        return dataset.view()
+    return dataset
+
+def _utf8_buffers(strs):
+    # converts a numpy unicode array into the Arrow string layout: 
+    # one buffer of UTF-8 bytes and n + 1 offsets into it
+    encoded = np.char.encode(strs, "utf-8")
+    lengths = np.char.str_len(encoded).astype(np.int64, copy=False)
+    offsets = np.zeros(len(encoded) + 1, np.int64)
+    np.cumsum(lengths, out=offsets[1:])
+
+    width = encoded.dtype.itemsize
+    if width == 0 or len(encoded) == 0:
+        chars = np.empty(0, np.ubyte)
+    else:
+        # numpy pads the fixed width items with zeros, so drop the padding past each length
+        padded = np.ascontiguousarray(encoded).view(np.ubyte).reshape(len(encoded), width)
+        chars = np.ascontiguousarray(padded[np.arange(width) < lengths[:, np.newaxis]])
+    return offsets, chars
+
+class CategoricalEncoder(AbstractContextManager):
+    """Lightweight wrapper for the native hash map from category strings to bins.
+    """
+
+    def __init__(self, categories):
+
+        """ Initializes internal wrapper for the native categorical encoder.
+
+        Args:
+            categories: dict from category string to its bin index, which must be 1 or higher
+        """
+
+        self.categories = categories
+
+    def __enter__(self):
+        native = Native.get_native_singleton()
+
+        strs = np.array(list(self.categories.keys()), np.unicode_)
+        offsets, chars = _utf8_buffers(strs)
+        bins = np.fromiter(self.categories.values(), np.int64, len(self.categories))
+
+        categorical_encoder_handle = ct.c_void_p(0)
+        return_code = native._unsafe.CreateCategoricalEncoder(
+            len(bins),
+            Native._make_pointer(offsets, np.int64),
+            Native._make_pointer(chars, np.ubyte),
+            Native._make_pointer(bins, np.int64),
+            ct.byref(categorical_encoder_handle),
+        )
+        if return_code:  # pragma: no cover
+            raise Native._get_native_exception(return_code, "CreateCategoricalEncoder")
+
+        self._categorical_encoder_handle = categorical_encoder_handle.value
+        return self
+
+    def __exit__(self, *args):
+
+        self.close()
+
+    def close(self):
+
+        """ Deallocates the native categorical encoder. """
+
+        categorical_encoder_handle = getattr(self, "_categorical_encoder_handle", None)
+        if categorical_encoder_handle:
+            native = Native.get_native_singleton()
+            self._categorical_encoder_handle = None
+            native._unsafe.FreeCategoricalEncoder(categorical_encoder_handle)
+
+    def encode(self, strs):
+
+        """ Bins a numpy unicode array in a single pass.
+
+        Returns:
+            The bin of each string, with -1 for strings that were not in categories, and the count of those unknowns
+        """
+
+        native = Native.get_native_singleton()
+
+        offsets, chars = _utf8_buffers(strs)
+        encoded = np.empty(len(strs), np.int64)
+        count_unknowns = ct.c_int64(0)
+        return_code = native._unsafe.EncodeCategorical(
+            self._categorical_encoder_handle,
+            len(strs),
+            Native._make_pointer(offsets, np.int64),
+            Native._make_pointer(chars, np.ubyte),
+            None,
+            Native._make_pointer(encoded, np.int64),
+            ct.byref(count_unknowns),
+        )
+        if return_code:  # pragma: no cover
+            raise Native._get_native_exception(return_code, "EncodeCategorical")
+
+        return encoded, count_unknowns.value
+
+    def encode_dictionary(self, dictionary_offsets, dictionary_chars, indexes, validity):
+
+        """ Bins an Arrow dictionary encoded string column, hashing each dictionary string once.
+
+        dictionary_offsets and dictionary_chars hold the dictionary strings in the Arrow layout, indexes is a
+        numpy view of the signed integer index buffer and validity is the Arrow validity bitmap as np.ubyte or None.
+
+        Returns:
+            The bin of each sample, with 0 for nulls and -1 for strings that were not in categories, and the
+            count of samples with those unknowns
+        """
+
+        native = Native.get_native_singleton()
+
+        encoded = np.empty(len(indexes), np.int64)
+        count_unknowns = ct.c_int64(0)
+        return_code = native._unsafe.EncodeCategoricalDictionary(
+            self._categorical_encoder_handle,
+            len(dictionary_offsets) - 1,
+            Native._make_pointer(dictionary_offsets, np.int64),
+            Native._make_pointer(dictionary_chars, np.ubyte),
+            len(indexes),
+            indexes.dtype.itemsize,
+            Native._make_pointer(indexes, indexes.dtype.type),
+            Native._make_pointer(validity, np.ubyte, 1, True),
+            Native._make_pointer(encoded, np.int64),
+            ct.byref(count_unknowns),
+        )
+        if return_code:  # pragma: no cover
+            raise Native._get_native_exception(return_code, "EncodeCategoricalDictionary")
+
+        return encoded, count_unknowns.value
+
 class Booster(AbstractContextManager):
     """Lightweight wrapper for EBM C boosting code.
     """
@@ -1042,7 +2273,7 @@ class Booster(AbstractContextManager):
         """ Initializes internal wrapper for EBM C code.
 
         Args:
-            dataset: binned data in a compressed native form
+            dataset: binned data in a compressed native form, or a SharedDataset holding it
             bag: definition of what data is included. 1 = training, -1 = validation, 0 = not included
             init_scores: predictions from a prior predictor
                 that this class will boost on top of.  For regression
@@ -1077,7 +2308,10 @@ class Booster(AbstractContextManager):
 
         native = Native.get_native_singleton()
 
-        n_samples, n_features, n_weights, n_targets = native.extract_dataset_header(self.dataset)
+        # a SharedDataset is read in place from the shared memory without copying
+        dataset = _dataset_view(self.dataset)
+
+        n_samples, n_features, n_weights, n_targets = native.extract_dataset_header(dataset)
 
         if n_weights != 0 and n_weights != 1:  # pragma: no cover
             raise ValueError("n_weights must be 0 or 1")
@@ -1085,12 +2319,12 @@ class Booster(AbstractContextManager):
         if n_targets != 1:  # pragma: no cover
             raise ValueError("n_targets must be 1")
 
-        class_counts = native.extract_target_classes(self.dataset, n_targets)
+        class_counts = native.extract_target_classes(dataset, n_targets)
         n_class_scores = sum((Native.get_count_scores_c(n_classes) for n_classes in class_counts))
 
         self._term_shapes = None
         if 0 < n_class_scores:
-            bin_counts = native.extract_bin_counts(self.dataset, n_features)
+            bin_counts = native.extract_bin_counts(dataset, n_features)
             self._term_shapes = []
             for feature_idxs in self.term_features:
                 dimensions = [bin_counts[feature_idx] for feature_idx in feature_idxs]
@@ -1136,13 +2370,14 @@ class Booster(AbstractContextManager):
         booster_handle = ct.c_void_p(0)
         return_code = native._unsafe.CreateBooster(
             random_seed,
-            Native._make_pointer(self.dataset, np.ubyte),
+            Native._make_pointer(dataset, np.ubyte),
             Native._make_pointer(self.bag, np.int8, 1, True),
             Native._make_pointer(self.init_scores, np.float64, 2 if n_class_scores > 1 else 1, True),
             len(dimension_counts),
             Native._make_pointer(dimension_counts, np.int64),
             Native._make_pointer(feature_indexes, np.int64),
             self.n_inner_bags,
+            Native.CreateBoosterFlags_Default,
             Native._make_pointer(self.optional_temp_params, np.float64, 1, True),
             ct.byref(booster_handle),
         )
@@ -1168,9 +2403,58 @@ class Booster(AbstractContextManager):
             native = Native.get_native_singleton()
             self._booster_handle = None
             native._unsafe.FreeBooster(booster_handle)
+            native.drain_log_messages()
 
         log.info("Deallocation boosting end")
 
+    def set_gradient_sampling(self, top_rate, other_rate):
+        """ Makes each generate_term_update boost on the top_rate fraction of the samples with the
+        largest gradients plus other_rate times the sample count picked randomly from the rest.
+        Rates that add up to 0 or to 1 or more turn it off.
+        """
+        native = Native.get_native_singleton()
+        return_code = native._unsafe.SetGradientSampling(self._booster_handle, top_rate, other_rate)
+        if return_code:  # pragma: no cover
+            raise Native._get_native_exception(return_code, "SetGradientSampling")
+
+    def set_row_subsampling(self, rate):
+        """ Makes each generate_term_update boost on a new uniformly random rate fraction of the
+        samples, keeping their weights.  A rate of 0 or 1 turns it off, and gradient sampling takes
+        precedence when both are on.
+        """
+        native = Native.get_native_singleton()
+        return_code = native._unsafe.SetRowSubsampling(self._booster_handle, rate)
+        if return_code:  # pragma: no cover
+            raise Native._get_native_exception(return_code, "SetRowSubsampling")
+
+    def set_term_scheduling(self, gain_relative_min, recheck_rounds):
+        """ Makes schedule_terms leave out the terms whose recent gains have fallen below
+        gain_relative_min times the best term's, re-checking each of them every recheck_rounds rounds.
+        A gain_relative_min of 0 turns it off.
+        """
+        native = Native.get_native_singleton()
+        return_code = native._unsafe.SetTermScheduling(self._booster_handle, gain_relative_min, recheck_rounds)
+        if return_code:  # pragma: no cover
+            raise Native._get_native_exception(return_code, "SetTermScheduling")
+
+    def schedule_terms(self):
+        """ Starts a boosting round.
+
+        Returns:
+            The indexes of the terms to boost this round, in increasing order.
+        """
+        native = Native.get_native_singleton()
+        term_idxs = np.empty(len(self.term_features), np.int64)
+        count_terms = ct.c_int64(0)
+        return_code = native._unsafe.ScheduleTerms(
+            self._booster_handle,
+            ct.byref(count_terms),
+            Native._make_pointer(term_idxs, np.int64),
+        )
+        if return_code:  # pragma: no cover
+            raise Native._get_native_exception(return_code, "ScheduleTerms")
+        return term_idxs[:count_terms.value].tolist()
+
     def generate_term_update(
         self, 
         term_idx, 
@@ -1247,6 +2531,131 @@ class Booster(AbstractContextManager):
         # log.debug("Boosting step end")
         return metric_output.value
 
+    def create_view(self):
+        """ Creates another Booster that shares this one's boosting state but has its own pending
+        term update.  Several views can call generate_term_update concurrently on separate threads,
+        and then apply_term_updates applies all of their updates together.  Close each view when
+        finished with it.
+
+        Returns:
+            The view as a Booster.
+        """
+        native = Native.get_native_singleton()
+
+        view_handle = ct.c_void_p(0)
+        return_code = native._unsafe.CreateBoosterView(self._booster_handle, ct.byref(view_handle))
+        if return_code:  # pragma: no cover
+            raise Native._get_native_exception(return_code, "CreateBoosterView")
+
+        view = Booster(
+            self.dataset,
+            self.bag,
+            self.init_scores,
+            self.term_features,
+            self.n_inner_bags,
+            self.random_state,
+            self.optional_temp_params,
+        )
+        view._booster_handle = view_handle.value
+        return view
+
+    @staticmethod
+    def apply_term_updates(views):
+        """ Applies the pending term updates of several views of the same booster in two passes
+        over the samples, instead of one pass per update.  Each view must have a pending update
+        for a different term.
+
+        Args:
+            views: Boosters from create_view (the original Booster can be included)
+
+        Returns:
+            Validation loss after all of the updates.
+        """
+        native = Native.get_native_singleton()
+
+        for view in views:
+            view._term_idx = -1
+
+        handles = (ct.c_void_p * len(views))(*[view._booster_handle for view in views])
+        metric_output = ct.c_double(0.0)
+        return_code = native._unsafe.ApplyTermUpdates(
+            len(views),
+            handles,
+            ct.byref(metric_output),
+        )
+        if return_code:  # pragma: no cover
+            raise Native._get_native_exception(return_code, "ApplyTermUpdates")
+
+        return metric_output.value
+
+    def serialize(self):
+        """ Captures the mutable boosting state so that boosting can be resumed later.
+
+        The dataset, bag and terms are not included.  To resume, create a new Booster with
+        identical construction parameters and call deserialize on it.  The term schedule is
+        included when set_term_scheduling is on, and resuming it requires calling
+        set_term_scheduling with the same settings before deserialize.
+
+        Returns:
+            Snapshot of the boosting state as a numpy array of bytes.
+        """
+        native = Native.get_native_singleton()
+
+        n_bytes = native._unsafe.SizeSerializedBooster(self._booster_handle)
+        if n_bytes < 0:  # pragma: no cover
+            raise Native._get_native_exception(n_bytes, "SizeSerializedBooster")
+
+        serialized = np.empty(n_bytes, np.ubyte)
+        return_code = native._unsafe.SerializeBooster(
+            self._booster_handle, 
+            n_bytes, 
+            Native._make_pointer(serialized, np.ubyte),
+        )
+        if return_code:  # pragma: no cover
+            raise Native._get_native_exception(return_code, "SerializeBooster")
+
+        return serialized
+
+    def deserialize(self, serialized):
+        """ Restores the boosting state previously captured by serialize.
+
+        Args:
+            serialized: Snapshot returned from serialize on a Booster built from the same inputs
+        """
+        self._term_idx = -1
+
+        serialized = np.ascontiguousarray(serialized, np.ubyte)
+
+        native = Native.get_native_singleton()
+        return_code = native._unsafe.DeserializeBooster(
+            self._booster_handle, 
+            serialized.shape[0], 
+            Native._make_pointer(serialized, np.ubyte),
+        )
+        if return_code:  # pragma: no cover
+            raise Native._get_native_exception(return_code, "DeserializeBooster")
+
+    def get_perf_counters(self):
+        """ Returns the call counts and the accumulated seconds spent in each native phase.
+
+        Returns:
+            Tuple of (call_counts, seconds) arrays indexed by the Native.PerfCounter_* constants
+        """
+        call_counts = np.empty(Native.PerfCounter_Count, np.int64)
+        seconds = np.empty(Native.PerfCounter_Count, np.float64)
+
+        native = Native.get_native_singleton()
+        return_code = native._unsafe.GetBoosterPerfCounters(
+            self._booster_handle, 
+            Native.PerfCounter_Count, 
+            Native._make_pointer(call_counts, np.int64), 
+            Native._make_pointer(seconds, np.float64), 
+        )
+        if return_code:  # pragma: no cover
+            raise Native._get_native_exception(return_code, "GetBoosterPerfCounters")
+
+        return call_counts, seconds
+
     def get_best_model(self):
         model = []
         for term_idx in range(len(self.term_features)):
@@ -1455,7 +2864,7 @@ class InteractionDetector(AbstractContextManager):
         """ Initializes internal wrapper for EBM C code.
 
         Args:
-            dataset: binned data in a compressed native form
+            dataset: binned data in a compressed native form, or a SharedDataset holding it
             bag: definition of what data is included. 1 = training, -1 = validation, 0 = not included
             init_scores: predictions from a prior predictor
                 that this class will boost on top of.  For regression
@@ -1475,7 +2884,10 @@ class InteractionDetector(AbstractContextManager):
 
         native = Native.get_native_singleton()
 
-        n_samples, n_features, n_weights, n_targets = native.extract_dataset_header(self.dataset)
+        # a SharedDataset is read in place from the shared memory without copying
+        dataset = _dataset_view(self.dataset)
+
+        n_samples, n_features, n_weights, n_targets = native.extract_dataset_header(dataset)
 
         if n_weights != 0 and n_weights != 1:  # pragma: no cover
             raise ValueError("n_weights must be 0 or 1")
@@ -1483,7 +2895,7 @@ class InteractionDetector(AbstractContextManager):
         if n_targets != 1:  # pragma: no cover
             raise ValueError("n_targets must be 1")
 
-        class_counts = native.extract_target_classes(self.dataset, n_targets)
+        class_counts = native.extract_target_classes(dataset, n_targets)
         n_class_scores = sum((Native.get_count_scores_c(n_classes) for n_classes in class_counts))
 
         n_scores = n_samples
@@ -1503,7 +2915,7 @@ class InteractionDetector(AbstractContextManager):
         # Allocate external resources
         interaction_handle = ct.c_void_p(0)
         return_code = native._unsafe.CreateInteractionDetector(
-            Native._make_pointer(self.dataset, np.ubyte),
+            Native._make_pointer(dataset, np.ubyte),
             Native._make_pointer(self.bag, np.int8, 1, True),
             Native._make_pointer(self.init_scores, np.float64, 2 if n_class_scores > 1 else 1, True),
             Native._make_pointer(self.optional_temp_params, np.float64, 1, True),
@@ -1531,6 +2943,7 @@ class InteractionDetector(AbstractContextManager):
             native = Native.get_native_singleton()
             self._interaction_handle = None
             native._unsafe.FreeInteractionDetector(interaction_handle)
+            native.drain_log_messages()
         
         log.info("Deallocation interaction end")
 
@@ -1554,3 +2967,24 @@ class InteractionDetector(AbstractContextManager):
 
         log.info("Fast interaction strength end")
         return strength.value
+
+    def get_perf_counters(self):
+        """ Returns the call counts and the accumulated seconds spent in each native phase.
+
+        Returns:
+            Tuple of (call_counts, seconds) arrays indexed by the Native.PerfCounter_* constants
+        """
+        call_counts = np.empty(Native.PerfCounter_Count, np.int64)
+        seconds = np.empty(Native.PerfCounter_Count, np.float64)
+
+        native = Native.get_native_singleton()
+        return_code = native._unsafe.GetInteractionPerfCounters(
+            self._interaction_handle, 
+            Native.PerfCounter_Count, 
+            Native._make_pointer(call_counts, np.int64), 
+            Native._make_pointer(seconds, np.float64), 
+        )
+        if return_code:  # pragma: no cover
+            raise Native._get_native_exception(return_code, "GetInteractionPerfCounters")
+
+        return call_counts, seconds
@@ -12,6 +12,7 @@ from itertools import repeat, chain
 
 from ..bin import *
 from ..bin import _process_column_initial, _encode_categorical_existing, _process_continuous, _deduplicate_bins
+from ..internal import Native
 
 class StringHolder:
     def __init__(self, internal_str):
@@ -644,6 +645,13 @@ def test_encode_categorical_existing_obj_str():
     assert(bad is None)
     assert(np.array_equal(encoded, np.array([c["ab"], c["cd"]], dtype=np.int64)))
 
+def test_encode_categorical_existing_str_unknown():
+    c = {"cd": 1, "ab": 2, "\u00e9": 3}
+    nonmissings = np.array([True, False, True, True, True], dtype=np.bool_)
+    encoded, bad = _encode_categorical_existing(np.array(["ab", "zz", "\u00e9", "cd"], dtype=np.unicode_), nonmissings, c)
+    assert(np.array_equal(encoded, np.array([c["ab"], 0, -1, c["\u00e9"], c["cd"]], dtype=np.int64)))
+    assert(bad[0] is None and bad[1] is None and bad[2] == "zz" and bad[3] is None and bad[4] is None)
+
 def test_encode_categorical_existing_obj_bool():
     c = {"True": 1, "False": 2}
     encoded, bad = _encode_categorical_existing(np.array([True, False], dtype=np.object_), None, c)
@@ -2221,6 +2229,98 @@ def test_bin_native():
     )
     assert(shared_dataset is not None)
 
+def test_bin_native_shared():
+    import pickle
+
+    X = np.array([[1.5, 3, 0.5], [2.5, 4, 7], [1.5, 4, 8], [3.5, 3, 9]], dtype=np.float64)
+    y = np.array([0, 1, 1, 0], dtype=np.int64)
+
+    X, n_samples = clean_X(X)
+
+    feature_names_in, feature_types_in, bins, bin_weights, feature_bounds, histogram_counts, unique_val_counts, zero_val_counts = construct_bins(
+        X,
+        None,
+        None, 
+        None, 
+        [256]
+    )
+
+    dataset = bin_native_by_dimension(2, 1, bins, X, y, None, feature_names_in, feature_types_in)
+    shared_dataset = bin_native_by_dimension(2, 1, bins, X, y, None, feature_names_in, feature_types_in, True)
+    try:
+        assert(shared_dataset.nbytes == dataset.nbytes)
+        assert(np.array_equal(shared_dataset.view(), dataset))
+
+        # pickling transfers only the segment name, and the attached view is read-only
+        attached = pickle.loads(pickle.dumps(shared_dataset))
+        view = attached.view()
+        assert(not view.flags.writeable)
+        assert(np.array_equal(view, dataset))
+        del view
+        attached.close()
+    finally:
+        shared_dataset.close()
+
+def test_bin_native_by_dimensions():
+    X = np.array([["a", 1.5, 0.5], ["b", 2.5, 7], ["a", 2.5, 8], ["c", 3.5, 9], ["b", 0.5, 4]], dtype=np.object_)
+    y = np.array([0.5, 1.5, 2.5, 3.5, 4.5], dtype=np.float64)
+
+    X, n_samples = clean_X(X)
+
+    feature_names_in, feature_types_in, bins, bin_weights, feature_bounds, histogram_counts, unique_val_counts, zero_val_counts = construct_bins(
+        X,
+        None,
+        None, 
+        ['nominal', 'continuous', 'continuous'], 
+        [256, 3]
+    )
+
+    mains, pairs = bin_native_by_dimensions(-1, [1, 2], bins, X, y, None, feature_names_in, feature_types_in)
+
+    # one scan of X must produce the same bytes as building each level separately
+    assert(np.array_equal(mains, bin_native_by_dimension(-1, 1, bins, X, y, None, feature_names_in, feature_types_in)))
+    assert(np.array_equal(pairs, bin_native_by_dimension(-1, 2, bins, X, y, None, feature_names_in, feature_types_in)))
+
+def test_bin_native_by_dimensions_expected():
+    X = np.array([["a", 1.5, 0.5], ["b", 2.5, 7], ["a", 2.5, 8], ["c", 3.5, 9], ["b", 0.5, 4]], dtype=np.object_)
+    y = np.array([0.5, 1.5, 2.5, 3.5, 4.5], dtype=np.float64)
+    feature_names_in = ["f0", "f1", "f2"]
+    feature_types_in = ['nominal', 'continuous', 'continuous']
+
+    X, n_samples = clean_X(X)
+
+    # feature 1 has different cuts for pairs, and feature 2 shares its cuts between the levels
+    shared_cuts = np.array([5.0], dtype=np.float64)
+    bins = [
+        [{"a": 1, "b": 2, "c": 3}],
+        [np.array([1.0, 2.0, 3.0], dtype=np.float64), np.array([2.0], dtype=np.float64)],
+        [shared_cuts, shared_cuts],
+    ]
+
+    mains, pairs = bin_native_by_dimensions(-1, [1, 2], bins, X, y, None, feature_names_in, feature_types_in)
+
+    # build the datasets directly from bins worked out by hand.  Each item is (n_bins, nominal, binned)
+    def build_dataset(features):
+        native = Native.get_native_singleton()
+        n_bytes = native.size_dataset_header(len(features), 0, 1)
+        for n_bins, nominal, binned in features:
+            n_bytes += native.size_feature(n_bins, False, False, nominal, binned)
+        n_bytes += native.size_regression_target(y)
+        dataset = np.empty(n_bytes, np.ubyte)
+        native.fill_dataset_header(len(features), 0, 1, dataset)
+        for n_bins, nominal, binned in features:
+            native.fill_feature(n_bins, False, False, nominal, binned, dataset)
+        native.fill_regression_target(y, dataset)
+        return dataset
+
+    f0 = (4, True, np.array([1, 2, 1, 3, 2], dtype=np.int64))
+    f2 = (3, False, np.array([1, 2, 2, 2, 1], dtype=np.int64))
+    expected_mains = build_dataset([f0, (5, False, np.array([2, 3, 3, 4, 1], dtype=np.int64)), f2])
+    expected_pairs = build_dataset([f0, (3, False, np.array([1, 2, 2, 2, 1], dtype=np.int64)), f2])
+
+    assert(np.array_equal(mains, expected_mains))
+    assert(np.array_equal(pairs, expected_pairs))
+
 def test_eval_terms():
     X = np.array([["a", 1, np.nan], ["b", 2, 8], ["a", 2, 9], [None, 3, "BAD_CONTINUOUS"]], dtype=np.object_)
     feature_names_in = ["f1", "99", "f3"]
@@ -2324,3 +2424,48 @@ def test_deduplicate_bins():
     assert(id(bins[1][0]) != id(bins[1][1]))
     assert(id(bins[1][0]) == id(bins[1][2]))
     assert(id(bins[1][1]) != id(bins[1][2]))
+
+def test_eval_terms_arrow():
+    pa = pytest.importorskip("pyarrow")
+
+    feature_names_in = ["a", "b"]
+    feature_types_in = ["continuous", "nominal"]
+    bins = [[np.array([2.5, 4.5], dtype=np.float64)], [{"x": 1, "y": 2}]]
+    term_features = [(0,), (1,)]
+
+    numbers = pa.array([1, None, 3, 5, 2], type=pa.int32())
+    strings = pa.array(["y", "x", None, "z", "y"]).dictionary_encode()
+
+    X_arrow = pa.table({"a": numbers, "b": strings})
+    X_arrow, n_samples = clean_X(X_arrow)
+    X_numpy = {
+        "a": np.array([1, np.nan, 3, 5, 2], dtype=np.float64),
+        "b": np.array(["y", "x", None, "z", "y"], dtype=np.object_),
+    }
+
+    arrow_binned = dict(eval_terms(X_arrow, n_samples, feature_names_in, feature_types_in, bins, term_features))
+    numpy_binned = dict(eval_terms(X_numpy, n_samples, feature_names_in, feature_types_in, bins, term_features))
+
+    assert(np.array_equal(arrow_binned[0][0], np.array([1, 0, 2, 3, 1], dtype=np.int64)))
+    assert(np.array_equal(arrow_binned[0][0], numpy_binned[0][0]))
+    assert(np.array_equal(arrow_binned[1][0], np.array([2, 1, 0, -1, 2], dtype=np.int64)))
+    assert(np.array_equal(arrow_binned[1][0], numpy_binned[1][0]))
+
+def test_eval_terms_arrow_unsigned_dictionary_indexes():
+    pa = pytest.importorskip("pyarrow")
+
+    feature_names_in = ["b"]
+    feature_types_in = ["nominal"]
+    term_features = [(0,)]
+
+    # with 200 dictionary strings, a uint8 index of 199 would be negative if read as int8
+    dictionary = pa.array([f"s{i}" for i in range(200)])
+    bins = [[{"s0": 1, "s199": 2}]]
+    for index_type in [pa.uint8(), pa.uint16(), pa.uint32(), pa.uint64()]:
+        indexes = pa.array([199, 0, None, 5], type=index_type)
+        strings = pa.DictionaryArray.from_arrays(indexes, dictionary)
+
+        X_arrow, n_samples = clean_X(pa.table({"b": strings}))
+        arrow_binned = dict(eval_terms(X_arrow, n_samples, feature_names_in, feature_types_in, bins, term_features))
+
+        assert(np.array_equal(arrow_binned[0][0], np.array([2, 1, 0, -1], dtype=np.int64)))
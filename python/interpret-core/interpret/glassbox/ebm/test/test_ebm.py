@@ -436,6 +436,24 @@ def test_ebm_predict_and_contrib_regression():
     assert np.allclose(predictions_orig, explanations_sum)
 
 
+def test_ebm_predict_and_contrib_top_terms():
+    data = synthetic_regression()
+    X = data["full"]["X"]
+    y = data["full"]["y"]
+
+    clf = ExplainableBoostingRegressor(n_jobs=-2, interactions=0)
+    clf.fit(X, y)
+
+    _, explanations = clf.predict_and_contrib(X)
+    predictions, top_explanations, term_indexes = clf.predict_and_contrib(X, n_top_terms=2)
+
+    assert np.allclose(clf.predict(X), predictions)
+    assert top_explanations.shape == (len(X), 2)
+    assert np.array_equal(top_explanations, np.take_along_axis(explanations, term_indexes, axis=1))
+    assert np.all(np.abs(top_explanations[:, 0]) >= np.abs(top_explanations[:, 1]))
+    assert np.all(np.abs(top_explanations[:, 1]) >= np.sort(np.abs(explanations), axis=1)[:, -2])
+
+
 def test_ebm_sample_weight():
     data = adult_classification()
     X_train = data["train"]["X"][:, [0, 1]]
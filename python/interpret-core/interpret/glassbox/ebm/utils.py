@@ -20,49 +20,12 @@ from itertools import islice
 from scipy.stats import norm
 from scipy.optimize import root_scalar, brentq
 
-from .postprocessing import multiclass_postprocess2
-
 from itertools import count, chain
 
 import logging
 
 _log = logging.getLogger(__name__)
 
-def _zero_tensor(tensor, zero_low=None, zero_high=None):
-    entire_tensor = [slice(None) for _ in range(tensor.ndim)]
-    if zero_low is not None:
-        for dimension_idx, is_zero in enumerate(zero_low):
-            if is_zero:
-                dim_slices = entire_tensor.copy()
-                dim_slices[dimension_idx] = 0
-                tensor[tuple(dim_slices)] = 0
-    if zero_high is not None:
-        for dimension_idx, is_zero in enumerate(zero_high):
-            if is_zero:
-                dim_slices = entire_tensor.copy()
-                dim_slices[dimension_idx] = -1
-                tensor[tuple(dim_slices)] = 0
-
-def _restore_missing_value_zeros2(tensor, weights):
-    n_dimensions = weights.ndim
-    entire_tensor = [slice(None)] * n_dimensions
-    lower = []
-    higher = []
-    for dimension_idx in range(n_dimensions):
-        dim_slices = entire_tensor.copy()
-        dim_slices[dimension_idx] = 0
-        total_sum = np.sum(weights[tuple(dim_slices)])
-        lower.append(True if total_sum == 0 else False)
-        dim_slices[dimension_idx] = -1
-        total_sum = np.sum(weights[tuple(dim_slices)])
-        higher.append(True if total_sum == 0 else False)
-    _zero_tensor(tensor, lower, higher)
-
-def _weighted_std(a, axis, weights):
-    average = np.average(a, axis, weights)
-    variance = np.average((a - average)**2, axis, weights)
-    return np.sqrt(variance)
-
 def _convert_categorical_to_continuous(categories):
     # we do automagic detection of feature types by default, and sometimes a feature which
     # was really continuous might have most of it's data as one or two values.  An example would
@@ -202,48 +165,35 @@ def _create_proportional_tensor(axis_weights):
     return tensor.reshape(shape)
 
 def _process_terms(n_classes, n_samples, bagged_scores, bin_weights, bag_weights):
+    native = Native.get_native_singleton()
+
+    intercept = np.zeros(Native.get_count_scores_c(n_classes), np.float64)
+
     term_scores = []
     term_standard_deviations = []
     new_bagged_scores = []
     for score_tensors, weights in zip(bagged_scores, bin_weights):
         # if the missing/unknown bin has zero weight then whatever number was generated via boosting is 
-        # effectively meaningless and can be ignored. Set the value to zero for interpretability reasons 
-        tensor_bags = []
-        for tensor in score_tensors:
-            tensor_copy = tensor.copy()
-            _restore_missing_value_zeros2(tensor_copy, weights)
-            tensor_bags.append(tensor_copy)
-        score_tensors = np.array(tensor_bags, np.float64) # replace it to get stddev of 0 for weight of 0
-        new_bagged_scores.append(score_tensors)
+        # effectively meaningless and can be ignored. The native code sets these to zero in every bag, which gives 
+        # them a stddev of 0, and keeps them at zero after zero-centering the averaged scores into the intercept.
 
         # TODO PK: shouldn't we be zero centering each score tensor first before taking the standard deviation
         # It's possible to shift scores arbitary to the intercept, so we should be able to get any desired stddev
 
-        if (bag_weights == bag_weights[0]).all():
-            # if all the bags have the same total weight we can avoid some numeracy issues
-            # by using a non-weighted standard deviation
-            term_scores.append(np.average(score_tensors, axis=0))
-            term_standard_deviations.append(np.std(score_tensors, axis=0))
-        else:
-            term_scores.append(np.average(score_tensors, axis=0, weights=bag_weights))
-            term_standard_deviations.append(_weighted_std(score_tensors, axis=0, weights=bag_weights))
-
-    intercept = np.zeros(Native.get_count_scores_c(n_classes), np.float64)
-
-    if n_classes <= 2:
-        for scores, weights in zip(term_scores, bin_weights):
-            score_mean = np.average(scores, weights=weights)
-            scores -= score_mean
-
-            # Add mean center adjustment back to intercept
-            intercept += score_mean
-    else:
-        # Postprocess model graphs for multiclass
-        multiclass_postprocess2(n_classes, n_samples, term_scores, intercept, bin_weights)
-
-    for scores, weights in zip(term_scores, bin_weights):
-        # set these to zero again since zero-centering them causes the missing/unknown to shift away from zero
-        _restore_missing_value_zeros2(scores, weights)
+        # our multiclass implementation has always used the simpler method of taking the mean of the class 
+        # scores over all the samples, which we preserve here
+        centering_weight = float(np.sum(weights)) if n_classes <= 2 else float(n_samples)
+
+        score_tensors, scores, standard_deviations = native.aggregate_bagged_term_scores(
+            score_tensors, 
+            bag_weights, 
+            weights, 
+            centering_weight, 
+            intercept
+        )
+        new_bagged_scores.append(score_tensors)
+        term_scores.append(scores)
+        term_standard_deviations.append(standard_deviations)
 
     if n_classes < 0:
         # scikit-learn uses a float for regression, and a numpy array with 1 element for binary classification
@@ -318,7 +268,7 @@ def make_histogram_edges(min_val, max_val, histogram_counts):
 
     return np.concatenate(([min_val], cuts, [max_val]))
 
-def _harmonize_tensor(
+def _harmonize_tensors(
     new_feature_idxs, 
     new_bounds, 
     new_bins, 
@@ -326,7 +276,7 @@ def _harmonize_tensor(
     old_bounds, 
     old_bins, 
     old_mapping, 
-    old_tensor, 
+    old_tensors, 
     bin_evidence_weight
 ):
     # TODO: don't pass in new_bound and old_bounds.  We use the bounds to proportion
@@ -356,6 +306,11 @@ def _harmonize_tensor(
     # guaranteed that we only have new bin cuts for feature axies that we have inside
     # the bin level that we're handling!
 
+    # old_tensors is a stack of tensors that share the same layout, like the outer bags of one term, so
+    # that the whole stack is harmonized in one native call
+
+    native = Native.get_native_singleton()
+
     old_feature_idxs = list(old_feature_idxs)
 
     axes = []
@@ -364,26 +319,27 @@ def _harmonize_tensor(
         old_feature_idxs[old_idx] = -1 # in case we have duplicate feature idxs
         axes.append(old_idx)
 
-    if len(axes) != old_tensor.ndim:
+    if bin_evidence_weight is not None:
+        bin_evidence_weight = bin_evidence_weight.transpose(tuple(axes))
+
+    n_dimensions = len(axes)
+    axes = [0] + [x + 1 for x in axes]
+    if len(axes) != old_tensors.ndim:
         # multiclass. The last dimension always stays put
         axes.append(len(axes))
 
-    old_tensor = old_tensor.transpose(tuple(axes))
-    if bin_evidence_weight is not None:
-        bin_evidence_weight = bin_evidence_weight.transpose(tuple(axes))
+    old_tensors = old_tensors.transpose(tuple(axes))
 
-    mapping = []
-    lookups = []
+    old_bins_dimensions = []
     percentages = []
     for feature_idx in new_feature_idxs:
         old_bin_levels = old_bins[feature_idx]
-        old_feature_bins = old_bin_levels[min(len(old_bin_levels), len(old_feature_idxs)) - 1]
+        old_feature_bins = old_bin_levels[min(len(old_bin_levels), n_dimensions) - 1]
 
         mapping_levels = old_mapping[feature_idx]
-        old_feature_mapping = mapping_levels[min(len(mapping_levels), len(old_feature_idxs)) - 1]
+        old_feature_mapping = mapping_levels[min(len(mapping_levels), n_dimensions) - 1]
         if old_feature_mapping is None:
             old_feature_mapping = list((x,) for x in range(len(old_feature_bins) + (2 if isinstance(old_feature_bins, dict) else 3)))
-        mapping.append(old_feature_mapping)
 
         new_bin_levels = new_bins[feature_idx]
         new_feature_bins = new_bin_levels[min(len(new_bin_levels), len(new_feature_idxs)) - 1]
@@ -426,117 +382,20 @@ def _harmonize_tensor(
         else:
             # continuous feature
 
-            lookup = list(np.searchsorted(old_feature_bins, new_feature_bins, side='left') + 1)
-            lookup.append(len(old_feature_bins) + 1)
-
-            percentage = [1.0]
-            for new_idx_minus_one, old_idx in enumerate(lookup):
-                if new_idx_minus_one == 0:
-                    new_low = new_bounds[feature_idx, 0]
-                    # TODO: if nan OR out of bounds from the cuts, estimate it.  If -inf or +inf, change it to min/max for float
-                else:
-                    new_low = new_feature_bins[new_idx_minus_one - 1]
-
-                if len(new_feature_bins) <= new_idx_minus_one:
-                    new_high = new_bounds[feature_idx, 1]
-                    # TODO: if nan OR out of bounds from the cuts, estimate it.  If -inf or +inf, change it to min/max for float
-                else:
-                    new_high = new_feature_bins[new_idx_minus_one]
-
-
-                if old_idx == 1:
-                    old_low = old_bounds[feature_idx, 0]
-                    # TODO: if nan OR out of bounds from the cuts, estimate it.  If -inf or +inf, change it to min/max for float
-                else:
-                    old_low = old_feature_bins[old_idx - 2]
-
-                if len(old_feature_bins) < old_idx:
-                    old_high = old_bounds[feature_idx, 1]
-                    # TODO: if nan OR out of bounds from the cuts, estimate it.  If -inf or +inf, change it to min/max for float
-                else:
-                    old_high = old_feature_bins[old_idx - 1]
-
-                if old_high <= new_low or new_high <= old_low:
-                    # if there are bins in the area above where the old data extended, then 
-                    # we'll have zero contribution in the old data where these new bins are
-                    # located
-                    percentage.append(0.0)
-                else:
-                    if new_low < old_low:
-                        # this can't happen except at the lowest bin where the new min can be
-                        # lower than the old min.  In that case we know the old data
-                        # had zero contribution between the new min to the old min.
-                        new_low = old_low
-
-                    if old_high < new_high:
-                        # this can't happen except at the lowest bin where the new max can be
-                        # higher than the old max.  In that case we know the old data
-                        # had zero contribution between the new max to the old max.
-                        new_high = old_high
-
-                    percentage.append((new_high - new_low) / (old_high - old_low))
-
-            percentage.append(1.0)
-            lookup.insert(0, 0)
-            lookup.append(-1)
+            # TODO: if the bounds are nan OR out of bounds from the cuts, estimate them.  If -inf or +inf, change them to min/max for float
+            lookup, percentage = native.harmonize_cuts(
+                old_feature_bins, 
+                old_bounds[feature_idx, 0], 
+                old_bounds[feature_idx, 1], 
+                new_feature_bins, 
+                new_bounds[feature_idx, 0], 
+                new_bounds[feature_idx, 1]
+            )
 
-        lookups.append(lookup)
+        old_bins_dimensions.append([old_feature_mapping[old_bin_idx] for old_bin_idx in lookup])
         percentages.append(percentage)
 
-    new_shape = tuple(len(lookup) for lookup in lookups)
-    n_cells = np.prod(new_shape)
-
-    lookups.reverse()
-    percentages.reverse()
-    mapping.reverse()
-
-    # now we need to inflate it
-    new_tensor = np.empty(n_cells, np.float64)
-    for cell_idx in range(n_cells):
-        remainder = cell_idx
-        old_reversed_bin_idxs = []
-        frac = 1.0
-        for lookup, percentage in zip(lookups, percentages):
-            n_bins = len(lookup)
-            new_bin_idx = remainder % n_bins
-            remainder //= n_bins
-            old_reversed_bin_idxs.append(lookup[new_bin_idx])
-            frac *= percentage[new_bin_idx]
-
-        cell_map = [map_bins[bin_idx] for map_bins, bin_idx in zip(mapping, old_reversed_bin_idxs)]
-        n_cells2 = np.prod([len(x) for x in cell_map])
-        val = 0.0
-        total_weight = 0.0
-        for cell2_idx in range(n_cells2):
-            remainder2 = cell2_idx
-            old_reversed_bin2_idxs = []
-            for lookup2 in cell_map:
-                n_bins2 = len(lookup2)
-                new_bin2_idx = remainder2 % n_bins2
-                remainder2 //= n_bins2
-                old_reversed_bin2_idxs.append(lookup2[new_bin2_idx])
-            update = old_tensor[tuple(reversed(old_reversed_bin2_idxs))]
-            if n_cells2 == 1:
-                # if there's just one cell, which is typical, don't 
-                # incur the floating point loss in precision
-                val = update
-            else:
-                if bin_evidence_weight is not None:
-                    evidence_weight = bin_evidence_weight[tuple(reversed(old_reversed_bin2_idxs))]
-                    update *= evidence_weight
-                    total_weight += evidence_weight
-                val += update
-        if bin_evidence_weight is None:
-            # we're doing a bin weight and NOT a score tensor
-            val *= frac
-        elif total_weight != 0.0:
-            # we're doing scores and we need to take a weighted average
-            # but if the total_weight is zero then val should be zero and
-            # our update should still be zero, which it already is
-            val = val / total_weight
-        new_tensor.itemset(cell_idx, val)
-    new_tensor = new_tensor.reshape(new_shape)
-    return new_tensor
+    return native.harmonize_tensors(old_tensors, old_bins_dimensions, percentages, bin_evidence_weight)
 
 def merge_ebms(models):
     """ Merging multiple EBM models trained on the same dataset.
@@ -873,7 +732,7 @@ def merge_ebms(models):
         for model_idx, model, fg_dict, model_weight in zip(count(), models, fg_dicts, model_weights):
             term_idx = fg_dict.get(sorted_fg)
             if term_idx is not None:
-                fixed_tensor = _harmonize_tensor(
+                fixed_tensor = _harmonize_tensors(
                     sorted_fg,
                     ebm.feature_bounds_,
                     ebm.bins_, 
@@ -881,9 +740,9 @@ def merge_ebms(models):
                     old_bounds[model_idx],
                     old_bins[model_idx],
                     old_mapping[model_idx],
-                    model.bin_weights_[term_idx], 
+                    model.bin_weights_[term_idx][np.newaxis], 
                     None
-                )
+                )[0]
                 bin_weight_percentages.append(fixed_tensor * model_weight)
 
         # use this when we don't have a feature group in a model as a reasonable 
@@ -908,7 +767,7 @@ def merge_ebms(models):
                 new_bin_weights.append(model_weight * bin_weight_percentages)
                 new_bagged_scores.extend(n_outer_bags * [np.zeros(additive_shape, np.float64)])
             else:
-                harmonized_bin_weights = _harmonize_tensor(
+                harmonized_bin_weights = _harmonize_tensors(
                     sorted_fg,
                     ebm.feature_bounds_,
                     ebm.bins_, 
@@ -916,12 +775,13 @@ def merge_ebms(models):
                     old_bounds[model_idx],
                     old_bins[model_idx],
                     old_mapping[model_idx],
-                    model.bin_weights_[term_idx], 
+                    model.bin_weights_[term_idx][np.newaxis], 
                     None
-                )
+                )[0]
                 new_bin_weights.append(harmonized_bin_weights)
-                for bag_idx in range(n_outer_bags):
-                    harmonized_bagged_scores = _harmonize_tensor(
+                if 0 < n_outer_bags:
+                    # all the bags of a model share the same bins, so harmonize them together
+                    harmonized_bagged_scores = _harmonize_tensors(
                         sorted_fg,
                         ebm.feature_bounds_,
                         ebm.bins_, 
@@ -929,10 +789,10 @@ def merge_ebms(models):
                         old_bounds[model_idx],
                         old_bins[model_idx],
                         old_mapping[model_idx],
-                        model.bagged_scores_[term_idx][bag_idx], 
+                        np.asarray(model.bagged_scores_[term_idx], np.float64), 
                         model.bin_weights_[term_idx] # we use these to weigh distribution of scores for mulple bins
                     )
-                    new_bagged_scores.append(harmonized_bagged_scores)
+                    new_bagged_scores.extend(harmonized_bagged_scores)
         ebm.bin_weights_.append(np.sum(new_bin_weights, axis=0))
         ebm.bagged_scores_.append(np.array(new_bagged_scores, np.float64))
 
@@ -1125,6 +985,7 @@ class EBMUtils:
         bin_weights,
         random_state,
         optional_temp_params=None,
+        term_scheduling=None,
     ):
         min_metric = np.inf
         episode_index = 0
@@ -1142,12 +1003,17 @@ class EBMUtils:
             _log.info("Start boosting")
             native = Native.get_native_singleton()
 
+            # term_scheduling is (gain_relative_min, recheck_rounds).  Which terms get skipped depends on the
+            # gains, so it would leak information about the data and is not used for private boosting
+            if term_scheduling is not None and not noise_scale:
+                booster.set_term_scheduling(*term_scheduling)
+
             for episode_index in range(max_rounds):
                 if episode_index % 10 == 0:
                     _log.debug("Sweep Index {0}".format(episode_index))
                     _log.debug("Metric: {0}".format(min_metric))
 
-                for term_idx in range(len(term_features)):
+                for term_idx in booster.schedule_terms():
                     avg_gain = booster.generate_term_update(
                         term_idx=term_idx,
                         boosting_flags=boosting_flags,
@@ -1185,6 +1051,9 @@ class EBMUtils:
 
                     min_metric = min(curr_metric, min_metric)
 
+                # forward any buffered native log messages once per round rather than once per message
+                native.drain_log_messages()
+
                 # TODO PK this early_stopping_tolerance is a little inconsistent
                 #      since it triggers intermittently and only re-triggers if the
                 #      threshold is re-passed, but not based on a smooth windowed set
@@ -0,0 +1,273 @@
+// Copyright (c) 2018 Microsoft Corporation
+// Licensed under the MIT license.
+// Author: Paul Koch <code@koch.ninja>
+
+#include "precompiled_header_cpp.hpp"
+
+#include <stdlib.h> // free
+#include <stddef.h> // size_t, ptrdiff_t
+#include <cmath> // std::sqrt, std::isfinite
+
+#include "ebm_native.h"
+#include "logging.h"
+#include "zones.h"
+
+#include "ebm_internal.hpp"
+
+namespace DEFINED_ZONE_NAME {
+#ifndef DEFINED_ZONE_NAME
+#error DEFINED_ZONE_NAME must be defined
+#endif // DEFINED_ZONE_NAME
+
+// advances aiBins through the tensor in python order, so the last dimension moves fastest
+INLINE_ALWAYS static void NextTensorBin(const size_t cDimensions, const size_t * const acBins, size_t * const aiBins) {
+   size_t iDimension = cDimensions;
+   while(size_t { 0 } != iDimension) {
+      --iDimension;
+      ++aiBins[iDimension];
+      if(aiBins[iDimension] != acBins[iDimension]) {
+         return;
+      }
+      aiBins[iDimension] = 0;
+   }
+}
+
+// if the missing/unknown bin at either end of a dimension has zero weight then whatever was generated via boosting
+// is meaningless, so any cell in a zero weight end slice is held at zero for interpretability
+INLINE_ALWAYS static bool IsZeroedTensorBin(
+   const size_t cDimensions,
+   const size_t * const acBins,
+   const size_t * const aiBins,
+   const double * const aLowWeights,
+   const double * const aHighWeights
+) {
+   for(size_t iDimension = 0; iDimension < cDimensions; ++iDimension) {
+      const size_t iBin = aiBins[iDimension];
+      if(size_t { 0 } == iBin && 0.0 == aLowWeights[iDimension]) {
+         return true;
+      }
+      if(acBins[iDimension] - 1 == iBin && 0.0 == aHighWeights[iDimension]) {
+         return true;
+      }
+   }
+   return false;
+}
+
+EBM_NATIVE_IMPORT_EXPORT_BODY ErrorEbmType EBM_NATIVE_CALLING_CONVENTION AggregateBaggedTermScores(
+   IntEbmType countBags,
+   const double * bagWeights,
+   IntEbmType countDimensions,
+   const IntEbmType * binCounts,
+   IntEbmType countScores,
+   const double * binWeights,
+   double centeringWeight,
+   double * bagScores,
+   double * meanOut,
+   double * stddevOut,
+   double * interceptInOut
+) {
+   LOG_N(
+      TraceLevelInfo,
+      "Entered AggregateBaggedTermScores: "
+      "countBags=%" IntEbmTypePrintf ", "
+      "bagWeights=%p, "
+      "countDimensions=%" IntEbmTypePrintf ", "
+      "binCounts=%p, "
+      "countScores=%" IntEbmTypePrintf ", "
+      "binWeights=%p, "
+      "centeringWeight=%le, "
+      "bagScores=%p, "
+      "meanOut=%p, "
+      "stddevOut=%p, "
+      "interceptInOut=%p"
+      ,
+      countBags,
+      static_cast<const void *>(bagWeights),
+      countDimensions,
+      static_cast<const void *>(binCounts),
+      countScores,
+      static_cast<const void *>(binWeights),
+      centeringWeight,
+      static_cast<void *>(bagScores),
+      static_cast<void *>(meanOut),
+      static_cast<void *>(stddevOut),
+      static_cast<void *>(interceptInOut)
+   );
+
+   if(countBags <= IntEbmType { 0 }) {
+      LOG_0(TraceLevelError, "ERROR AggregateBaggedTermScores countBags must be 1 or more");
+      return Error_IllegalParamValue;
+   }
+   if(IsConvertError<size_t>(countBags)) {
+      LOG_0(TraceLevelError, "ERROR AggregateBaggedTermScores IsConvertError<size_t>(countBags)");
+      return Error_IllegalParamValue;
+   }
+   const size_t cBags = static_cast<size_t>(countBags);
+
+   if(countDimensions < IntEbmType { 0 }) {
+      LOG_0(TraceLevelError, "ERROR AggregateBaggedTermScores countDimensions must be positive");
+      return Error_IllegalParamValue;
+   }
+   if(IntEbmType { k_cDimensionsMax } < countDimensions) {
+      LOG_0(TraceLevelError, "ERROR AggregateBaggedTermScores countDimensions too large");
+      return Error_IllegalParamValue;
+   }
+   const size_t cDimensions = static_cast<size_t>(countDimensions);
+
+   if(countScores <= IntEbmType { 0 }) {
+      LOG_0(TraceLevelError, "ERROR AggregateBaggedTermScores countScores must be 1 or more");
+      return Error_IllegalParamValue;
+   }
+   if(IsConvertError<size_t>(countScores)) {
+      LOG_0(TraceLevelError, "ERROR AggregateBaggedTermScores IsConvertError<size_t>(countScores)");
+      return Error_IllegalParamValue;
+   }
+   const size_t cScores = static_cast<size_t>(countScores);
+
+   if(nullptr == bagWeights || nullptr == binWeights || nullptr == bagScores || nullptr == meanOut ||
+      nullptr == stddevOut || nullptr == interceptInOut)
+   {
+      LOG_0(TraceLevelError, "ERROR AggregateBaggedTermScores array parameters cannot be null");
+      return Error_IllegalParamValue;
+   }
+   if(size_t { 0 } != cDimensions && nullptr == binCounts) {
+      LOG_0(TraceLevelError, "ERROR AggregateBaggedTermScores nullptr == binCounts");
+      return Error_IllegalParamValue;
+   }
+   if(!std::isfinite(centeringWeight) || centeringWeight < 0.0) {
+      LOG_0(TraceLevelError, "ERROR AggregateBaggedTermScores centeringWeight must be a positive number or zero");
+      return Error_IllegalParamValue;
+   }
+
+   size_t acBins[k_cDimensionsMax];
+   size_t cTensorBins = 1;
+   for(size_t iDimension = 0; iDimension < cDimensions; ++iDimension) {
+      const IntEbmType countBins = binCounts[iDimension];
+      if(countBins <= IntEbmType { 0 } || IsConvertError<size_t>(countBins)) {
+         LOG_0(TraceLevelError, "ERROR AggregateBaggedTermScores binCounts contains an illegal value");
+         return Error_IllegalParamValue;
+      }
+      const size_t cBins = static_cast<size_t>(countBins);
+      if(IsMultiplyError(cTensorBins, cBins)) {
+         LOG_0(TraceLevelError, "ERROR AggregateBaggedTermScores IsMultiplyError(cTensorBins, cBins)");
+         return Error_IllegalParamValue;
+      }
+      cTensorBins *= cBins;
+      acBins[iDimension] = cBins;
+   }
+   if(IsMultiplyError(sizeof(double), cBags, cTensorBins, cScores)) {
+      LOG_0(TraceLevelError, "ERROR AggregateBaggedTermScores IsMultiplyError(sizeof(double), cBags, cTensorBins, cScores)");
+      return Error_IllegalParamValue;
+   }
+   const size_t cTensorScores = cTensorBins * cScores;
+
+   // if all the bags have the same total weight we can avoid some numeracy issues by using unweighted averages
+   bool bEqualBagWeights = true;
+   double weightBagsTotal = 0.0;
+   for(size_t iBag = 0; iBag < cBags; ++iBag) {
+      const double bagWeight = bagWeights[iBag];
+      if(!std::isfinite(bagWeight) || bagWeight < 0.0) {
+         LOG_0(TraceLevelError, "ERROR AggregateBaggedTermScores bagWeights must be positive numbers or zero");
+         return Error_IllegalParamValue;
+      }
+      bEqualBagWeights = bEqualBagWeights && bagWeights[0] == bagWeight;
+      weightBagsTotal += bagWeight;
+   }
+   if(bEqualBagWeights) {
+      weightBagsTotal = static_cast<double>(cBags);
+   }
+   if(!(0.0 < weightBagsTotal) || !std::isfinite(weightBagsTotal)) {
+      LOG_0(TraceLevelError, "ERROR AggregateBaggedTermScores bagWeights must have a positive finite total");
+      return Error_IllegalParamValue;
+   }
+
+   double * const aCenteringSums = EbmMalloc<double>(cScores);
+   if(nullptr == aCenteringSums) {
+      LOG_0(TraceLevelWarning, "WARNING AggregateBaggedTermScores out of memory");
+      return Error_OutOfMemory;
+   }
+   for(size_t iScore = 0; iScore < cScores; ++iScore) {
+      aCenteringSums[iScore] = 0.0;
+   }
+
+   double aLowWeights[k_cDimensionsMax];
+   double aHighWeights[k_cDimensionsMax];
+   size_t aiBins[k_cDimensionsMax];
+   for(size_t iDimension = 0; iDimension < cDimensions; ++iDimension) {
+      aLowWeights[iDimension] = 0.0;
+      aHighWeights[iDimension] = 0.0;
+      aiBins[iDimension] = 0;
+   }
+
+   for(size_t iTensorBin = 0; iTensorBin < cTensorBins; ++iTensorBin) {
+      const double binWeight = binWeights[iTensorBin];
+      for(size_t iDimension = 0; iDimension < cDimensions; ++iDimension) {
+         if(size_t { 0 } == aiBins[iDimension]) {
+            aLowWeights[iDimension] += binWeight;
+         }
+         if(acBins[iDimension] - 1 == aiBins[iDimension]) {
+            aHighWeights[iDimension] += binWeight;
+         }
+      }
+      NextTensorBin(cDimensions, acBins, aiBins);
+   }
+
+   // the bags are visited cell by cell so that the (bags x tensor) stack is never copied, and zeroed cells in
+   // bagScores get a standard deviation of zero
+   for(size_t iTensorBin = 0; iTensorBin < cTensorBins; ++iTensorBin) {
+      const bool bZeroed = IsZeroedTensorBin(cDimensions, acBins, aiBins, aLowWeights, aHighWeights);
+      const double binWeight = binWeights[iTensorBin];
+      for(size_t iScore = 0; iScore < cScores; ++iScore) {
+         const size_t iTensorScore = iTensorBin * cScores + iScore;
+         double mean = 0.0;
+         double stddev = 0.0;
+         if(bZeroed) {
+            for(size_t iBag = 0; iBag < cBags; ++iBag) {
+               bagScores[iBag * cTensorScores + iTensorScore] = 0.0;
+            }
+         } else {
+            for(size_t iBag = 0; iBag < cBags; ++iBag) {
+               const double bagWeight = bEqualBagWeights ? 1.0 : bagWeights[iBag];
+               mean += bagWeight * bagScores[iBag * cTensorScores + iTensorScore];
+            }
+            mean /= weightBagsTotal;
+
+            double variance = 0.0;
+            for(size_t iBag = 0; iBag < cBags; ++iBag) {
+               const double bagWeight = bEqualBagWeights ? 1.0 : bagWeights[iBag];
+               const double difference = bagScores[iBag * cTensorScores + iTensorScore] - mean;
+               variance += bagWeight * difference * difference;
+            }
+            stddev = std::sqrt(variance / weightBagsTotal);
+         }
+         meanOut[iTensorScore] = mean;
+         stddevOut[iTensorScore] = stddev;
+         aCenteringSums[iScore] += binWeight * mean;
+      }
+      NextTensorBin(cDimensions, acBins, aiBins);
+   }
+
+   if(0.0 != centeringWeight) {
+      for(size_t iScore = 0; iScore < cScores; ++iScore) {
+         const double shift = aCenteringSums[iScore] / centeringWeight;
+         aCenteringSums[iScore] = shift;
+         interceptInOut[iScore] += shift;
+      }
+      for(size_t iTensorBin = 0; iTensorBin < cTensorBins; ++iTensorBin) {
+         // centering shifts the zeroed cells away from zero, so leave them where they are
+         if(!IsZeroedTensorBin(cDimensions, acBins, aiBins, aLowWeights, aHighWeights)) {
+            for(size_t iScore = 0; iScore < cScores; ++iScore) {
+               meanOut[iTensorBin * cScores + iScore] -= aCenteringSums[iScore];
+            }
+         }
+         NextTensorBin(cDimensions, acBins, aiBins);
+      }
+   }
+
+   free(aCenteringSums);
+
+   LOG_0(TraceLevelInfo, "Exited AggregateBaggedTermScores");
+   return Error_None;
+}
+
+} // DEFINED_ZONE_NAME
@@ -34,6 +34,27 @@ extern double ApplyTermUpdateValidation(
    const Term * const pTerm
 );
 
+extern ErrorEbmType ApplyTermUpdateScores(
+   const size_t cBoosterShells,
+   BoosterShell * const * const apBoosterShells,
+   DataSetBoosting * const pDataSet
+);
+
+static ErrorEbmType CopyCurrentToBestModel(BoosterCore * const pBoosterCore) {
+   // TODO : in the future don't copy over all CompressibleTensors.  We only need to copy the ones that changed, which we can detect if we 
+   // use a linked list and array lookup for the same data structure
+   size_t iTermCopy = 0;
+   size_t iTermCopyEnd = pBoosterCore->GetCountTerms();
+   do {
+      const ErrorEbmType error = pBoosterCore->GetBestModel()[iTermCopy]->Copy(*pBoosterCore->GetCurrentModel()[iTermCopy]);
+      if(Error_None != error) {
+         return error;
+      }
+      ++iTermCopy;
+   } while(iTermCopy != iTermCopyEnd);
+   return Error_None;
+}
+
 static ErrorEbmType ApplyTermUpdateInternal(
    BoosterShell * const pBoosterShell,
    double * const pValidationMetricReturn
@@ -79,7 +100,9 @@ static ErrorEbmType ApplyTermUpdateInternal(
    pBoosterCore->GetCurrentModel()[iTerm]->AddExpandedWithBadValueProtection(aUpdateScores);
 
    if(0 != pBoosterCore->GetTrainingSet()->GetCountSamples()) {
+      const uint64_t timestampApplyTermUpdateTraining = PerfCounters::GetTimestamp();
       ApplyTermUpdateTraining(pBoosterShell, pTerm);
+      pBoosterShell->GetPerfCounters()->Record(PerfCounter_ApplyTermUpdateTraining, timestampApplyTermUpdateTraining);
    }
 
    double modelMetric = 0.0;
@@ -95,7 +118,9 @@ static ErrorEbmType ApplyTermUpdateInternal(
       // but it isn't guaranteed, so let's check for zero samples in the validation set this better way
       // https://stackoverflow.com/questions/31225264/what-is-the-result-of-comparing-a-number-with-nan
 
+      const uint64_t timestampApplyTermUpdateValidation = PerfCounters::GetTimestamp();
       modelMetric = ApplyTermUpdateValidation(pBoosterShell, pTerm);
+      pBoosterShell->GetPerfCounters()->Record(PerfCounter_ApplyTermUpdateValidation, timestampApplyTermUpdateValidation);
 
       EBM_ASSERT(!std::isnan(modelMetric)); // NaNs can happen, but we should have converted them
       EBM_ASSERT(!std::isinf(modelMetric)); // +infinity can happen, but we should have converted it
@@ -108,21 +133,14 @@ static ErrorEbmType ApplyTermUpdateInternal(
          // we keep on improving, so this is more likely than not, and we'll exit if it becomes negative a lot
          pBoosterCore->SetBestModelMetric(modelMetric);
 
-         // TODO : in the future don't copy over all CompressibleTensors.  We only need to copy the ones that changed, which we can detect if we 
-         // use a linked list and array lookup for the same data structure
-         size_t iTermCopy = 0;
-         size_t iTermCopyEnd = pBoosterCore->GetCountTerms();
-         do {
-            error = pBoosterCore->GetBestModel()[iTermCopy]->Copy(*pBoosterCore->GetCurrentModel()[iTermCopy]);
-            if(Error_None != error) {
-               if(nullptr != pValidationMetricReturn) {
-                  *pValidationMetricReturn = double { 0 };
-               }
-               LOG_0(TraceLevelVerbose, "Exited ApplyTermUpdateInternal with memory allocation error in copy");
-               return error;
+         error = CopyCurrentToBestModel(pBoosterCore);
+         if(Error_None != error) {
+            if(nullptr != pValidationMetricReturn) {
+               *pValidationMetricReturn = double { 0 };
             }
-            ++iTermCopy;
-         } while(iTermCopy != iTermCopyEnd);
+            LOG_0(TraceLevelVerbose, "Exited ApplyTermUpdateInternal with memory allocation error in copy");
+            return error;
+         }
       }
    }
    if(nullptr != pValidationMetricReturn) {
@@ -134,10 +152,9 @@ static ErrorEbmType ApplyTermUpdateInternal(
 }
 
 // we made this a global because if we had put this variable inside the BoosterCore object, then we would need to dereference that before 
-// getting the count.  By making this global we can send a log message incase a bad BoosterCore object is sent into us
-// we only decrease the count if the count is non-zero, so at worst if there is a race condition then we'll output this log message more 
-// times than desired, but we can live with that
-static int g_cLogApplyTermUpdateParametersMessages = 10;
+// getting the count.  By making this global we can send a log message incase a bad BoosterCore object is sent into us.
+// It is thread_local, so views boosting on separate threads each get their own count and never race on it
+static thread_local int g_cLogApplyTermUpdateParametersMessages = 10;
 
 // TODO: validationMetricOut should be an average
 EBM_NATIVE_IMPORT_EXPORT_BODY ErrorEbmType EBM_NATIVE_CALLING_CONVENTION ApplyTermUpdate(
@@ -240,11 +257,205 @@ EBM_NATIVE_IMPORT_EXPORT_BODY ErrorEbmType EBM_NATIVE_CALLING_CONVENTION ApplyTe
    return error;
 }
 
+static ErrorEbmType ApplyTermUpdatesInternal(
+   const size_t cBoosterShells,
+   BoosterShell * const * const apBoosterShells,
+   double * const pValidationMetricReturn
+) {
+   LOG_0(TraceLevelVerbose, "Entered ApplyTermUpdatesInternal");
+
+   ErrorEbmType error;
+
+   EBM_ASSERT(1 <= cBoosterShells);
+   BoosterShell * const pBoosterShellLast = apBoosterShells[cBoosterShells - 1];
+   BoosterCore * const pBoosterCore = pBoosterShellLast->GetBoosterCore();
+
+   EBM_ASSERT(nullptr != pBoosterCore->GetCurrentModel());
+   EBM_ASSERT(nullptr != pBoosterCore->GetBestModel());
+
+   size_t iBoosterShell = 0;
+   do {
+      BoosterShell * const pBoosterShell = apBoosterShells[iBoosterShell];
+      const size_t iTerm = pBoosterShell->GetTermIndex();
+      const Term * const pTerm = pBoosterCore->GetTerms()[iTerm];
+
+      error = pBoosterShell->GetTermUpdate()->Expand(pTerm);
+      if(Error_None != error) {
+         if(nullptr != pValidationMetricReturn) {
+            *pValidationMetricReturn = double { 0 };
+         }
+         return error;
+      }
+
+      // see the notes in ApplyTermUpdateInternal about bad values
+      pBoosterCore->GetCurrentModel()[iTerm]->AddExpandedWithBadValueProtection(
+         pBoosterShell->GetTermUpdate()->GetScoresPointer()
+      );
+      ++iBoosterShell;
+   } while(cBoosterShells != iBoosterShell);
+
+   // All the updates were generated against the same gradients (Jacobi style), so the order we add them in doesn't matter.
+   // This takes two passes over each set of samples.  The first adds all but the last update directly into the scores 
+   // together, and the second is the normal path for the last update which also recomputes the gradients and the 
+   // validation metric from the combined scores.  The exp/log work of the second pass dominates, and it only happens 
+   // once regardless of the number of updates
+   const Term * const pTermLast = pBoosterCore->GetTerms()[pBoosterShellLast->GetTermIndex()];
+
+   if(0 != pBoosterCore->GetTrainingSet()->GetCountSamples()) {
+      const uint64_t timestampApplyTermUpdateTraining = PerfCounters::GetTimestamp();
+      if(size_t { 1 } != cBoosterShells) {
+         error = ApplyTermUpdateScores(cBoosterShells - 1, apBoosterShells, pBoosterCore->GetTrainingSet());
+         if(Error_None != error) {
+            if(nullptr != pValidationMetricReturn) {
+               *pValidationMetricReturn = double { 0 };
+            }
+            return error;
+         }
+      }
+      ApplyTermUpdateTraining(pBoosterShellLast, pTermLast);
+      pBoosterShellLast->GetPerfCounters()->Record(PerfCounter_ApplyTermUpdateTraining, timestampApplyTermUpdateTraining);
+   }
+
+   double modelMetric = 0.0;
+   if(0 != pBoosterCore->GetValidationSet()->GetCountSamples()) {
+      const uint64_t timestampApplyTermUpdateValidation = PerfCounters::GetTimestamp();
+      if(size_t { 1 } != cBoosterShells) {
+         error = ApplyTermUpdateScores(cBoosterShells - 1, apBoosterShells, pBoosterCore->GetValidationSet());
+         if(Error_None != error) {
+            if(nullptr != pValidationMetricReturn) {
+               *pValidationMetricReturn = double { 0 };
+            }
+            return error;
+         }
+      }
+      modelMetric = ApplyTermUpdateValidation(pBoosterShellLast, pTermLast);
+      pBoosterShellLast->GetPerfCounters()->Record(PerfCounter_ApplyTermUpdateValidation, timestampApplyTermUpdateValidation);
+
+      EBM_ASSERT(!std::isnan(modelMetric)); // NaNs can happen, but we should have converted them
+      EBM_ASSERT(!std::isinf(modelMetric)); // +infinity can happen, but we should have converted it
+      EBM_ASSERT(0.0 <= modelMetric);
+
+      if(LIKELY(modelMetric < pBoosterCore->GetBestModelMetric())) {
+         pBoosterCore->SetBestModelMetric(modelMetric);
+         error = CopyCurrentToBestModel(pBoosterCore);
+         if(Error_None != error) {
+            if(nullptr != pValidationMetricReturn) {
+               *pValidationMetricReturn = double { 0 };
+            }
+            LOG_0(TraceLevelVerbose, "Exited ApplyTermUpdatesInternal with memory allocation error in copy");
+            return error;
+         }
+      }
+   }
+   if(nullptr != pValidationMetricReturn) {
+      *pValidationMetricReturn = modelMetric;
+   }
+
+   LOG_0(TraceLevelVerbose, "Exited ApplyTermUpdatesInternal");
+   return Error_None;
+}
+
+EBM_NATIVE_IMPORT_EXPORT_BODY ErrorEbmType EBM_NATIVE_CALLING_CONVENTION ApplyTermUpdates(
+   IntEbmType countBoosterHandles,
+   const BoosterHandle * boosterHandles,
+   double * validationMetricOut
+) {
+   LOG_N(
+      TraceLevelVerbose,
+      "Entered ApplyTermUpdates: "
+      "countBoosterHandles=%" IntEbmTypePrintf ", "
+      "boosterHandles=%p, "
+      "validationMetricOut=%p"
+      ,
+      countBoosterHandles,
+      static_cast<const void *>(boosterHandles),
+      static_cast<void *>(validationMetricOut)
+   );
+
+   if(LIKELY(nullptr != validationMetricOut)) {
+      *validationMetricOut = 0.0;
+   }
+
+   if(countBoosterHandles <= IntEbmType { 0 }) {
+      LOG_0(TraceLevelError, "ERROR ApplyTermUpdates countBoosterHandles must be positive");
+      return Error_IllegalParamValue;
+   }
+   if(IsConvertError<size_t>(countBoosterHandles)) {
+      LOG_0(TraceLevelError, "ERROR ApplyTermUpdates IsConvertError<size_t>(countBoosterHandles)");
+      return Error_IllegalParamValue;
+   }
+   const size_t cBoosterShells = static_cast<size_t>(countBoosterHandles);
+   if(nullptr == boosterHandles) {
+      LOG_0(TraceLevelError, "ERROR ApplyTermUpdates boosterHandles cannot be nullptr");
+      return Error_IllegalParamValue;
+   }
+
+   BoosterShell ** const apBoosterShells = EbmMalloc<BoosterShell *>(cBoosterShells);
+   if(nullptr == apBoosterShells) {
+      LOG_0(TraceLevelWarning, "WARNING ApplyTermUpdates nullptr == apBoosterShells");
+      return Error_OutOfMemory;
+   }
+
+   ErrorEbmType error = Error_None;
+   BoosterCore * pBoosterCore = nullptr;
+   for(size_t iBoosterShell = 0; iBoosterShell < cBoosterShells; ++iBoosterShell) {
+      BoosterShell * const pBoosterShell = BoosterShell::GetBoosterShellFromHandle(boosterHandles[iBoosterShell]);
+      if(nullptr == pBoosterShell) {
+         // already logged
+         free(apBoosterShells);
+         return Error_IllegalParamValue;
+      }
+      apBoosterShells[iBoosterShell] = pBoosterShell;
+
+      if(nullptr == pBoosterCore) {
+         pBoosterCore = pBoosterShell->GetBoosterCore();
+      } else if(pBoosterCore != pBoosterShell->GetBoosterCore()) {
+         LOG_0(TraceLevelError, "ERROR ApplyTermUpdates all boosterHandles must be views of the same booster");
+         error = Error_IllegalParamValue;
+      }
+
+      const size_t iTerm = pBoosterShell->GetTermIndex();
+      if(BoosterShell::k_illegalTermIndex == iTerm) {
+         LOG_0(TraceLevelError, "ERROR ApplyTermUpdates bad internal state.  No Term index set");
+         error = Error_IllegalParamValue;
+      }
+      for(size_t iBoosterShellPrev = 0; iBoosterShellPrev < iBoosterShell; ++iBoosterShellPrev) {
+         if(apBoosterShells[iBoosterShellPrev] == pBoosterShell) {
+            LOG_0(TraceLevelError, "ERROR ApplyTermUpdates the same boosterHandle was passed in twice");
+            error = Error_IllegalParamValue;
+         } else if(apBoosterShells[iBoosterShellPrev]->GetTermIndex() == iTerm) {
+            LOG_0(TraceLevelError, "ERROR ApplyTermUpdates each boosterHandle must have an update for a different term");
+            error = Error_IllegalParamValue;
+         }
+      }
+   }
+   EBM_ASSERT(nullptr != pBoosterCore);
+
+   if(Error_None == error) {
+      if(ptrdiff_t { 0 } != pBoosterCore->GetRuntimeLearningTypeOrCountTargetClasses() && 
+         ptrdiff_t { 1 } != pBoosterCore->GetRuntimeLearningTypeOrCountTargetClasses()) 
+      {
+         error = ApplyTermUpdatesInternal(cBoosterShells, apBoosterShells, validationMetricOut);
+         if(Error_None != error) {
+            LOG_N(TraceLevelWarning, "WARNING ApplyTermUpdates: return=%" ErrorEbmTypePrintf, error);
+         }
+      }
+   }
+
+   // like ApplyTermUpdate, the pending updates are consumed even if we fail so that they cannot be applied twice
+   for(size_t iBoosterShell = 0; iBoosterShell < cBoosterShells; ++iBoosterShell) {
+      apBoosterShells[iBoosterShell]->SetTermIndex(BoosterShell::k_illegalTermIndex);
+   }
+   free(apBoosterShells);
+
+   LOG_0(TraceLevelVerbose, "Exited ApplyTermUpdates");
+   return error;
+}
+
 // we made this a global because if we had put this variable inside the BoosterCore object, then we would need to dereference that before 
-// getting the count.  By making this global we can send a log message incase a bad BoosterCore object is sent into us
-// we only decrease the count if the count is non-zero, so at worst if there is a race condition then we'll output this log message more 
-// times than desired, but we can live with that
-static int g_cLogGetTermUpdateSplitsParametersMessages = 10;
+// getting the count.  By making this global we can send a log message incase a bad BoosterCore object is sent into us.
+// It is thread_local, so views boosting on separate threads each get their own count and never race on it
+static thread_local int g_cLogGetTermUpdateSplitsParametersMessages = 10;
 
 EBM_NATIVE_IMPORT_EXPORT_BODY ErrorEbmType EBM_NATIVE_CALLING_CONVENTION GetTermUpdateSplits(
    BoosterHandle boosterHandle,
@@ -342,10 +553,9 @@ EBM_NATIVE_IMPORT_EXPORT_BODY ErrorEbmType EBM_NATIVE_CALLING_CONVENTION GetTerm
 }
 
 // we made this a global because if we had put this variable inside the BoosterCore object, then we would need to dereference that before 
-// getting the count.  By making this global we can send a log message incase a bad BoosterCore object is sent into us
-// we only decrease the count if the count is non-zero, so at worst if there is a race condition then we'll output this log message more 
-// times than desired, but we can live with that
-static int g_cLogGetTermUpdateExpandedParametersMessages = 10;
+// getting the count.  By making this global we can send a log message incase a bad BoosterCore object is sent into us.
+// It is thread_local, so views boosting on separate threads each get their own count and never race on it
+static thread_local int g_cLogGetTermUpdateExpandedParametersMessages = 10;
 
 EBM_NATIVE_IMPORT_EXPORT_BODY ErrorEbmType EBM_NATIVE_CALLING_CONVENTION GetTermUpdateExpanded(
    BoosterHandle boosterHandle,
@@ -414,10 +624,9 @@ EBM_NATIVE_IMPORT_EXPORT_BODY ErrorEbmType EBM_NATIVE_CALLING_CONVENTION GetTerm
 }
 
 // we made this a global because if we had put this variable inside the BoosterCore object, then we would need to dereference that before 
-// getting the count.  By making this global we can send a log message incase a bad BoosterCore object is sent into us
-// we only decrease the count if the count is non-zero, so at worst if there is a race condition then we'll output this log message more 
-// times than desired, but we can live with that
-static int g_cLogSetTermUpdateExpandedParametersMessages = 10;
+// getting the count.  By making this global we can send a log message incase a bad BoosterCore object is sent into us.
+// It is thread_local, so views boosting on separate threads each get their own count and never race on it
+static thread_local int g_cLogSetTermUpdateExpandedParametersMessages = 10;
 
 EBM_NATIVE_IMPORT_EXPORT_BODY ErrorEbmType EBM_NATIVE_CALLING_CONVENTION SetTermUpdateExpanded(
    BoosterHandle boosterHandle,
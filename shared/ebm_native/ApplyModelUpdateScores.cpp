@@ -0,0 +1,143 @@
+// Copyright (c) 2018 Microsoft Corporation
+// Licensed under the MIT license.
+// Author: Paul Koch <code@koch.ninja>
+
+#include "precompiled_header_cpp.hpp"
+
+#include <stddef.h> // size_t, ptrdiff_t
+
+#include "ebm_native.h"
+#include "logging.h"
+#include "zones.h"
+
+#include "ebm_internal.hpp"
+
+// FeatureGroup.hpp depends on FeatureInternal.h
+#include "FeatureGroup.hpp"
+// dataset depends on features
+#include "DataSetBoosting.hpp"
+
+#include "BoosterCore.hpp"
+#include "BoosterShell.hpp"
+
+namespace DEFINED_ZONE_NAME {
+#ifndef DEFINED_ZONE_NAME
+#error DEFINED_ZONE_NAME must be defined
+#endif // DEFINED_ZONE_NAME
+
+// the position of one term's bin indexes while we walk the samples of a DataSetBoosting
+struct TermScoresCursor final {
+   const FloatFast * m_aUpdateScores;
+   const StorageDataType * m_pInputData;
+   size_t m_cItemsPerBitPack;
+   size_t m_cBitsPerItemMax;
+   size_t m_maskBits;
+   size_t m_cItemsRemaining;
+   size_t m_iTensorBinCombined;
+};
+
+// ApplyTermUpdateScores only adds the term updates of several views into the sample scores (classification) or the 
+// residuals (regression) of a DataSetBoosting.  It does not recompute the gradients, hessians or the validation 
+// metric.  All the updates are added to each sample before moving to the next one, so the scores are read and written 
+// once no matter how many terms there are.  ApplyTermUpdates uses it for all but the last term in a batch, and then 
+// the normal ApplyTermUpdateTraining and ApplyTermUpdateValidation passes on the last term pick up the accumulated 
+// scores, so the expensive exp/log work happens once per sample instead of once per term.  For regression the 
+// gradient is the residual and EbmStats::ComputeGradientRegressionMSEFromOriginalGradient is a plain addition, so 
+// adding here is exact.
+extern ErrorEbmType ApplyTermUpdateScores(
+   const size_t cBoosterShells,
+   BoosterShell * const * const apBoosterShells,
+   DataSetBoosting * const pDataSet
+) {
+   LOG_0(TraceLevelVerbose, "Entered ApplyTermUpdateScores");
+
+   EBM_ASSERT(1 <= cBoosterShells);
+   EBM_ASSERT(nullptr != apBoosterShells);
+
+   BoosterCore * const pBoosterCore = apBoosterShells[0]->GetBoosterCore();
+   const ptrdiff_t runtimeLearningTypeOrCountTargetClasses = pBoosterCore->GetRuntimeLearningTypeOrCountTargetClasses();
+   const size_t cVectorLength = GetVectorLength(runtimeLearningTypeOrCountTargetClasses);
+
+   const size_t cSamples = pDataSet->GetCountSamples();
+   EBM_ASSERT(1 <= cSamples);
+
+   TermScoresCursor * const aCursors = EbmMalloc<TermScoresCursor>(cBoosterShells);
+   if(nullptr == aCursors) {
+      LOG_0(TraceLevelWarning, "WARNING ApplyTermUpdateScores nullptr == aCursors");
+      return Error_OutOfMemory;
+   }
+   const TermScoresCursor * const pCursorsEnd = aCursors + cBoosterShells;
+
+   for(size_t iBoosterShell = 0; iBoosterShell < cBoosterShells; ++iBoosterShell) {
+      BoosterShell * const pBoosterShell = apBoosterShells[iBoosterShell];
+      const Term * const pTerm = pBoosterCore->GetTerms()[pBoosterShell->GetTermIndex()];
+      TermScoresCursor * const pCursor = &aCursors[iBoosterShell];
+
+      pCursor->m_aUpdateScores = pBoosterShell->GetTermUpdate()->GetScoresPointer();
+      EBM_ASSERT(nullptr != pCursor->m_aUpdateScores);
+      pCursor->m_cItemsRemaining = 0;
+      pCursor->m_iTensorBinCombined = 0;
+      if(0 == pTerm->GetCountSignificantDimensions()) {
+         // every sample is in the one and only tensor bin
+         pCursor->m_pInputData = nullptr;
+         pCursor->m_cItemsPerBitPack = 0;
+         pCursor->m_cBitsPerItemMax = 0;
+         pCursor->m_maskBits = 0;
+      } else {
+         const size_t cItemsPerBitPack = static_cast<size_t>(pTerm->GetBitPack());
+         EBM_ASSERT(1 <= cItemsPerBitPack);
+         EBM_ASSERT(cItemsPerBitPack <= k_cBitsForStorageType);
+         const size_t cBitsPerItemMax = GetCountBits(cItemsPerBitPack);
+         EBM_ASSERT(1 <= cBitsPerItemMax);
+         EBM_ASSERT(cBitsPerItemMax <= k_cBitsForStorageType);
+
+         pCursor->m_pInputData = pDataSet->GetInputDataPointer(pTerm);
+         pCursor->m_cItemsPerBitPack = cItemsPerBitPack;
+         pCursor->m_cBitsPerItemMax = cBitsPerItemMax;
+         pCursor->m_maskBits = std::numeric_limits<size_t>::max() >> (k_cBitsForStorageType - cBitsPerItemMax);
+      }
+   }
+
+   // for regression we only keep the residuals, which are the gradients and there are no hessians
+   FloatFast * pScore = IsClassification(runtimeLearningTypeOrCountTargetClasses) ?
+      pDataSet->GetSampleScores() : pDataSet->GetGradientsAndHessiansPointer();
+   const FloatFast * const pScoresEnd = pScore + cSamples * cVectorLength;
+
+   do {
+      const FloatFast * const pScoresInnerEnd = pScore + cVectorLength;
+      TermScoresCursor * pCursor = aCursors;
+      do {
+         size_t iTensorBin = 0;
+         if(nullptr != pCursor->m_pInputData) {
+            if(0 == pCursor->m_cItemsRemaining) {
+               // we store the already multiplied dimensional value in *pInputData
+               pCursor->m_iTensorBinCombined = static_cast<size_t>(*pCursor->m_pInputData);
+               ++pCursor->m_pInputData;
+               pCursor->m_cItemsRemaining = pCursor->m_cItemsPerBitPack;
+            }
+            iTensorBin = pCursor->m_maskBits & pCursor->m_iTensorBinCombined;
+            pCursor->m_iTensorBinCombined >>= pCursor->m_cBitsPerItemMax;
+            --pCursor->m_cItemsRemaining;
+         }
+
+         // the terms are added in the same order as separate passes would add them, so the sums match exactly
+         const FloatFast * pUpdateScore = &pCursor->m_aUpdateScores[iTensorBin * cVectorLength];
+         FloatFast * pScoreInner = pScore;
+         do {
+            *pScoreInner += *pUpdateScore;
+            ++pUpdateScore;
+            ++pScoreInner;
+         } while(pScoresInnerEnd != pScoreInner);
+
+         ++pCursor;
+      } while(pCursorsEnd != pCursor);
+      pScore += cVectorLength;
+   } while(pScoresEnd != pScore);
+
+   free(aCursors);
+
+   LOG_0(TraceLevelVerbose, "Exited ApplyTermUpdateScores");
+   return Error_None;
+}
+
+} // DEFINED_ZONE_NAME
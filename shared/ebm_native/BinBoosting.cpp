@@ -160,7 +160,7 @@ public:
       BoosterCore * const pBoosterCore = pBoosterShell->GetBoosterCore();
       const ptrdiff_t runtimeLearningTypeOrCountTargetClasses = pBoosterCore->GetRuntimeLearningTypeOrCountTargetClasses();
       EBM_ASSERT(IsClassification(runtimeLearningTypeOrCountTargetClasses));
-      EBM_ASSERT(runtimeLearningTypeOrCountTargetClasses <= k_cCompilerOptimizedTargetClassesMax);
+      EBM_ASSERT(compilerLearningTypeOrCountTargetClassesPossible <= runtimeLearningTypeOrCountTargetClasses);
 
       if(compilerLearningTypeOrCountTargetClassesPossible == runtimeLearningTypeOrCountTargetClasses) {
          BinBoostingZeroDimensions<compilerLearningTypeOrCountTargetClassesPossible>::Func(
@@ -371,6 +371,155 @@ public:
    }
 };
 
+// For many classes the histogram of a term no longer fits into the L1 or L2 cache, and BinBoostingInternal touches
+// the whole class vector of a bucket for every sample.  Instead, we sweep the samples once per block of classes so
+// that only k_cHistogramClassesPerBlock classes of each bucket are in use at a time.  Each entry still sums the
+// samples in the same order, so the histograms are identical to the ones BinBoostingInternal builds.
+constexpr static size_t k_cHistogramClassesPerBlock = 16;
+constexpr static size_t k_cHistogramClassesPerBlockDynamic = 0;
+
+template<size_t compilerClassesPerBlock>
+class BinBoostingClassBlock final {
+public:
+
+   BinBoostingClassBlock() = delete; // this is a static class.  Do not construct
+
+   static void Func(
+      BoosterShell * const pBoosterShell,
+      const Term * const pTerm,
+      const SamplingSet * const pTrainingSet,
+      const size_t iClassFirst,
+      const size_t runtimeClassesPerBlock
+   ) {
+      LOG_0(TraceLevelVerbose, "Entered BinBoostingClassBlock");
+
+      const size_t cClassesBlock = k_cHistogramClassesPerBlockDynamic == compilerClassesPerBlock ? 
+         runtimeClassesPerBlock : compilerClassesPerBlock;
+      EBM_ASSERT(1 <= cClassesBlock);
+
+      HistogramBucketBase * const aHistogramBucketBase = pBoosterShell->GetHistogramBucketBaseFast();
+      auto * const aHistogramBuckets = aHistogramBucketBase->GetHistogramBucket<FloatFast, true>();
+
+      BoosterCore * const pBoosterCore = pBoosterShell->GetBoosterCore();
+      const ptrdiff_t runtimeLearningTypeOrCountTargetClasses = pBoosterCore->GetRuntimeLearningTypeOrCountTargetClasses();
+      const size_t cVectorLength = GetVectorLength(runtimeLearningTypeOrCountTargetClasses);
+      EBM_ASSERT(iClassFirst + cClassesBlock <= cVectorLength);
+
+      const size_t cItemsPerBitPack = static_cast<size_t>(pTerm->GetBitPack());
+      EBM_ASSERT(size_t { 1 } <= cItemsPerBitPack);
+      EBM_ASSERT(cItemsPerBitPack <= k_cBitsForStorageType);
+      const size_t cBitsPerItemMax = GetCountBits(cItemsPerBitPack);
+      EBM_ASSERT(1 <= cBitsPerItemMax);
+      EBM_ASSERT(cBitsPerItemMax <= k_cBitsForStorageType);
+      const size_t maskBits = std::numeric_limits<size_t>::max() >> (k_cBitsForStorageType - cBitsPerItemMax);
+      EBM_ASSERT(!GetHistogramBucketSizeOverflow<FloatFast>(true, cVectorLength)); // we're accessing allocated memory
+      const size_t cBytesPerHistogramBucket = GetHistogramBucketSize<FloatFast>(true, cVectorLength);
+
+      const size_t cSamples = pTrainingSet->GetDataSetBoosting()->GetCountSamples();
+      EBM_ASSERT(0 < cSamples);
+
+      // only the first block of classes updates the counts and weights of the buckets
+      const bool bCountsAndWeights = size_t { 0 } == iClassFirst;
+
+      const size_t * pCountOccurrences = pTrainingSet->GetCountOccurrences();
+      const FloatFast * pWeight = pTrainingSet->GetWeights();
+      EBM_ASSERT(nullptr != pWeight);
+
+      const StorageDataType * pInputData = pTrainingSet->GetDataSetBoosting()->GetInputDataPointer(pTerm);
+      const FloatFast * pGradientAndHessian = 
+         pTrainingSet->GetDataSetBoosting()->GetGradientsAndHessiansPointer() + size_t { 2 } * iClassFirst;
+      const size_t cFloatsPerSample = size_t { 2 } * cVectorLength;
+
+      size_t cSamplesRemaining = cSamples;
+      do {
+         // all the packs are full except possibly the last one
+         size_t cItemsRemaining = std::min(cItemsPerBitPack, cSamplesRemaining);
+         cSamplesRemaining -= cItemsRemaining;
+
+         // we store the already multiplied dimensional value in *pInputData
+         size_t iTensorBinCombined = static_cast<size_t>(*pInputData);
+         ++pInputData;
+         do {
+            const size_t iTensorBin = maskBits & iTensorBinCombined;
+
+            auto * const pHistogramBucketEntry = GetHistogramBucketByIndex(
+               cBytesPerHistogramBucket,
+               aHistogramBuckets,
+               iTensorBin
+            );
+
+            ASSERT_BINNED_BUCKET_OK(cBytesPerHistogramBucket, pHistogramBucketEntry, pBoosterShell->GetHistogramBucketsEndDebugFast());
+            const FloatFast weight = *pWeight;
+            ++pWeight;
+            if(bCountsAndWeights) {
+               const size_t cOccurences = *pCountOccurrences;
+               ++pCountOccurrences;
+               pHistogramBucketEntry->SetCountSamplesInBucket(pHistogramBucketEntry->GetCountSamplesInBucket() + cOccurences);
+               pHistogramBucketEntry->SetWeightInBucket(pHistogramBucketEntry->GetWeightInBucket() + weight);
+            }
+
+            auto * const pHistogramTargetEntry = pHistogramBucketEntry->GetHistogramTargetEntry() + iClassFirst;
+
+            size_t iClass = 0;
+            do {
+               const FloatFast gradient = pGradientAndHessian[size_t { 2 } * iClass];
+               const FloatFast hessian = pGradientAndHessian[size_t { 2 } * iClass + 1];
+               pHistogramTargetEntry[iClass].m_sumGradients += gradient * weight;
+               pHistogramTargetEntry[iClass].SetSumHessians(
+                  pHistogramTargetEntry[iClass].GetSumHessians() + hessian * weight
+               );
+               ++iClass;
+               // as in BinBoostingInternal, (iClass < cClassesBlock) lets the compiler unroll the compile time blocks
+            } while(iClass < cClassesBlock);
+            pGradientAndHessian += cFloatsPerSample;
+
+            iTensorBinCombined >>= cBitsPerItemMax;
+            --cItemsRemaining;
+         } while(0 != cItemsRemaining);
+      } while(0 != cSamplesRemaining);
+
+      LOG_0(TraceLevelVerbose, "Exited BinBoostingClassBlock");
+   }
+};
+
+class BinBoostingMulticlassBlocked final {
+public:
+
+   BinBoostingMulticlassBlocked() = delete; // this is a static class.  Do not construct
+
+   INLINE_ALWAYS static void Func(
+      BoosterShell * const pBoosterShell,
+      const Term * const pTerm,
+      const SamplingSet * const pTrainingSet
+   ) {
+      const size_t cVectorLength = GetVectorLength(pBoosterShell->GetBoosterCore()->GetRuntimeLearningTypeOrCountTargetClasses());
+      EBM_ASSERT(k_cHistogramClassesPerBlock < cVectorLength);
+
+      size_t iClassFirst = 0;
+      do {
+         const size_t cClassesBlock = std::min(k_cHistogramClassesPerBlock, cVectorLength - iClassFirst);
+         if(k_cHistogramClassesPerBlock == cClassesBlock) {
+            BinBoostingClassBlock<k_cHistogramClassesPerBlock>::Func(
+               pBoosterShell,
+               pTerm,
+               pTrainingSet,
+               iClassFirst,
+               cClassesBlock
+            );
+         } else {
+            BinBoostingClassBlock<k_cHistogramClassesPerBlockDynamic>::Func(
+               pBoosterShell,
+               pTerm,
+               pTrainingSet,
+               iClassFirst,
+               cClassesBlock
+            );
+         }
+         iClassFirst += cClassesBlock;
+      } while(iClassFirst < cVectorLength);
+   }
+};
+
 template<ptrdiff_t compilerLearningTypeOrCountTargetClassesPossible>
 class BinBoostingNormalTarget final {
 public:
@@ -388,7 +537,7 @@ public:
       BoosterCore * const pBoosterCore = pBoosterShell->GetBoosterCore();
       const ptrdiff_t runtimeLearningTypeOrCountTargetClasses = pBoosterCore->GetRuntimeLearningTypeOrCountTargetClasses();
       EBM_ASSERT(IsClassification(runtimeLearningTypeOrCountTargetClasses));
-      EBM_ASSERT(runtimeLearningTypeOrCountTargetClasses <= k_cCompilerOptimizedTargetClassesMax);
+      EBM_ASSERT(compilerLearningTypeOrCountTargetClassesPossible <= runtimeLearningTypeOrCountTargetClasses);
 
       if(compilerLearningTypeOrCountTargetClassesPossible == runtimeLearningTypeOrCountTargetClasses) {
          BinBoostingInternal<compilerLearningTypeOrCountTargetClassesPossible, k_cItemsPerBitPackDynamic>::Func(
@@ -422,11 +571,21 @@ public:
       EBM_ASSERT(IsClassification(pBoosterShell->GetBoosterCore()->GetRuntimeLearningTypeOrCountTargetClasses()));
       EBM_ASSERT(k_cCompilerOptimizedTargetClassesMax < pBoosterShell->GetBoosterCore()->GetRuntimeLearningTypeOrCountTargetClasses());
 
-      BinBoostingInternal<k_dynamicClassification, k_cItemsPerBitPackDynamic>::Func(
-         pBoosterShell,
-         pTerm,
-         pTrainingSet
-      );
+      if(k_cHistogramClassesPerBlock < 
+         GetVectorLength(pBoosterShell->GetBoosterCore()->GetRuntimeLearningTypeOrCountTargetClasses())) 
+      {
+         BinBoostingMulticlassBlocked::Func(
+            pBoosterShell,
+            pTerm,
+            pTrainingSet
+         );
+      } else {
+         BinBoostingInternal<k_dynamicClassification, k_cItemsPerBitPackDynamic>::Func(
+            pBoosterShell,
+            pTerm,
+            pTrainingSet
+         );
+      }
    }
 };
 
@@ -503,7 +662,7 @@ public:
       BoosterCore * const pBoosterCore = pBoosterShell->GetBoosterCore();
       const ptrdiff_t runtimeLearningTypeOrCountTargetClasses = pBoosterCore->GetRuntimeLearningTypeOrCountTargetClasses();
       EBM_ASSERT(IsClassification(runtimeLearningTypeOrCountTargetClasses));
-      EBM_ASSERT(runtimeLearningTypeOrCountTargetClasses <= k_cCompilerOptimizedTargetClassesMax);
+      EBM_ASSERT(compilerLearningTypeOrCountTargetClassesPossible <= runtimeLearningTypeOrCountTargetClasses);
 
       if(compilerLearningTypeOrCountTargetClassesPossible == runtimeLearningTypeOrCountTargetClasses) {
          BinBoostingSIMDPacking<
@@ -540,7 +699,349 @@ public:
       EBM_ASSERT(IsClassification(pBoosterShell->GetBoosterCore()->GetRuntimeLearningTypeOrCountTargetClasses()));
       EBM_ASSERT(k_cCompilerOptimizedTargetClassesMax < pBoosterShell->GetBoosterCore()->GetRuntimeLearningTypeOrCountTargetClasses());
 
-      BinBoostingSIMDPacking<k_dynamicClassification, k_cItemsPerBitPackMax>::Func(
+      if(k_cHistogramClassesPerBlock < 
+         GetVectorLength(pBoosterShell->GetBoosterCore()->GetRuntimeLearningTypeOrCountTargetClasses())) 
+      {
+         BinBoostingMulticlassBlocked::Func(
+            pBoosterShell,
+            pTerm,
+            pTrainingSet
+         );
+      } else {
+         BinBoostingSIMDPacking<k_dynamicClassification, k_cItemsPerBitPackMax>::Func(
+            pBoosterShell,
+            pTerm,
+            pTrainingSet
+         );
+      }
+   }
+};
+
+// Compact SamplingSet objects (see SamplingSet::FillGradientSampling) only hold the samples they selected along with a 
+// gathered copy of their gradients and hessians, so we read those contiguously and look up the bins of just the 
+// selected samples instead of passing over every sample in the dataset
+template<ptrdiff_t compilerLearningTypeOrCountTargetClasses>
+class BinBoostingCompact final {
+public:
+
+   BinBoostingCompact() = delete; // this is a static class.  Do not construct
+
+   static void Func(
+      BoosterShell * const pBoosterShell,
+      const Term * const pTerm,
+      const SamplingSet * const pTrainingSet
+   ) {
+      constexpr bool bClassification = IsClassification(compilerLearningTypeOrCountTargetClasses);
+
+      LOG_0(TraceLevelVerbose, "Entered BinBoostingCompact");
+
+      EBM_ASSERT(pTrainingSet->IsCompact());
+
+      HistogramBucketBase * const aHistogramBucketBase = pBoosterShell->GetHistogramBucketBaseFast();
+      auto * const aHistogramBuckets = aHistogramBucketBase->GetHistogramBucket<FloatFast, bClassification>();
+
+      BoosterCore * const pBoosterCore = pBoosterShell->GetBoosterCore();
+      const ptrdiff_t runtimeLearningTypeOrCountTargetClasses = pBoosterCore->GetRuntimeLearningTypeOrCountTargetClasses();
+
+      const ptrdiff_t learningTypeOrCountTargetClasses = GET_LEARNING_TYPE_OR_COUNT_TARGET_CLASSES(
+         compilerLearningTypeOrCountTargetClasses,
+         runtimeLearningTypeOrCountTargetClasses
+      );
+      const size_t cVectorLength = GetVectorLength(learningTypeOrCountTargetClasses);
+      EBM_ASSERT(!GetHistogramBucketSizeOverflow<FloatFast>(bClassification, cVectorLength)); // we're accessing allocated memory
+      const size_t cBytesPerHistogramBucket = GetHistogramBucketSize<FloatFast>(bClassification, cVectorLength);
+
+      // zero dimensional updates put every sample into the single bucket at index zero
+      const StorageDataType * aInputData = nullptr;
+      size_t cItemsPerBitPack = 1;
+      size_t cBitsPerItemMax = 0;
+      size_t maskBits = 0;
+      if(nullptr != pTerm) {
+         aInputData = pTrainingSet->GetDataSetBoosting()->GetInputDataPointer(pTerm);
+         cItemsPerBitPack = static_cast<size_t>(pTerm->GetBitPack());
+         EBM_ASSERT(size_t { 1 } <= cItemsPerBitPack);
+         EBM_ASSERT(cItemsPerBitPack <= k_cBitsForStorageType);
+         cBitsPerItemMax = GetCountBits(cItemsPerBitPack);
+         EBM_ASSERT(1 <= cBitsPerItemMax);
+         EBM_ASSERT(cBitsPerItemMax <= k_cBitsForStorageType);
+         maskBits = std::numeric_limits<size_t>::max() >> (k_cBitsForStorageType - cBitsPerItemMax);
+      }
+
+      const size_t cSelectedSamples = pTrainingSet->GetCountSelectedSamples();
+      EBM_ASSERT(0 < cSelectedSamples);
+
+      const size_t * piSample = pTrainingSet->GetSelectedSamples();
+      const size_t * const piSamplesEnd = piSample + cSelectedSamples;
+      const size_t * pCountOccurrences = pTrainingSet->GetCountOccurrences();
+      const FloatFast * pWeight = pTrainingSet->GetWeights();
+      const FloatFast * pGradientAndHessian = pTrainingSet->GetSelectedGradientsAndHessians();
+#ifndef NDEBUG
+      FloatFast weightTotalDebug = 0;
+#endif // NDEBUG
+
+      do {
+         size_t iTensorBin = 0;
+         if(nullptr != aInputData) {
+            const size_t iSample = *piSample;
+            const size_t iTensorBinCombined = static_cast<size_t>(aInputData[iSample / cItemsPerBitPack]);
+            iTensorBin = maskBits & (iTensorBinCombined >> (iSample % cItemsPerBitPack * cBitsPerItemMax));
+         }
+         ++piSample;
+
+         auto * const pHistogramBucketEntry = GetHistogramBucketByIndex(
+            cBytesPerHistogramBucket,
+            aHistogramBuckets,
+            iTensorBin
+         );
+
+         ASSERT_BINNED_BUCKET_OK(cBytesPerHistogramBucket, pHistogramBucketEntry, pBoosterShell->GetHistogramBucketsEndDebugFast());
+         const size_t cOccurences = *pCountOccurrences;
+         const FloatFast weight = *pWeight;
+
+#ifndef NDEBUG
+         weightTotalDebug += weight;
+#endif // NDEBUG
+
+         ++pCountOccurrences;
+         ++pWeight;
+         pHistogramBucketEntry->SetCountSamplesInBucket(pHistogramBucketEntry->GetCountSamplesInBucket() + cOccurences);
+         pHistogramBucketEntry->SetWeightInBucket(pHistogramBucketEntry->GetWeightInBucket() + weight);
+
+         auto * const pHistogramTargetEntry = pHistogramBucketEntry->GetHistogramTargetEntry();
+
+         size_t iVector = 0;
+         do {
+            const FloatFast gradient = *pGradientAndHessian;
+            pHistogramTargetEntry[iVector].m_sumGradients += gradient * weight;
+            if(bClassification) {
+               const FloatFast hessian = *(pGradientAndHessian + 1);
+               pHistogramTargetEntry[iVector].SetSumHessians(
+                  pHistogramTargetEntry[iVector].GetSumHessians() + hessian * weight
+               );
+            }
+            pGradientAndHessian += bClassification ? 2 : 1;
+            ++iVector;
+         } while(iVector < cVectorLength);
+      } while(piSamplesEnd != piSample);
+
+      EBM_ASSERT(0 < weightTotalDebug);
+      EBM_ASSERT(static_cast<FloatBig>(weightTotalDebug * 0.999) <= pTrainingSet->GetWeightTotal() &&
+         pTrainingSet->GetWeightTotal() <= static_cast<FloatBig>(1.001 * weightTotalDebug));
+
+      LOG_0(TraceLevelVerbose, "Exited BinBoostingCompact");
+   }
+};
+
+template<ptrdiff_t compilerLearningTypeOrCountTargetClassesPossible>
+class BinBoostingCompactTarget final {
+public:
+
+   BinBoostingCompactTarget() = delete; // this is a static class.  Do not construct
+
+   INLINE_ALWAYS static void Func(
+      BoosterShell * const pBoosterShell,
+      const Term * const pTerm,
+      const SamplingSet * const pTrainingSet
+   ) {
+      static_assert(IsClassification(compilerLearningTypeOrCountTargetClassesPossible), "compilerLearningTypeOrCountTargetClassesPossible needs to be a classification");
+      static_assert(compilerLearningTypeOrCountTargetClassesPossible <= k_cCompilerOptimizedTargetClassesMax, "We can't have this many items in a data pack.");
+
+      BoosterCore * const pBoosterCore = pBoosterShell->GetBoosterCore();
+      const ptrdiff_t runtimeLearningTypeOrCountTargetClasses = pBoosterCore->GetRuntimeLearningTypeOrCountTargetClasses();
+      EBM_ASSERT(IsClassification(runtimeLearningTypeOrCountTargetClasses));
+      EBM_ASSERT(compilerLearningTypeOrCountTargetClassesPossible <= runtimeLearningTypeOrCountTargetClasses);
+
+      if(compilerLearningTypeOrCountTargetClassesPossible == runtimeLearningTypeOrCountTargetClasses) {
+         BinBoostingCompact<compilerLearningTypeOrCountTargetClassesPossible>::Func(
+            pBoosterShell,
+            pTerm,
+            pTrainingSet
+         );
+      } else {
+         BinBoostingCompactTarget<compilerLearningTypeOrCountTargetClassesPossible + 1>::Func(
+            pBoosterShell,
+            pTerm,
+            pTrainingSet
+         );
+      }
+   }
+};
+
+template<>
+class BinBoostingCompactTarget<k_cCompilerOptimizedTargetClassesMax + 1> final {
+public:
+
+   BinBoostingCompactTarget() = delete; // this is a static class.  Do not construct
+
+   INLINE_ALWAYS static void Func(
+      BoosterShell * const pBoosterShell,
+      const Term * const pTerm,
+      const SamplingSet * const pTrainingSet
+   ) {
+      static_assert(IsClassification(k_cCompilerOptimizedTargetClassesMax), "k_cCompilerOptimizedTargetClassesMax needs to be a classification");
+
+      EBM_ASSERT(IsClassification(pBoosterShell->GetBoosterCore()->GetRuntimeLearningTypeOrCountTargetClasses()));
+      EBM_ASSERT(k_cCompilerOptimizedTargetClassesMax < pBoosterShell->GetBoosterCore()->GetRuntimeLearningTypeOrCountTargetClasses());
+
+      BinBoostingCompact<k_dynamicClassification>::Func(
+         pBoosterShell,
+         pTerm,
+         pTrainingSet
+      );
+   }
+};
+
+// with the bin sorted layout (CreateBoosterFlags_BinSortedLayout) each bucket is summed from the run of samples that
+// belong to its bin, so the bucket stays put for the whole run instead of being scattered to on every sample
+template<ptrdiff_t compilerLearningTypeOrCountTargetClasses>
+class BinBoostingBinSorted final {
+public:
+
+   BinBoostingBinSorted() = delete; // this is a static class.  Do not construct
+
+   static void Func(
+      BoosterShell * const pBoosterShell,
+      const Term * const pTerm,
+      const SamplingSet * const pTrainingSet
+   ) {
+      constexpr bool bClassification = IsClassification(compilerLearningTypeOrCountTargetClasses);
+
+      LOG_0(TraceLevelVerbose, "Entered BinBoostingBinSorted");
+
+      EBM_ASSERT(nullptr != pTerm);
+      EBM_ASSERT(!pTrainingSet->IsCompact());
+      EBM_ASSERT(size_t { 1 } == pTerm->GetCountSignificantDimensions());
+
+      HistogramBucketBase * const aHistogramBucketBase = pBoosterShell->GetHistogramBucketBaseFast();
+      auto * const aHistogramBuckets = aHistogramBucketBase->GetHistogramBucket<FloatFast, bClassification>();
+
+      BoosterCore * const pBoosterCore = pBoosterShell->GetBoosterCore();
+      const ptrdiff_t runtimeLearningTypeOrCountTargetClasses = pBoosterCore->GetRuntimeLearningTypeOrCountTargetClasses();
+
+      const ptrdiff_t learningTypeOrCountTargetClasses = GET_LEARNING_TYPE_OR_COUNT_TARGET_CLASSES(
+         compilerLearningTypeOrCountTargetClasses,
+         runtimeLearningTypeOrCountTargetClasses
+      );
+      const size_t cVectorLength = GetVectorLength(learningTypeOrCountTargetClasses);
+      EBM_ASSERT(!GetHistogramBucketSizeOverflow<FloatFast>(bClassification, cVectorLength)); // we're accessing allocated memory
+      const size_t cBytesPerHistogramBucket = GetHistogramBucketSize<FloatFast>(bClassification, cVectorLength);
+      const size_t cFloatsPerSample = bClassification ? cVectorLength * size_t { 2 } : cVectorLength;
+
+      const DataSetBoosting * const pDataSet = pTrainingSet->GetDataSetBoosting();
+      const size_t cBins = pTerm->GetCountTensorBins();
+      const size_t * const aOffsets = pDataSet->GetBinSortedSamples(pTerm);
+      EBM_ASSERT(nullptr != aOffsets);
+      const size_t * const aiSamples = aOffsets + cBins + size_t { 1 };
+
+      const size_t * const aCountOccurrences = pTrainingSet->GetCountOccurrences();
+      const FloatFast * const aWeights = pTrainingSet->GetWeights();
+      const FloatFast * const aGradientsAndHessians = pDataSet->GetGradientsAndHessiansPointer();
+#ifndef NDEBUG
+      FloatFast weightTotalDebug = 0;
+#endif // NDEBUG
+
+      for(size_t iBin = 0; iBin < cBins; ++iBin) {
+         auto * const pHistogramBucketEntry = GetHistogramBucketByIndex(
+            cBytesPerHistogramBucket,
+            aHistogramBuckets,
+            iBin
+         );
+         ASSERT_BINNED_BUCKET_OK(cBytesPerHistogramBucket, pHistogramBucketEntry, pBoosterShell->GetHistogramBucketsEndDebugFast());
+         auto * const pHistogramTargetEntry = pHistogramBucketEntry->GetHistogramTargetEntry();
+
+         size_t cOccurrencesBin = 0;
+         FloatFast weightBin = 0;
+         const size_t * piSample = aiSamples + aOffsets[iBin];
+         const size_t * const piSamplesEnd = aiSamples + aOffsets[iBin + 1];
+         for(; piSamplesEnd != piSample; ++piSample) {
+            const size_t iSample = *piSample;
+            const FloatFast weight = aWeights[iSample];
+            // samples outside of the inner bag have zero counts and weights, so they add nothing below
+            cOccurrencesBin += aCountOccurrences[iSample];
+            weightBin += weight;
+
+            const FloatFast * const pGradientAndHessian = &aGradientsAndHessians[iSample * cFloatsPerSample];
+            size_t iVector = 0;
+            do {
+               pHistogramTargetEntry[iVector].m_sumGradients += 
+                  pGradientAndHessian[bClassification ? iVector * size_t { 2 } : iVector] * weight;
+               if(bClassification) {
+                  pHistogramTargetEntry[iVector].SetSumHessians(
+                     pHistogramTargetEntry[iVector].GetSumHessians() + pGradientAndHessian[iVector * size_t { 2 } + size_t { 1 }] * weight
+                  );
+               }
+               ++iVector;
+            } while(iVector < cVectorLength);
+         }
+
+#ifndef NDEBUG
+         weightTotalDebug += weightBin;
+#endif // NDEBUG
+
+         pHistogramBucketEntry->SetCountSamplesInBucket(pHistogramBucketEntry->GetCountSamplesInBucket() + cOccurrencesBin);
+         pHistogramBucketEntry->SetWeightInBucket(pHistogramBucketEntry->GetWeightInBucket() + weightBin);
+      }
+
+      EBM_ASSERT(0 < weightTotalDebug);
+      EBM_ASSERT(static_cast<FloatBig>(weightTotalDebug * 0.999) <= pTrainingSet->GetWeightTotal() &&
+         pTrainingSet->GetWeightTotal() <= static_cast<FloatBig>(1.001 * weightTotalDebug));
+
+      LOG_0(TraceLevelVerbose, "Exited BinBoostingBinSorted");
+   }
+};
+
+template<ptrdiff_t compilerLearningTypeOrCountTargetClassesPossible>
+class BinBoostingBinSortedTarget final {
+public:
+
+   BinBoostingBinSortedTarget() = delete; // this is a static class.  Do not construct
+
+   INLINE_ALWAYS static void Func(
+      BoosterShell * const pBoosterShell,
+      const Term * const pTerm,
+      const SamplingSet * const pTrainingSet
+   ) {
+      static_assert(IsClassification(compilerLearningTypeOrCountTargetClassesPossible), "compilerLearningTypeOrCountTargetClassesPossible needs to be a classification");
+      static_assert(compilerLearningTypeOrCountTargetClassesPossible <= k_cCompilerOptimizedTargetClassesMax, "We can't have this many items in a data pack.");
+
+      BoosterCore * const pBoosterCore = pBoosterShell->GetBoosterCore();
+      const ptrdiff_t runtimeLearningTypeOrCountTargetClasses = pBoosterCore->GetRuntimeLearningTypeOrCountTargetClasses();
+      EBM_ASSERT(IsClassification(runtimeLearningTypeOrCountTargetClasses));
+      EBM_ASSERT(compilerLearningTypeOrCountTargetClassesPossible <= runtimeLearningTypeOrCountTargetClasses);
+
+      if(compilerLearningTypeOrCountTargetClassesPossible == runtimeLearningTypeOrCountTargetClasses) {
+         BinBoostingBinSorted<compilerLearningTypeOrCountTargetClassesPossible>::Func(
+            pBoosterShell,
+            pTerm,
+            pTrainingSet
+         );
+      } else {
+         BinBoostingBinSortedTarget<compilerLearningTypeOrCountTargetClassesPossible + 1>::Func(
+            pBoosterShell,
+            pTerm,
+            pTrainingSet
+         );
+      }
+   }
+};
+
+template<>
+class BinBoostingBinSortedTarget<k_cCompilerOptimizedTargetClassesMax + 1> final {
+public:
+
+   BinBoostingBinSortedTarget() = delete; // this is a static class.  Do not construct
+
+   INLINE_ALWAYS static void Func(
+      BoosterShell * const pBoosterShell,
+      const Term * const pTerm,
+      const SamplingSet * const pTrainingSet
+   ) {
+      static_assert(IsClassification(k_cCompilerOptimizedTargetClassesMax), "k_cCompilerOptimizedTargetClassesMax needs to be a classification");
+
+      EBM_ASSERT(IsClassification(pBoosterShell->GetBoosterCore()->GetRuntimeLearningTypeOrCountTargetClasses()));
+      EBM_ASSERT(k_cCompilerOptimizedTargetClassesMax < pBoosterShell->GetBoosterCore()->GetRuntimeLearningTypeOrCountTargetClasses());
+
+      BinBoostingBinSorted<k_dynamicClassification>::Func(
          pBoosterShell,
          pTerm,
          pTrainingSet
@@ -558,7 +1059,22 @@ extern void BinBoosting(
    BoosterCore * const pBoosterCore = pBoosterShell->GetBoosterCore();
    const ptrdiff_t runtimeLearningTypeOrCountTargetClasses = pBoosterCore->GetRuntimeLearningTypeOrCountTargetClasses();
 
-   if(nullptr == pTerm) {
+   if(pTrainingSet->IsCompact()) {
+      if(IsClassification(runtimeLearningTypeOrCountTargetClasses)) {
+         BinBoostingCompactTarget<2>::Func(
+            pBoosterShell,
+            pTerm,
+            pTrainingSet
+         );
+      } else {
+         EBM_ASSERT(IsRegression(runtimeLearningTypeOrCountTargetClasses));
+         BinBoostingCompact<k_regression>::Func(
+            pBoosterShell,
+            pTerm,
+            pTrainingSet
+         );
+      }
+   } else if(nullptr == pTerm) {
       if(IsClassification(runtimeLearningTypeOrCountTargetClasses)) {
          BinBoostingZeroDimensionsTarget<2>::Func(
             pBoosterShell,
@@ -571,6 +1087,21 @@ extern void BinBoosting(
             pTrainingSet
          );
       }
+   } else if(nullptr != pTrainingSet->GetDataSetBoosting()->GetBinSortedSamples(pTerm)) {
+      if(IsClassification(runtimeLearningTypeOrCountTargetClasses)) {
+         BinBoostingBinSortedTarget<2>::Func(
+            pBoosterShell,
+            pTerm,
+            pTrainingSet
+         );
+      } else {
+         EBM_ASSERT(IsRegression(runtimeLearningTypeOrCountTargetClasses));
+         BinBoostingBinSorted<k_regression>::Func(
+            pBoosterShell,
+            pTerm,
+            pTrainingSet
+         );
+      }
    } else {
       EBM_ASSERT(1 <= pTerm->GetCountSignificantDimensions());
       if(k_bUseSIMD) {
@@ -215,7 +215,7 @@ public:
       InteractionCore * const pInteractionCore = pInteractionShell->GetInteractionCore();
       const ptrdiff_t runtimeLearningTypeOrCountTargetClasses = pInteractionCore->GetRuntimeLearningTypeOrCountTargetClasses();
       EBM_ASSERT(IsClassification(runtimeLearningTypeOrCountTargetClasses));
-      EBM_ASSERT(runtimeLearningTypeOrCountTargetClasses <= k_cCompilerOptimizedTargetClassesMax);
+      EBM_ASSERT(compilerLearningTypeOrCountTargetClassesPossible <= runtimeLearningTypeOrCountTargetClasses);
 
       if(compilerLearningTypeOrCountTargetClassesPossible == runtimeLearningTypeOrCountTargetClasses) {
          BinInteractionDimensions<compilerLearningTypeOrCountTargetClassesPossible, 2>::Func(pInteractionShell, pTerm);
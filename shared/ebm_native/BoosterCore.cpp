@@ -169,6 +169,7 @@ ErrorEbmType BoosterCore::Create(
    BoosterShell * const pBoosterShell,
    const size_t cTerms,
    const size_t cSamplingSets,
+   const CreateBoosterFlagsType flags,
    const double * const optionalTempParams,
    const IntEbmType * const acTermDimensions,
    const IntEbmType * const aiTermFeatures, 
@@ -469,6 +470,14 @@ ErrorEbmType BoosterCore::Create(
       return error;
    }
 
+   if(0 != (CreateBoosterFlags_BinSortedLayout & flags)) {
+      error = pBoosterCore->m_trainingSet.InitializeBinSortedLayout(pBoosterCore->m_apTerms);
+      if(Error_None != error) {
+         LOG_0(TraceLevelWarning, "WARNING BoosterCore::Create m_trainingSet.InitializeBinSortedLayout");
+         return error;
+      }
+   }
+
    error = pBoosterCore->m_validationSet.Initialize(
       runtimeLearningTypeOrCountTargetClasses,
       !bClassification,
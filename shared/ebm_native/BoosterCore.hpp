@@ -185,6 +185,7 @@ public:
       BoosterShell * const pBoosterShell,
       const size_t cTerms,
       const size_t cSamplingSets,
+      const CreateBoosterFlagsType flags,
       const double * const optionalTempParams,
       const IntEbmType * const acTermDimensions,
       const IntEbmType * const aiTermFeatures,
@@ -7,6 +7,9 @@
 #include <stdlib.h> // free
 #include <stddef.h> // size_t, ptrdiff_t
 #include <string.h> // memcpy
+#include <algorithm> // std::min, std::max
+#include <cmath> // std::isnan
+#include <limits> // std::numeric_limits
 
 #include "ebm_native.h"
 #include "logging.h"
@@ -42,6 +45,11 @@ void BoosterShell::Free(BoosterShell * const pBoosterShell) {
       free(pBoosterShell->m_aSumHistogramTargetEntryRight);
       free(pBoosterShell->m_aTempFloatVector);
       free(pBoosterShell->m_aEquivalentSplits);
+      if(nullptr != pBoosterShell->m_pCompactSamplingSet) {
+         pBoosterShell->m_pCompactSamplingSet->Free();
+      }
+      free(pBoosterShell->m_aSamplingMagnitudesTemp);
+      free(pBoosterShell->m_aTermSchedule);
       BoosterCore::Free(pBoosterShell->m_pBoosterCore);
 
       // before we free our memory, indicate it was freed so if our higher level language attempts to use it we have
@@ -177,6 +185,184 @@ ErrorEbmType BoosterShell::GrowThreadByteBuffer2(const size_t cByteBoundaries) {
    return Error_None;
 }
 
+ErrorEbmType BoosterShell::AllocateCompactSamplingSet() {
+   if(nullptr != m_pCompactSamplingSet) {
+      m_pCompactSamplingSet->Free();
+      m_pCompactSamplingSet = nullptr;
+   }
+   free(m_aSamplingMagnitudesTemp);
+   m_aSamplingMagnitudesTemp = nullptr;
+
+   // GOSS and row subsampling share the compact set, so it needs to hold whichever keeps more samples
+   const bool bGradientSampling = IsGradientSampling();
+   const double rateMax = std::max(
+      bGradientSampling ? m_gradientSamplingTopRate + m_gradientSamplingOtherRate : 0.0, 
+      m_rowSubsamplingRate
+   );
+   if(rateMax <= 0.0) {
+      return Error_None;
+   }
+
+   // if there are no training samples then there is nothing to sample.  The booster handles that case already
+   const DataSetBoosting * const pTrainingSet = m_pBoosterCore->GetTrainingSet();
+   const size_t cSamples = pTrainingSet->GetCountSamples();
+   if(size_t { 0 } == cSamples) {
+      m_gradientSamplingTopRate = 0.0;
+      m_gradientSamplingOtherRate = 0.0;
+      m_rowSubsamplingRate = 0.0;
+      return Error_None;
+   }
+
+   const ptrdiff_t runtimeLearningTypeOrCountTargetClasses = m_pBoosterCore->GetRuntimeLearningTypeOrCountTargetClasses();
+   const size_t cVectorLength = GetVectorLength(runtimeLearningTypeOrCountTargetClasses);
+   const size_t cFloatsPerSample = IsClassification(runtimeLearningTypeOrCountTargetClasses) ? 
+      cVectorLength * size_t { 2 } : cVectorLength;
+
+   // size the set with the same rounding as the fill functions.  GOSS rounds its top and other counts down 
+   // separately, so their sum can be one more than the rounded sum of the rates.  The inner bag never has more 
+   // candidates than cSamples, so the counts from cSamples bound the ones the fills compute.  Keep at least 1 sample
+   const double cSamplesDouble = static_cast<double>(cSamples);
+   size_t cSelectedCapacity = static_cast<size_t>(m_rowSubsamplingRate * cSamplesDouble);
+   if(bGradientSampling) {
+      const size_t cTopMax = static_cast<size_t>(m_gradientSamplingTopRate * cSamplesDouble);
+      const size_t cOtherMax = static_cast<size_t>(m_gradientSamplingOtherRate * cSamplesDouble);
+      cSelectedCapacity = std::max(cSelectedCapacity, cTopMax + cOtherMax);
+   }
+   cSelectedCapacity = std::max(size_t { 1 }, std::min(cSamples, cSelectedCapacity));
+
+   if(bGradientSampling) {
+      if(IsMultiplyError(sizeof(FloatFast), cSamples, size_t { 2 })) {
+         LOG_0(TraceLevelWarning, "WARNING BoosterShell::AllocateCompactSamplingSet IsMultiplyError(sizeof(FloatFast), cSamples, size_t { 2 })");
+         goto exit_error;
+      }
+      m_aSamplingMagnitudesTemp = EbmMalloc<FloatFast>(cSamples * size_t { 2 });
+      if(nullptr == m_aSamplingMagnitudesTemp) {
+         LOG_0(TraceLevelWarning, "WARNING BoosterShell::AllocateCompactSamplingSet nullptr == m_aSamplingMagnitudesTemp");
+         goto exit_error;
+      }
+   }
+   m_pCompactSamplingSet = SamplingSet::CreateCompactSamplingSet(pTrainingSet, cSelectedCapacity, cFloatsPerSample);
+   if(nullptr == m_pCompactSamplingSet) {
+      goto exit_error;
+   }
+   return Error_None;
+
+exit_error:;
+   // leave the handle in a consistent state with all sampling turned off
+   free(m_aSamplingMagnitudesTemp);
+   m_aSamplingMagnitudesTemp = nullptr;
+   m_gradientSamplingTopRate = 0.0;
+   m_gradientSamplingOtherRate = 0.0;
+   m_rowSubsamplingRate = 0.0;
+   return Error_OutOfMemory;
+}
+
+ErrorEbmType BoosterShell::SetGradientSampling(const double topRate, const double otherRate) {
+   const double rateTotal = topRate + otherRate;
+   if(rateTotal <= 0.0 || 1.0 <= rateTotal) {
+      // keeping all the samples is the same as not sampling
+      m_gradientSamplingTopRate = 0.0;
+      m_gradientSamplingOtherRate = 0.0;
+   } else {
+      m_gradientSamplingTopRate = topRate;
+      m_gradientSamplingOtherRate = otherRate;
+   }
+   return AllocateCompactSamplingSet();
+}
+
+ErrorEbmType BoosterShell::SetRowSubsampling(const double rate) {
+   // keeping all the samples is the same as not sampling
+   m_rowSubsamplingRate = 1.0 <= rate ? 0.0 : rate;
+   return AllocateCompactSamplingSet();
+}
+
+// the weight of the newest gain in a term's history.  Gains are noisy from round to round, especially with inner bags
+// or sampling, so a single lucky or unlucky round shouldn't move a term in or out of the schedule
+constexpr static double k_termScheduleGainSmoothing = 0.5;
+
+ErrorEbmType BoosterShell::SetTermScheduling(const double gainRelativeMin, const size_t cRecheckRounds) {
+   free(m_aTermSchedule);
+   m_aTermSchedule = nullptr;
+   m_termScheduleGainRelativeMin = 0.0;
+   m_cTermScheduleRecheckRounds = 0;
+   m_iTermScheduleRound = 0;
+
+   const size_t cTerms = m_pBoosterCore->GetCountTerms();
+   if(0.0 == gainRelativeMin || size_t { 0 } == cTerms) {
+      return Error_None;
+   }
+
+   TermScheduleEntry * const aTermSchedule = EbmMalloc<TermScheduleEntry>(cTerms);
+   if(nullptr == aTermSchedule) {
+      LOG_0(TraceLevelWarning, "WARNING BoosterShell::SetTermScheduling nullptr == aTermSchedule");
+      return Error_OutOfMemory;
+   }
+   for(size_t iTerm = 0; iTerm < cTerms; ++iTerm) {
+      aTermSchedule[iTerm].m_gainAverage = std::numeric_limits<double>::quiet_NaN();
+      aTermSchedule[iTerm].m_bExhausted = false;
+   }
+   m_aTermSchedule = aTermSchedule;
+   m_termScheduleGainRelativeMin = gainRelativeMin;
+   m_cTermScheduleRecheckRounds = cRecheckRounds;
+   return Error_None;
+}
+
+void BoosterShell::RecordTermGain(const size_t iTerm, const double gain) {
+   if(nullptr == m_aTermSchedule) {
+      return;
+   }
+   EBM_ASSERT(iTerm < m_pBoosterCore->GetCountTerms());
+   if(gain < 0.0) {
+      // k_illegalGainDouble means the update overflowed and was discarded, which says nothing about the term
+      return;
+   }
+   TermScheduleEntry * const pEntry = &m_aTermSchedule[iTerm];
+   if(std::isnan(pEntry->m_gainAverage) || pEntry->m_bExhausted) {
+      // a re-check replaces the history, which is stale since the term has not been boosted for many rounds
+      pEntry->m_gainAverage = gain;
+   } else {
+      pEntry->m_gainAverage += k_termScheduleGainSmoothing * (gain - pEntry->m_gainAverage);
+   }
+}
+
+size_t BoosterShell::ScheduleTerms(IntEbmType * const aTermIndexesOut) {
+   const size_t cTerms = m_pBoosterCore->GetCountTerms();
+   if(nullptr == m_aTermSchedule) {
+      for(size_t iTerm = 0; iTerm < cTerms; ++iTerm) {
+         aTermIndexesOut[iTerm] = static_cast<IntEbmType>(iTerm);
+      }
+      return cTerms;
+   }
+
+   double gainMax = 0.0;
+   for(size_t iTerm = 0; iTerm < cTerms; ++iTerm) {
+      const double gainAverage = m_aTermSchedule[iTerm].m_gainAverage;
+      // NaN fails this comparison, so terms without any history don't count
+      if(gainMax < gainAverage) {
+         gainMax = gainAverage;
+      }
+   }
+   // the best term is never below this, so at least one term is boosted every round
+   const double gainThreshold = m_termScheduleGainRelativeMin * gainMax;
+
+   const size_t iRound = m_iTermScheduleRound;
+   ++m_iTermScheduleRound;
+
+   size_t cScheduled = 0;
+   for(size_t iTerm = 0; iTerm < cTerms; ++iTerm) {
+      TermScheduleEntry * const pEntry = &m_aTermSchedule[iTerm];
+      // terms without history are NaN, which fails this comparison, so they get boosted
+      const bool bExhausted = pEntry->m_gainAverage < gainThreshold;
+      pEntry->m_bExhausted = bExhausted;
+      // offsetting by the term index spreads the re-checks of the exhausted terms over the rounds
+      if(!bExhausted || size_t { 0 } == (iRound + iTerm) % m_cTermScheduleRecheckRounds) {
+         aTermIndexesOut[cScheduled] = static_cast<IntEbmType>(iTerm);
+         ++cScheduled;
+      }
+   }
+   return cScheduled;
+}
+
 EBM_NATIVE_IMPORT_EXPORT_BODY ErrorEbmType EBM_NATIVE_CALLING_CONVENTION CreateBooster(
    SeedEbmType randomSeed,
    const void * dataSet,
@@ -186,6 +372,7 @@ EBM_NATIVE_IMPORT_EXPORT_BODY ErrorEbmType EBM_NATIVE_CALLING_CONVENTION CreateB
    const IntEbmType * dimensionCounts,
    const IntEbmType * featureIndexes,
    IntEbmType countInnerBags,
+   CreateBoosterFlagsType flags,
    const double * optionalTempParams,
    BoosterHandle * boosterHandleOut
 ) {
@@ -200,6 +387,7 @@ EBM_NATIVE_IMPORT_EXPORT_BODY ErrorEbmType EBM_NATIVE_CALLING_CONVENTION CreateB
       "dimensionCounts=%p, "
       "featureIndexes=%p, "
       "countInnerBags=%" IntEbmTypePrintf ", "
+      "flags=0x%" UCreateBoosterFlagsTypePrintf ", "
       "optionalTempParams=%p, "
       "boosterHandleOut=%p"
       ,
@@ -211,6 +399,7 @@ EBM_NATIVE_IMPORT_EXPORT_BODY ErrorEbmType EBM_NATIVE_CALLING_CONVENTION CreateB
       static_cast<const void *>(dimensionCounts),
       static_cast<const void *>(featureIndexes),
       countInnerBags,
+      static_cast<UCreateBoosterFlagsType>(flags), // signed to unsigned conversion is defined behavior in C++
       static_cast<const void *>(optionalTempParams),
       static_cast<const void *>(boosterHandleOut)
    );
@@ -245,6 +434,11 @@ EBM_NATIVE_IMPORT_EXPORT_BODY ErrorEbmType EBM_NATIVE_CALLING_CONVENTION CreateB
       return Error_UserParamValue;
    }
 
+   if(0 != (~CreateBoosterFlags_BinSortedLayout & flags)) {
+      LOG_0(TraceLevelError, "ERROR CreateBooster flags contains unknown flags");
+      return Error_IllegalParamValue;
+   }
+
    if(IsConvertError<size_t>(countTerms)) {
       // the caller should not have been able to allocate memory for dimensionCounts if this wasn't fittable in size_t
       LOG_0(TraceLevelError, "ERROR CreateBooster IsConvertError<size_t>(countTerms)");
@@ -271,6 +465,7 @@ EBM_NATIVE_IMPORT_EXPORT_BODY ErrorEbmType EBM_NATIVE_CALLING_CONVENTION CreateB
       pBoosterShell,
       cTerms,
       cInnerBags,
+      flags,
       optionalTempParams,
       dimensionCounts,
       featureIndexes,
@@ -536,6 +731,195 @@ EBM_NATIVE_IMPORT_EXPORT_BODY ErrorEbmType EBM_NATIVE_CALLING_CONVENTION GetCurr
    return Error_None;
 }
 
+EBM_NATIVE_IMPORT_EXPORT_BODY ErrorEbmType EBM_NATIVE_CALLING_CONVENTION GetBoosterPerfCounters(
+   BoosterHandle boosterHandle,
+   IntEbmType countPerfCounters,
+   IntEbmType * callCountsOut,
+   double * secondsOut
+) {
+   LOG_N(
+      TraceLevelInfo,
+      "Entered GetBoosterPerfCounters: "
+      "boosterHandle=%p, "
+      "countPerfCounters=%" IntEbmTypePrintf ", "
+      "callCountsOut=%p, "
+      "secondsOut=%p"
+      ,
+      static_cast<void *>(boosterHandle),
+      countPerfCounters,
+      static_cast<void *>(callCountsOut),
+      static_cast<void *>(secondsOut)
+   );
+
+   BoosterShell * const pBoosterShell = BoosterShell::GetBoosterShellFromHandle(boosterHandle);
+   if(nullptr == pBoosterShell) {
+      // already logged
+      return Error_IllegalParamValue;
+   }
+
+   if(countPerfCounters < IntEbmType { 0 } || PerfCounter_Count < countPerfCounters) {
+      LOG_0(TraceLevelError, "ERROR GetBoosterPerfCounters countPerfCounters must be between 0 and PerfCounter_Count");
+      return Error_IllegalParamValue;
+   }
+
+   pBoosterShell->GetPerfCounters()->Fill(static_cast<size_t>(countPerfCounters), callCountsOut, secondsOut);
+
+   LOG_0(TraceLevelInfo, "Exited GetBoosterPerfCounters");
+   return Error_None;
+}
+
+EBM_NATIVE_IMPORT_EXPORT_BODY ErrorEbmType EBM_NATIVE_CALLING_CONVENTION SetGradientSampling(
+   BoosterHandle boosterHandle,
+   double topRate,
+   double otherRate
+) {
+   LOG_N(
+      TraceLevelInfo,
+      "Entered SetGradientSampling: "
+      "boosterHandle=%p, "
+      "topRate=%le, "
+      "otherRate=%le"
+      ,
+      static_cast<void *>(boosterHandle),
+      topRate,
+      otherRate
+   );
+
+   BoosterShell * const pBoosterShell = BoosterShell::GetBoosterShellFromHandle(boosterHandle);
+   if(nullptr == pBoosterShell) {
+      // already logged
+      return Error_IllegalParamValue;
+   }
+
+   // the negated comparisons also reject NaN
+   if(!(0.0 <= topRate && topRate <= 1.0)) {
+      LOG_0(TraceLevelError, "ERROR SetGradientSampling topRate must be between 0 and 1");
+      return Error_IllegalParamValue;
+   }
+   if(!(0.0 <= otherRate && otherRate <= 1.0)) {
+      LOG_0(TraceLevelError, "ERROR SetGradientSampling otherRate must be between 0 and 1");
+      return Error_IllegalParamValue;
+   }
+
+   const ErrorEbmType error = pBoosterShell->SetGradientSampling(topRate, otherRate);
+
+   LOG_0(TraceLevelInfo, "Exited SetGradientSampling");
+   return error;
+}
+
+EBM_NATIVE_IMPORT_EXPORT_BODY ErrorEbmType EBM_NATIVE_CALLING_CONVENTION SetRowSubsampling(
+   BoosterHandle boosterHandle,
+   double rate
+) {
+   LOG_N(
+      TraceLevelInfo,
+      "Entered SetRowSubsampling: "
+      "boosterHandle=%p, "
+      "rate=%le"
+      ,
+      static_cast<void *>(boosterHandle),
+      rate
+   );
+
+   BoosterShell * const pBoosterShell = BoosterShell::GetBoosterShellFromHandle(boosterHandle);
+   if(nullptr == pBoosterShell) {
+      // already logged
+      return Error_IllegalParamValue;
+   }
+
+   // the negated comparison also rejects NaN
+   if(!(0.0 <= rate && rate <= 1.0)) {
+      LOG_0(TraceLevelError, "ERROR SetRowSubsampling rate must be between 0 and 1");
+      return Error_IllegalParamValue;
+   }
+
+   const ErrorEbmType error = pBoosterShell->SetRowSubsampling(rate);
+
+   LOG_0(TraceLevelInfo, "Exited SetRowSubsampling");
+   return error;
+}
+
+EBM_NATIVE_IMPORT_EXPORT_BODY ErrorEbmType EBM_NATIVE_CALLING_CONVENTION SetTermScheduling(
+   BoosterHandle boosterHandle,
+   double gainRelativeMin,
+   IntEbmType recheckRounds
+) {
+   LOG_N(
+      TraceLevelInfo,
+      "Entered SetTermScheduling: "
+      "boosterHandle=%p, "
+      "gainRelativeMin=%le, "
+      "recheckRounds=%" IntEbmTypePrintf
+      ,
+      static_cast<void *>(boosterHandle),
+      gainRelativeMin,
+      recheckRounds
+   );
+
+   BoosterShell * const pBoosterShell = BoosterShell::GetBoosterShellFromHandle(boosterHandle);
+   if(nullptr == pBoosterShell) {
+      // already logged
+      return Error_IllegalParamValue;
+   }
+
+   // the negated comparison also rejects NaN
+   if(!(0.0 <= gainRelativeMin && gainRelativeMin <= 1.0)) {
+      LOG_0(TraceLevelError, "ERROR SetTermScheduling gainRelativeMin must be between 0 and 1");
+      return Error_IllegalParamValue;
+   }
+   if(recheckRounds < IntEbmType { 1 } || IsConvertError<size_t>(recheckRounds)) {
+      LOG_0(TraceLevelError, "ERROR SetTermScheduling recheckRounds must be 1 or more");
+      return Error_IllegalParamValue;
+   }
+
+   const ErrorEbmType error = pBoosterShell->SetTermScheduling(gainRelativeMin, static_cast<size_t>(recheckRounds));
+
+   LOG_0(TraceLevelInfo, "Exited SetTermScheduling");
+   return error;
+}
+
+static thread_local int g_cLogScheduleTermsParametersMessages = 10;
+
+EBM_NATIVE_IMPORT_EXPORT_BODY ErrorEbmType EBM_NATIVE_CALLING_CONVENTION ScheduleTerms(
+   BoosterHandle boosterHandle,
+   IntEbmType * countTermsOut,
+   IntEbmType * termIndexesOut
+) {
+   LOG_COUNTED_N(
+      &g_cLogScheduleTermsParametersMessages,
+      TraceLevelInfo,
+      TraceLevelVerbose,
+      "ScheduleTerms: "
+      "boosterHandle=%p, "
+      "countTermsOut=%p, "
+      "termIndexesOut=%p"
+      ,
+      static_cast<void *>(boosterHandle),
+      static_cast<void *>(countTermsOut),
+      static_cast<void *>(termIndexesOut)
+   );
+
+   if(nullptr == countTermsOut) {
+      LOG_0(TraceLevelError, "ERROR ScheduleTerms countTermsOut cannot be null");
+      return Error_IllegalParamValue;
+   }
+   *countTermsOut = 0;
+
+   BoosterShell * const pBoosterShell = BoosterShell::GetBoosterShellFromHandle(boosterHandle);
+   if(nullptr == pBoosterShell) {
+      // already logged
+      return Error_IllegalParamValue;
+   }
+
+   if(size_t { 0 } != pBoosterShell->GetBoosterCore()->GetCountTerms() && nullptr == termIndexesOut) {
+      LOG_0(TraceLevelError, "ERROR ScheduleTerms termIndexesOut cannot be null");
+      return Error_IllegalParamValue;
+   }
+
+   *countTermsOut = static_cast<IntEbmType>(pBoosterShell->ScheduleTerms(termIndexesOut));
+   return Error_None;
+}
+
 EBM_NATIVE_IMPORT_EXPORT_BODY void EBM_NATIVE_CALLING_CONVENTION FreeBooster(
    BoosterHandle boosterHandle
 ) {
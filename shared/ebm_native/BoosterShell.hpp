@@ -16,6 +16,7 @@
 
 #include "RandomStream.hpp"
 #include "HistogramTargetEntry.hpp"
+#include "PerfCounters.hpp"
 
 namespace DEFINED_ZONE_NAME {
 #ifndef DEFINED_ZONE_NAME
@@ -24,6 +25,20 @@ namespace DEFINED_ZONE_NAME {
 
 struct HistogramBucketBase;
 class BoosterCore;
+class SamplingSet;
+
+struct TermScheduleEntry final {
+   // NaN until the term has a gain from GenerateTermUpdate
+   double m_gainAverage;
+   // set by ScheduleTerms for the terms that it only schedules as a re-check
+   bool m_bExhausted;
+};
+static_assert(std::is_standard_layout<TermScheduleEntry>::value,
+   "We use the struct hack in several places, so disallow non-standard_layout types in general");
+static_assert(std::is_trivial<TermScheduleEntry>::value,
+   "We use memcpy in several places, so disallow non-trivial types in general");
+static_assert(std::is_pod<TermScheduleEntry>::value,
+   "We use a lot of C constructs, so disallow non-POD types in general");
 
 class BoosterShell final {
    static constexpr size_t k_handleVerificationOk = 25077; // random 15 bit number
@@ -56,11 +71,31 @@ class BoosterShell final {
    HistogramTargetEntryBase * m_aSumHistogramTargetEntryLeft;
    HistogramTargetEntryBase * m_aSumHistogramTargetEntryRight;
 
+   PerfCounters m_perfCounters;
+
+   // gradient-based one-side sampling (GOSS) and row subsampling are set per handle by SetGradientSampling and 
+   // SetRowSubsampling.  When either is on, m_pCompactSamplingSet is refilled from each inner bag on every call 
+   // to GenerateTermUpdate.  The rates are zero whenever the corresponding sampling is off
+   double m_gradientSamplingTopRate;
+   double m_gradientSamplingOtherRate;
+   double m_rowSubsamplingRate;
+   SamplingSet * m_pCompactSamplingSet;
+   FloatFast * m_aSamplingMagnitudesTemp;
+
+   // adaptive term scheduling is set per handle by SetTermScheduling.  m_aTermSchedule holds one entry per term and 
+   // is null whenever scheduling is off
+   double m_termScheduleGainRelativeMin;
+   size_t m_cTermScheduleRecheckRounds;
+   size_t m_iTermScheduleRound;
+   TermScheduleEntry * m_aTermSchedule;
+
 #ifndef NDEBUG
    const unsigned char * m_aHistogramBucketsEndDebugFast;
    const unsigned char * m_aHistogramBucketsEndDebugBig;
 #endif // NDEBUG
 
+   ErrorEbmType AllocateCompactSamplingSet();
+
 public:
 
    BoosterShell() = default; // preserve our POD status
@@ -87,6 +122,16 @@ public:
       m_aSumHistogramTargetEntry = nullptr;
       m_aSumHistogramTargetEntryLeft = nullptr;
       m_aSumHistogramTargetEntryRight = nullptr;
+      m_perfCounters.InitializeUnfailing();
+      m_gradientSamplingTopRate = 0.0;
+      m_gradientSamplingOtherRate = 0.0;
+      m_rowSubsamplingRate = 0.0;
+      m_pCompactSamplingSet = nullptr;
+      m_aSamplingMagnitudesTemp = nullptr;
+      m_termScheduleGainRelativeMin = 0.0;
+      m_cTermScheduleRecheckRounds = 0;
+      m_iTermScheduleRound = 0;
+      m_aTermSchedule = nullptr;
    }
 
    static void Free(BoosterShell * const pBoosterShell);
@@ -144,6 +189,47 @@ public:
       return &m_randomDeterministic;
    }
 
+   INLINE_ALWAYS PerfCounters * GetPerfCounters() {
+      return &m_perfCounters;
+   }
+
+   ErrorEbmType SetGradientSampling(const double topRate, const double otherRate);
+   ErrorEbmType SetRowSubsampling(const double rate);
+   INLINE_ALWAYS bool IsGradientSampling() const {
+      return 0.0 != m_gradientSamplingTopRate || 0.0 != m_gradientSamplingOtherRate;
+   }
+   INLINE_ALWAYS bool IsRowSubsampling() const {
+      return 0.0 != m_rowSubsamplingRate;
+   }
+   INLINE_ALWAYS double GetRowSubsamplingRate() const {
+      return m_rowSubsamplingRate;
+   }
+   INLINE_ALWAYS double GetGradientSamplingTopRate() const {
+      return m_gradientSamplingTopRate;
+   }
+   INLINE_ALWAYS double GetGradientSamplingOtherRate() const {
+      return m_gradientSamplingOtherRate;
+   }
+   INLINE_ALWAYS SamplingSet * GetCompactSamplingSet() {
+      return m_pCompactSamplingSet;
+   }
+   INLINE_ALWAYS FloatFast * GetSamplingMagnitudesTemp() {
+      return m_aSamplingMagnitudesTemp;
+   }
+
+   ErrorEbmType SetTermScheduling(const double gainRelativeMin, const size_t cRecheckRounds);
+   void RecordTermGain(const size_t iTerm, const double gain);
+   size_t ScheduleTerms(IntEbmType * const aTermIndexesOut);
+   INLINE_ALWAYS TermScheduleEntry * GetTermSchedule() {
+      return m_aTermSchedule;
+   }
+   INLINE_ALWAYS size_t GetTermScheduleRound() const {
+      return m_iTermScheduleRound;
+   }
+   INLINE_ALWAYS void SetTermScheduleRound(const size_t iTermScheduleRound) {
+      m_iTermScheduleRound = iTermScheduleRound;
+   }
+
    HistogramBucketBase * GetHistogramBucketBaseFast(size_t cBytesRequired);
 
    INLINE_ALWAYS HistogramBucketBase * GetHistogramBucketBaseFast() {
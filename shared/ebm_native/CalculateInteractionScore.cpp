@@ -140,7 +140,9 @@ static ErrorEbmType CalcInteractionStrengthInternal(
    pInteractionShell->SetHistogramBucketsEndDebugFast(aHistogramBucketsEndDebugFast);
 #endif // NDEBUG
 
+   const uint64_t timestampBinInteraction = PerfCounters::GetTimestamp();
    BinInteraction(pInteractionShell, pTerm);
+   pInteractionShell->GetPerfCounters()->Record(PerfCounter_BinInteraction, timestampBinInteraction);
 
    const size_t cAuxillaryBucketsForSplitting = 4;
    const size_t cAuxillaryBuckets =
@@ -192,6 +194,7 @@ static ErrorEbmType CalcInteractionStrengthInternal(
    HistogramBucketBase * pAuxiliaryBucketZone =
       GetHistogramBucketByIndex(cBytesPerHistogramBucketBig, aHistogramBucketsBig, cTotalBucketsMainSpace);
 
+   const uint64_t timestampTensorTotalsBuild = PerfCounters::GetTimestamp();
    TensorTotalsBuild(
       runtimeLearningTypeOrCountTargetClasses,
       pTerm,
@@ -202,10 +205,12 @@ static ErrorEbmType CalcInteractionStrengthInternal(
       , aHistogramBucketsEndDebugBig
 #endif // NDEBUG
    );
+   pInteractionShell->GetPerfCounters()->Record(PerfCounter_TensorTotalsBuild, timestampTensorTotalsBuild);
 
    if(2 == pTerm->GetCountSignificantDimensions()) {
       LOG_0(TraceLevelVerbose, "CalcInteractionStrengthInternal Starting bin sweep loop");
 
+      const uint64_t timestampPartitionTwoDimensionalInteraction = PerfCounters::GetTimestamp();
       double bestGain = PartitionTwoDimensionalInteraction(
          pInteractionCore,
          pTerm,
@@ -218,6 +223,7 @@ static ErrorEbmType CalcInteractionStrengthInternal(
          , aHistogramBucketsEndDebugBig
 #endif // NDEBUG
       );
+      pInteractionShell->GetPerfCounters()->Record(PerfCounter_CalculateInteractionScore, timestampPartitionTwoDimensionalInteraction);
 
       if(nullptr != pInteractionStrengthAvgOut) {
          // if totalWeight < 1 then bestGain could overflow to +inf, so do the division first
@@ -271,9 +277,8 @@ static ErrorEbmType CalcInteractionStrengthInternal(
    return Error_None;
 }
 
-// there is a race condition for decrementing this variable, but if a thread loses the 
-// race then it just doesn't get decremented as quickly, which we can live with
-static int g_cLogCalcInteractionStrengthParametersMessages = 10;
+// this is thread_local, so threads calculating interaction strengths at the same time each get their own count
+static thread_local int g_cLogCalcInteractionStrengthParametersMessages = 10;
 
 EBM_NATIVE_IMPORT_EXPORT_BODY ErrorEbmType EBM_NATIVE_CALLING_CONVENTION CalcInteractionStrength(
    InteractionHandle interactionHandle,
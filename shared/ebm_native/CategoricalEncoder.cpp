@@ -0,0 +1,559 @@
+// Copyright (c) 2018 Microsoft Corporation
+// Licensed under the MIT license.
+// Author: Paul Koch <code@koch.ninja>
+
+#include "precompiled_header_cpp.hpp"
+
+#include <stdlib.h> // free
+#include <stddef.h> // size_t, ptrdiff_t
+#include <string.h> // memcpy, memcmp
+#include <algorithm> // std::max
+
+#include "ebm_native.h"
+#include "logging.h"
+#include "zones.h"
+
+#include "ebm_internal.hpp"
+#include "CategoricalEncoder.hpp"
+
+namespace DEFINED_ZONE_NAME {
+#ifndef DEFINED_ZONE_NAME
+#error DEFINED_ZONE_NAME must be defined
+#endif // DEFINED_ZONE_NAME
+
+// we keep the table at most half full so that the expected probe length for an unknown string stays below 3
+constexpr static size_t k_cSlotsPerCategoryMin = 2;
+
+// returns the number of chars in item iItem, or ~size_t { 0 } if the offsets are illegal
+INLINE_ALWAYS static size_t GetStringLength(
+   const IntEbmType * const aOffsets,
+   const size_t iItem,
+   size_t * const piCharFirstOut
+) {
+   const IntEbmType offsetFirst = aOffsets[iItem];
+   const IntEbmType offsetLast = aOffsets[iItem + 1];
+   if(offsetFirst < IntEbmType { 0 } || offsetLast < offsetFirst || IsConvertError<size_t>(offsetLast)) {
+      return ~size_t { 0 };
+   }
+   *piCharFirstOut = static_cast<size_t>(offsetFirst);
+   return static_cast<size_t>(offsetLast - offsetFirst);
+}
+
+void CategoricalEncoder::Free(CategoricalEncoder * const pCategoricalEncoder) {
+   LOG_0(TraceLevelInfo, "Entered CategoricalEncoder::Free");
+
+   if(nullptr != pCategoricalEncoder) {
+      free(pCategoricalEncoder->m_aSlots);
+      free(pCategoricalEncoder->m_aChars);
+      // before we free our memory, indicate it was freed so if our higher level language attempts to use it we have
+      // a chance to detect the error
+      pCategoricalEncoder->m_handleVerification = k_handleVerificationFreed;
+      free(pCategoricalEncoder);
+   }
+
+   LOG_0(TraceLevelInfo, "Exited CategoricalEncoder::Free");
+}
+
+ErrorEbmType CategoricalEncoder::Create(
+   const size_t cCategories,
+   const IntEbmType * const aCategoryOffsets,
+   const char * const aCategoryChars,
+   const IntEbmType * const aCategoryBins,
+   CategoricalEncoder ** const ppCategoricalEncoderOut
+) {
+   EBM_ASSERT(nullptr != aCategoryOffsets);
+   EBM_ASSERT(nullptr != ppCategoricalEncoderOut);
+   EBM_ASSERT(nullptr == *ppCategoricalEncoderOut);
+
+   if(IsMultiplyError(k_cSlotsPerCategoryMin, cCategories)) {
+      LOG_0(TraceLevelWarning, "WARNING CategoricalEncoder::Create IsMultiplyError(k_cSlotsPerCategoryMin, cCategories)");
+      return Error_OutOfMemory;
+   }
+   size_t cSlots = 1;
+   while(cSlots < cCategories * k_cSlotsPerCategoryMin) {
+      if(IsMultiplyError(size_t { 2 }, cSlots)) {
+         LOG_0(TraceLevelWarning, "WARNING CategoricalEncoder::Create IsMultiplyError(size_t { 2 }, cSlots)");
+         return Error_OutOfMemory;
+      }
+      cSlots <<= 1;
+   }
+
+   const IntEbmType offsetEnd = aCategoryOffsets[cCategories];
+   if(offsetEnd < IntEbmType { 0 } || IsConvertError<size_t>(offsetEnd)) {
+      LOG_0(TraceLevelError, "ERROR CategoricalEncoder::Create categoryOffsets has an illegal end offset");
+      return Error_IllegalParamValue;
+   }
+   const size_t cChars = static_cast<size_t>(offsetEnd);
+   if(size_t { 0 } != cChars && nullptr == aCategoryChars) {
+      LOG_0(TraceLevelError, "ERROR CategoricalEncoder::Create categoryChars cannot be null");
+      return Error_IllegalParamValue;
+   }
+
+   CategoricalEncoder * const pCategoricalEncoder = EbmMalloc<CategoricalEncoder>();
+   if(nullptr == pCategoricalEncoder) {
+      LOG_0(TraceLevelWarning, "WARNING CategoricalEncoder::Create nullptr == pCategoricalEncoder");
+      return Error_OutOfMemory;
+   }
+   pCategoricalEncoder->InitializeUnfailing();
+
+   CategoricalSlot * const aSlots = EbmMalloc<CategoricalSlot>(cSlots);
+   if(nullptr == aSlots) {
+      LOG_0(TraceLevelWarning, "WARNING CategoricalEncoder::Create nullptr == aSlots");
+      CategoricalEncoder::Free(pCategoricalEncoder);
+      return Error_OutOfMemory;
+   }
+   pCategoricalEncoder->m_aSlots = aSlots;
+   pCategoricalEncoder->m_maskSlots = cSlots - 1;
+
+   // malloc of zero bytes is allowed to return nullptr, so always allocate at least one char
+   char * const aChars = EbmMalloc<char>(size_t { 0 } == cChars ? size_t { 1 } : cChars);
+   if(nullptr == aChars) {
+      LOG_0(TraceLevelWarning, "WARNING CategoricalEncoder::Create nullptr == aChars");
+      CategoricalEncoder::Free(pCategoricalEncoder);
+      return Error_OutOfMemory;
+   }
+   pCategoricalEncoder->m_aChars = aChars;
+   if(size_t { 0 } != cChars) {
+      memcpy(aChars, aCategoryChars, cChars);
+   }
+
+   const CategoricalSlot * const pSlotsEnd = aSlots + cSlots;
+   CategoricalSlot * pSlotInit = aSlots;
+   do {
+      pSlotInit->m_iCharFirst = k_emptySlot;
+      ++pSlotInit;
+   } while(pSlotsEnd != pSlotInit);
+
+   for(size_t iCategory = 0; iCategory < cCategories; ++iCategory) {
+      size_t iCharFirst;
+      const size_t cCategoryChars = GetStringLength(aCategoryOffsets, iCategory, &iCharFirst);
+      if(~size_t { 0 } == cCategoryChars || cChars < iCharFirst + cCategoryChars) {
+         LOG_0(TraceLevelError, "ERROR CategoricalEncoder::Create categoryOffsets are illegal");
+         CategoricalEncoder::Free(pCategoricalEncoder);
+         return Error_IllegalParamValue;
+      }
+      const IntEbmType bin = aCategoryBins[iCategory];
+      if(bin <= IntEbmType { 0 }) {
+         LOG_0(TraceLevelError, "ERROR CategoricalEncoder::Create categoryBins must be positive");
+         CategoricalEncoder::Free(pCategoricalEncoder);
+         return Error_IllegalParamValue;
+      }
+
+      const char * const pChars = &aChars[iCharFirst];
+      if(nullptr != pCategoricalEncoder->Find(pChars, cCategoryChars)) {
+         LOG_0(TraceLevelError, "ERROR CategoricalEncoder::Create duplicate category");
+         CategoricalEncoder::Free(pCategoricalEncoder);
+         return Error_IllegalParamValue;
+      }
+
+      const uint64_t hash = Hash(pChars, cCategoryChars);
+      size_t iSlot = static_cast<size_t>(hash) & pCategoricalEncoder->m_maskSlots;
+      while(k_emptySlot != aSlots[iSlot].m_iCharFirst) {
+         iSlot = (iSlot + 1) & pCategoricalEncoder->m_maskSlots;
+      }
+      CategoricalSlot * const pSlot = &aSlots[iSlot];
+      pSlot->m_hash = hash;
+      pSlot->m_iCharFirst = iCharFirst;
+      pSlot->m_cChars = cCategoryChars;
+      pSlot->m_bin = bin;
+   }
+
+   *ppCategoricalEncoderOut = pCategoricalEncoder;
+   return Error_None;
+}
+
+ErrorEbmType CategoricalEncoder::Encode(
+   const size_t cSamples,
+   const IntEbmType * const aOffsets,
+   const char * const aChars,
+   const uint8_t * const aValidityBitmap,
+   IntEbmType * const aBinnedOut,
+   size_t * const pcUnknownsOut
+) const {
+   EBM_ASSERT(nullptr != aOffsets);
+   EBM_ASSERT(nullptr != aBinnedOut);
+   EBM_ASSERT(nullptr != pcUnknownsOut);
+
+   size_t cUnknowns = 0;
+   for(size_t iSample = 0; iSample < cSamples; ++iSample) {
+      if(nullptr != aValidityBitmap && 0 == ((aValidityBitmap[iSample >> 3] >> (iSample & size_t { 7 })) & 1)) {
+         aBinnedOut[iSample] = IntEbmType { 0 };
+         continue;
+      }
+      size_t iCharFirst;
+      const size_t cChars = GetStringLength(aOffsets, iSample, &iCharFirst);
+      if(~size_t { 0 } == cChars || (size_t { 0 } != cChars && nullptr == aChars)) {
+         LOG_0(TraceLevelError, "ERROR CategoricalEncoder::Encode offsets are illegal");
+         return Error_IllegalParamValue;
+      }
+      const CategoricalSlot * const pSlot = Find(size_t { 0 } == cChars ? m_aChars : &aChars[iCharFirst], cChars);
+      if(nullptr == pSlot) {
+         ++cUnknowns;
+         aBinnedOut[iSample] = IntEbmType { -1 };
+      } else {
+         aBinnedOut[iSample] = pSlot->m_bin;
+      }
+   }
+   *pcUnknownsOut = cUnknowns;
+   return Error_None;
+}
+
+EBM_NATIVE_IMPORT_EXPORT_BODY ErrorEbmType EBM_NATIVE_CALLING_CONVENTION CreateCategoricalEncoder(
+   IntEbmType countCategories,
+   const IntEbmType * categoryOffsets,
+   const char * categoryChars,
+   const IntEbmType * categoryBins,
+   CategoricalEncoderHandle * categoricalEncoderHandleOut
+) {
+   LOG_N(
+      TraceLevelInfo,
+      "Entered CreateCategoricalEncoder: "
+      "countCategories=%" IntEbmTypePrintf ", "
+      "categoryOffsets=%p, "
+      "categoryChars=%p, "
+      "categoryBins=%p, "
+      "categoricalEncoderHandleOut=%p"
+      ,
+      countCategories,
+      static_cast<const void *>(categoryOffsets),
+      static_cast<const void *>(categoryChars),
+      static_cast<const void *>(categoryBins),
+      static_cast<const void *>(categoricalEncoderHandleOut)
+   );
+
+   if(nullptr == categoricalEncoderHandleOut) {
+      LOG_0(TraceLevelError, "ERROR CreateCategoricalEncoder nullptr == categoricalEncoderHandleOut");
+      return Error_IllegalParamValue;
+   }
+   *categoricalEncoderHandleOut = nullptr; // set this to nullptr as soon as possible so the caller doesn't attempt to free it
+
+   if(countCategories < IntEbmType { 0 }) {
+      LOG_0(TraceLevelError, "ERROR CreateCategoricalEncoder countCategories must be positive");
+      return Error_IllegalParamValue;
+   }
+   if(IsConvertError<size_t>(countCategories)) {
+      LOG_0(TraceLevelError, "ERROR CreateCategoricalEncoder IsConvertError<size_t>(countCategories)");
+      return Error_IllegalParamValue;
+   }
+   const size_t cCategories = static_cast<size_t>(countCategories);
+   if(nullptr == categoryOffsets) {
+      LOG_0(TraceLevelError, "ERROR CreateCategoricalEncoder nullptr == categoryOffsets");
+      return Error_IllegalParamValue;
+   }
+   if(size_t { 0 } != cCategories && nullptr == categoryBins) {
+      LOG_0(TraceLevelError, "ERROR CreateCategoricalEncoder nullptr == categoryBins");
+      return Error_IllegalParamValue;
+   }
+
+   CategoricalEncoder * pCategoricalEncoder = nullptr;
+   const ErrorEbmType error = CategoricalEncoder::Create(
+      cCategories,
+      categoryOffsets,
+      categoryChars,
+      categoryBins,
+      &pCategoricalEncoder
+   );
+   if(Error_None != error) {
+      // already logged
+      return error;
+   }
+
+   const CategoricalEncoderHandle handle = pCategoricalEncoder->GetHandle();
+   *categoricalEncoderHandleOut = handle;
+
+   LOG_N(TraceLevelInfo, "Exited CreateCategoricalEncoder: *categoricalEncoderHandleOut=%p", static_cast<void *>(handle));
+   return Error_None;
+}
+
+static thread_local int g_cLogEnterEncodeCategoricalParametersMessages = 25;
+static thread_local int g_cLogExitEncodeCategoricalParametersMessages = 25;
+
+EBM_NATIVE_IMPORT_EXPORT_BODY ErrorEbmType EBM_NATIVE_CALLING_CONVENTION EncodeCategorical(
+   CategoricalEncoderHandle categoricalEncoderHandle,
+   IntEbmType countSamples,
+   const IntEbmType * offsets,
+   const char * chars,
+   const uint8_t * validityBitmap,
+   IntEbmType * binnedOut,
+   IntEbmType * countUnknownsOut
+) {
+   LOG_COUNTED_N(
+      &g_cLogEnterEncodeCategoricalParametersMessages,
+      TraceLevelInfo,
+      TraceLevelVerbose,
+      "Entered EncodeCategorical: "
+      "categoricalEncoderHandle=%p, "
+      "countSamples=%" IntEbmTypePrintf ", "
+      "offsets=%p, "
+      "chars=%p, "
+      "validityBitmap=%p, "
+      "binnedOut=%p, "
+      "countUnknownsOut=%p"
+      ,
+      static_cast<void *>(categoricalEncoderHandle),
+      countSamples,
+      static_cast<const void *>(offsets),
+      static_cast<const void *>(chars),
+      static_cast<const void *>(validityBitmap),
+      static_cast<void *>(binnedOut),
+      static_cast<void *>(countUnknownsOut)
+   );
+
+   if(nullptr != countUnknownsOut) {
+      *countUnknownsOut = IntEbmType { 0 };
+   }
+
+   const CategoricalEncoder * const pCategoricalEncoder =
+      CategoricalEncoder::GetCategoricalEncoderFromHandle(categoricalEncoderHandle);
+   if(nullptr == pCategoricalEncoder) {
+      // already logged
+      return Error_IllegalParamValue;
+   }
+
+   if(countSamples < IntEbmType { 0 }) {
+      LOG_0(TraceLevelError, "ERROR EncodeCategorical countSamples must be positive");
+      return Error_IllegalParamValue;
+   }
+   if(IsConvertError<size_t>(countSamples)) {
+      LOG_0(TraceLevelError, "ERROR EncodeCategorical IsConvertError<size_t>(countSamples)");
+      return Error_IllegalParamValue;
+   }
+   const size_t cSamples = static_cast<size_t>(countSamples);
+   if(size_t { 0 } == cSamples) {
+      LOG_0(TraceLevelInfo, "INFO EncodeCategorical size_t { 0 } == cSamples");
+      return Error_None;
+   }
+   if(nullptr == offsets) {
+      LOG_0(TraceLevelError, "ERROR EncodeCategorical nullptr == offsets");
+      return Error_IllegalParamValue;
+   }
+   if(nullptr == binnedOut) {
+      LOG_0(TraceLevelError, "ERROR EncodeCategorical nullptr == binnedOut");
+      return Error_IllegalParamValue;
+   }
+
+   size_t cUnknowns;
+   const ErrorEbmType error = pCategoricalEncoder->Encode(
+      cSamples,
+      offsets,
+      chars,
+      validityBitmap,
+      binnedOut,
+      &cUnknowns
+   );
+   if(Error_None != error) {
+      // already logged
+      return error;
+   }
+
+   if(nullptr != countUnknownsOut) {
+      // cUnknowns <= cSamples, and cSamples came from an IntEbmType
+      *countUnknownsOut = static_cast<IntEbmType>(cUnknowns);
+   }
+
+   LOG_COUNTED_0(
+      &g_cLogExitEncodeCategoricalParametersMessages,
+      TraceLevelInfo,
+      TraceLevelVerbose,
+      "Exited EncodeCategorical"
+   );
+   return Error_None;
+}
+
+template<typename TIndex>
+static bool MapDictionaryIndexes(
+   const size_t cDictionary,
+   const IntEbmType * const aDictionaryBins,
+   const size_t cSamples,
+   const void * const indexes,
+   const uint8_t * const aValidityBitmap,
+   IntEbmType * const aBinnedOut,
+   size_t * const pcUnknownsOut
+) {
+   const TIndex * const aIndexes = static_cast<const TIndex *>(indexes);
+   size_t cUnknowns = 0;
+   for(size_t iSample = 0; iSample < cSamples; ++iSample) {
+      if(nullptr != aValidityBitmap && 0 == ((aValidityBitmap[iSample >> 3] >> (iSample & size_t { 7 })) & 1)) {
+         aBinnedOut[iSample] = IntEbmType { 0 };
+         continue;
+      }
+      const TIndex iDictionary = aIndexes[iSample];
+      if(iDictionary < TIndex { 0 } || cDictionary <= static_cast<size_t>(iDictionary)) {
+         return true;
+      }
+      const IntEbmType bin = aDictionaryBins[static_cast<size_t>(iDictionary)];
+      cUnknowns += bin < IntEbmType { 0 } ? size_t { 1 } : size_t { 0 };
+      aBinnedOut[iSample] = bin;
+   }
+   *pcUnknownsOut = cUnknowns;
+   return false;
+}
+
+EBM_NATIVE_IMPORT_EXPORT_BODY ErrorEbmType EBM_NATIVE_CALLING_CONVENTION EncodeCategoricalDictionary(
+   CategoricalEncoderHandle categoricalEncoderHandle,
+   IntEbmType countDictionary,
+   const IntEbmType * dictionaryOffsets,
+   const char * dictionaryChars,
+   IntEbmType countSamples,
+   IntEbmType indexBytes,
+   const void * indexes,
+   const uint8_t * validityBitmap,
+   IntEbmType * binnedOut,
+   IntEbmType * countUnknownsOut
+) {
+   LOG_COUNTED_N(
+      &g_cLogEnterEncodeCategoricalParametersMessages,
+      TraceLevelInfo,
+      TraceLevelVerbose,
+      "Entered EncodeCategoricalDictionary: "
+      "categoricalEncoderHandle=%p, "
+      "countDictionary=%" IntEbmTypePrintf ", "
+      "dictionaryOffsets=%p, "
+      "dictionaryChars=%p, "
+      "countSamples=%" IntEbmTypePrintf ", "
+      "indexBytes=%" IntEbmTypePrintf ", "
+      "indexes=%p, "
+      "validityBitmap=%p, "
+      "binnedOut=%p, "
+      "countUnknownsOut=%p"
+      ,
+      static_cast<void *>(categoricalEncoderHandle),
+      countDictionary,
+      static_cast<const void *>(dictionaryOffsets),
+      static_cast<const void *>(dictionaryChars),
+      countSamples,
+      indexBytes,
+      indexes,
+      static_cast<const void *>(validityBitmap),
+      static_cast<void *>(binnedOut),
+      static_cast<void *>(countUnknownsOut)
+   );
+
+   if(nullptr != countUnknownsOut) {
+      *countUnknownsOut = IntEbmType { 0 };
+   }
+
+   const CategoricalEncoder * const pCategoricalEncoder =
+      CategoricalEncoder::GetCategoricalEncoderFromHandle(categoricalEncoderHandle);
+   if(nullptr == pCategoricalEncoder) {
+      // already logged
+      return Error_IllegalParamValue;
+   }
+
+   if(countDictionary < IntEbmType { 0 } || IsConvertError<size_t>(countDictionary)) {
+      LOG_0(TraceLevelError, "ERROR EncodeCategoricalDictionary countDictionary must be positive");
+      return Error_IllegalParamValue;
+   }
+   const size_t cDictionary = static_cast<size_t>(countDictionary);
+
+   if(countSamples < IntEbmType { 0 } || IsConvertError<size_t>(countSamples)) {
+      LOG_0(TraceLevelError, "ERROR EncodeCategoricalDictionary countSamples must be positive");
+      return Error_IllegalParamValue;
+   }
+   const size_t cSamples = static_cast<size_t>(countSamples);
+   if(size_t { 0 } == cSamples) {
+      LOG_0(TraceLevelInfo, "INFO EncodeCategoricalDictionary size_t { 0 } == cSamples");
+      return Error_None;
+   }
+   if(nullptr == dictionaryOffsets) {
+      LOG_0(TraceLevelError, "ERROR EncodeCategoricalDictionary nullptr == dictionaryOffsets");
+      return Error_IllegalParamValue;
+   }
+   if(nullptr == indexes) {
+      LOG_0(TraceLevelError, "ERROR EncodeCategoricalDictionary nullptr == indexes");
+      return Error_IllegalParamValue;
+   }
+   if(nullptr == binnedOut) {
+      LOG_0(TraceLevelError, "ERROR EncodeCategoricalDictionary nullptr == binnedOut");
+      return Error_IllegalParamValue;
+   }
+   if(IntEbmType { 1 } != indexBytes && IntEbmType { 2 } != indexBytes && IntEbmType { 4 } != indexBytes &&
+      IntEbmType { 8 } != indexBytes)
+   {
+      LOG_0(TraceLevelError, "ERROR EncodeCategoricalDictionary indexBytes must be 1, 2, 4 or 8");
+      return Error_IllegalParamValue;
+   }
+
+   // the dictionary is usually far smaller than the column, so each distinct string is hashed only once
+   IntEbmType * const aDictionaryBins = EbmMalloc<IntEbmType>(std::max(cDictionary, size_t { 1 }));
+   if(nullptr == aDictionaryBins) {
+      LOG_0(TraceLevelWarning, "WARNING EncodeCategoricalDictionary nullptr == aDictionaryBins");
+      return Error_OutOfMemory;
+   }
+
+   size_t cUnknowns;
+   ErrorEbmType error = pCategoricalEncoder->Encode(
+      cDictionary,
+      dictionaryOffsets,
+      dictionaryChars,
+      nullptr,
+      aDictionaryBins,
+      &cUnknowns
+   );
+   if(Error_None == error) {
+      bool bBadIndex;
+      switch(indexBytes) {
+      case 1:
+         bBadIndex = MapDictionaryIndexes<int8_t>(cDictionary, aDictionaryBins, cSamples, indexes, validityBitmap,
+            binnedOut, &cUnknowns);
+         break;
+      case 2:
+         bBadIndex = MapDictionaryIndexes<int16_t>(cDictionary, aDictionaryBins, cSamples, indexes, validityBitmap,
+            binnedOut, &cUnknowns);
+         break;
+      case 4:
+         bBadIndex = MapDictionaryIndexes<int32_t>(cDictionary, aDictionaryBins, cSamples, indexes, validityBitmap,
+            binnedOut, &cUnknowns);
+         break;
+      default:
+         EBM_ASSERT(IntEbmType { 8 } == indexBytes);
+         bBadIndex = MapDictionaryIndexes<int64_t>(cDictionary, aDictionaryBins, cSamples, indexes, validityBitmap,
+            binnedOut, &cUnknowns);
+         break;
+      }
+      if(bBadIndex) {
+         LOG_0(TraceLevelError, "ERROR EncodeCategoricalDictionary indexes contains an index outside the dictionary");
+         error = Error_IllegalParamValue;
+      }
+   }
+   free(aDictionaryBins);
+   if(Error_None != error) {
+      // already logged
+      return error;
+   }
+
+   if(nullptr != countUnknownsOut) {
+      // cUnknowns <= cSamples, and cSamples came from an IntEbmType
+      *countUnknownsOut = static_cast<IntEbmType>(cUnknowns);
+   }
+
+   LOG_COUNTED_0(
+      &g_cLogExitEncodeCategoricalParametersMessages,
+      TraceLevelInfo,
+      TraceLevelVerbose,
+      "Exited EncodeCategoricalDictionary"
+   );
+   return Error_None;
+}
+
+EBM_NATIVE_IMPORT_EXPORT_BODY void EBM_NATIVE_CALLING_CONVENTION FreeCategoricalEncoder(
+   CategoricalEncoderHandle categoricalEncoderHandle
+) {
+   LOG_N(
+      TraceLevelInfo,
+      "Entered FreeCategoricalEncoder: categoricalEncoderHandle=%p",
+      static_cast<void *>(categoricalEncoderHandle)
+   );
+
+   CategoricalEncoder * const pCategoricalEncoder =
+      CategoricalEncoder::GetCategoricalEncoderFromHandle(categoricalEncoderHandle);
+   // if the conversion above doesn't work, it'll return null, and our free will not in fact free any memory,
+   // but it will not crash. We'll leak memory, but at least we'll log that.
+
+   // it's legal to call free on nullptr, just like for free().  This is checked inside CategoricalEncoder::Free()
+   CategoricalEncoder::Free(pCategoricalEncoder);
+
+   LOG_0(TraceLevelInfo, "Exited FreeCategoricalEncoder");
+}
+
+} // DEFINED_ZONE_NAME
@@ -0,0 +1,142 @@
+// Copyright (c) 2018 Microsoft Corporation
+// Licensed under the MIT license.
+// Author: Paul Koch <code@koch.ninja>
+
+#ifndef CATEGORICAL_ENCODER_HPP
+#define CATEGORICAL_ENCODER_HPP
+
+#include <inttypes.h> // uint64_t
+#include <stddef.h> // size_t, ptrdiff_t
+#include <string.h> // memcmp
+
+#include "ebm_native.h"
+#include "logging.h"
+#include "zones.h"
+
+#include "ebm_internal.hpp"
+
+namespace DEFINED_ZONE_NAME {
+#ifndef DEFINED_ZONE_NAME
+#error DEFINED_ZONE_NAME must be defined
+#endif // DEFINED_ZONE_NAME
+
+struct CategoricalSlot final {
+   uint64_t m_hash;
+   size_t m_iCharFirst; // k_emptySlot if the slot is unused
+   size_t m_cChars;
+   IntEbmType m_bin;
+};
+static_assert(std::is_standard_layout<CategoricalSlot>::value,
+   "We use the struct hack in several places, so disallow non-standard_layout types in general");
+static_assert(std::is_trivial<CategoricalSlot>::value,
+   "We use memcpy in several places, so disallow non-trivial types in general");
+
+// CategoricalEncoder is an open addressing hash map from the UTF-8 bytes of each fitted category to its bin.  We
+// use linear probing and keep the table at most half full, so unknown categories are found to be missing after a
+// short probe, which matters for high cardinality columns where many of the values seen at predict time are new.
+class CategoricalEncoder final {
+   static constexpr size_t k_handleVerificationOk = 21821; // random 15 bit number
+   static constexpr size_t k_handleVerificationFreed = 21825; // random 15 bit number
+   size_t m_handleVerification; // this needs to be at the top and make it pointer sized to keep best alignment
+
+   size_t m_maskSlots;
+   CategoricalSlot * m_aSlots;
+   char * m_aChars;
+
+   INLINE_ALWAYS static uint64_t Hash(const char * const pChars, const size_t cChars) {
+      // FNV-1a is simple and fast for the short strings that categories usually are
+      uint64_t hash = uint64_t { 14695981039346656037u };
+      const unsigned char * pChar = reinterpret_cast<const unsigned char *>(pChars);
+      const unsigned char * const pCharsEnd = pChar + cChars;
+      while(pCharsEnd != pChar) {
+         hash ^= static_cast<uint64_t>(*pChar);
+         hash *= uint64_t { 1099511628211u };
+         ++pChar;
+      }
+      return hash;
+   }
+
+public:
+
+   constexpr static size_t k_emptySlot = ~size_t { 0 };
+
+   CategoricalEncoder() = default; // preserve our POD status
+   ~CategoricalEncoder() = default; // preserve our POD status
+   void * operator new(std::size_t) = delete; // we only use malloc/free in this library
+   void operator delete (void *) = delete; // we only use malloc/free in this library
+
+   INLINE_ALWAYS void InitializeUnfailing() {
+      m_handleVerification = k_handleVerificationOk;
+      m_maskSlots = 0;
+      m_aSlots = nullptr;
+      m_aChars = nullptr;
+   }
+
+   static void Free(CategoricalEncoder * const pCategoricalEncoder);
+   static ErrorEbmType Create(
+      const size_t cCategories,
+      const IntEbmType * const aCategoryOffsets,
+      const char * const aCategoryChars,
+      const IntEbmType * const aCategoryBins,
+      CategoricalEncoder ** const ppCategoricalEncoderOut
+   );
+
+   ErrorEbmType Encode(
+      const size_t cSamples,
+      const IntEbmType * const aOffsets,
+      const char * const aChars,
+      const uint8_t * const aValidityBitmap,
+      IntEbmType * const aBinnedOut,
+      size_t * const pcUnknownsOut
+   ) const;
+
+   static INLINE_ALWAYS CategoricalEncoder * GetCategoricalEncoderFromHandle(
+      const CategoricalEncoderHandle categoricalEncoderHandle
+   ) {
+      if(nullptr == categoricalEncoderHandle) {
+         LOG_0(TraceLevelError, "ERROR GetCategoricalEncoderFromHandle null categoricalEncoderHandle");
+         return nullptr;
+      }
+      CategoricalEncoder * const pCategoricalEncoder = reinterpret_cast<CategoricalEncoder *>(categoricalEncoderHandle);
+      if(k_handleVerificationOk == pCategoricalEncoder->m_handleVerification) {
+         return pCategoricalEncoder;
+      }
+      if(k_handleVerificationFreed == pCategoricalEncoder->m_handleVerification) {
+         LOG_0(TraceLevelError, "ERROR GetCategoricalEncoderFromHandle attempt to use freed CategoricalEncoderHandle");
+      } else {
+         LOG_0(TraceLevelError, "ERROR GetCategoricalEncoderFromHandle attempt to use invalid CategoricalEncoderHandle");
+      }
+      return nullptr;
+   }
+   INLINE_ALWAYS CategoricalEncoderHandle GetHandle() {
+      return reinterpret_cast<CategoricalEncoderHandle>(this);
+   }
+
+   INLINE_ALWAYS const CategoricalSlot * Find(const char * const pChars, const size_t cChars) const {
+      EBM_ASSERT(nullptr != m_aSlots);
+      const uint64_t hash = Hash(pChars, cChars);
+      size_t iSlot = static_cast<size_t>(hash) & m_maskSlots;
+      while(true) {
+         const CategoricalSlot * const pSlot = &m_aSlots[iSlot];
+         if(k_emptySlot == pSlot->m_iCharFirst) {
+            return nullptr;
+         }
+         if(hash == pSlot->m_hash && cChars == pSlot->m_cChars &&
+            0 == memcmp(&m_aChars[pSlot->m_iCharFirst], pChars, cChars))
+         {
+            return pSlot;
+         }
+         iSlot = (iSlot + 1) & m_maskSlots;
+      }
+   }
+};
+static_assert(std::is_standard_layout<CategoricalEncoder>::value,
+   "We use the struct hack in several places, so disallow non-standard_layout types in general");
+static_assert(std::is_trivial<CategoricalEncoder>::value,
+   "We use memcpy in several places, so disallow non-trivial types in general");
+static_assert(std::is_pod<CategoricalEncoder>::value,
+   "We use a lot of C constructs, so disallow non-POD types in general");
+
+} // DEFINED_ZONE_NAME
+
+#endif // CATEGORICAL_ENCODER_HPP
@@ -0,0 +1,557 @@
+// Copyright (c) 2018 Microsoft Corporation
+// Licensed under the MIT license.
+// Author: Paul Koch <code@koch.ninja>
+
+#include "precompiled_header_cpp.hpp"
+
+#include <stdlib.h> // free
+#include <stddef.h> // size_t, ptrdiff_t
+#include <algorithm> // std::max
+#include <cmath> // std::sqrt, std::isfinite
+
+#include "ebm_native.h"
+#include "logging.h"
+#include "zones.h"
+
+#include "ebm_internal.hpp"
+
+namespace DEFINED_ZONE_NAME {
+#ifndef DEFINED_ZONE_NAME
+#error DEFINED_ZONE_NAME must be defined
+#endif // DEFINED_ZONE_NAME
+
+// Changing one feature of an additive model only changes the terms that contain it, so both the permutation and the
+// partial dependence routines below keep just those terms, and for each dimension of the feature they read the bin
+// from m_aReplaceData instead of the sample's own bin
+struct EffectDimension final {
+   const IntEbmType * m_aBinnedData;
+   const IntEbmType * m_aReplaceData;
+   size_t m_cBins;
+};
+static_assert(std::is_standard_layout<EffectDimension>::value,
+   "We use the struct hack in several places, so disallow non-standard_layout types in general");
+static_assert(std::is_trivial<EffectDimension>::value,
+   "We use memcpy in several places, so disallow non-trivial types in general");
+
+struct EffectTerm final {
+   size_t m_cDimensions;
+   const EffectDimension * m_aDimensions;
+   const double * m_aTermScores;
+};
+static_assert(std::is_standard_layout<EffectTerm>::value,
+   "We use the struct hack in several places, so disallow non-standard_layout types in general");
+static_assert(std::is_trivial<EffectTerm>::value,
+   "We use memcpy in several places, so disallow non-trivial types in general");
+
+// the tensor layout is the python one, which puts the first dimension in the highest stride.  If aReplaceData is
+// null the sample's own bins are used, otherwise the feature's dimensions take their bin from iReplace
+static bool GetTensorBin(
+   const EffectTerm * const pTerm,
+   const size_t iSample,
+   const bool bReplace,
+   const size_t iReplace,
+   size_t * const piTensorBinOut
+) {
+   size_t iTensorBin = 0;
+   const EffectDimension * const aDimensions = pTerm->m_aDimensions;
+   for(size_t iDimension = 0; iDimension < pTerm->m_cDimensions; ++iDimension) {
+      const EffectDimension * const pDimension = &aDimensions[iDimension];
+      const size_t cBins = pDimension->m_cBins;
+      IntEbmType iBin = bReplace && nullptr != pDimension->m_aReplaceData ?
+         pDimension->m_aReplaceData[iReplace] : pDimension->m_aBinnedData[iSample];
+      if(iBin < IntEbmType { 0 }) {
+         // like python, negative indexes count from the end.  -1 is the unknown bin
+         iBin += static_cast<IntEbmType>(cBins);
+      }
+      if(iBin < IntEbmType { 0 } || static_cast<IntEbmType>(cBins) <= iBin) {
+         return true;
+      }
+      iTensorBin = iTensorBin * cBins + static_cast<size_t>(iBin);
+   }
+   *piTensorBinOut = iTensorBin;
+   return false;
+}
+
+// fills aTerms with the terms that contain feature, and returns the number of them in pcTermsOut.  aReplaceData holds
+// one row of cReplace bins for each dimension, in the same order as binnedData
+static ErrorEbmType BuildEffectTerms(
+   const size_t cSamples,
+   const size_t cScores,
+   const size_t cTerms,
+   const IntEbmType * const dimensionCounts,
+   const IntEbmType * const binCounts,
+   const IntEbmType * const dimensionFeatures,
+   const IntEbmType * const binnedData,
+   const double * const termScores,
+   const IntEbmType feature,
+   const IntEbmType * const aReplaceData,
+   const size_t cReplace,
+   EffectTerm * const aTerms,
+   EffectDimension * const aDimensions,
+   size_t * const pcTermsOut
+) {
+   size_t cEffectTerms = 0;
+   EffectDimension * pDimension = aDimensions;
+   const double * pTermScores = termScores;
+   const IntEbmType * pBinCount = binCounts;
+   const IntEbmType * pDimensionFeature = dimensionFeatures;
+   const IntEbmType * pBinnedData = binnedData;
+   const IntEbmType * pReplaceData = aReplaceData;
+   for(size_t iTerm = 0; iTerm < cTerms; ++iTerm) {
+      const size_t cDimensions = static_cast<size_t>(dimensionCounts[iTerm]);
+      EffectDimension * const aTermDimensions = pDimension;
+
+      bool bContainsFeature = false;
+      size_t cTensorBins = 1;
+      for(size_t iDimension = 0; iDimension < cDimensions; ++iDimension) {
+         const IntEbmType countBins = *pBinCount;
+         ++pBinCount;
+         if(countBins <= IntEbmType { 0 } || IsConvertError<size_t>(countBins)) {
+            LOG_0(TraceLevelError, "ERROR BuildEffectTerms binCounts contains an illegal value");
+            return Error_IllegalParamValue;
+         }
+         const size_t cBins = static_cast<size_t>(countBins);
+         if(IsMultiplyError(cTensorBins, cBins)) {
+            LOG_0(TraceLevelError, "ERROR BuildEffectTerms IsMultiplyError(cTensorBins, cBins)");
+            return Error_IllegalParamValue;
+         }
+         cTensorBins *= cBins;
+
+         const bool bFeature = feature == *pDimensionFeature;
+         ++pDimensionFeature;
+         bContainsFeature = bContainsFeature || bFeature;
+
+         pDimension->m_aBinnedData = pBinnedData;
+         pDimension->m_aReplaceData = bFeature ? pReplaceData : nullptr;
+         pDimension->m_cBins = cBins;
+         pBinnedData += cSamples;
+         pReplaceData += cReplace;
+         ++pDimension;
+      }
+      if(IsMultiplyError(cScores, cTensorBins)) {
+         LOG_0(TraceLevelError, "ERROR BuildEffectTerms IsMultiplyError(cScores, cTensorBins)");
+         return Error_IllegalParamValue;
+      }
+
+      if(bContainsFeature) {
+         EffectTerm * const pTerm = &aTerms[cEffectTerms];
+         pTerm->m_cDimensions = cDimensions;
+         pTerm->m_aDimensions = aTermDimensions;
+         pTerm->m_aTermScores = pTermScores;
+         ++cEffectTerms;
+      }
+      pTermScores += cScores * cTensorBins;
+   }
+   *pcTermsOut = cEffectTerms;
+   return Error_None;
+}
+
+static ErrorEbmType CheckEffectParams(
+   const IntEbmType countSamples,
+   const IntEbmType countScores,
+   const IntEbmType countTerms,
+   const IntEbmType * const dimensionCounts,
+   const IntEbmType * const binCounts,
+   const IntEbmType * const dimensionFeatures,
+   const IntEbmType * const binnedData,
+   const double * const termScores,
+   const double * const sampleScores,
+   size_t * const pcDimensionsTotalOut
+) {
+   if(countSamples < IntEbmType { 0 } || IsConvertError<size_t>(countSamples)) {
+      LOG_0(TraceLevelError, "ERROR CheckEffectParams countSamples must be positive");
+      return Error_IllegalParamValue;
+   }
+   if(countScores <= IntEbmType { 0 } || IsConvertError<size_t>(countScores)) {
+      LOG_0(TraceLevelError, "ERROR CheckEffectParams countScores must be 1 or more");
+      return Error_IllegalParamValue;
+   }
+   if(countTerms < IntEbmType { 0 } || IsConvertError<size_t>(countTerms)) {
+      LOG_0(TraceLevelError, "ERROR CheckEffectParams countTerms must be positive");
+      return Error_IllegalParamValue;
+   }
+   const size_t cTerms = static_cast<size_t>(countTerms);
+   if(size_t { 0 } != cTerms && (nullptr == dimensionCounts || nullptr == termScores)) {
+      LOG_0(TraceLevelError, "ERROR CheckEffectParams dimensionCounts/termScores cannot be null");
+      return Error_IllegalParamValue;
+   }
+   if(IntEbmType { 0 } != countSamples && nullptr == sampleScores) {
+      LOG_0(TraceLevelError, "ERROR CheckEffectParams nullptr == sampleScores");
+      return Error_IllegalParamValue;
+   }
+   if(IsMultiplyError(sizeof(double), static_cast<size_t>(countSamples), static_cast<size_t>(countScores))) {
+      LOG_0(TraceLevelError, "ERROR CheckEffectParams IsMultiplyError(sizeof(double), cSamples, cScores)");
+      return Error_IllegalParamValue;
+   }
+
+   size_t cDimensionsTotal = 0;
+   for(size_t iTerm = 0; iTerm < cTerms; ++iTerm) {
+      const IntEbmType countDimensions = dimensionCounts[iTerm];
+      if(countDimensions < IntEbmType { 0 } || IsConvertError<size_t>(countDimensions)) {
+         LOG_0(TraceLevelError, "ERROR CheckEffectParams dimensionCounts contains an illegal value");
+         return Error_IllegalParamValue;
+      }
+      if(IsAddError(cDimensionsTotal, static_cast<size_t>(countDimensions))) {
+         LOG_0(TraceLevelError, "ERROR CheckEffectParams IsAddError(cDimensionsTotal, countDimensions)");
+         return Error_IllegalParamValue;
+      }
+      cDimensionsTotal += static_cast<size_t>(countDimensions);
+   }
+   if(size_t { 0 } != cDimensionsTotal && (nullptr == binCounts || nullptr == dimensionFeatures || nullptr == binnedData)) {
+      LOG_0(TraceLevelError, "ERROR CheckEffectParams binCounts/dimensionFeatures/binnedData cannot be null");
+      return Error_IllegalParamValue;
+   }
+   *pcDimensionsTotalOut = cDimensionsTotal;
+   return Error_None;
+}
+
+EBM_NATIVE_IMPORT_EXPORT_BODY ErrorEbmType EBM_NATIVE_CALLING_CONVENTION ComputePermutedScores(
+   IntEbmType countSamples,
+   IntEbmType countScores,
+   IntEbmType countTerms,
+   const IntEbmType * dimensionCounts,
+   const IntEbmType * binCounts,
+   const IntEbmType * dimensionFeatures,
+   const IntEbmType * binnedData,
+   const double * termScores,
+   IntEbmType feature,
+   const double * sampleScores,
+   const IntEbmType * permutation,
+   double * scoresOut
+) {
+   LOG_N(
+      TraceLevelInfo,
+      "Entered ComputePermutedScores: "
+      "countSamples=%" IntEbmTypePrintf ", "
+      "countScores=%" IntEbmTypePrintf ", "
+      "countTerms=%" IntEbmTypePrintf ", "
+      "dimensionCounts=%p, "
+      "binCounts=%p, "
+      "dimensionFeatures=%p, "
+      "binnedData=%p, "
+      "termScores=%p, "
+      "feature=%" IntEbmTypePrintf ", "
+      "sampleScores=%p, "
+      "permutation=%p, "
+      "scoresOut=%p"
+      ,
+      countSamples,
+      countScores,
+      countTerms,
+      static_cast<const void *>(dimensionCounts),
+      static_cast<const void *>(binCounts),
+      static_cast<const void *>(dimensionFeatures),
+      static_cast<const void *>(binnedData),
+      static_cast<const void *>(termScores),
+      feature,
+      static_cast<const void *>(sampleScores),
+      static_cast<const void *>(permutation),
+      static_cast<void *>(scoresOut)
+   );
+
+   size_t cDimensionsTotal;
+   ErrorEbmType error = CheckEffectParams(countSamples, countScores, countTerms,
+      dimensionCounts, binCounts, dimensionFeatures, binnedData, termScores, sampleScores, &cDimensionsTotal);
+   if(Error_None != error) {
+      return error;
+   }
+   const size_t cSamples = static_cast<size_t>(countSamples);
+   const size_t cScores = static_cast<size_t>(countScores);
+   const size_t cTerms = static_cast<size_t>(countTerms);
+
+   if(size_t { 0 } == cSamples) {
+      LOG_0(TraceLevelInfo, "INFO ComputePermutedScores size_t { 0 } == cSamples");
+      return Error_None;
+   }
+   if(nullptr == permutation || nullptr == scoresOut) {
+      LOG_0(TraceLevelError, "ERROR ComputePermutedScores permutation/scoresOut cannot be null");
+      return Error_IllegalParamValue;
+   }
+   for(size_t iSample = 0; iSample < cSamples; ++iSample) {
+      const IntEbmType iPermuted = permutation[iSample];
+      if(iPermuted < IntEbmType { 0 } || countSamples <= iPermuted) {
+         LOG_0(TraceLevelError, "ERROR ComputePermutedScores permutation contains an illegal sample index");
+         return Error_IllegalParamValue;
+      }
+   }
+
+   EffectTerm * aTerms = nullptr;
+   EffectDimension * aDimensions = nullptr;
+   size_t cEffectTerms;
+
+   // allocate at least one item of each so that a zero term model doesn't look like an allocation failure
+   aTerms = EbmMalloc<EffectTerm>(std::max(cTerms, size_t { 1 }));
+   aDimensions = EbmMalloc<EffectDimension>(std::max(cDimensionsTotal, size_t { 1 }));
+   if(nullptr == aTerms || nullptr == aDimensions) {
+      LOG_0(TraceLevelWarning, "WARNING ComputePermutedScores out of memory");
+      error = Error_OutOfMemory;
+      goto exit_free;
+   }
+
+   // permuting the feature is the same as reading its bins from the sample that the permutation points to, so the
+   // replacement rows are the binned data itself
+   error = BuildEffectTerms(cSamples, cScores, cTerms, dimensionCounts, binCounts, dimensionFeatures, binnedData,
+      termScores, feature, binnedData, cSamples, aTerms, aDimensions, &cEffectTerms);
+   if(Error_None != error) {
+      goto exit_free;
+   }
+
+   for(size_t iSample = 0; iSample < cSamples; ++iSample) {
+      double * const pScores = &scoresOut[iSample * cScores];
+      const double * const pSampleScores = &sampleScores[iSample * cScores];
+      for(size_t iScore = 0; iScore < cScores; ++iScore) {
+         pScores[iScore] = pSampleScores[iScore];
+      }
+      const size_t iPermuted = static_cast<size_t>(permutation[iSample]);
+      for(size_t iTerm = 0; iTerm < cEffectTerms; ++iTerm) {
+         const EffectTerm * const pTerm = &aTerms[iTerm];
+         size_t iTensorBinOld;
+         size_t iTensorBinNew;
+         if(GetTensorBin(pTerm, iSample, false, 0, &iTensorBinOld) ||
+            GetTensorBin(pTerm, iSample, true, iPermuted, &iTensorBinNew))
+         {
+            LOG_0(TraceLevelError, "ERROR ComputePermutedScores binnedData contains an illegal bin index");
+            error = Error_IllegalParamValue;
+            goto exit_free;
+         }
+         if(iTensorBinOld != iTensorBinNew) {
+            const double * const pOld = &pTerm->m_aTermScores[iTensorBinOld * cScores];
+            const double * const pNew = &pTerm->m_aTermScores[iTensorBinNew * cScores];
+            for(size_t iScore = 0; iScore < cScores; ++iScore) {
+               pScores[iScore] += pNew[iScore] - pOld[iScore];
+            }
+         }
+      }
+   }
+
+exit_free:;
+   free(aDimensions);
+   free(aTerms);
+
+   LOG_N(TraceLevelInfo, "Exited ComputePermutedScores: return=%" ErrorEbmTypePrintf, error);
+   return error;
+}
+
+EBM_NATIVE_IMPORT_EXPORT_BODY ErrorEbmType EBM_NATIVE_CALLING_CONVENTION ComputePartialDependence(
+   IntEbmType countSamples,
+   IntEbmType countScores,
+   IntEbmType countTerms,
+   const IntEbmType * dimensionCounts,
+   const IntEbmType * binCounts,
+   const IntEbmType * dimensionFeatures,
+   const IntEbmType * binnedData,
+   const double * termScores,
+   IntEbmType feature,
+   const double * sampleScores,
+   IntEbmType countGridPoints,
+   const IntEbmType * gridBinnedData,
+   const double * sampleWeights,
+   double * partialDependenceOut,
+   double * stddevOut,
+   double * iceOut
+) {
+   LOG_N(
+      TraceLevelInfo,
+      "Entered ComputePartialDependence: "
+      "countSamples=%" IntEbmTypePrintf ", "
+      "countScores=%" IntEbmTypePrintf ", "
+      "countTerms=%" IntEbmTypePrintf ", "
+      "dimensionCounts=%p, "
+      "binCounts=%p, "
+      "dimensionFeatures=%p, "
+      "binnedData=%p, "
+      "termScores=%p, "
+      "feature=%" IntEbmTypePrintf ", "
+      "sampleScores=%p, "
+      "countGridPoints=%" IntEbmTypePrintf ", "
+      "gridBinnedData=%p, "
+      "sampleWeights=%p, "
+      "partialDependenceOut=%p, "
+      "stddevOut=%p, "
+      "iceOut=%p"
+      ,
+      countSamples,
+      countScores,
+      countTerms,
+      static_cast<const void *>(dimensionCounts),
+      static_cast<const void *>(binCounts),
+      static_cast<const void *>(dimensionFeatures),
+      static_cast<const void *>(binnedData),
+      static_cast<const void *>(termScores),
+      feature,
+      static_cast<const void *>(sampleScores),
+      countGridPoints,
+      static_cast<const void *>(gridBinnedData),
+      static_cast<const void *>(sampleWeights),
+      static_cast<void *>(partialDependenceOut),
+      static_cast<void *>(stddevOut),
+      static_cast<void *>(iceOut)
+   );
+
+   size_t cDimensionsTotal;
+   ErrorEbmType error = CheckEffectParams(countSamples, countScores, countTerms,
+      dimensionCounts, binCounts, dimensionFeatures, binnedData, termScores, sampleScores, &cDimensionsTotal);
+   if(Error_None != error) {
+      return error;
+   }
+   const size_t cSamples = static_cast<size_t>(countSamples);
+   const size_t cScores = static_cast<size_t>(countScores);
+   const size_t cTerms = static_cast<size_t>(countTerms);
+
+   if(countGridPoints < IntEbmType { 0 } || IsConvertError<size_t>(countGridPoints)) {
+      LOG_0(TraceLevelError, "ERROR ComputePartialDependence countGridPoints must be positive");
+      return Error_IllegalParamValue;
+   }
+   const size_t cGridPoints = static_cast<size_t>(countGridPoints);
+   if(size_t { 0 } == cGridPoints) {
+      LOG_0(TraceLevelInfo, "INFO ComputePartialDependence size_t { 0 } == cGridPoints");
+      return Error_None;
+   }
+   if(nullptr == partialDependenceOut) {
+      LOG_0(TraceLevelError, "ERROR ComputePartialDependence nullptr == partialDependenceOut");
+      return Error_IllegalParamValue;
+   }
+   if(size_t { 0 } != cDimensionsTotal && nullptr == gridBinnedData) {
+      LOG_0(TraceLevelError, "ERROR ComputePartialDependence nullptr == gridBinnedData");
+      return Error_IllegalParamValue;
+   }
+   if(IsMultiplyError(sizeof(double), cSamples, cGridPoints, cScores) ||
+      IsMultiplyError(sizeof(IntEbmType), cDimensionsTotal, std::max(cSamples, cGridPoints)))
+   {
+      LOG_0(TraceLevelError, "ERROR ComputePartialDependence IsMultiplyError(sizeof(double), cSamples, cGridPoints, cScores)");
+      return Error_IllegalParamValue;
+   }
+
+   double weightTotal = static_cast<double>(cSamples);
+   if(nullptr != sampleWeights) {
+      weightTotal = 0.0;
+      for(size_t iSample = 0; iSample < cSamples; ++iSample) {
+         const double weight = sampleWeights[iSample];
+         if(!std::isfinite(weight) || weight < 0.0) {
+            LOG_0(TraceLevelError, "ERROR ComputePartialDependence sampleWeights must be positive numbers or zero");
+            return Error_IllegalParamValue;
+         }
+         weightTotal += weight;
+      }
+   }
+
+   EffectTerm * aTerms = nullptr;
+   EffectDimension * aDimensions = nullptr;
+   double * aBaseScores = nullptr;
+   double * aIce = nullptr;
+   size_t cEffectTerms;
+
+   // allocate at least one item of each so that a zero term model doesn't look like an allocation failure
+   aTerms = EbmMalloc<EffectTerm>(std::max(cTerms, size_t { 1 }));
+   aDimensions = EbmMalloc<EffectDimension>(std::max(cDimensionsTotal, size_t { 1 }));
+   aBaseScores = EbmMalloc<double>(std::max(cSamples * cScores, size_t { 1 }));
+   aIce = EbmMalloc<double>(std::max(cSamples * cScores, size_t { 1 }));
+   if(nullptr == aTerms || nullptr == aDimensions || nullptr == aBaseScores || nullptr == aIce) {
+      LOG_0(TraceLevelWarning, "WARNING ComputePartialDependence out of memory");
+      error = Error_OutOfMemory;
+      goto exit_free;
+   }
+
+   error = BuildEffectTerms(cSamples, cScores, cTerms, dimensionCounts, binCounts, dimensionFeatures, binnedData,
+      termScores, feature, gridBinnedData, cGridPoints, aTerms, aDimensions, &cEffectTerms);
+   if(Error_None != error) {
+      goto exit_free;
+   }
+
+   // take the terms with the feature out of each sample's score once, so that each grid point only adds them back
+   for(size_t iSample = 0; iSample < cSamples; ++iSample) {
+      double * const pBase = &aBaseScores[iSample * cScores];
+      const double * const pSampleScores = &sampleScores[iSample * cScores];
+      for(size_t iScore = 0; iScore < cScores; ++iScore) {
+         pBase[iScore] = pSampleScores[iScore];
+      }
+      for(size_t iTerm = 0; iTerm < cEffectTerms; ++iTerm) {
+         const EffectTerm * const pTerm = &aTerms[iTerm];
+         size_t iTensorBin;
+         if(GetTensorBin(pTerm, iSample, false, 0, &iTensorBin)) {
+            LOG_0(TraceLevelError, "ERROR ComputePartialDependence binnedData contains an illegal bin index");
+            error = Error_IllegalParamValue;
+            goto exit_free;
+         }
+         const double * const pTermScores = &pTerm->m_aTermScores[iTensorBin * cScores];
+         for(size_t iScore = 0; iScore < cScores; ++iScore) {
+            pBase[iScore] -= pTermScores[iScore];
+         }
+      }
+   }
+
+   for(size_t iGridPoint = 0; iGridPoint < cGridPoints; ++iGridPoint) {
+      double * const pPartialDependence = &partialDependenceOut[iGridPoint * cScores];
+      for(size_t iScore = 0; iScore < cScores; ++iScore) {
+         pPartialDependence[iScore] = 0.0;
+      }
+
+      for(size_t iSample = 0; iSample < cSamples; ++iSample) {
+         double * const pIce = &aIce[iSample * cScores];
+         const double * const pBase = &aBaseScores[iSample * cScores];
+         for(size_t iScore = 0; iScore < cScores; ++iScore) {
+            pIce[iScore] = pBase[iScore];
+         }
+         for(size_t iTerm = 0; iTerm < cEffectTerms; ++iTerm) {
+            const EffectTerm * const pTerm = &aTerms[iTerm];
+            size_t iTensorBin;
+            if(GetTensorBin(pTerm, iSample, true, iGridPoint, &iTensorBin)) {
+               LOG_0(TraceLevelError, "ERROR ComputePartialDependence gridBinnedData contains an illegal bin index");
+               error = Error_IllegalParamValue;
+               goto exit_free;
+            }
+            const double * const pTermScores = &pTerm->m_aTermScores[iTensorBin * cScores];
+            for(size_t iScore = 0; iScore < cScores; ++iScore) {
+               pIce[iScore] += pTermScores[iScore];
+            }
+         }
+
+         const double weight = nullptr == sampleWeights ? 1.0 : sampleWeights[iSample];
+         for(size_t iScore = 0; iScore < cScores; ++iScore) {
+            pPartialDependence[iScore] += weight * pIce[iScore];
+         }
+         if(nullptr != iceOut) {
+            // the ICE lines are output in (sample, grid point, score) order like the python arrays
+            double * const pIceOut = &iceOut[(iSample * cGridPoints + iGridPoint) * cScores];
+            for(size_t iScore = 0; iScore < cScores; ++iScore) {
+               pIceOut[iScore] = pIce[iScore];
+            }
+         }
+      }
+
+      if(0.0 != weightTotal) {
+         for(size_t iScore = 0; iScore < cScores; ++iScore) {
+            pPartialDependence[iScore] /= weightTotal;
+         }
+      }
+
+      if(nullptr != stddevOut) {
+         double * const pStddev = &stddevOut[iGridPoint * cScores];
+         for(size_t iScore = 0; iScore < cScores; ++iScore) {
+            pStddev[iScore] = 0.0;
+         }
+         for(size_t iSample = 0; iSample < cSamples; ++iSample) {
+            const double weight = nullptr == sampleWeights ? 1.0 : sampleWeights[iSample];
+            const double * const pIce = &aIce[iSample * cScores];
+            for(size_t iScore = 0; iScore < cScores; ++iScore) {
+               const double difference = pIce[iScore] - pPartialDependence[iScore];
+               pStddev[iScore] += weight * difference * difference;
+            }
+         }
+         for(size_t iScore = 0; iScore < cScores; ++iScore) {
+            pStddev[iScore] = 0.0 == weightTotal ? 0.0 : std::sqrt(pStddev[iScore] / weightTotal);
+         }
+      }
+   }
+
+exit_free:;
+   free(aIce);
+   free(aBaseScores);
+   free(aDimensions);
+   free(aTerms);
+
+   LOG_N(TraceLevelInfo, "Exited ComputePartialDependence: return=%" ErrorEbmTypePrintf, error);
+   return error;
+}
+
+} // DEFINED_ZONE_NAME
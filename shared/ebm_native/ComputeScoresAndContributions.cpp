@@ -0,0 +1,329 @@
+// Copyright (c) 2018 Microsoft Corporation
+// Licensed under the MIT license.
+// Author: Paul Koch <code@koch.ninja>
+
+#include "precompiled_header_cpp.hpp"
+
+#include <stdlib.h> // free
+#include <stddef.h> // size_t, ptrdiff_t
+#include <algorithm> // std::partial_sort
+#include <cmath> // std::abs, std::isnan
+#include <limits> // std::numeric_limits
+
+#include "ebm_native.h"
+#include "logging.h"
+#include "zones.h"
+
+#include "ebm_internal.hpp"
+
+namespace DEFINED_ZONE_NAME {
+#ifndef DEFINED_ZONE_NAME
+#error DEFINED_ZONE_NAME must be defined
+#endif // DEFINED_ZONE_NAME
+
+struct ContributionDimension final {
+   const IntEbmType * m_aBinnedData;
+   size_t m_cBins;
+};
+static_assert(std::is_standard_layout<ContributionDimension>::value,
+   "We use the struct hack in several places, so disallow non-standard_layout types in general");
+static_assert(std::is_trivial<ContributionDimension>::value,
+   "We use memcpy in several places, so disallow non-trivial types in general");
+
+struct ContributionTerm final {
+   size_t m_cDimensions;
+   const ContributionDimension * m_aDimensions;
+   const double * m_aTermScores;
+};
+static_assert(std::is_standard_layout<ContributionTerm>::value,
+   "We use the struct hack in several places, so disallow non-standard_layout types in general");
+static_assert(std::is_trivial<ContributionTerm>::value,
+   "We use memcpy in several places, so disallow non-trivial types in general");
+
+// orders the terms by the size of their contribution, largest first, with ties going to the lower term index
+// so that the output is deterministic
+class ContributionGreater final {
+   const double * m_aMagnitudes;
+public:
+   ContributionGreater(const double * const aMagnitudes) : m_aMagnitudes(aMagnitudes) {
+   }
+   INLINE_ALWAYS bool operator() (const size_t iTerm1, const size_t iTerm2) const {
+      const double magnitude1 = m_aMagnitudes[iTerm1];
+      const double magnitude2 = m_aMagnitudes[iTerm2];
+      if(magnitude1 == magnitude2) {
+         return iTerm1 < iTerm2;
+      }
+      return magnitude2 < magnitude1;
+   }
+};
+
+EBM_NATIVE_IMPORT_EXPORT_BODY ErrorEbmType EBM_NATIVE_CALLING_CONVENTION ComputeScoresAndContributions(
+   IntEbmType countSamples,
+   IntEbmType countScores,
+   IntEbmType countTerms,
+   const IntEbmType * dimensionCounts,
+   const IntEbmType * binCounts,
+   const IntEbmType * binnedData,
+   const double * termScores,
+   const double * intercept,
+   IntEbmType countTopTerms,
+   double * scoresOut,
+   double * contributionsOut,
+   IntEbmType * termIndexesOut
+) {
+   LOG_N(
+      TraceLevelInfo,
+      "Entered ComputeScoresAndContributions: "
+      "countSamples=%" IntEbmTypePrintf ", "
+      "countScores=%" IntEbmTypePrintf ", "
+      "countTerms=%" IntEbmTypePrintf ", "
+      "dimensionCounts=%p, "
+      "binCounts=%p, "
+      "binnedData=%p, "
+      "termScores=%p, "
+      "intercept=%p, "
+      "countTopTerms=%" IntEbmTypePrintf ", "
+      "scoresOut=%p, "
+      "contributionsOut=%p, "
+      "termIndexesOut=%p"
+      ,
+      countSamples,
+      countScores,
+      countTerms,
+      static_cast<const void *>(dimensionCounts),
+      static_cast<const void *>(binCounts),
+      static_cast<const void *>(binnedData),
+      static_cast<const void *>(termScores),
+      static_cast<const void *>(intercept),
+      countTopTerms,
+      static_cast<void *>(scoresOut),
+      static_cast<void *>(contributionsOut),
+      static_cast<void *>(termIndexesOut)
+   );
+
+   if(countSamples < IntEbmType { 0 }) {
+      LOG_0(TraceLevelError, "ERROR ComputeScoresAndContributions countSamples must be positive");
+      return Error_IllegalParamValue;
+   }
+   if(IsConvertError<size_t>(countSamples)) {
+      LOG_0(TraceLevelError, "ERROR ComputeScoresAndContributions IsConvertError<size_t>(countSamples)");
+      return Error_IllegalParamValue;
+   }
+   const size_t cSamples = static_cast<size_t>(countSamples);
+
+   if(countScores <= IntEbmType { 0 }) {
+      LOG_0(TraceLevelError, "ERROR ComputeScoresAndContributions countScores must be 1 or more");
+      return Error_IllegalParamValue;
+   }
+   if(IsConvertError<size_t>(countScores)) {
+      LOG_0(TraceLevelError, "ERROR ComputeScoresAndContributions IsConvertError<size_t>(countScores)");
+      return Error_IllegalParamValue;
+   }
+   const size_t cScores = static_cast<size_t>(countScores);
+
+   if(countTerms < IntEbmType { 0 }) {
+      LOG_0(TraceLevelError, "ERROR ComputeScoresAndContributions countTerms must be positive");
+      return Error_IllegalParamValue;
+   }
+   if(IsConvertError<size_t>(countTerms)) {
+      LOG_0(TraceLevelError, "ERROR ComputeScoresAndContributions IsConvertError<size_t>(countTerms)");
+      return Error_IllegalParamValue;
+   }
+   const size_t cTerms = static_cast<size_t>(countTerms);
+   if(size_t { 0 } != cTerms && (nullptr == dimensionCounts || nullptr == termScores)) {
+      LOG_0(TraceLevelError, "ERROR ComputeScoresAndContributions dimensionCounts/termScores cannot be null");
+      return Error_IllegalParamValue;
+   }
+
+   if(countTopTerms < IntEbmType { 0 }) {
+      LOG_0(TraceLevelError, "ERROR ComputeScoresAndContributions countTopTerms must be positive or zero");
+      return Error_IllegalParamValue;
+   }
+   // zero, or more than we have, means that every term is output in its natural order
+   const bool bTopTerms = IntEbmType { 0 } != countTopTerms && countTopTerms < countTerms;
+   const size_t cOutputTerms = bTopTerms ? static_cast<size_t>(countTopTerms) : cTerms;
+
+   if(size_t { 0 } == cSamples) {
+      LOG_0(TraceLevelInfo, "INFO ComputeScoresAndContributions size_t { 0 } == cSamples");
+      return Error_None;
+   }
+   if(nullptr == scoresOut) {
+      LOG_0(TraceLevelError, "ERROR ComputeScoresAndContributions nullptr == scoresOut");
+      return Error_IllegalParamValue;
+   }
+   if(bTopTerms && (nullptr == contributionsOut || nullptr == termIndexesOut)) {
+      LOG_0(TraceLevelError,
+         "ERROR ComputeScoresAndContributions contributionsOut and termIndexesOut are required for countTopTerms");
+      return Error_IllegalParamValue;
+   }
+   if(IsMultiplyError(sizeof(double), cSamples, cTerms, cScores)) {
+      LOG_0(TraceLevelError, "ERROR ComputeScoresAndContributions IsMultiplyError(sizeof(double), cSamples, ...)");
+      return Error_IllegalParamValue;
+   }
+
+   ErrorEbmType error = Error_None;
+
+   size_t cDimensionsTotal = 0;
+   for(size_t iTerm = 0; iTerm < cTerms; ++iTerm) {
+      const IntEbmType countDimensions = dimensionCounts[iTerm];
+      if(countDimensions < IntEbmType { 0 } || IsConvertError<size_t>(countDimensions)) {
+         LOG_0(TraceLevelError, "ERROR ComputeScoresAndContributions dimensionCounts contains an illegal value");
+         return Error_IllegalParamValue;
+      }
+      if(IsAddError(cDimensionsTotal, static_cast<size_t>(countDimensions))) {
+         LOG_0(TraceLevelError, "ERROR ComputeScoresAndContributions IsAddError(cDimensionsTotal, countDimensions)");
+         return Error_IllegalParamValue;
+      }
+      cDimensionsTotal += static_cast<size_t>(countDimensions);
+   }
+   if(size_t { 0 } != cDimensionsTotal && (nullptr == binCounts || nullptr == binnedData)) {
+      LOG_0(TraceLevelError, "ERROR ComputeScoresAndContributions binCounts/binnedData cannot be null");
+      return Error_IllegalParamValue;
+   }
+
+   ContributionTerm * aTerms = nullptr;
+   ContributionDimension * aDimensions = nullptr;
+   double * aContributions = nullptr;
+   double * aMagnitudes = nullptr;
+   size_t * aiTerms = nullptr;
+
+   // allocate at least one item of each so that a zero term model doesn't look like an allocation failure
+   aTerms = EbmMalloc<ContributionTerm>(std::max(cTerms, size_t { 1 }));
+   aDimensions = EbmMalloc<ContributionDimension>(std::max(cDimensionsTotal, size_t { 1 }));
+   aContributions = EbmMalloc<double>(std::max(cTerms * cScores, size_t { 1 }));
+   aMagnitudes = EbmMalloc<double>(std::max(cTerms, size_t { 1 }));
+   aiTerms = EbmMalloc<size_t>(std::max(cTerms, size_t { 1 }));
+   if(nullptr == aTerms || nullptr == aDimensions || nullptr == aContributions || nullptr == aMagnitudes ||
+      nullptr == aiTerms)
+   {
+      LOG_0(TraceLevelWarning, "WARNING ComputeScoresAndContributions out of memory");
+      error = Error_OutOfMemory;
+      goto exit_free;
+   }
+
+   {
+      ContributionDimension * pDimension = aDimensions;
+      const double * pTermScores = termScores;
+      const IntEbmType * pBinCount = binCounts;
+      const IntEbmType * pBinnedData = binnedData;
+      for(size_t iTerm = 0; iTerm < cTerms; ++iTerm) {
+         ContributionTerm * const pTerm = &aTerms[iTerm];
+         const size_t cDimensions = static_cast<size_t>(dimensionCounts[iTerm]);
+         pTerm->m_cDimensions = cDimensions;
+         pTerm->m_aDimensions = pDimension;
+         pTerm->m_aTermScores = pTermScores;
+
+         size_t cTensorBins = 1;
+         for(size_t iDimension = 0; iDimension < cDimensions; ++iDimension) {
+            const IntEbmType countBins = *pBinCount;
+            ++pBinCount;
+            if(countBins <= IntEbmType { 0 } || IsConvertError<size_t>(countBins)) {
+               LOG_0(TraceLevelError, "ERROR ComputeScoresAndContributions binCounts contains an illegal value");
+               error = Error_IllegalParamValue;
+               goto exit_free;
+            }
+            const size_t cBins = static_cast<size_t>(countBins);
+            if(IsMultiplyError(cTensorBins, cBins)) {
+               LOG_0(TraceLevelError, "ERROR ComputeScoresAndContributions IsMultiplyError(cTensorBins, cBins)");
+               error = Error_IllegalParamValue;
+               goto exit_free;
+            }
+            cTensorBins *= cBins;
+
+            pDimension->m_aBinnedData = pBinnedData;
+            pDimension->m_cBins = cBins;
+            pBinnedData += cSamples;
+            ++pDimension;
+         }
+         if(IsMultiplyError(cScores, cTensorBins)) {
+            LOG_0(TraceLevelError, "ERROR ComputeScoresAndContributions IsMultiplyError(cScores, cTensorBins)");
+            error = Error_IllegalParamValue;
+            goto exit_free;
+         }
+         pTermScores += cScores * cTensorBins;
+      }
+   }
+
+   for(size_t iSample = 0; iSample < cSamples; ++iSample) {
+      double * const pScores = &scoresOut[iSample * cScores];
+      for(size_t iScore = 0; iScore < cScores; ++iScore) {
+         pScores[iScore] = nullptr == intercept ? 0.0 : intercept[iScore];
+      }
+
+      // when all the terms are kept in order we write straight into the caller's contributions
+      double * const aSampleContributions = bTopTerms || nullptr == contributionsOut ?
+         aContributions : &contributionsOut[iSample * cTerms * cScores];
+
+      for(size_t iTerm = 0; iTerm < cTerms; ++iTerm) {
+         const ContributionTerm * const pTerm = &aTerms[iTerm];
+         const size_t cDimensions = pTerm->m_cDimensions;
+         const ContributionDimension * const aTermDimensions = pTerm->m_aDimensions;
+
+         // this is the python tensor layout, which puts the first dimension in the highest stride
+         size_t iTensorBin = 0;
+         for(size_t iDimension = 0; iDimension < cDimensions; ++iDimension) {
+            const ContributionDimension * const pDimension = &aTermDimensions[iDimension];
+            const size_t cBins = pDimension->m_cBins;
+            IntEbmType iBin = pDimension->m_aBinnedData[iSample];
+            if(iBin < IntEbmType { 0 }) {
+               // like python, negative indexes count from the end.  -1 is the unknown bin
+               iBin += static_cast<IntEbmType>(cBins);
+            }
+            if(iBin < IntEbmType { 0 } || static_cast<IntEbmType>(cBins) <= iBin) {
+               LOG_0(TraceLevelError, "ERROR ComputeScoresAndContributions binnedData contains an illegal bin index");
+               error = Error_IllegalParamValue;
+               goto exit_free;
+            }
+            iTensorBin = iTensorBin * cBins + static_cast<size_t>(iBin);
+         }
+
+         const double * const pTermScores = &pTerm->m_aTermScores[iTensorBin * cScores];
+         double * const pContributions = &aSampleContributions[iTerm * cScores];
+         double magnitude = 0.0;
+         for(size_t iScore = 0; iScore < cScores; ++iScore) {
+            const double termScore = pTermScores[iScore];
+            pContributions[iScore] = termScore;
+            pScores[iScore] += termScore;
+            magnitude += std::abs(termScore);
+         }
+         // NaN would break the strict weak ordering that partial_sort needs, so rank the broken terms first where 
+         // they will be noticed
+         aMagnitudes[iTerm] = std::isnan(magnitude) ? std::numeric_limits<double>::infinity() : magnitude;
+      }
+
+      if(nullptr != termIndexesOut) {
+         IntEbmType * const pTermIndexes = &termIndexesOut[iSample * cOutputTerms];
+         if(bTopTerms) {
+            for(size_t iTerm = 0; iTerm < cTerms; ++iTerm) {
+               aiTerms[iTerm] = iTerm;
+            }
+            std::partial_sort(aiTerms, aiTerms + cOutputTerms, aiTerms + cTerms, ContributionGreater(aMagnitudes));
+
+            double * const pContributionsOut = &contributionsOut[iSample * cOutputTerms * cScores];
+            for(size_t iOutputTerm = 0; iOutputTerm < cOutputTerms; ++iOutputTerm) {
+               const size_t iTerm = aiTerms[iOutputTerm];
+               pTermIndexes[iOutputTerm] = static_cast<IntEbmType>(iTerm);
+               for(size_t iScore = 0; iScore < cScores; ++iScore) {
+                  pContributionsOut[iOutputTerm * cScores + iScore] = aContributions[iTerm * cScores + iScore];
+               }
+            }
+         } else {
+            for(size_t iTerm = 0; iTerm < cTerms; ++iTerm) {
+               pTermIndexes[iTerm] = static_cast<IntEbmType>(iTerm);
+            }
+         }
+      }
+   }
+
+exit_free:;
+   free(aiTerms);
+   free(aMagnitudes);
+   free(aContributions);
+   free(aDimensions);
+   free(aTerms);
+
+   LOG_N(TraceLevelInfo, "Exited ComputeScoresAndContributions: return=%" ErrorEbmTypePrintf, error);
+   return error;
+}
+
+} // DEFINED_ZONE_NAME
@@ -0,0 +1,364 @@
+// Copyright (c) 2018 Microsoft Corporation
+// Licensed under the MIT license.
+// Author: Paul Koch <code@koch.ninja>
+
+#include "precompiled_header_cpp.hpp"
+
+#include <stdlib.h> // free
+#include <stddef.h> // size_t, ptrdiff_t
+#include <algorithm> // std::min, std::max
+#include <thread> // std::thread
+
+#include "ebm_native.h"
+#include "logging.h"
+#include "zones.h"
+
+#include "ebm_internal.hpp"
+#include "data_set_shared.hpp"
+
+namespace DEFINED_ZONE_NAME {
+#ifndef DEFINED_ZONE_NAME
+#error DEFINED_ZONE_NAME must be defined
+#endif // DEFINED_ZONE_NAME
+
+// starting a thread costs tens of microseconds, so don't split the samples into chunks smaller than this
+constexpr static size_t k_cSamplesPerThreadMin = 16384;
+constexpr static size_t k_cComputeScoresThreadsMax = 64;
+
+struct ComputeScoresDimension final {
+   const SharedStorageDataType * m_aBinnedData;
+   size_t m_cBins;
+};
+static_assert(std::is_standard_layout<ComputeScoresDimension>::value,
+   "We use the struct hack in several places, so disallow non-standard_layout types in general");
+static_assert(std::is_trivial<ComputeScoresDimension>::value,
+   "We use memcpy in several places, so disallow non-trivial types in general");
+
+struct ComputeScoresTerm final {
+   size_t m_cDimensions;
+   const ComputeScoresDimension * m_aDimensions;
+   const double * m_aTermScores;
+};
+static_assert(std::is_standard_layout<ComputeScoresTerm>::value,
+   "We use the struct hack in several places, so disallow non-standard_layout types in general");
+static_assert(std::is_trivial<ComputeScoresTerm>::value,
+   "We use memcpy in several places, so disallow non-trivial types in general");
+
+// each call owns the samples [iSampleFirst, iSampleEnd) of scoresOut, so the threads never write to the same scores.
+// We loop over the terms on the outside so that the term tensor and the binned feature columns stream through
+// the cache once per chunk instead of jumping between all the terms for every sample
+static void ComputeScoresChunk(
+   const size_t cTerms,
+   const ComputeScoresTerm * const aTerms,
+   const size_t cScores,
+   const double * const aIntercept,
+   const size_t iSampleFirst,
+   const size_t iSampleEnd,
+   double * const aScores
+) {
+   EBM_ASSERT(1 <= cScores);
+   EBM_ASSERT(iSampleFirst < iSampleEnd);
+
+   double * const pScoresFirst = aScores + iSampleFirst * cScores;
+   const double * const pScoresEnd = aScores + iSampleEnd * cScores;
+
+   double * pScore = pScoresFirst;
+   do {
+      for(size_t iScore = 0; iScore < cScores; ++iScore) {
+         pScore[iScore] = nullptr == aIntercept ? 0.0 : aIntercept[iScore];
+      }
+      pScore += cScores;
+   } while(pScoresEnd != pScore);
+
+   for(size_t iTerm = 0; iTerm < cTerms; ++iTerm) {
+      const ComputeScoresTerm * const pTerm = &aTerms[iTerm];
+      const size_t cDimensions = pTerm->m_cDimensions;
+      const ComputeScoresDimension * const aDimensions = pTerm->m_aDimensions;
+      const double * const aTermScores = pTerm->m_aTermScores;
+
+      size_t iSample = iSampleFirst;
+      pScore = pScoresFirst;
+      do {
+         // the tensor layout puts the first dimension in the lowest stride, which is the same as GetBestTermScores
+         size_t iTensorBin = 0;
+         size_t tensorMultiple = 1;
+         for(size_t iDimension = 0; iDimension < cDimensions; ++iDimension) {
+            const ComputeScoresDimension * const pDimension = &aDimensions[iDimension];
+            const SharedStorageDataType binnedData = pDimension->m_aBinnedData[iSample];
+            // FillFeature verified that every bin index is less than the number of bins
+            EBM_ASSERT(static_cast<size_t>(binnedData) < pDimension->m_cBins);
+            iTensorBin += tensorMultiple * static_cast<size_t>(binnedData);
+            tensorMultiple *= pDimension->m_cBins;
+         }
+
+         const double * const pTermScores = &aTermScores[iTensorBin * cScores];
+         for(size_t iScore = 0; iScore < cScores; ++iScore) {
+            pScore[iScore] += pTermScores[iScore];
+         }
+         pScore += cScores;
+         ++iSample;
+      } while(iSampleEnd != iSample);
+   }
+}
+
+EBM_NATIVE_IMPORT_EXPORT_BODY ErrorEbmType EBM_NATIVE_CALLING_CONVENTION ComputeScoresFromDataSet(
+   const void * dataSet,
+   IntEbmType countTerms,
+   const IntEbmType * dimensionCounts,
+   const IntEbmType * featureIndexes,
+   const double * termScores,
+   const double * intercept,
+   IntEbmType countThreads,
+   double * scoresOut
+) {
+   LOG_N(
+      TraceLevelInfo,
+      "Entered ComputeScoresFromDataSet: "
+      "dataSet=%p, "
+      "countTerms=%" IntEbmTypePrintf ", "
+      "dimensionCounts=%p, "
+      "featureIndexes=%p, "
+      "termScores=%p, "
+      "intercept=%p, "
+      "countThreads=%" IntEbmTypePrintf ", "
+      "scoresOut=%p"
+      ,
+      static_cast<const void *>(dataSet),
+      countTerms,
+      static_cast<const void *>(dimensionCounts),
+      static_cast<const void *>(featureIndexes),
+      static_cast<const void *>(termScores),
+      static_cast<const void *>(intercept),
+      countThreads,
+      static_cast<void *>(scoresOut)
+   );
+
+   ErrorEbmType error;
+
+   if(nullptr == dataSet) {
+      LOG_0(TraceLevelError, "ERROR ComputeScoresFromDataSet nullptr == dataSet");
+      return Error_IllegalParamValue;
+   }
+
+   if(countTerms < IntEbmType { 0 }) {
+      LOG_0(TraceLevelError, "ERROR ComputeScoresFromDataSet countTerms must be positive");
+      return Error_IllegalParamValue;
+   }
+   if(IsConvertError<size_t>(countTerms)) {
+      LOG_0(TraceLevelError, "ERROR ComputeScoresFromDataSet IsConvertError<size_t>(countTerms)");
+      return Error_IllegalParamValue;
+   }
+   const size_t cTerms = static_cast<size_t>(countTerms);
+   if(size_t { 0 } != cTerms && (nullptr == dimensionCounts || nullptr == termScores)) {
+      LOG_0(TraceLevelError, "ERROR ComputeScoresFromDataSet dimensionCounts/termScores cannot be null");
+      return Error_IllegalParamValue;
+   }
+
+   if(countThreads < IntEbmType { 0 }) {
+      LOG_0(TraceLevelError, "ERROR ComputeScoresFromDataSet countThreads must be positive, or zero to use all cores");
+      return Error_IllegalParamValue;
+   }
+
+   const unsigned char * const pDataSetShared = static_cast<const unsigned char *>(dataSet);
+
+   size_t cSamples;
+   size_t cFeatures;
+   size_t cWeights;
+   size_t cTargets;
+   error = GetDataSetSharedHeader(pDataSetShared, &cSamples, &cFeatures, &cWeights, &cTargets);
+   if(Error_None != error) {
+      // already logged
+      return error;
+   }
+
+   if(size_t { 1 } != cTargets) {
+      LOG_0(TraceLevelError, "ERROR ComputeScoresFromDataSet the dataSet must have exactly 1 target");
+      return Error_IllegalParamValue;
+   }
+
+   ptrdiff_t runtimeLearningTypeOrCountTargetClasses;
+   GetDataSetSharedTarget(pDataSetShared, 0, &runtimeLearningTypeOrCountTargetClasses);
+
+   if(ptrdiff_t { 0 } <= runtimeLearningTypeOrCountTargetClasses && 
+      runtimeLearningTypeOrCountTargetClasses <= ptrdiff_t { 1 }) 
+   {
+      // with 0 or 1 classes there are no scores to compute
+      LOG_0(TraceLevelInfo, "INFO ComputeScoresFromDataSet target with 0/1 classes");
+      return Error_None;
+   }
+   const size_t cScores = GetVectorLength(runtimeLearningTypeOrCountTargetClasses);
+
+   if(size_t { 0 } == cSamples) {
+      LOG_0(TraceLevelInfo, "INFO ComputeScoresFromDataSet zero samples");
+      return Error_None;
+   }
+   if(nullptr == scoresOut) {
+      LOG_0(TraceLevelError, "ERROR ComputeScoresFromDataSet nullptr == scoresOut");
+      return Error_IllegalParamValue;
+   }
+   if(IsMultiplyError(sizeof(double), cScores, cSamples)) {
+      LOG_0(TraceLevelError, "ERROR ComputeScoresFromDataSet IsMultiplyError(sizeof(double), cScores, cSamples)");
+      return Error_IllegalParamValue;
+   }
+
+   size_t cDimensionsTotal = 0;
+   for(size_t iTerm = 0; iTerm < cTerms; ++iTerm) {
+      const IntEbmType countDimensions = dimensionCounts[iTerm];
+      if(countDimensions < IntEbmType { 0 }) {
+         LOG_0(TraceLevelError, "ERROR ComputeScoresFromDataSet countDimensions cannot be negative");
+         return Error_IllegalParamValue;
+      }
+      if(IntEbmType { k_cDimensionsMax } < countDimensions) {
+         LOG_0(TraceLevelError, "ERROR ComputeScoresFromDataSet countDimensions too large");
+         return Error_IllegalParamValue;
+      }
+      cDimensionsTotal += static_cast<size_t>(countDimensions);
+   }
+   if(size_t { 0 } != cDimensionsTotal && nullptr == featureIndexes) {
+      LOG_0(TraceLevelError, "ERROR ComputeScoresFromDataSet featureIndexes cannot be null if there are dimensions");
+      return Error_IllegalParamValue;
+   }
+
+   ComputeScoresTerm * aTerms = nullptr;
+   ComputeScoresDimension * aDimensions = nullptr;
+   if(size_t { 0 } != cTerms) {
+      aTerms = EbmMalloc<ComputeScoresTerm>(cTerms);
+      if(nullptr == aTerms) {
+         LOG_0(TraceLevelWarning, "WARNING ComputeScoresFromDataSet nullptr == aTerms");
+         return Error_OutOfMemory;
+      }
+      if(size_t { 0 } != cDimensionsTotal) {
+         aDimensions = EbmMalloc<ComputeScoresDimension>(cDimensionsTotal);
+         if(nullptr == aDimensions) {
+            LOG_0(TraceLevelWarning, "WARNING ComputeScoresFromDataSet nullptr == aDimensions");
+            free(aTerms);
+            return Error_OutOfMemory;
+         }
+      }
+   }
+
+   error = Error_None;
+
+   const IntEbmType * pFeatureIndex = featureIndexes;
+   ComputeScoresDimension * pDimension = aDimensions;
+   const double * pTermScores = termScores;
+   for(size_t iTerm = 0; iTerm < cTerms; ++iTerm) {
+      const size_t cDimensions = static_cast<size_t>(dimensionCounts[iTerm]);
+      ComputeScoresTerm * const pTerm = &aTerms[iTerm];
+      pTerm->m_cDimensions = cDimensions;
+      pTerm->m_aDimensions = pDimension;
+      pTerm->m_aTermScores = pTermScores;
+
+      size_t cTensorBins = 1;
+      for(size_t iDimension = 0; iDimension < cDimensions; ++iDimension) {
+         const IntEbmType indexFeature = *pFeatureIndex;
+         ++pFeatureIndex;
+         if(indexFeature < IntEbmType { 0 } || IsConvertError<size_t>(indexFeature) ||
+            cFeatures <= static_cast<size_t>(indexFeature))
+         {
+            LOG_0(TraceLevelError, "ERROR ComputeScoresFromDataSet featureIndexes value out of range");
+            error = Error_IllegalParamValue;
+            goto exit_free;
+         }
+
+         size_t cBins;
+         bool bMissing;
+         bool bUnknown;
+         bool bNominal;
+         bool bSparse;
+         SharedStorageDataType defaultValueSparse;
+         size_t cNonDefaultsSparse;
+         const void * pBinnedData = GetDataSetSharedFeature(
+            pDataSetShared,
+            static_cast<size_t>(indexFeature),
+            &cBins,
+            &bMissing,
+            &bUnknown,
+            &bNominal,
+            &bSparse,
+            &defaultValueSparse,
+            &cNonDefaultsSparse
+         );
+         EBM_ASSERT(nullptr != pBinnedData);
+         if(bSparse) {
+            // FillFeature never makes sparse features today
+            LOG_0(TraceLevelError, "ERROR ComputeScoresFromDataSet sparse features are not supported");
+            error = Error_IllegalParamValue;
+            goto exit_free;
+         }
+         if(IsMultiplyError(cTensorBins, cBins)) {
+            LOG_0(TraceLevelError, "ERROR ComputeScoresFromDataSet IsMultiplyError(cTensorBins, cBins)");
+            error = Error_IllegalParamValue;
+            goto exit_free;
+         }
+         cTensorBins *= cBins;
+
+         pDimension->m_aBinnedData = static_cast<const SharedStorageDataType *>(pBinnedData);
+         pDimension->m_cBins = cBins;
+         ++pDimension;
+      }
+      if(IsMultiplyError(cScores, cTensorBins)) {
+         LOG_0(TraceLevelError, "ERROR ComputeScoresFromDataSet IsMultiplyError(cScores, cTensorBins)");
+         error = Error_IllegalParamValue;
+         goto exit_free;
+      }
+      pTermScores += cScores * cTensorBins;
+   }
+
+   {
+      size_t cThreads = IsConvertError<size_t>(countThreads) ? 
+         k_cComputeScoresThreadsMax : static_cast<size_t>(countThreads);
+      if(size_t { 0 } == cThreads) {
+         // hardware_concurrency can return 0 if it cannot tell
+         cThreads = static_cast<size_t>(std::thread::hardware_concurrency());
+      }
+      cThreads = std::min(cThreads, cSamples / k_cSamplesPerThreadMin);
+      cThreads = std::min(cThreads, k_cComputeScoresThreadsMax);
+      cThreads = std::max(cThreads, size_t { 1 });
+
+      const size_t cSamplesPerThread = cSamples / cThreads;
+      const size_t cSamplesRemainder = cSamples % cThreads;
+
+      // the calling thread handles the last chunk, so we only start cThreads - 1 additional threads.  If a thread
+      // fails to start we compute its chunk here instead of failing the whole call
+      std::thread aThreads[k_cComputeScoresThreadsMax - 1];
+      bool abStarted[k_cComputeScoresThreadsMax - 1];
+      size_t iSampleFirst = 0;
+      for(size_t iThread = 0; iThread < cThreads; ++iThread) {
+         const size_t iSampleEnd = iSampleFirst + cSamplesPerThread + 
+            (iThread < cSamplesRemainder ? size_t { 1 } : size_t { 0 });
+         if(iThread + 1 == cThreads) {
+            ComputeScoresChunk(cTerms, aTerms, cScores, intercept, iSampleFirst, iSampleEnd, scoresOut);
+         } else {
+            abStarted[iThread] = false;
+            try {
+               aThreads[iThread] = std::thread(
+                  ComputeScoresChunk, cTerms, aTerms, cScores, intercept, iSampleFirst, iSampleEnd, scoresOut);
+               abStarted[iThread] = true;
+            } catch(...) {
+               LOG_0(TraceLevelWarning, "WARNING ComputeScoresFromDataSet thread start failed");
+            }
+            if(!abStarted[iThread]) {
+               ComputeScoresChunk(cTerms, aTerms, cScores, intercept, iSampleFirst, iSampleEnd, scoresOut);
+            }
+         }
+         iSampleFirst = iSampleEnd;
+      }
+      EBM_ASSERT(cSamples == iSampleFirst);
+
+      for(size_t iThread = 0; iThread + 1 < cThreads; ++iThread) {
+         if(abStarted[iThread]) {
+            aThreads[iThread].join();
+         }
+      }
+   }
+
+exit_free:;
+   free(aDimensions);
+   free(aTerms);
+
+   LOG_N(TraceLevelInfo, "Exited ComputeScoresFromDataSet: return=%" ErrorEbmTypePrintf, error);
+   return error;
+}
+
+} // DEFINED_ZONE_NAME
@@ -0,0 +1,594 @@
+// Copyright (c) 2018 Microsoft Corporation
+// Licensed under the MIT license.
+// Author: Paul Koch <code@koch.ninja>
+
+#include "precompiled_header_cpp.hpp"
+
+#include <stdlib.h> // free
+#include <stddef.h> // size_t, ptrdiff_t
+#include <algorithm> // std::min, std::max
+#include <cmath> // std::isfinite
+#include <thread> // std::thread
+
+#include "ebm_native.h"
+#include "logging.h"
+#include "zones.h"
+
+#include "ebm_internal.hpp"
+
+namespace DEFINED_ZONE_NAME {
+#ifndef DEFINED_ZONE_NAME
+#error DEFINED_ZONE_NAME must be defined
+#endif // DEFINED_ZONE_NAME
+
+// starting a thread costs tens of microseconds, so don't split the samples into chunks smaller than this
+constexpr static size_t k_cShapleySamplesPerThreadMin = 4096;
+constexpr static size_t k_cShapleyThreadsMax = 64;
+
+// An additive model's Shapley values are the sum of each term's Shapley values, and a term only shares its value
+// between its own features.  With the term's bin weights as the background distribution, the value of the subset S of
+// a term's dimensions is the expected score when the dimensions in S are fixed to the sample's bins and the others
+// are drawn from their joint distribution.  We tabulate that expectation once per subset, which leaves each sample
+// with 2^N lookups per dimension of an N dimensional term, so mains are one subtraction and pairs a few more.
+struct ShapleyDimension final {
+   const IntEbmType * m_aBinnedData;
+   size_t m_cBins;
+   size_t m_iFeature;
+};
+static_assert(std::is_standard_layout<ShapleyDimension>::value,
+   "We use the struct hack in several places, so disallow non-standard_layout types in general");
+static_assert(std::is_trivial<ShapleyDimension>::value,
+   "We use memcpy in several places, so disallow non-trivial types in general");
+
+struct ShapleyTerm final {
+   size_t m_cDimensions;
+   const ShapleyDimension * m_aDimensions;
+   // one tensor per subset of the dimensions, indexed by the subset's bit mask, each over only the dimensions in the
+   // subset in python order with the scores innermost
+   const double * m_aExpectations;
+   const size_t * m_aiSubsetOffsets;
+};
+static_assert(std::is_standard_layout<ShapleyTerm>::value,
+   "We use the struct hack in several places, so disallow non-standard_layout types in general");
+static_assert(std::is_trivial<ShapleyTerm>::value,
+   "We use memcpy in several places, so disallow non-trivial types in general");
+
+INLINE_ALWAYS static size_t GetSubsetIndex(
+   const size_t cDimensions,
+   const ShapleyDimension * const aDimensions,
+   const size_t * const aiBins,
+   const size_t subset
+) {
+   size_t iSubsetBin = 0;
+   for(size_t iDimension = 0; iDimension < cDimensions; ++iDimension) {
+      if(size_t { 0 } != (subset & (size_t { 1 } << iDimension))) {
+         iSubsetBin = iSubsetBin * aDimensions[iDimension].m_cBins + aiBins[iDimension];
+      }
+   }
+   return iSubsetBin;
+}
+
+INLINE_ALWAYS static size_t CountSubsetBits(size_t subset) {
+   size_t cBits = 0;
+   while(size_t { 0 } != subset) {
+      subset &= subset - 1;
+      ++cBits;
+   }
+   return cBits;
+}
+
+// fills the expectation tensors of pTerm.  aWeightsScratch needs room for one weight per subset bin, which is the
+// number of doubles in m_aExpectations divided by cScores
+static void BuildExpectations(
+   const ShapleyTerm * const pTerm,
+   const size_t cScores,
+   const double * const aTermScores,
+   const double * const aBinWeights,
+   const size_t * const aiWeightOffsets,
+   const size_t cSubsetBinsTotal,
+   double * const aWeightsScratch,
+   double * const aExpectations
+) {
+   const size_t cDimensions = pTerm->m_cDimensions;
+   const ShapleyDimension * const aDimensions = pTerm->m_aDimensions;
+   const size_t cSubsets = size_t { 1 } << cDimensions;
+   const size_t subsetAll = cSubsets - 1;
+   const size_t * const aiSubsetOffsets = pTerm->m_aiSubsetOffsets;
+
+   size_t cCells = 1;
+   for(size_t iDimension = 0; iDimension < cDimensions; ++iDimension) {
+      cCells *= aDimensions[iDimension].m_cBins;
+   }
+
+   double weightTotal = 0.0;
+   if(nullptr != aBinWeights) {
+      for(size_t iCell = 0; iCell < cCells; ++iCell) {
+         weightTotal += aBinWeights[iCell];
+      }
+   }
+   // without any weight there is no background distribution, so treat every cell as equally likely
+   const bool bUniform = !(0.0 < weightTotal);
+   if(bUniform) {
+      weightTotal = static_cast<double>(cCells);
+   }
+
+   size_t aiBins[k_cDimensionsMax];
+
+   // first the weight of each subset's bins, which is the marginal distribution of the dimensions in the subset
+   for(size_t iWeight = 0; iWeight < cSubsetBinsTotal; ++iWeight) {
+      aWeightsScratch[iWeight] = 0.0;
+   }
+   for(size_t iDimension = 0; iDimension < cDimensions; ++iDimension) {
+      aiBins[iDimension] = 0;
+   }
+   for(size_t iCell = 0; iCell < cCells; ++iCell) {
+      const double weight = bUniform ? 1.0 : aBinWeights[iCell];
+      for(size_t subset = 0; subset < cSubsets; ++subset) {
+         aWeightsScratch[aiWeightOffsets[subset] + GetSubsetIndex(cDimensions, aDimensions, aiBins, subset)] += weight;
+      }
+      size_t iDimension = cDimensions;
+      while(size_t { 0 } != iDimension) {
+         --iDimension;
+         ++aiBins[iDimension];
+         if(aiBins[iDimension] != aDimensions[iDimension].m_cBins) {
+            break;
+         }
+         aiBins[iDimension] = 0;
+      }
+   }
+
+   // then the expectation of each subset, where every cell contributes its score at the probability of its bins
+   // outside of the subset
+   for(size_t iExpectation = 0; iExpectation < cSubsetBinsTotal * cScores; ++iExpectation) {
+      aExpectations[iExpectation] = 0.0;
+   }
+   for(size_t iDimension = 0; iDimension < cDimensions; ++iDimension) {
+      aiBins[iDimension] = 0;
+   }
+   for(size_t iCell = 0; iCell < cCells; ++iCell) {
+      const double * const pCellScores = &aTermScores[iCell * cScores];
+      for(size_t subset = 0; subset < cSubsets; ++subset) {
+         const size_t subsetOther = subsetAll ^ subset;
+         const double probability = aWeightsScratch[aiWeightOffsets[subsetOther] +
+            GetSubsetIndex(cDimensions, aDimensions, aiBins, subsetOther)] / weightTotal;
+         double * const pExpectation = &aExpectations[aiSubsetOffsets[subset] +
+            GetSubsetIndex(cDimensions, aDimensions, aiBins, subset) * cScores];
+         for(size_t iScore = 0; iScore < cScores; ++iScore) {
+            pExpectation[iScore] += probability * pCellScores[iScore];
+         }
+      }
+      size_t iDimension = cDimensions;
+      while(size_t { 0 } != iDimension) {
+         --iDimension;
+         ++aiBins[iDimension];
+         if(aiBins[iDimension] != aDimensions[iDimension].m_cBins) {
+            break;
+         }
+         aiBins[iDimension] = 0;
+      }
+   }
+}
+
+// each call owns the samples [iSampleFirst, iSampleEnd) of shapleyOut, so the threads never write to the same values
+static void ComputeShapleyChunk(
+   const size_t cTerms,
+   const ShapleyTerm * const aTerms,
+   const size_t cFeatures,
+   const size_t cScores,
+   const size_t iSampleFirst,
+   const size_t iSampleEnd,
+   double * const aShapley
+) {
+   EBM_ASSERT(iSampleFirst < iSampleEnd);
+
+   double * const pShapleyFirst = &aShapley[iSampleFirst * cFeatures * cScores];
+   const double * const pShapleyEnd = &aShapley[iSampleEnd * cFeatures * cScores];
+   for(double * pShapley = pShapleyFirst; pShapleyEnd != pShapley; ++pShapley) {
+      *pShapley = 0.0;
+   }
+
+   // the weight of a subset of size s for one of N players is s! (N - s - 1)! / N!
+   double aSubsetWeights[k_cDimensionsMax];
+   size_t aiBins[k_cDimensionsMax];
+
+   for(size_t iTerm = 0; iTerm < cTerms; ++iTerm) {
+      const ShapleyTerm * const pTerm = &aTerms[iTerm];
+      const size_t cDimensions = pTerm->m_cDimensions;
+      if(size_t { 0 } == cDimensions) {
+         // a constant term only moves the expected value
+         continue;
+      }
+      const ShapleyDimension * const aDimensions = pTerm->m_aDimensions;
+      const double * const aExpectations = pTerm->m_aExpectations;
+      const size_t * const aiSubsetOffsets = pTerm->m_aiSubsetOffsets;
+      const size_t cSubsets = size_t { 1 } << cDimensions;
+
+      double subsetWeight = 1.0 / static_cast<double>(cDimensions);
+      aSubsetWeights[0] = subsetWeight;
+      for(size_t cSubsetBits = 1; cSubsetBits < cDimensions; ++cSubsetBits) {
+         subsetWeight *= static_cast<double>(cSubsetBits) / static_cast<double>(cDimensions - cSubsetBits);
+         aSubsetWeights[cSubsetBits] = subsetWeight;
+      }
+
+      for(size_t iSample = iSampleFirst; iSample < iSampleEnd; ++iSample) {
+         for(size_t iDimension = 0; iDimension < cDimensions; ++iDimension) {
+            const ShapleyDimension * const pDimension = &aDimensions[iDimension];
+            IntEbmType iBin = pDimension->m_aBinnedData[iSample];
+            if(iBin < IntEbmType { 0 }) {
+               // like python, negative indexes count from the end.  We checked these are in range before starting
+               iBin += static_cast<IntEbmType>(pDimension->m_cBins);
+            }
+            aiBins[iDimension] = static_cast<size_t>(iBin);
+         }
+
+         double * const pSampleShapley = &aShapley[iSample * cFeatures * cScores];
+         for(size_t iDimension = 0; iDimension < cDimensions; ++iDimension) {
+            const size_t bitDimension = size_t { 1 } << iDimension;
+            double * const pFeatureShapley = &pSampleShapley[aDimensions[iDimension].m_iFeature * cScores];
+            for(size_t subset = 0; subset < cSubsets; ++subset) {
+               if(size_t { 0 } != (subset & bitDimension)) {
+                  continue;
+               }
+               const double weight = aSubsetWeights[CountSubsetBits(subset)];
+               const double * const pWithout = &aExpectations[aiSubsetOffsets[subset] +
+                  GetSubsetIndex(cDimensions, aDimensions, aiBins, subset) * cScores];
+               const double * const pWith = &aExpectations[aiSubsetOffsets[subset | bitDimension] +
+                  GetSubsetIndex(cDimensions, aDimensions, aiBins, subset | bitDimension) * cScores];
+               for(size_t iScore = 0; iScore < cScores; ++iScore) {
+                  pFeatureShapley[iScore] += weight * (pWith[iScore] - pWithout[iScore]);
+               }
+            }
+         }
+      }
+   }
+}
+
+EBM_NATIVE_IMPORT_EXPORT_BODY ErrorEbmType EBM_NATIVE_CALLING_CONVENTION ComputeShapleyValues(
+   IntEbmType countSamples,
+   IntEbmType countScores,
+   IntEbmType countFeatures,
+   IntEbmType countTerms,
+   const IntEbmType * dimensionCounts,
+   const IntEbmType * binCounts,
+   const IntEbmType * dimensionFeatures,
+   const IntEbmType * binnedData,
+   const double * termScores,
+   const double * binWeights,
+   const double * intercept,
+   IntEbmType countThreads,
+   double * expectedValueOut,
+   double * shapleyOut
+) {
+   LOG_N(
+      TraceLevelInfo,
+      "Entered ComputeShapleyValues: "
+      "countSamples=%" IntEbmTypePrintf ", "
+      "countScores=%" IntEbmTypePrintf ", "
+      "countFeatures=%" IntEbmTypePrintf ", "
+      "countTerms=%" IntEbmTypePrintf ", "
+      "dimensionCounts=%p, "
+      "binCounts=%p, "
+      "dimensionFeatures=%p, "
+      "binnedData=%p, "
+      "termScores=%p, "
+      "binWeights=%p, "
+      "intercept=%p, "
+      "countThreads=%" IntEbmTypePrintf ", "
+      "expectedValueOut=%p, "
+      "shapleyOut=%p"
+      ,
+      countSamples,
+      countScores,
+      countFeatures,
+      countTerms,
+      static_cast<const void *>(dimensionCounts),
+      static_cast<const void *>(binCounts),
+      static_cast<const void *>(dimensionFeatures),
+      static_cast<const void *>(binnedData),
+      static_cast<const void *>(termScores),
+      static_cast<const void *>(binWeights),
+      static_cast<const void *>(intercept),
+      countThreads,
+      static_cast<void *>(expectedValueOut),
+      static_cast<void *>(shapleyOut)
+   );
+
+   if(countSamples < IntEbmType { 0 } || IsConvertError<size_t>(countSamples)) {
+      LOG_0(TraceLevelError, "ERROR ComputeShapleyValues countSamples must be positive");
+      return Error_IllegalParamValue;
+   }
+   const size_t cSamples = static_cast<size_t>(countSamples);
+
+   if(countScores <= IntEbmType { 0 } || IsConvertError<size_t>(countScores)) {
+      LOG_0(TraceLevelError, "ERROR ComputeShapleyValues countScores must be 1 or more");
+      return Error_IllegalParamValue;
+   }
+   const size_t cScores = static_cast<size_t>(countScores);
+
+   if(countFeatures < IntEbmType { 0 } || IsConvertError<size_t>(countFeatures)) {
+      LOG_0(TraceLevelError, "ERROR ComputeShapleyValues countFeatures must be positive");
+      return Error_IllegalParamValue;
+   }
+   const size_t cFeatures = static_cast<size_t>(countFeatures);
+
+   if(countTerms < IntEbmType { 0 } || IsConvertError<size_t>(countTerms)) {
+      LOG_0(TraceLevelError, "ERROR ComputeShapleyValues countTerms must be positive");
+      return Error_IllegalParamValue;
+   }
+   const size_t cTerms = static_cast<size_t>(countTerms);
+   if(size_t { 0 } != cTerms && (nullptr == dimensionCounts || nullptr == termScores)) {
+      LOG_0(TraceLevelError, "ERROR ComputeShapleyValues dimensionCounts/termScores cannot be null");
+      return Error_IllegalParamValue;
+   }
+
+   if(countThreads < IntEbmType { 0 }) {
+      LOG_0(TraceLevelError, "ERROR ComputeShapleyValues countThreads must be positive, or zero to use all cores");
+      return Error_IllegalParamValue;
+   }
+
+   if(nullptr == expectedValueOut) {
+      LOG_0(TraceLevelError, "ERROR ComputeShapleyValues nullptr == expectedValueOut");
+      return Error_IllegalParamValue;
+   }
+   if(size_t { 0 } != cSamples && nullptr == shapleyOut) {
+      LOG_0(TraceLevelError, "ERROR ComputeShapleyValues nullptr == shapleyOut");
+      return Error_IllegalParamValue;
+   }
+   if(IsMultiplyError(sizeof(double), cSamples, cFeatures, cScores)) {
+      LOG_0(TraceLevelError, "ERROR ComputeShapleyValues IsMultiplyError(sizeof(double), cSamples, cFeatures, cScores)");
+      return Error_IllegalParamValue;
+   }
+
+   size_t cDimensionsTotal = 0;
+   size_t cSubsetsTotal = 0;
+   for(size_t iTerm = 0; iTerm < cTerms; ++iTerm) {
+      const IntEbmType countDimensions = dimensionCounts[iTerm];
+      if(countDimensions < IntEbmType { 0 } || IntEbmType { k_cDimensionsMax } < countDimensions) {
+         LOG_0(TraceLevelError, "ERROR ComputeShapleyValues dimensionCounts contains an illegal value");
+         return Error_IllegalParamValue;
+      }
+      const size_t cSubsets = size_t { 1 } << static_cast<size_t>(countDimensions);
+      if(IsAddError(cSubsetsTotal, cSubsets)) {
+         LOG_0(TraceLevelError, "ERROR ComputeShapleyValues IsAddError(cSubsetsTotal, cSubsets)");
+         return Error_IllegalParamValue;
+      }
+      cSubsetsTotal += cSubsets;
+      cDimensionsTotal += static_cast<size_t>(countDimensions);
+   }
+   if(size_t { 0 } != cDimensionsTotal && (nullptr == binCounts || nullptr == dimensionFeatures ||
+      (size_t { 0 } != cSamples && nullptr == binnedData)))
+   {
+      LOG_0(TraceLevelError, "ERROR ComputeShapleyValues binCounts/dimensionFeatures/binnedData cannot be null");
+      return Error_IllegalParamValue;
+   }
+
+   ErrorEbmType error = Error_None;
+
+   ShapleyTerm * aTerms = nullptr;
+   ShapleyDimension * aDimensions = nullptr;
+   size_t * aiSubsetOffsets = nullptr;
+   size_t * aiWeightOffsets = nullptr;
+   double * aExpectations = nullptr;
+   double * aWeightsScratch = nullptr;
+   size_t cExpectationsTotal = 0;
+   size_t cSubsetBinsMax = 1;
+
+   // allocate at least one item of each so that a zero term model doesn't look like an allocation failure
+   aTerms = EbmMalloc<ShapleyTerm>(std::max(cTerms, size_t { 1 }));
+   aDimensions = EbmMalloc<ShapleyDimension>(std::max(cDimensionsTotal, size_t { 1 }));
+   aiSubsetOffsets = EbmMalloc<size_t>(std::max(cSubsetsTotal, size_t { 1 }));
+   aiWeightOffsets = EbmMalloc<size_t>(std::max(cSubsetsTotal, size_t { 1 }));
+   if(nullptr == aTerms || nullptr == aDimensions || nullptr == aiSubsetOffsets || nullptr == aiWeightOffsets) {
+      LOG_0(TraceLevelWarning, "WARNING ComputeShapleyValues out of memory");
+      error = Error_OutOfMemory;
+      goto exit_free;
+   }
+
+   {
+      ShapleyDimension * pDimension = aDimensions;
+      size_t * piSubsetOffsets = aiSubsetOffsets;
+      size_t * piWeightOffsets = aiWeightOffsets;
+      const IntEbmType * pBinCount = binCounts;
+      const IntEbmType * pDimensionFeature = dimensionFeatures;
+      const IntEbmType * pBinnedData = binnedData;
+      for(size_t iTerm = 0; iTerm < cTerms; ++iTerm) {
+         ShapleyTerm * const pTerm = &aTerms[iTerm];
+         const size_t cDimensions = static_cast<size_t>(dimensionCounts[iTerm]);
+         pTerm->m_cDimensions = cDimensions;
+         pTerm->m_aDimensions = pDimension;
+         pTerm->m_aiSubsetOffsets = piSubsetOffsets;
+
+         for(size_t iDimension = 0; iDimension < cDimensions; ++iDimension) {
+            const IntEbmType countBins = *pBinCount;
+            ++pBinCount;
+            if(countBins <= IntEbmType { 0 } || IsConvertError<size_t>(countBins)) {
+               LOG_0(TraceLevelError, "ERROR ComputeShapleyValues binCounts contains an illegal value");
+               error = Error_IllegalParamValue;
+               goto exit_free;
+            }
+            const IntEbmType iFeature = *pDimensionFeature;
+            ++pDimensionFeature;
+            if(iFeature < IntEbmType { 0 } || countFeatures <= iFeature) {
+               LOG_0(TraceLevelError, "ERROR ComputeShapleyValues dimensionFeatures contains an illegal feature index");
+               error = Error_IllegalParamValue;
+               goto exit_free;
+            }
+            for(size_t iSample = 0; iSample < cSamples; ++iSample) {
+               const IntEbmType iBin = pBinnedData[iSample];
+               if(iBin < -countBins || countBins <= iBin) {
+                  LOG_0(TraceLevelError, "ERROR ComputeShapleyValues binnedData contains an illegal bin index");
+                  error = Error_IllegalParamValue;
+                  goto exit_free;
+               }
+            }
+            pDimension->m_aBinnedData = pBinnedData;
+            pDimension->m_cBins = static_cast<size_t>(countBins);
+            pDimension->m_iFeature = static_cast<size_t>(iFeature);
+            pBinnedData += cSamples;
+            ++pDimension;
+         }
+
+         // each subset tensor only spans the dimensions in its subset, so together they hold prod(cBins + 1) bins
+         size_t cSubsetBins = 0;
+         const size_t cSubsets = size_t { 1 } << cDimensions;
+         for(size_t subset = 0; subset < cSubsets; ++subset) {
+            size_t cBinsInSubset = 1;
+            for(size_t iDimension = 0; iDimension < cDimensions; ++iDimension) {
+               if(size_t { 0 } != (subset & (size_t { 1 } << iDimension))) {
+                  const size_t cBins = pTerm->m_aDimensions[iDimension].m_cBins;
+                  if(IsMultiplyError(cBinsInSubset, cBins)) {
+                     LOG_0(TraceLevelError, "ERROR ComputeShapleyValues IsMultiplyError(cBinsInSubset, cBins)");
+                     error = Error_IllegalParamValue;
+                     goto exit_free;
+                  }
+                  cBinsInSubset *= cBins;
+               }
+            }
+            if(IsAddError(cSubsetBins, cBinsInSubset) || IsMultiplyError(cScores, cSubsetBins + cBinsInSubset) ||
+               IsAddError(cExpectationsTotal, cScores * (cSubsetBins + cBinsInSubset)))
+            {
+               LOG_0(TraceLevelError, "ERROR ComputeShapleyValues the subset tensors are too large");
+               error = Error_IllegalParamValue;
+               goto exit_free;
+            }
+            piWeightOffsets[subset] = cSubsetBins;
+            piSubsetOffsets[subset] = cSubsetBins * cScores;
+            cSubsetBins += cBinsInSubset;
+         }
+         cSubsetBinsMax = std::max(cSubsetBinsMax, cSubsetBins);
+         cExpectationsTotal += cSubsetBins * cScores;
+         piSubsetOffsets += cSubsets;
+         piWeightOffsets += cSubsets;
+      }
+   }
+
+   if(IsMultiplyError(sizeof(double), cExpectationsTotal) || IsMultiplyError(sizeof(double), cSubsetBinsMax)) {
+      LOG_0(TraceLevelError, "ERROR ComputeShapleyValues IsMultiplyError(sizeof(double), cExpectationsTotal)");
+      error = Error_IllegalParamValue;
+      goto exit_free;
+   }
+   aExpectations = EbmMalloc<double>(std::max(cExpectationsTotal, size_t { 1 }));
+   aWeightsScratch = EbmMalloc<double>(cSubsetBinsMax);
+   if(nullptr == aExpectations || nullptr == aWeightsScratch) {
+      LOG_0(TraceLevelWarning, "WARNING ComputeShapleyValues out of memory");
+      error = Error_OutOfMemory;
+      goto exit_free;
+   }
+
+   for(size_t iScore = 0; iScore < cScores; ++iScore) {
+      expectedValueOut[iScore] = nullptr == intercept ? 0.0 : intercept[iScore];
+   }
+
+   {
+      double * pExpectations = aExpectations;
+      const double * pTermScores = termScores;
+      const double * pBinWeights = binWeights;
+      const size_t * piWeightOffsets = aiWeightOffsets;
+      for(size_t iTerm = 0; iTerm < cTerms; ++iTerm) {
+         ShapleyTerm * const pTerm = &aTerms[iTerm];
+         const size_t cDimensions = pTerm->m_cDimensions;
+         const size_t cSubsets = size_t { 1 } << cDimensions;
+
+         size_t cCells = 1;
+         for(size_t iDimension = 0; iDimension < cDimensions; ++iDimension) {
+            cCells *= pTerm->m_aDimensions[iDimension].m_cBins;
+         }
+         size_t cSubsetBins = 0;
+         for(size_t subset = 0; subset < cSubsets; ++subset) {
+            size_t cBinsInSubset = 1;
+            for(size_t iDimension = 0; iDimension < cDimensions; ++iDimension) {
+               if(size_t { 0 } != (subset & (size_t { 1 } << iDimension))) {
+                  cBinsInSubset *= pTerm->m_aDimensions[iDimension].m_cBins;
+               }
+            }
+            cSubsetBins += cBinsInSubset;
+         }
+
+         if(nullptr != pBinWeights) {
+            for(size_t iCell = 0; iCell < cCells; ++iCell) {
+               if(!std::isfinite(pBinWeights[iCell]) || pBinWeights[iCell] < 0.0) {
+                  LOG_0(TraceLevelError, "ERROR ComputeShapleyValues binWeights must be positive numbers or zero");
+                  error = Error_IllegalParamValue;
+                  goto exit_free;
+               }
+            }
+         }
+
+         pTerm->m_aExpectations = pExpectations;
+         BuildExpectations(pTerm, cScores, pTermScores, pBinWeights, piWeightOffsets, cSubsetBins, aWeightsScratch,
+            pExpectations);
+
+         // the empty subset holds the term's expected score
+         for(size_t iScore = 0; iScore < cScores; ++iScore) {
+            expectedValueOut[iScore] += pExpectations[iScore];
+         }
+
+         pExpectations += cSubsetBins * cScores;
+         pTermScores += cCells * cScores;
+         if(nullptr != pBinWeights) {
+            pBinWeights += cCells;
+         }
+         piWeightOffsets += cSubsets;
+      }
+   }
+
+   if(size_t { 0 } != cSamples) {
+      size_t cThreads = IsConvertError<size_t>(countThreads) ? k_cShapleyThreadsMax : static_cast<size_t>(countThreads);
+      if(size_t { 0 } == cThreads) {
+         // hardware_concurrency can return 0 if it cannot tell
+         cThreads = static_cast<size_t>(std::thread::hardware_concurrency());
+      }
+      cThreads = std::min(cThreads, cSamples / k_cShapleySamplesPerThreadMin);
+      cThreads = std::min(cThreads, k_cShapleyThreadsMax);
+      cThreads = std::max(cThreads, size_t { 1 });
+
+      const size_t cSamplesPerThread = cSamples / cThreads;
+      const size_t cSamplesRemainder = cSamples % cThreads;
+
+      // the calling thread handles the last chunk, so we only start cThreads - 1 additional threads.  If a thread
+      // fails to start we compute its chunk here instead of failing the whole call
+      std::thread aThreads[k_cShapleyThreadsMax - 1];
+      bool abStarted[k_cShapleyThreadsMax - 1];
+      size_t iSampleFirst = 0;
+      for(size_t iThread = 0; iThread < cThreads; ++iThread) {
+         const size_t iSampleEnd = iSampleFirst + cSamplesPerThread +
+            (iThread < cSamplesRemainder ? size_t { 1 } : size_t { 0 });
+         if(iThread + 1 == cThreads) {
+            ComputeShapleyChunk(cTerms, aTerms, cFeatures, cScores, iSampleFirst, iSampleEnd, shapleyOut);
+         } else {
+            abStarted[iThread] = false;
+            try {
+               aThreads[iThread] = std::thread(ComputeShapleyChunk, cTerms, aTerms, cFeatures, cScores, iSampleFirst,
+                  iSampleEnd, shapleyOut);
+               abStarted[iThread] = true;
+            } catch(...) {
+               LOG_0(TraceLevelWarning, "WARNING ComputeShapleyValues thread start failed");
+            }
+            if(!abStarted[iThread]) {
+               ComputeShapleyChunk(cTerms, aTerms, cFeatures, cScores, iSampleFirst, iSampleEnd, shapleyOut);
+            }
+         }
+         iSampleFirst = iSampleEnd;
+      }
+      EBM_ASSERT(cSamples == iSampleFirst);
+
+      for(size_t iThread = 0; iThread + 1 < cThreads; ++iThread) {
+         if(abStarted[iThread]) {
+            aThreads[iThread].join();
+         }
+      }
+   }
+
+exit_free:;
+   free(aWeightsScratch);
+   free(aExpectations);
+   free(aiWeightOffsets);
+   free(aiSubsetOffsets);
+   free(aDimensions);
+   free(aTerms);
+
+   LOG_N(TraceLevelInfo, "Exited ComputeShapleyValues: return=%" ErrorEbmTypePrintf, error);
+   return error;
+}
+
+} // DEFINED_ZONE_NAME
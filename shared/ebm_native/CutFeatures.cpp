@@ -0,0 +1,223 @@
+// Copyright (c) 2018 Microsoft Corporation
+// Licensed under the MIT license.
+// Author: Paul Koch <code@koch.ninja>
+
+#include "precompiled_header_cpp.hpp"
+
+#include <stddef.h> // size_t, ptrdiff_t
+#include <algorithm> // std::min, std::max
+#include <atomic> // std::atomic
+#include <thread> // std::thread
+
+#include "ebm_native.h"
+#include "logging.h"
+#include "zones.h"
+
+#include "ebm_internal.hpp"
+
+namespace DEFINED_ZONE_NAME {
+#ifndef DEFINED_ZONE_NAME
+#error DEFINED_ZONE_NAME must be defined
+#endif // DEFINED_ZONE_NAME
+
+// cutting is dominated by sorting the feature, so a thread needs about this many values to be worth starting
+constexpr static size_t k_cCutValuesPerThreadMin = 65536;
+constexpr static size_t k_cCutFeaturesThreadsMax = 64;
+
+struct CutFeaturesShared final {
+   // The cost of cutting a feature depends mostly on its number of unique values, which we only learn by sorting it,
+   // and sorting is most of the work.  Instead of splitting the features up front, each thread takes the next
+   // feature when it finishes its last one, so a thread that draws a high cardinality feature simply takes fewer
+   std::atomic<size_t> m_iFeatureNext;
+   std::atomic<ErrorEbmType> m_error;
+
+   size_t m_cFeatures;
+   IntEbmType m_countSamples;
+   const double * const * m_aFeatureValues;
+   const IntEbmType * m_aCutMethods;
+   IntEbmType m_countSamplesPerBinMin;
+   IntEbmType m_countCutsMax;
+   IntEbmType * m_aCountCutsOut;
+   double * m_aCutsOut;
+};
+
+static void CutFeaturesWorker(CutFeaturesShared * const pShared) {
+   const size_t cCutsMax = static_cast<size_t>(pShared->m_countCutsMax);
+   while(true) {
+      if(Error_None != pShared->m_error.load(std::memory_order_relaxed)) {
+         // another thread failed, so the results will be discarded anyways
+         return;
+      }
+      const size_t iFeature = pShared->m_iFeatureNext.fetch_add(1, std::memory_order_relaxed);
+      if(pShared->m_cFeatures <= iFeature) {
+         return;
+      }
+
+      const double * const aFeatureValues = pShared->m_aFeatureValues[iFeature];
+      double * const aCuts = &pShared->m_aCutsOut[iFeature * cCutsMax];
+      IntEbmType countCuts = pShared->m_countCutsMax;
+      ErrorEbmType error;
+      switch(pShared->m_aCutMethods[iFeature]) {
+      case CutMethod_Quantile:
+         error = CutQuantile(pShared->m_countSamples, aFeatureValues, pShared->m_countSamplesPerBinMin, EBM_FALSE,
+            &countCuts, aCuts);
+         break;
+      case CutMethod_RoundedQuantile:
+         error = CutQuantile(pShared->m_countSamples, aFeatureValues, pShared->m_countSamplesPerBinMin, EBM_TRUE,
+            &countCuts, aCuts);
+         break;
+      case CutMethod_Uniform:
+         countCuts = CutUniform(pShared->m_countSamples, aFeatureValues, countCuts, aCuts);
+         error = Error_None;
+         break;
+      default:
+         EBM_ASSERT(CutMethod_Winsorized == pShared->m_aCutMethods[iFeature]);
+         error = CutWinsorized(pShared->m_countSamples, aFeatureValues, &countCuts, aCuts);
+         break;
+      }
+      if(Error_None != error) {
+         // keep the first error, since later ones are often a consequence of it
+         ErrorEbmType errorNone = Error_None;
+         pShared->m_error.compare_exchange_strong(errorNone, error);
+         return;
+      }
+      pShared->m_aCountCutsOut[iFeature] = countCuts;
+   }
+}
+
+EBM_NATIVE_IMPORT_EXPORT_BODY ErrorEbmType EBM_NATIVE_CALLING_CONVENTION CutFeatures(
+   IntEbmType countFeatures,
+   IntEbmType countSamples,
+   const double * const * featureValues,
+   const IntEbmType * cutMethods,
+   IntEbmType countSamplesPerBinMin,
+   IntEbmType countCutsMax,
+   IntEbmType countThreads,
+   IntEbmType * countCutsOut,
+   double * cutsLowerBoundInclusiveOut
+) {
+   LOG_N(
+      TraceLevelInfo,
+      "Entered CutFeatures: "
+      "countFeatures=%" IntEbmTypePrintf ", "
+      "countSamples=%" IntEbmTypePrintf ", "
+      "featureValues=%p, "
+      "cutMethods=%p, "
+      "countSamplesPerBinMin=%" IntEbmTypePrintf ", "
+      "countCutsMax=%" IntEbmTypePrintf ", "
+      "countThreads=%" IntEbmTypePrintf ", "
+      "countCutsOut=%p, "
+      "cutsLowerBoundInclusiveOut=%p"
+      ,
+      countFeatures,
+      countSamples,
+      static_cast<const void *>(featureValues),
+      static_cast<const void *>(cutMethods),
+      countSamplesPerBinMin,
+      countCutsMax,
+      countThreads,
+      static_cast<void *>(countCutsOut),
+      static_cast<void *>(cutsLowerBoundInclusiveOut)
+   );
+
+   if(countFeatures < IntEbmType { 0 } || IsConvertError<size_t>(countFeatures)) {
+      LOG_0(TraceLevelError, "ERROR CutFeatures countFeatures must be positive");
+      return Error_IllegalParamValue;
+   }
+   const size_t cFeatures = static_cast<size_t>(countFeatures);
+   if(size_t { 0 } == cFeatures) {
+      LOG_0(TraceLevelInfo, "INFO CutFeatures size_t { 0 } == cFeatures");
+      return Error_None;
+   }
+
+   if(countSamples < IntEbmType { 0 } || IsConvertError<size_t>(countSamples)) {
+      LOG_0(TraceLevelError, "ERROR CutFeatures countSamples must be positive");
+      return Error_IllegalParamValue;
+   }
+   const size_t cSamples = static_cast<size_t>(countSamples);
+
+   if(countCutsMax < IntEbmType { 0 } || IsConvertError<size_t>(countCutsMax)) {
+      LOG_0(TraceLevelError, "ERROR CutFeatures countCutsMax must be positive");
+      return Error_IllegalParamValue;
+   }
+   const size_t cCutsMax = static_cast<size_t>(countCutsMax);
+   if(IsMultiplyError(sizeof(double), cFeatures, cCutsMax)) {
+      LOG_0(TraceLevelError, "ERROR CutFeatures IsMultiplyError(sizeof(double), cFeatures, cCutsMax)");
+      return Error_IllegalParamValue;
+   }
+
+   if(countThreads < IntEbmType { 0 }) {
+      LOG_0(TraceLevelError, "ERROR CutFeatures countThreads must be positive, or zero to use all cores");
+      return Error_IllegalParamValue;
+   }
+
+   if(nullptr == featureValues || nullptr == cutMethods || nullptr == countCutsOut ||
+      (size_t { 0 } != cCutsMax && nullptr == cutsLowerBoundInclusiveOut))
+   {
+      LOG_0(TraceLevelError, "ERROR CutFeatures featureValues/cutMethods/countCutsOut/cutsLowerBoundInclusiveOut cannot be null");
+      return Error_IllegalParamValue;
+   }
+
+   for(size_t iFeature = 0; iFeature < cFeatures; ++iFeature) {
+      const IntEbmType cutMethod = cutMethods[iFeature];
+      if(CutMethod_Quantile != cutMethod && CutMethod_RoundedQuantile != cutMethod && CutMethod_Uniform != cutMethod &&
+         CutMethod_Winsorized != cutMethod)
+      {
+         LOG_0(TraceLevelError, "ERROR CutFeatures cutMethods contains an unrecognized method");
+         return Error_IllegalParamValue;
+      }
+      if(size_t { 0 } != cSamples && nullptr == featureValues[iFeature]) {
+         LOG_0(TraceLevelError, "ERROR CutFeatures featureValues contains a null feature");
+         return Error_IllegalParamValue;
+      }
+   }
+
+   CutFeaturesShared shared;
+   shared.m_iFeatureNext.store(0);
+   shared.m_error.store(Error_None);
+   shared.m_cFeatures = cFeatures;
+   shared.m_countSamples = countSamples;
+   shared.m_aFeatureValues = featureValues;
+   shared.m_aCutMethods = cutMethods;
+   shared.m_countSamplesPerBinMin = countSamplesPerBinMin;
+   shared.m_countCutsMax = countCutsMax;
+   shared.m_aCountCutsOut = countCutsOut;
+   shared.m_aCutsOut = cutsLowerBoundInclusiveOut;
+
+   size_t cThreads = IsConvertError<size_t>(countThreads) ? k_cCutFeaturesThreadsMax : static_cast<size_t>(countThreads);
+   if(size_t { 0 } == cThreads) {
+      // hardware_concurrency can return 0 if it cannot tell
+      cThreads = static_cast<size_t>(std::thread::hardware_concurrency());
+   }
+   const size_t cValuesTotal = IsMultiplyError(cFeatures, cSamples) ? ~size_t { 0 } : cFeatures * cSamples;
+   cThreads = std::min(cThreads, cValuesTotal / k_cCutValuesPerThreadMin);
+   cThreads = std::min(cThreads, cFeatures);
+   cThreads = std::min(cThreads, k_cCutFeaturesThreadsMax);
+   cThreads = std::max(cThreads, size_t { 1 });
+
+   // the calling thread is a worker too, so we only start cThreads - 1 additional threads.  If a thread fails to
+   // start then the threads that did start, or this one, take its features
+   std::thread aThreads[k_cCutFeaturesThreadsMax - 1];
+   bool abStarted[k_cCutFeaturesThreadsMax - 1];
+   for(size_t iThread = 0; iThread + 1 < cThreads; ++iThread) {
+      abStarted[iThread] = false;
+      try {
+         aThreads[iThread] = std::thread(CutFeaturesWorker, &shared);
+         abStarted[iThread] = true;
+      } catch(...) {
+         LOG_0(TraceLevelWarning, "WARNING CutFeatures thread start failed");
+      }
+   }
+   CutFeaturesWorker(&shared);
+   for(size_t iThread = 0; iThread + 1 < cThreads; ++iThread) {
+      if(abStarted[iThread]) {
+         aThreads[iThread].join();
+      }
+   }
+
+   const ErrorEbmType error = shared.m_error.load();
+   LOG_N(TraceLevelInfo, "Exited CutFeatures: return=%" ErrorEbmTypePrintf, error);
+   return error;
+}
+
+} // DEFINED_ZONE_NAME
@@ -2447,9 +2447,9 @@ INLINE_RELEASE_UNTEMPLATED static size_t GetUncuttableRangeLengthMin(
    return cUncuttableRangeLengthMin;
 }
 
-// we don't care if an extra log message is outputted due to the non-atomic nature of the decrement to this value
-static int g_cLogEnterCutQuantileParametersMessages = 25;
-static int g_cLogExitCutQuantileParametersMessages = 25;
+// these counts are thread_local, so each thread logs its own first messages without racing on the decrement
+static thread_local int g_cLogEnterCutQuantileParametersMessages = 25;
+static thread_local int g_cLogExitCutQuantileParametersMessages = 25;
 
 EBM_NATIVE_IMPORT_EXPORT_BODY ErrorEbmType EBM_NATIVE_CALLING_CONVENTION CutQuantile(
    IntEbmType countSamples,
@@ -29,9 +29,9 @@ extern double ArithmeticMean(
    const double high
 ) noexcept;
 
-// we don't care if an extra log message is outputted due to the non-atomic nature of the decrement to this value
-static int g_cLogEnterCutWinsorizedParametersMessages = 25;
-static int g_cLogExitCutWinsorizedParametersMessages = 25;
+// these counts are thread_local, so each thread logs its own first messages without racing on the decrement
+static thread_local int g_cLogEnterCutWinsorizedParametersMessages = 25;
+static thread_local int g_cLogExitCutWinsorizedParametersMessages = 25;
 
 // TODO: add this as a python/R option "winsorized"
 EBM_NATIVE_IMPORT_EXPORT_BODY ErrorEbmType EBM_NATIVE_CALLING_CONVENTION CutWinsorized(
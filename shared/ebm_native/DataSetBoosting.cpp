@@ -489,6 +489,91 @@ ErrorEbmType DataSetBoosting::Initialize(
    return Error_None;
 }
 
+ErrorEbmType DataSetBoosting::InitializeBinSortedLayout(const Term * const * const apTerms) {
+   LOG_0(TraceLevelInfo, "Entered DataSetBoosting::InitializeBinSortedLayout");
+
+   EBM_ASSERT(nullptr == m_aaBinSortedSamples);
+
+   if(size_t { 0 } == m_cSamples || size_t { 0 } == m_cTerms) {
+      LOG_0(TraceLevelInfo, "Exited DataSetBoosting::InitializeBinSortedLayout no samples or terms");
+      return Error_None;
+   }
+   EBM_ASSERT(nullptr != apTerms);
+   EBM_ASSERT(nullptr != m_aaInputData);
+
+   size_t * * const aaBinSortedSamples = EbmMalloc<size_t *>(m_cTerms);
+   if(nullptr == aaBinSortedSamples) {
+      LOG_0(TraceLevelWarning, "WARNING DataSetBoosting::InitializeBinSortedLayout nullptr == aaBinSortedSamples");
+      return Error_OutOfMemory;
+   }
+   for(size_t iTerm = 0; iTerm < m_cTerms; ++iTerm) {
+      aaBinSortedSamples[iTerm] = nullptr;
+   }
+   // take ownership right away so that Destruct cleans up if we exit early below
+   m_aaBinSortedSamples = aaBinSortedSamples;
+
+   const size_t cSamples = m_cSamples;
+   for(size_t iTerm = 0; iTerm < m_cTerms; ++iTerm) {
+      const Term * const pTerm = apTerms[iTerm];
+      EBM_ASSERT(nullptr != pTerm);
+      if(size_t { 1 } != pTerm->GetCountSignificantDimensions()) {
+         continue;
+      }
+      const size_t cBins = pTerm->GetCountTensorBins();
+      EBM_ASSERT(size_t { 2 } <= cBins);
+
+      // offsets and indexes share one allocation.  The offsets need cBins + 1 entries
+      if(IsAddError(cBins + size_t { 1 }, cSamples)) {
+         LOG_0(TraceLevelWarning, "WARNING DataSetBoosting::InitializeBinSortedLayout IsAddError(cBins + 1, cSamples)");
+         return Error_OutOfMemory;
+      }
+      size_t * const aOffsets = EbmMalloc<size_t>(cBins + size_t { 1 } + cSamples);
+      if(nullptr == aOffsets) {
+         LOG_0(TraceLevelWarning, "WARNING DataSetBoosting::InitializeBinSortedLayout nullptr == aOffsets");
+         return Error_OutOfMemory;
+      }
+      aaBinSortedSamples[iTerm] = aOffsets;
+      size_t * const aiSamples = aOffsets + cBins + size_t { 1 };
+
+      const StorageDataType * const aInputData = m_aaInputData[iTerm];
+      EBM_ASSERT(nullptr != aInputData);
+      const size_t cItemsPerBitPack = static_cast<size_t>(pTerm->GetBitPack());
+      EBM_ASSERT(size_t { 1 } <= cItemsPerBitPack);
+      const size_t cBitsPerItemMax = GetCountBits(cItemsPerBitPack);
+      const size_t maskBits = std::numeric_limits<size_t>::max() >> (k_cBitsForStorageType - cBitsPerItemMax);
+
+      // counting sort: histogram the bins, turn the counts into starting offsets, then scatter the sample indexes
+      // into place.  The scatter walks the samples in order, so each bin's indexes come out sorted
+      for(size_t iBin = 0; iBin <= cBins; ++iBin) {
+         aOffsets[iBin] = 0;
+      }
+      for(size_t iSample = 0; iSample < cSamples; ++iSample) {
+         const size_t iTensorBinCombined = static_cast<size_t>(aInputData[iSample / cItemsPerBitPack]);
+         const size_t iBin = maskBits & (iTensorBinCombined >> (iSample % cItemsPerBitPack * cBitsPerItemMax));
+         EBM_ASSERT(iBin < cBins);
+         ++aOffsets[iBin + 1];
+      }
+      for(size_t iBin = 0; iBin < cBins; ++iBin) {
+         aOffsets[iBin + 1] += aOffsets[iBin];
+      }
+      EBM_ASSERT(cSamples == aOffsets[cBins]);
+      // we borrow the offsets as write cursors and shift them back into place afterwards
+      for(size_t iSample = 0; iSample < cSamples; ++iSample) {
+         const size_t iTensorBinCombined = static_cast<size_t>(aInputData[iSample / cItemsPerBitPack]);
+         const size_t iBin = maskBits & (iTensorBinCombined >> (iSample % cItemsPerBitPack * cBitsPerItemMax));
+         aiSamples[aOffsets[iBin]] = iSample;
+         ++aOffsets[iBin];
+      }
+      for(size_t iBin = cBins; size_t { 0 } != iBin; --iBin) {
+         aOffsets[iBin] = aOffsets[iBin - 1];
+      }
+      aOffsets[0] = 0;
+   }
+
+   LOG_0(TraceLevelInfo, "Exited DataSetBoosting::InitializeBinSortedLayout");
+   return Error_None;
+}
+
 WARNING_PUSH
 WARNING_DISABLE_USING_UNINITIALIZED_MEMORY
 void DataSetBoosting::Destruct() {
@@ -509,6 +594,14 @@ void DataSetBoosting::Destruct() {
       free(m_aaInputData);
    }
 
+   if(nullptr != m_aaBinSortedSamples) {
+      EBM_ASSERT(0 < m_cTerms);
+      for(size_t iTerm = 0; iTerm < m_cTerms; ++iTerm) {
+         free(m_aaBinSortedSamples[iTerm]);
+      }
+      free(m_aaBinSortedSamples);
+   }
+
    LOG_0(TraceLevelInfo, "Exited DataSetBoosting::Destruct");
 }
 WARNING_POP
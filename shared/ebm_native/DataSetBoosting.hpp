@@ -29,6 +29,11 @@ class DataSetBoosting final {
    size_t m_cSamples;
    size_t m_cTerms;
 
+   // optional layout for terms with one significant dimension.  Each entry holds cTensorBins + 1 offsets followed
+   // by the sample indexes grouped by bin, so the samples of bin iBin are at [offsets[iBin], offsets[iBin + 1]).
+   // Entries are nullptr for the terms without the layout, and the whole array is nullptr when nothing has it
+   size_t * * m_aaBinSortedSamples;
+
 public:
 
    DataSetBoosting() = default; // preserve our POD status
@@ -43,6 +48,7 @@ public:
       m_aaInputData = nullptr;
       m_cSamples = 0;
       m_cTerms = 0;
+      m_aaBinSortedSamples = nullptr;
    }
 
    void Destruct();
@@ -62,6 +68,8 @@ public:
       const Term * const * const apTerms
    );
 
+   ErrorEbmType InitializeBinSortedLayout(const Term * const * const apTerms);
+
    INLINE_ALWAYS FloatFast * GetGradientsAndHessiansPointer() {
       EBM_ASSERT(nullptr != m_aGradientsAndHessians);
       return m_aGradientsAndHessians;
@@ -85,6 +93,11 @@ public:
       EBM_ASSERT(nullptr != m_aaInputData);
       return m_aaInputData[pTerm->GetIndexTerm()];
    }
+   INLINE_ALWAYS const size_t * GetBinSortedSamples(const Term * const pTerm) const {
+      EBM_ASSERT(nullptr != pTerm);
+      EBM_ASSERT(pTerm->GetIndexTerm() < m_cTerms || nullptr == m_aaBinSortedSamples);
+      return nullptr == m_aaBinSortedSamples ? nullptr : m_aaBinSortedSamples[pTerm->GetIndexTerm()];
+   }
    INLINE_ALWAYS size_t GetCountSamples() const {
       return m_cSamples;
    }
@@ -9,6 +9,7 @@
 
 #include <stddef.h> // size_t, ptrdiff_t
 #include <limits> // std::numeric_limits
+#include <algorithm> // std::min
 #include <string.h> // memcpy
 
 #include "ebm_native.h"
@@ -214,9 +215,9 @@ EBM_NATIVE_IMPORT_EXPORT_BODY IntEbmType EBM_NATIVE_CALLING_CONVENTION Discretiz
    return static_cast<IntEbmType>(middle);
 }
 
-// don't bother using a lock here.  We don't care if an extra log message is written out due to thread parallism
-static int g_cLogEnterDiscretizeParametersMessages = 25;
-static int g_cLogExitDiscretizeParametersMessages = 25;
+// these counts are thread_local, so Discretize can be called from many threads at once without a lock
+static thread_local int g_cLogEnterDiscretizeParametersMessages = 25;
+static thread_local int g_cLogExitDiscretizeParametersMessages = 25;
 
 EBM_NATIVE_IMPORT_EXPORT_BODY ErrorEbmType EBM_NATIVE_CALLING_CONVENTION Discretize(
    IntEbmType countSamples,
@@ -1035,4 +1036,145 @@ exit_with_log:;
    return error;
 }
 
+// non-double Arrow values are widened to doubles on the stack in chunks this size so that no full column copy is made
+constexpr static size_t k_cArrowChunkSamples = 1024;
+
+template<typename TArrow>
+static void ConvertArrowChunk(const void * const values, const size_t iSampleFirst, const size_t cSamples, double * const aOut) {
+   const TArrow * const aValues = static_cast<const TArrow *>(values) + iSampleFirst;
+   for(size_t iSample = 0; iSample < cSamples; ++iSample) {
+      aOut[iSample] = static_cast<double>(aValues[iSample]);
+   }
+}
+
+typedef void (* CONVERT_ARROW_CHUNK)(const void * const values, const size_t iSampleFirst, const size_t cSamples, double * const aOut);
+
+static thread_local int g_cLogEnterDiscretizeArrowParametersMessages = 25;
+static thread_local int g_cLogExitDiscretizeArrowParametersMessages = 25;
+
+EBM_NATIVE_IMPORT_EXPORT_BODY ErrorEbmType EBM_NATIVE_CALLING_CONVENTION DiscretizeArrow(
+   IntEbmType countSamples,
+   IntEbmType arrowType,
+   const void * values,
+   const uint8_t * validityBitmap,
+   IntEbmType countCuts,
+   const double * cutsLowerBoundInclusive,
+   IntEbmType * discretizedOut
+) {
+   LOG_COUNTED_N(
+      &g_cLogEnterDiscretizeArrowParametersMessages,
+      TraceLevelInfo,
+      TraceLevelVerbose,
+      "Entered DiscretizeArrow: "
+      "countSamples=%" IntEbmTypePrintf ", "
+      "arrowType=%" IntEbmTypePrintf ", "
+      "values=%p, "
+      "validityBitmap=%p, "
+      "countCuts=%" IntEbmTypePrintf ", "
+      "cutsLowerBoundInclusive=%p, "
+      "discretizedOut=%p"
+      ,
+      countSamples,
+      arrowType,
+      values,
+      static_cast<const void *>(validityBitmap),
+      countCuts,
+      static_cast<const void *>(cutsLowerBoundInclusive),
+      static_cast<void *>(discretizedOut)
+   );
+
+   if(countSamples < IntEbmType { 0 } || IsConvertError<size_t>(countSamples)) {
+      LOG_0(TraceLevelError, "ERROR DiscretizeArrow countSamples must be positive");
+      return Error_IllegalParamValue;
+   }
+   const size_t cSamples = static_cast<size_t>(countSamples);
+   if(size_t { 0 } == cSamples) {
+      return Error_None;
+   }
+   if(nullptr == values) {
+      LOG_0(TraceLevelError, "ERROR DiscretizeArrow values cannot be null");
+      return Error_IllegalParamValue;
+   }
+   if(nullptr == discretizedOut) {
+      LOG_0(TraceLevelError, "ERROR DiscretizeArrow discretizedOut cannot be null");
+      return Error_IllegalParamValue;
+   }
+
+   ErrorEbmType error;
+   if(ArrowType_Float64 == arrowType) {
+      // doubles are what Discretize reads, so use the caller's buffer as is
+      error = Discretize(countSamples, static_cast<const double *>(values), countCuts, cutsLowerBoundInclusive,
+         discretizedOut);
+      if(Error_None != error) {
+         // already logged
+         return error;
+      }
+   } else {
+      CONVERT_ARROW_CHUNK pConvert;
+      switch(arrowType) {
+      case ArrowType_Float32:
+         pConvert = ConvertArrowChunk<float>;
+         break;
+      case ArrowType_Int64:
+         pConvert = ConvertArrowChunk<int64_t>;
+         break;
+      case ArrowType_Int32:
+         pConvert = ConvertArrowChunk<int32_t>;
+         break;
+      case ArrowType_Int16:
+         pConvert = ConvertArrowChunk<int16_t>;
+         break;
+      case ArrowType_Int8:
+         pConvert = ConvertArrowChunk<int8_t>;
+         break;
+      case ArrowType_UInt64:
+         pConvert = ConvertArrowChunk<uint64_t>;
+         break;
+      case ArrowType_UInt32:
+         pConvert = ConvertArrowChunk<uint32_t>;
+         break;
+      case ArrowType_UInt16:
+         pConvert = ConvertArrowChunk<uint16_t>;
+         break;
+      case ArrowType_UInt8:
+         pConvert = ConvertArrowChunk<uint8_t>;
+         break;
+      default:
+         LOG_0(TraceLevelError, "ERROR DiscretizeArrow arrowType is not recognized");
+         return Error_IllegalParamValue;
+      }
+
+      double aChunk[k_cArrowChunkSamples];
+      size_t iSampleFirst = 0;
+      do {
+         const size_t cChunkSamples = std::min(cSamples - iSampleFirst, k_cArrowChunkSamples);
+         (*pConvert)(values, iSampleFirst, cChunkSamples, aChunk);
+         error = Discretize(static_cast<IntEbmType>(cChunkSamples), aChunk, countCuts, cutsLowerBoundInclusive,
+            &discretizedOut[iSampleFirst]);
+         if(Error_None != error) {
+            // already logged
+            return error;
+         }
+         iSampleFirst += cChunkSamples;
+      } while(cSamples != iSampleFirst);
+   }
+
+   if(nullptr != validityBitmap) {
+      // null slots hold arbitrary values in Arrow, so whatever bin they landed in is replaced with the missing bin
+      for(size_t iSample = 0; iSample < cSamples; ++iSample) {
+         if(0 == ((validityBitmap[iSample >> 3] >> (iSample & size_t { 7 })) & 1)) {
+            discretizedOut[iSample] = IntEbmType { 0 };
+         }
+      }
+   }
+
+   LOG_COUNTED_0(
+      &g_cLogExitDiscretizeArrowParametersMessages,
+      TraceLevelInfo,
+      TraceLevelVerbose,
+      "Exited DiscretizeArrow"
+   );
+   return Error_None;
+}
+
 } // DEFINED_ZONE_NAME
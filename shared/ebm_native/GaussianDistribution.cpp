@@ -19,9 +19,9 @@ namespace DEFINED_ZONE_NAME {
 #error DEFINED_ZONE_NAME must be defined
 #endif // DEFINED_ZONE_NAME
 
-// we don't care if an extra log message is outputted due to the non-atomic nature of the decrement to this value
-static int g_cLogEnterGenerateGaussianRandomCountParametersMessages = 25;
-static int g_cLogExitGenerateGaussianRandomCountParametersMessages = 25;
+// these counts are thread_local, so each thread logs its own first messages without racing on the decrement
+static thread_local int g_cLogEnterGenerateGaussianRandomCountParametersMessages = 25;
+static thread_local int g_cLogExitGenerateGaussianRandomCountParametersMessages = 25;
 
 EBM_NATIVE_IMPORT_EXPORT_BODY ErrorEbmType EBM_NATIVE_CALLING_CONVENTION GenerateGaussianRandom(
    BoolEbmType isDeterministic,
@@ -84,6 +84,17 @@ extern ErrorEbmType PartitionTwoDimensionalBoosting(
 #endif // NDEBUG
 );
 
+extern ErrorEbmType PartitionCornerBoosting(
+   BoosterShell * const pBoosterShell,
+   const Term * const pTerm,
+   const size_t cSamplesRequiredForChildSplitMin,
+   HistogramBucketBase * pAuxiliaryBucketZone,
+   double * const pTotalGain
+#ifndef NDEBUG
+   , const HistogramBucketBase * const aHistogramBucketsDebugCopy
+#endif // NDEBUG
+);
+
 extern ErrorEbmType PartitionRandomBoosting(
    BoosterShell * const pBoosterShell,
    const Term * const pTerm,
@@ -125,11 +136,13 @@ static ErrorEbmType BoostZeroDimensional(
    pBoosterShell->SetHistogramBucketsEndDebugFast(reinterpret_cast<unsigned char *>(pHistogramBucketFast) + cBytesPerHistogramBucketFast);
 #endif // NDEBUG
 
+   const uint64_t timestampBinBoosting = PerfCounters::GetTimestamp();
    BinBoosting(
       pBoosterShell,
       nullptr,
       pTrainingSet
    );
+   pBoosterShell->GetPerfCounters()->Record(PerfCounter_BinBoosting, timestampBinBoosting);
 
    const size_t cBytesPerHistogramBucketBig = GetHistogramBucketSize<FloatBig>(bClassification, cVectorLength);
 
@@ -269,11 +282,13 @@ static ErrorEbmType BoostSingleDimensional(
    pBoosterShell->SetHistogramBucketsEndDebugFast(reinterpret_cast<unsigned char *>(aHistogramBucketsFast) + cBytesBufferFast);
 #endif // NDEBUG
 
+   const uint64_t timestampBinBoosting = PerfCounters::GetTimestamp();
    BinBoosting(
       pBoosterShell,
       pTerm,
       pTrainingSet
    );
+   pBoosterShell->GetPerfCounters()->Record(PerfCounter_BinBoosting, timestampBinBoosting);
 
    const size_t cBytesPerHistogramBucketBig = GetHistogramBucketSize<FloatBig>(bClassification, cVectorLength);
    if(IsMultiplyError(cBytesPerHistogramBucketBig, cHistogramBuckets)) {
@@ -306,6 +321,7 @@ static ErrorEbmType BoostSingleDimensional(
    const size_t cBytesPerHistogramTargetEntry = GetHistogramTargetEntrySize<FloatBig>(bClassification);
    aSumHistogramTargetEntry->Zero(cBytesPerHistogramTargetEntry, cVectorLength);
 
+   const uint64_t timestampSumHistogramBuckets = PerfCounters::GetTimestamp();
    SumHistogramBuckets(
       pBoosterShell,
       cHistogramBuckets
@@ -314,11 +330,13 @@ static ErrorEbmType BoostSingleDimensional(
       , pTrainingSet->GetWeightTotal()
 #endif // NDEBUG
    );
+   pBoosterShell->GetPerfCounters()->Record(PerfCounter_SumHistogramBuckets, timestampSumHistogramBuckets);
 
    const size_t cSamplesTotal = pTrainingSet->GetTotalCountSampleOccurrences();
    EBM_ASSERT(1 <= cSamplesTotal);
    const FloatBig weightTotal = pTrainingSet->GetWeightTotal();
 
+   const uint64_t timestampPartitionOneDimensionalBoosting = PerfCounters::GetTimestamp();
    error = PartitionOneDimensionalBoosting(
       pBoosterShell,
       cHistogramBuckets,
@@ -329,6 +347,7 @@ static ErrorEbmType BoostSingleDimensional(
       cLeavesMax, 
       pTotalGain
    );
+   pBoosterShell->GetPerfCounters()->Record(PerfCounter_PartitionOneDimensionalBoosting, timestampPartitionOneDimensionalBoosting);
 
    LOG_0(TraceLevelVerbose, "Exited BoostSingleDimensional");
    return error;
@@ -408,11 +427,13 @@ static ErrorEbmType BoostMultiDimensional(
    pBoosterShell->SetHistogramBucketsEndDebugFast(reinterpret_cast<unsigned char *>(aHistogramBucketsFast) + cBytesBufferFast);
 #endif // NDEBUG
 
+   const uint64_t timestampBinBoosting = PerfCounters::GetTimestamp();
    BinBoosting(
       pBoosterShell,
       pTerm,
       pTrainingSet
    );
+   pBoosterShell->GetPerfCounters()->Record(PerfCounter_BinBoosting, timestampBinBoosting);
 
    // we need to reserve 4 PAST the pointer we pass into SweepMultiDimensional!!!!.  We pass in index 20 at max, so we need 24
    const size_t cAuxillaryBucketsForSplitting = 24;
@@ -473,6 +494,7 @@ static ErrorEbmType BoostMultiDimensional(
       cTotalBucketsMainSpace
    );
 
+   const uint64_t timestampTensorTotalsBuild = PerfCounters::GetTimestamp();
    TensorTotalsBuild(
       runtimeLearningTypeOrCountTargetClasses,
       pTerm,
@@ -483,6 +505,7 @@ static ErrorEbmType BoostMultiDimensional(
       , aHistogramBucketsEndDebugBig
 #endif // NDEBUG
    );
+   pBoosterShell->GetPerfCounters()->Record(PerfCounter_TensorTotalsBuild, timestampTensorTotalsBuild);
 
    //permutation0
    //gain_permute0
@@ -581,6 +604,7 @@ static ErrorEbmType BoostMultiDimensional(
    //} while(std::next_permutation(aiDimensionPermutation, &aiDimensionPermutation[cDimensions]));
 
    if(2 == pTerm->GetCountSignificantDimensions()) {
+      const uint64_t timestampPartitionTwoDimensionalBoosting = PerfCounters::GetTimestamp();
       error = PartitionTwoDimensionalBoosting(
          pBoosterShell,
          pTerm,
@@ -591,6 +615,32 @@ static ErrorEbmType BoostMultiDimensional(
          , aHistogramBucketsDebugCopy
 #endif // NDEBUG
       );
+      pBoosterShell->GetPerfCounters()->Record(PerfCounter_PartitionTwoDimensionalBoosting, timestampPartitionTwoDimensionalBoosting);
+      if(Error_None != error) {
+#ifndef NDEBUG
+         free(aHistogramBucketsDebugCopy);
+#endif // NDEBUG
+
+         LOG_0(TraceLevelVerbose, "Exited BoostMultiDimensional with Error code");
+
+         return error;
+      }
+
+      EBM_ASSERT(!std::isnan(*pTotalGain));
+      EBM_ASSERT(0 <= *pTotalGain);
+   } else if(pTerm->GetCountSignificantDimensions() <= k_cDimensionsCornerPartitionMax) {
+      const uint64_t timestampPartitionCornerBoosting = PerfCounters::GetTimestamp();
+      error = PartitionCornerBoosting(
+         pBoosterShell,
+         pTerm,
+         cSamplesRequiredForChildSplitMin,
+         pAuxiliaryBucketZone,
+         pTotalGain
+#ifndef NDEBUG
+         , aHistogramBucketsDebugCopy
+#endif // NDEBUG
+      );
+      pBoosterShell->GetPerfCounters()->Record(PerfCounter_PartitionCornerBoosting, timestampPartitionCornerBoosting);
       if(Error_None != error) {
 #ifndef NDEBUG
          free(aHistogramBucketsDebugCopy);
@@ -604,10 +654,9 @@ static ErrorEbmType BoostMultiDimensional(
       EBM_ASSERT(!std::isnan(*pTotalGain));
       EBM_ASSERT(0 <= *pTotalGain);
    } else {
-      LOG_0(TraceLevelWarning, "WARNING BoostMultiDimensional 2 != pTerm->GetCountSignificantFeatures()");
+      LOG_0(TraceLevelWarning, "WARNING BoostMultiDimensional k_cDimensionsCornerPartitionMax < pTerm->GetCountSignificantFeatures()");
 
-      // TODO: eventually handle this in our caller and this function can specialize in handling just 2 dimensional
-      //       then we can replace this branch with an assert
+      // our caller sends terms with more dimensions than we can partition to BoostRandom
 #ifndef NDEBUG
       EBM_ASSERT(false);
       free(aHistogramBucketsDebugCopy);
@@ -682,11 +731,13 @@ static ErrorEbmType BoostRandom(
    pBoosterShell->SetHistogramBucketsEndDebugFast(reinterpret_cast<unsigned char *>(aHistogramBucketsFast) + cBytesBufferFast);
 #endif // NDEBUG
 
+   const uint64_t timestampBinBoosting = PerfCounters::GetTimestamp();
    BinBoosting(
       pBoosterShell,
       pTerm,
       pTrainingSet
    );
+   pBoosterShell->GetPerfCounters()->Record(PerfCounter_BinBoosting, timestampBinBoosting);
 
    const size_t cBytesPerHistogramBucketBig = GetHistogramBucketSize<FloatBig>(bClassification, cVectorLength);
    if(IsMultiplyError(cBytesPerHistogramBucketBig, cTotalBuckets)) {
@@ -715,6 +766,7 @@ static ErrorEbmType BoostRandom(
    // TODO: we can exit here back to python to allow caller modification to our histograms
 
 
+   const uint64_t timestampPartitionRandomBoosting = PerfCounters::GetTimestamp();
    error = PartitionRandomBoosting(
       pBoosterShell,
       pTerm,
@@ -722,6 +774,7 @@ static ErrorEbmType BoostRandom(
       aLeavesMax,
       pTotalGain
    );
+   pBoosterShell->GetPerfCounters()->Record(PerfCounter_PartitionRandomBoosting, timestampPartitionRandomBoosting);
    if(Error_None != error) {
       LOG_0(TraceLevelVerbose, "Exited BoostRandom with Error code");
       return error;
@@ -817,7 +870,39 @@ static ErrorEbmType GenerateTermUpdateInternal(
       const double invertedSampleCount = 1.0 / cSamplingSetsAfterZero;
       double gainAvg = 0;
       do {
-         const SamplingSet * const pSamplingSet = *ppSamplingSet;
+         const SamplingSet * pSamplingSet = *ppSamplingSet;
+         if(pBoosterShell->IsGradientSampling() || pBoosterShell->IsRowSubsampling()) {
+            // GOSS picks its samples from the current gradients and row subsampling draws new samples each round, 
+            // so the compact set is rebuilt for every update.  GOSS wins if both are on
+            const size_t cVectorLength = GetVectorLength(runtimeLearningTypeOrCountTargetClasses);
+            const size_t cFloatsPerSample = bClassification ? cVectorLength * size_t { 2 } : cVectorLength;
+            SamplingSet * const pCompactSamplingSet = pBoosterShell->GetCompactSamplingSet();
+            if(pBoosterShell->IsGradientSampling()) {
+               error = pCompactSamplingSet->FillGradientSampling(
+                  pBoosterShell->GetRandomDeterministic(),
+                  pSamplingSet,
+                  cFloatsPerSample,
+                  cVectorLength,
+                  pBoosterShell->GetGradientSamplingTopRate(),
+                  pBoosterShell->GetGradientSamplingOtherRate(),
+                  pBoosterShell->GetSamplingMagnitudesTemp()
+               );
+            } else {
+               error = pCompactSamplingSet->FillRowSubsampling(
+                  pBoosterShell->GetRandomDeterministic(),
+                  pSamplingSet,
+                  cFloatsPerSample,
+                  pBoosterShell->GetRowSubsamplingRate()
+               );
+            }
+            if(Error_None != error) {
+               if(LIKELY(nullptr != pGainAvgOut)) {
+                  *pGainAvgOut = double { 0 };
+               }
+               return error;
+            }
+            pSamplingSet = pCompactSamplingSet;
+         }
          if(UNLIKELY(IntEbmType { 0 } == lastDimensionLeavesMax)) {
             LOG_0(TraceLevelWarning, "WARNING GenerateTermUpdateInternal boosting zero dimensional");
             error = BoostZeroDimensional(pBoosterShell, pSamplingSet, options);
@@ -829,7 +914,7 @@ static ErrorEbmType GenerateTermUpdateInternal(
             }
          } else {
             double gain;
-            if(0 != (GenerateUpdateOptions_RandomSplits & options) || 2 < cSignificantDimensions) {
+            if(0 != (GenerateUpdateOptions_RandomSplits & options) || k_cDimensionsCornerPartitionMax < cSignificantDimensions) {
                if(size_t { 1 } != cSamplesRequiredForChildSplitMin) {
                   LOG_0(TraceLevelWarning,
                      "WARNING GenerateTermUpdateInternal cSamplesRequiredForChildSplitMin is ignored when doing random splitting"
@@ -1005,6 +1090,8 @@ static ErrorEbmType GenerateTermUpdateInternal(
    EBM_ASSERT(std::numeric_limits<double>::infinity() != gainAvgOut);
    EBM_ASSERT(k_illegalGainDouble == gainAvgOut || double { 0 } <= gainAvgOut);
 
+   pBoosterShell->RecordTermGain(iTerm, gainAvgOut);
+
    if(nullptr != pGainAvgOut) {
       *pGainAvgOut = gainAvgOut;
    }
@@ -1014,9 +1101,9 @@ static ErrorEbmType GenerateTermUpdateInternal(
 }
 
 // we made this a global because if we had put this variable inside the BoosterCore object, then we would need to dereference that before getting 
-// the count.  By making this global we can send a log message incase a bad BoosterCore object is sent into us we only decrease the count if the 
-// count is non-zero, so at worst if there is a race condition then we'll output this log message more times than desired, but we can live with that
-static int g_cLogGenerateTermUpdateParametersMessages = 10;
+// the count.  By making this global we can send a log message incase a bad BoosterCore object is sent into us.  It is thread_local, so views 
+// boosting on separate threads each get their own count and never race on it
+static thread_local int g_cLogGenerateTermUpdateParametersMessages = 10;
 
 
 EBM_NATIVE_IMPORT_EXPORT_BODY ErrorEbmType EBM_NATIVE_CALLING_CONVENTION GenerateTermUpdate(
@@ -0,0 +1,493 @@
+// Copyright (c) 2018 Microsoft Corporation
+// Licensed under the MIT license.
+// Author: Paul Koch <code@koch.ninja>
+
+#include "precompiled_header_cpp.hpp"
+
+#include <stdlib.h> // free
+#include <stddef.h> // size_t, ptrdiff_t
+#include <algorithm> // std::min, std::max
+#include <cmath> // std::isnan
+#include <thread> // std::thread
+
+#include "ebm_native.h"
+#include "logging.h"
+#include "zones.h"
+
+#include "ebm_internal.hpp"
+
+namespace DEFINED_ZONE_NAME {
+#ifndef DEFINED_ZONE_NAME
+#error DEFINED_ZONE_NAME must be defined
+#endif // DEFINED_ZONE_NAME
+
+// starting a thread costs tens of microseconds, so don't split the tensor cells into chunks smaller than this
+constexpr static size_t k_cHarmonizeCellsPerThreadMin = 4096;
+constexpr static size_t k_cHarmonizeThreadsMax = 64;
+
+EBM_NATIVE_IMPORT_EXPORT_BODY ErrorEbmType EBM_NATIVE_CALLING_CONVENTION HarmonizeCuts(
+   IntEbmType countOldCuts,
+   const double * oldCuts,
+   double oldMin,
+   double oldMax,
+   IntEbmType countNewCuts,
+   const double * newCuts,
+   double newMin,
+   double newMax,
+   IntEbmType * lookupOut,
+   double * percentagesOut
+) {
+   LOG_N(
+      TraceLevelInfo,
+      "Entered HarmonizeCuts: "
+      "countOldCuts=%" IntEbmTypePrintf ", "
+      "oldCuts=%p, "
+      "oldMin=%le, "
+      "oldMax=%le, "
+      "countNewCuts=%" IntEbmTypePrintf ", "
+      "newCuts=%p, "
+      "newMin=%le, "
+      "newMax=%le, "
+      "lookupOut=%p, "
+      "percentagesOut=%p"
+      ,
+      countOldCuts,
+      static_cast<const void *>(oldCuts),
+      oldMin,
+      oldMax,
+      countNewCuts,
+      static_cast<const void *>(newCuts),
+      newMin,
+      newMax,
+      static_cast<void *>(lookupOut),
+      static_cast<void *>(percentagesOut)
+   );
+
+   if(countOldCuts < IntEbmType { 0 } || IsConvertError<size_t>(countOldCuts)) {
+      LOG_0(TraceLevelError, "ERROR HarmonizeCuts countOldCuts must be positive");
+      return Error_IllegalParamValue;
+   }
+   const size_t cOldCuts = static_cast<size_t>(countOldCuts);
+
+   if(countNewCuts < IntEbmType { 0 } || IsConvertError<size_t>(countNewCuts)) {
+      LOG_0(TraceLevelError, "ERROR HarmonizeCuts countNewCuts must be positive");
+      return Error_IllegalParamValue;
+   }
+   const size_t cNewCuts = static_cast<size_t>(countNewCuts);
+
+   if(size_t { 0 } != cOldCuts && nullptr == oldCuts || size_t { 0 } != cNewCuts && nullptr == newCuts) {
+      LOG_0(TraceLevelError, "ERROR HarmonizeCuts oldCuts/newCuts cannot be null");
+      return Error_IllegalParamValue;
+   }
+   if(nullptr == lookupOut || nullptr == percentagesOut) {
+      LOG_0(TraceLevelError, "ERROR HarmonizeCuts lookupOut/percentagesOut cannot be null");
+      return Error_IllegalParamValue;
+   }
+   if(IsAddError(cNewCuts, size_t { 3 })) {
+      LOG_0(TraceLevelError, "ERROR HarmonizeCuts IsAddError(cNewCuts, 3)");
+      return Error_IllegalParamValue;
+   }
+
+   for(size_t iCut = 0; iCut < cOldCuts; ++iCut) {
+      if(std::isnan(oldCuts[iCut]) || size_t { 0 } != iCut && !(oldCuts[iCut - 1] < oldCuts[iCut])) {
+         LOG_0(TraceLevelError, "ERROR HarmonizeCuts oldCuts must be sorted and unique");
+         return Error_IllegalParamValue;
+      }
+   }
+   for(size_t iCut = 0; iCut < cNewCuts; ++iCut) {
+      if(std::isnan(newCuts[iCut]) || size_t { 0 } != iCut && !(newCuts[iCut - 1] < newCuts[iCut])) {
+         LOG_0(TraceLevelError, "ERROR HarmonizeCuts newCuts must be sorted and unique");
+         return Error_IllegalParamValue;
+      }
+   }
+
+   // bin 0 is the missing bin and the last bin is the unknown bin, which keep all of their weight.  In between, each
+   // new bin maps to the old bin that holds its upper cut, which we find by walking both sorted cut arrays together
+   // instead of binary searching for every new cut
+   lookupOut[0] = 0;
+   percentagesOut[0] = 1.0;
+
+   size_t iOldCut = 0;
+   for(size_t iNewBin = 0; iNewBin <= cNewCuts; ++iNewBin) {
+      if(iNewBin < cNewCuts) {
+         const double newCut = newCuts[iNewBin];
+         while(iOldCut < cOldCuts && oldCuts[iOldCut] < newCut) {
+            ++iOldCut;
+         }
+      } else {
+         iOldCut = cOldCuts;
+      }
+      // iOldCut cannot be larger than cOldCuts, which we checked can convert to IntEbmType
+      lookupOut[iNewBin + 1] = static_cast<IntEbmType>(iOldCut) + IntEbmType { 1 };
+
+      double newLow = size_t { 0 } == iNewBin ? newMin : newCuts[iNewBin - 1];
+      double newHigh = cNewCuts == iNewBin ? newMax : newCuts[iNewBin];
+      const double oldLow = size_t { 0 } == iOldCut ? oldMin : oldCuts[iOldCut - 1];
+      const double oldHigh = cOldCuts == iOldCut ? oldMax : oldCuts[iOldCut];
+
+      double percentage;
+      if(oldHigh <= newLow || newHigh <= oldLow) {
+         // if there are bins in the area beyond where the old data extended, then the old data has zero
+         // contribution where these new bins are located
+         percentage = 0.0;
+      } else {
+         // the new range can only extend past the old range at the lowest and highest bins, where the new min or
+         // max is beyond the old one.  The old data had zero contribution in that extra range
+         if(newLow < oldLow) {
+            newLow = oldLow;
+         }
+         if(oldHigh < newHigh) {
+            newHigh = oldHigh;
+         }
+         percentage = (newHigh - newLow) / (oldHigh - oldLow);
+      }
+      percentagesOut[iNewBin + 1] = percentage;
+   }
+
+   lookupOut[cNewCuts + 2] = IntEbmType { -1 };
+   percentagesOut[cNewCuts + 2] = 1.0;
+
+   LOG_0(TraceLevelInfo, "Exited HarmonizeCuts");
+   return Error_None;
+}
+
+struct HarmonizeDimension final {
+   size_t m_cOldBins;
+   size_t m_cNewBins;
+   size_t m_cOldStride;
+   const IntEbmType * m_aOldBinOffsets;
+   const double * m_aPercentages;
+};
+static_assert(std::is_standard_layout<HarmonizeDimension>::value,
+   "We use the struct hack in several places, so disallow non-standard_layout types in general");
+static_assert(std::is_trivial<HarmonizeDimension>::value,
+   "We use memcpy in several places, so disallow non-trivial types in general");
+
+INLINE_ALWAYS static size_t ResolveOldBin(const IntEbmType iBin, const size_t cOldBins) {
+   // like python, negative indexes count from the end.  We checked these are in range before starting
+   return iBin < IntEbmType { 0 } ? static_cast<size_t>(iBin + static_cast<IntEbmType>(cOldBins)) : static_cast<size_t>(iBin);
+}
+
+// each call owns the work items [iWorkFirst, iWorkEnd), where a work item is one cell of one of the new tensors, so
+// the threads never write to the same cells.  The work items are ordered tensor by tensor
+static void HarmonizeChunk(
+   const size_t cDimensions,
+   const HarmonizeDimension * const aDimensions,
+   const IntEbmType * const aOldBins,
+   const size_t cScores,
+   const size_t cOldCells,
+   const size_t cNewCells,
+   const double * const aOldTensors,
+   const double * const aOldWeights,
+   const size_t iWorkFirst,
+   const size_t iWorkEnd,
+   double * const aNewTensors
+) {
+   EBM_ASSERT(iWorkFirst < iWorkEnd);
+
+   size_t aiOldBinFirst[k_cDimensionsMax];
+   size_t aiOldBinEnd[k_cDimensionsMax];
+   size_t aiOldBinCur[k_cDimensionsMax];
+
+   for(size_t iWork = iWorkFirst; iWork < iWorkEnd; ++iWork) {
+      const size_t iTensor = iWork / cNewCells;
+      const double * const aOldTensor = &aOldTensors[iTensor * cOldCells * cScores];
+      double * const pNew = &aNewTensors[iWork * cScores];
+
+      for(size_t iScore = 0; iScore < cScores; ++iScore) {
+         pNew[iScore] = 0.0;
+      }
+
+      // the python layout puts the first dimension in the highest stride, so peel the bins off from the last one
+      size_t remainder = iWork % cNewCells;
+      double percentage = 1.0;
+      size_t cCombinations = 1;
+      size_t iDimension = cDimensions;
+      while(size_t { 0 } != iDimension) {
+         --iDimension;
+         const HarmonizeDimension * const pDimension = &aDimensions[iDimension];
+         const size_t iNewBin = remainder % pDimension->m_cNewBins;
+         remainder /= pDimension->m_cNewBins;
+
+         percentage *= pDimension->m_aPercentages[iNewBin];
+         const size_t iFirst = static_cast<size_t>(pDimension->m_aOldBinOffsets[iNewBin]);
+         const size_t iEnd = static_cast<size_t>(pDimension->m_aOldBinOffsets[iNewBin + 1]);
+         aiOldBinFirst[iDimension] = iFirst;
+         aiOldBinEnd[iDimension] = iEnd;
+         aiOldBinCur[iDimension] = iFirst;
+         cCombinations *= iEnd - iFirst;
+      }
+      if(size_t { 0 } == cCombinations) {
+         // a new bin that maps to no old bins gets nothing from the old tensor
+         continue;
+      }
+
+      double weightTotal = 0.0;
+      while(true) {
+         size_t iOldCell = 0;
+         for(size_t iDimensionCell = 0; iDimensionCell < cDimensions; ++iDimensionCell) {
+            const HarmonizeDimension * const pDimension = &aDimensions[iDimensionCell];
+            iOldCell += ResolveOldBin(aOldBins[aiOldBinCur[iDimensionCell]], pDimension->m_cOldBins) *
+               pDimension->m_cOldStride;
+         }
+         const double * const pOld = &aOldTensor[iOldCell * cScores];
+
+         if(size_t { 1 } == cCombinations) {
+            // if there's just one cell, which is typical, don't incur the floating point loss in precision
+            for(size_t iScore = 0; iScore < cScores; ++iScore) {
+               pNew[iScore] = pOld[iScore];
+            }
+            break;
+         }
+
+         if(nullptr == aOldWeights) {
+            for(size_t iScore = 0; iScore < cScores; ++iScore) {
+               pNew[iScore] += pOld[iScore];
+            }
+         } else {
+            const double weight = aOldWeights[iOldCell];
+            for(size_t iScore = 0; iScore < cScores; ++iScore) {
+               pNew[iScore] += pOld[iScore] * weight;
+            }
+            weightTotal += weight;
+         }
+
+         size_t iDimensionIncrement = 0;
+         while(true) {
+            ++aiOldBinCur[iDimensionIncrement];
+            if(aiOldBinCur[iDimensionIncrement] != aiOldBinEnd[iDimensionIncrement]) {
+               break;
+            }
+            aiOldBinCur[iDimensionIncrement] = aiOldBinFirst[iDimensionIncrement];
+            ++iDimensionIncrement;
+            if(cDimensions == iDimensionIncrement) {
+               goto done_combinations;
+            }
+         }
+      }
+   done_combinations:;
+
+      if(nullptr == aOldWeights) {
+         // we're proportioning bin weights and NOT scores
+         for(size_t iScore = 0; iScore < cScores; ++iScore) {
+            pNew[iScore] *= percentage;
+         }
+      } else if(size_t { 1 } != cCombinations && 0.0 != weightTotal) {
+         // scores are a weighted average, but if the total weight is zero then our sums are zero too,
+         // which is what we want to output
+         for(size_t iScore = 0; iScore < cScores; ++iScore) {
+            pNew[iScore] /= weightTotal;
+         }
+      }
+   }
+}
+
+EBM_NATIVE_IMPORT_EXPORT_BODY ErrorEbmType EBM_NATIVE_CALLING_CONVENTION HarmonizeTensors(
+   IntEbmType countTensors,
+   IntEbmType countDimensions,
+   const IntEbmType * oldBinCounts,
+   const IntEbmType * newBinCounts,
+   IntEbmType countOldBins,
+   const IntEbmType * oldBinOffsets,
+   const IntEbmType * oldBins,
+   const double * percentages,
+   IntEbmType countScores,
+   const double * oldTensors,
+   const double * oldWeights,
+   IntEbmType countThreads,
+   double * newTensorsOut
+) {
+   LOG_N(
+      TraceLevelInfo,
+      "Entered HarmonizeTensors: "
+      "countTensors=%" IntEbmTypePrintf ", "
+      "countDimensions=%" IntEbmTypePrintf ", "
+      "oldBinCounts=%p, "
+      "newBinCounts=%p, "
+      "countOldBins=%" IntEbmTypePrintf ", "
+      "oldBinOffsets=%p, "
+      "oldBins=%p, "
+      "percentages=%p, "
+      "countScores=%" IntEbmTypePrintf ", "
+      "oldTensors=%p, "
+      "oldWeights=%p, "
+      "countThreads=%" IntEbmTypePrintf ", "
+      "newTensorsOut=%p"
+      ,
+      countTensors,
+      countDimensions,
+      static_cast<const void *>(oldBinCounts),
+      static_cast<const void *>(newBinCounts),
+      countOldBins,
+      static_cast<const void *>(oldBinOffsets),
+      static_cast<const void *>(oldBins),
+      static_cast<const void *>(percentages),
+      countScores,
+      static_cast<const void *>(oldTensors),
+      static_cast<const void *>(oldWeights),
+      countThreads,
+      static_cast<void *>(newTensorsOut)
+   );
+
+   if(countTensors < IntEbmType { 0 } || IsConvertError<size_t>(countTensors)) {
+      LOG_0(TraceLevelError, "ERROR HarmonizeTensors countTensors must be positive");
+      return Error_IllegalParamValue;
+   }
+   const size_t cTensors = static_cast<size_t>(countTensors);
+
+   if(countDimensions < IntEbmType { 0 } || IntEbmType { k_cDimensionsMax } < countDimensions) {
+      LOG_0(TraceLevelError, "ERROR HarmonizeTensors countDimensions must be between 0 and k_cDimensionsMax");
+      return Error_IllegalParamValue;
+   }
+   const size_t cDimensions = static_cast<size_t>(countDimensions);
+
+   if(countOldBins < IntEbmType { 0 } || IsConvertError<size_t>(countOldBins)) {
+      LOG_0(TraceLevelError, "ERROR HarmonizeTensors countOldBins must be positive");
+      return Error_IllegalParamValue;
+   }
+   const size_t cOldBinsTotal = static_cast<size_t>(countOldBins);
+
+   if(countScores <= IntEbmType { 0 } || IsConvertError<size_t>(countScores)) {
+      LOG_0(TraceLevelError, "ERROR HarmonizeTensors countScores must be 1 or more");
+      return Error_IllegalParamValue;
+   }
+   const size_t cScores = static_cast<size_t>(countScores);
+
+   if(size_t { 0 } == cTensors) {
+      LOG_0(TraceLevelInfo, "INFO HarmonizeTensors size_t { 0 } == cTensors");
+      return Error_None;
+   }
+   if(nullptr == oldTensors || nullptr == newTensorsOut) {
+      LOG_0(TraceLevelError, "ERROR HarmonizeTensors oldTensors/newTensorsOut cannot be null");
+      return Error_IllegalParamValue;
+   }
+   if(size_t { 0 } != cDimensions &&
+      (nullptr == oldBinCounts || nullptr == newBinCounts || nullptr == oldBinOffsets || nullptr == percentages))
+   {
+      LOG_0(TraceLevelError, "ERROR HarmonizeTensors oldBinCounts/newBinCounts/oldBinOffsets/percentages cannot be null");
+      return Error_IllegalParamValue;
+   }
+   if(size_t { 0 } != cOldBinsTotal && nullptr == oldBins) {
+      LOG_0(TraceLevelError, "ERROR HarmonizeTensors nullptr == oldBins");
+      return Error_IllegalParamValue;
+   }
+
+   HarmonizeDimension aDimensions[k_cDimensionsMax];
+   size_t cOldCells = 1;
+   size_t cNewCells = 1;
+   const IntEbmType * pOldBinOffsets = oldBinOffsets;
+   const double * pPercentages = percentages;
+   for(size_t iDimension = 0; iDimension < cDimensions; ++iDimension) {
+      const IntEbmType countOldBinsDimension = oldBinCounts[iDimension];
+      const IntEbmType countNewBinsDimension = newBinCounts[iDimension];
+      if(countOldBinsDimension <= IntEbmType { 0 } || IsConvertError<size_t>(countOldBinsDimension) ||
+         countNewBinsDimension <= IntEbmType { 0 } || IsConvertError<size_t>(countNewBinsDimension))
+      {
+         LOG_0(TraceLevelError, "ERROR HarmonizeTensors oldBinCounts/newBinCounts contains an illegal value");
+         return Error_IllegalParamValue;
+      }
+      const size_t cOldBins = static_cast<size_t>(countOldBinsDimension);
+      const size_t cNewBins = static_cast<size_t>(countNewBinsDimension);
+      if(IsMultiplyError(cOldCells, cOldBins) || IsMultiplyError(cNewCells, cNewBins)) {
+         LOG_0(TraceLevelError, "ERROR HarmonizeTensors IsMultiplyError(cCells, cBins)");
+         return Error_IllegalParamValue;
+      }
+      cOldCells *= cOldBins;
+      cNewCells *= cNewBins;
+
+      IntEbmType iOffsetPrev = pOldBinOffsets[0];
+      for(size_t iNewBin = 0; iNewBin <= cNewBins; ++iNewBin) {
+         const IntEbmType iOffset = pOldBinOffsets[iNewBin];
+         if(iOffset < iOffsetPrev || static_cast<IntEbmType>(cOldBinsTotal) < iOffset) {
+            LOG_0(TraceLevelError, "ERROR HarmonizeTensors oldBinOffsets must be ordered and within countOldBins");
+            return Error_IllegalParamValue;
+         }
+         if(iNewBin < cNewBins) {
+            for(IntEbmType iOldBin = iOffset; iOldBin < pOldBinOffsets[iNewBin + 1] &&
+               iOldBin < static_cast<IntEbmType>(cOldBinsTotal); ++iOldBin)
+            {
+               const IntEbmType iBin = oldBins[iOldBin];
+               if(iBin < -countOldBinsDimension || countOldBinsDimension <= iBin) {
+                  LOG_0(TraceLevelError, "ERROR HarmonizeTensors oldBins contains an illegal bin index");
+                  return Error_IllegalParamValue;
+               }
+            }
+         }
+         iOffsetPrev = iOffset;
+      }
+
+      aDimensions[iDimension].m_cOldBins = cOldBins;
+      aDimensions[iDimension].m_cNewBins = cNewBins;
+      aDimensions[iDimension].m_aOldBinOffsets = pOldBinOffsets;
+      aDimensions[iDimension].m_aPercentages = pPercentages;
+      pOldBinOffsets += cNewBins + 1;
+      pPercentages += cNewBins;
+   }
+
+   // the python layout puts the first dimension in the highest stride
+   size_t cOldStride = 1;
+   size_t iDimensionStride = cDimensions;
+   while(size_t { 0 } != iDimensionStride) {
+      --iDimensionStride;
+      aDimensions[iDimensionStride].m_cOldStride = cOldStride;
+      cOldStride *= aDimensions[iDimensionStride].m_cOldBins;
+   }
+
+   if(IsMultiplyError(sizeof(double), cTensors, cScores, std::max(cOldCells, cNewCells))) {
+      LOG_0(TraceLevelError, "ERROR HarmonizeTensors IsMultiplyError(sizeof(double), cTensors, cScores, cCells)");
+      return Error_IllegalParamValue;
+   }
+   const size_t cWork = cTensors * cNewCells;
+
+   size_t cThreads = IsConvertError<size_t>(countThreads) || countThreads < IntEbmType { 0 } ?
+      k_cHarmonizeThreadsMax : static_cast<size_t>(countThreads);
+   if(size_t { 0 } == cThreads) {
+      // hardware_concurrency can return 0 if it cannot tell
+      cThreads = static_cast<size_t>(std::thread::hardware_concurrency());
+   }
+   cThreads = std::min(cThreads, cWork / k_cHarmonizeCellsPerThreadMin);
+   cThreads = std::min(cThreads, k_cHarmonizeThreadsMax);
+   cThreads = std::max(cThreads, size_t { 1 });
+
+   const size_t cWorkPerThread = cWork / cThreads;
+   const size_t cWorkRemainder = cWork % cThreads;
+
+   // the calling thread handles the last chunk, so we only start cThreads - 1 additional threads.  If a thread
+   // fails to start we compute its chunk here instead of failing the whole call
+   std::thread aThreads[k_cHarmonizeThreadsMax - 1];
+   bool abStarted[k_cHarmonizeThreadsMax - 1];
+   size_t iWorkFirst = 0;
+   for(size_t iThread = 0; iThread < cThreads; ++iThread) {
+      const size_t iWorkEnd = iWorkFirst + cWorkPerThread + (iThread < cWorkRemainder ? size_t { 1 } : size_t { 0 });
+      if(iThread + 1 == cThreads) {
+         HarmonizeChunk(cDimensions, aDimensions, oldBins, cScores, cOldCells, cNewCells, oldTensors, oldWeights,
+            iWorkFirst, iWorkEnd, newTensorsOut);
+      } else {
+         abStarted[iThread] = false;
+         try {
+            aThreads[iThread] = std::thread(HarmonizeChunk, cDimensions, aDimensions, oldBins, cScores, cOldCells,
+               cNewCells, oldTensors, oldWeights, iWorkFirst, iWorkEnd, newTensorsOut);
+            abStarted[iThread] = true;
+         } catch(...) {
+            LOG_0(TraceLevelWarning, "WARNING HarmonizeTensors thread start failed");
+         }
+         if(!abStarted[iThread]) {
+            HarmonizeChunk(cDimensions, aDimensions, oldBins, cScores, cOldCells, cNewCells, oldTensors, oldWeights,
+               iWorkFirst, iWorkEnd, newTensorsOut);
+         }
+      }
+      iWorkFirst = iWorkEnd;
+   }
+   EBM_ASSERT(cWork == iWorkFirst);
+
+   for(size_t iThread = 0; iThread + 1 < cThreads; ++iThread) {
+      if(abStarted[iThread]) {
+         aThreads[iThread].join();
+      }
+   }
+
+   LOG_0(TraceLevelInfo, "Exited HarmonizeTensors");
+   return Error_None;
+}
+
+} // DEFINED_ZONE_NAME
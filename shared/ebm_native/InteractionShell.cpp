@@ -145,6 +145,43 @@ EBM_NATIVE_IMPORT_EXPORT_BODY ErrorEbmType EBM_NATIVE_CALLING_CONVENTION CreateI
    return Error_None;
 }
 
+EBM_NATIVE_IMPORT_EXPORT_BODY ErrorEbmType EBM_NATIVE_CALLING_CONVENTION GetInteractionPerfCounters(
+   InteractionHandle interactionHandle,
+   IntEbmType countPerfCounters,
+   IntEbmType * callCountsOut,
+   double * secondsOut
+) {
+   LOG_N(
+      TraceLevelInfo,
+      "Entered GetInteractionPerfCounters: "
+      "interactionHandle=%p, "
+      "countPerfCounters=%" IntEbmTypePrintf ", "
+      "callCountsOut=%p, "
+      "secondsOut=%p"
+      ,
+      static_cast<void *>(interactionHandle),
+      countPerfCounters,
+      static_cast<void *>(callCountsOut),
+      static_cast<void *>(secondsOut)
+   );
+
+   InteractionShell * const pInteractionShell = InteractionShell::GetInteractionShellFromHandle(interactionHandle);
+   if(nullptr == pInteractionShell) {
+      // already logged
+      return Error_IllegalParamValue;
+   }
+
+   if(countPerfCounters < IntEbmType { 0 } || PerfCounter_Count < countPerfCounters) {
+      LOG_0(TraceLevelError, "ERROR GetInteractionPerfCounters countPerfCounters must be between 0 and PerfCounter_Count");
+      return Error_IllegalParamValue;
+   }
+
+   pInteractionShell->GetPerfCounters()->Fill(static_cast<size_t>(countPerfCounters), callCountsOut, secondsOut);
+
+   LOG_0(TraceLevelInfo, "Exited GetInteractionPerfCounters");
+   return Error_None;
+}
+
 EBM_NATIVE_IMPORT_EXPORT_BODY void EBM_NATIVE_CALLING_CONVENTION FreeInteractionDetector(
    InteractionHandle interactionHandle
 ) {
@@ -14,6 +14,8 @@
 
 #include "ebm_internal.hpp"
 
+#include "PerfCounters.hpp"
+
 namespace DEFINED_ZONE_NAME {
 #ifndef DEFINED_ZONE_NAME
 #error DEFINED_ZONE_NAME must be defined
@@ -38,6 +40,8 @@ class InteractionShell final {
    int m_cLogEnterMessages;
    int m_cLogExitMessages;
 
+   PerfCounters m_perfCounters;
+
 #ifndef NDEBUG
    const unsigned char * m_aHistogramBucketsEndDebugFast;
 #endif // NDEBUG
@@ -61,6 +65,8 @@ public:
 
       m_cLogEnterMessages = 1000;
       m_cLogExitMessages = 1000;
+
+      m_perfCounters.InitializeUnfailing();
    }
 
    static void Free(InteractionShell * const pInteractionShell);
@@ -107,6 +113,10 @@ public:
       return &m_cLogExitMessages;
    }
 
+   INLINE_ALWAYS PerfCounters * GetPerfCounters() {
+      return &m_perfCounters;
+   }
+
    HistogramBucketBase * GetHistogramBucketBaseFast(size_t cBytesRequired);
 
    INLINE_ALWAYS HistogramBucketBase * GetHistogramBucketBaseFast() {
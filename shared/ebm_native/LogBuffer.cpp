@@ -0,0 +1,160 @@
+// Copyright (c) 2018 Microsoft Corporation
+// Licensed under the MIT license.
+// Author: Paul Koch <code@koch.ninja>
+
+#include "precompiled_header_cpp.hpp"
+
+#include <stddef.h> // size_t, ptrdiff_t
+#include <string.h> // strlen, memcpy
+#include <limits> // std::numeric_limits
+#include <atomic> // std::atomic
+
+#include "ebm_native.h"
+#include "logging.h"
+#include "zones.h"
+
+#include "ebm_internal.hpp"
+
+namespace DEFINED_ZONE_NAME {
+#ifndef DEFINED_ZONE_NAME
+#error DEFINED_ZONE_NAME must be defined
+#endif // DEFINED_ZONE_NAME
+
+// must be a power of 2 so that the slot index is a mask of the position
+constexpr static size_t k_cLogSlots = 1024;
+static_assert(0 == (k_cLogSlots & (k_cLogSlots - 1)), "k_cLogSlots must be a power of 2");
+// longer messages are clipped, but even our "Entered" messages that print all their parameters fit in this
+constexpr static size_t k_cLogSlotChars = 512;
+
+// This is a bounded multi-producer queue in the style of Dmitry Vyukov's.  Each slot has a sequence number which says
+// whether the slot is waiting for the writer or for the reader of a given lap around the ring, so producers only
+// contend on the write position and never wait on each other or on the reader.
+//
+// m_sequence is stored relative to the slot's index so that the zero initialization of static memory is the correct
+// starting state and we avoid a dynamic initializer.  For the lap that starts at position base (a multiple of
+// k_cLogSlots), the slot is free for writing when m_sequence is base, holds a message when it is base + 1, and
+// becomes free for the next lap when the reader sets it to base + k_cLogSlots
+struct LogSlot final {
+   std::atomic<size_t> m_sequence;
+   TraceEbmType m_traceLevel;
+   size_t m_cChars;
+   char m_chars[k_cLogSlotChars];
+};
+
+static LogSlot g_aLogSlots[k_cLogSlots];
+static std::atomic<size_t> g_iLogWrite { 0 };
+static std::atomic<size_t> g_iLogRead { 0 };
+static std::atomic<size_t> g_cLogDropped { 0 };
+
+EBM_NATIVE_IMPORT_EXPORT_BODY void EBM_NATIVE_CALLING_CONVENTION LogMessageToBuffer(
+   TraceEbmType traceLevel,
+   const char * message
+) {
+   // this function is called from within our logging, so it must not log
+   if(nullptr == message) {
+      return;
+   }
+
+   size_t iWrite = g_iLogWrite.load(std::memory_order_relaxed);
+   LogSlot * pSlot;
+   size_t base;
+   while(true) {
+      pSlot = &g_aLogSlots[iWrite & (k_cLogSlots - 1)];
+      base = iWrite & ~(k_cLogSlots - 1);
+      const size_t sequence = pSlot->m_sequence.load(std::memory_order_acquire);
+      const ptrdiff_t diff = static_cast<ptrdiff_t>(sequence - base);
+      if(0 == diff) {
+         if(g_iLogWrite.compare_exchange_weak(iWrite, iWrite + 1, std::memory_order_relaxed)) {
+            break;
+         }
+         // on failure compare_exchange_weak loaded the new write position into iWrite
+      } else if(diff < 0) {
+         // the reader has not emptied this slot from the previous lap, so the buffer is full.  We never wait since
+         // our callers are in the middle of boosting, so count it and let the host know on the next drain
+         g_cLogDropped.fetch_add(1, std::memory_order_relaxed);
+         return;
+      } else {
+         // another producer claimed this slot after we loaded the write position
+         iWrite = g_iLogWrite.load(std::memory_order_relaxed);
+      }
+   }
+
+   size_t cChars = strlen(message);
+   cChars = k_cLogSlotChars - 1 < cChars ? k_cLogSlotChars - 1 : cChars;
+   memcpy(pSlot->m_chars, message, cChars);
+   pSlot->m_chars[cChars] = '\0';
+   pSlot->m_cChars = cChars;
+   pSlot->m_traceLevel = traceLevel;
+
+   pSlot->m_sequence.store(base + 1, std::memory_order_release);
+}
+
+EBM_NATIVE_IMPORT_EXPORT_BODY ErrorEbmType EBM_NATIVE_CALLING_CONVENTION DrainLogMessages(
+   IntEbmType countMessagesMax,
+   IntEbmType countCharsMax,
+   TraceEbmType * traceLevelsOut,
+   char * charsOut,
+   IntEbmType * countMessagesOut,
+   IntEbmType * countDroppedOut
+) {
+   // we don't log the entry or exit here, since with the buffer as the log sink every drain would produce more
+   // messages to drain
+
+   if(nullptr == countMessagesOut || nullptr == countDroppedOut) {
+      LOG_0(TraceLevelError, "ERROR DrainLogMessages countMessagesOut and countDroppedOut cannot be null");
+      return Error_IllegalParamValue;
+   }
+   *countMessagesOut = 0;
+   *countDroppedOut = 0;
+
+   if(countMessagesMax < IntEbmType { 0 } || IsConvertError<size_t>(countMessagesMax)) {
+      LOG_0(TraceLevelError, "ERROR DrainLogMessages countMessagesMax must be positive");
+      return Error_IllegalParamValue;
+   }
+   const size_t cMessagesMax = static_cast<size_t>(countMessagesMax);
+
+   if(countCharsMax < IntEbmType { 0 } || IsConvertError<size_t>(countCharsMax)) {
+      LOG_0(TraceLevelError, "ERROR DrainLogMessages countCharsMax must be positive");
+      return Error_IllegalParamValue;
+   }
+   const size_t cCharsMax = static_cast<size_t>(countCharsMax);
+
+   if((size_t { 0 } != cMessagesMax && nullptr == traceLevelsOut) || (size_t { 0 } != cCharsMax && nullptr == charsOut)) {
+      LOG_0(TraceLevelError, "ERROR DrainLogMessages traceLevelsOut and charsOut cannot be null");
+      return Error_IllegalParamValue;
+   }
+
+   // there is only ever one reader, so nobody else moves g_iLogRead while we hold it in iRead
+   size_t iRead = g_iLogRead.load(std::memory_order_relaxed);
+   size_t iMessage = 0;
+   size_t iChar = 0;
+   while(iMessage < cMessagesMax) {
+      LogSlot * const pSlot = &g_aLogSlots[iRead & (k_cLogSlots - 1)];
+      const size_t base = iRead & ~(k_cLogSlots - 1);
+      if(base + 1 != pSlot->m_sequence.load(std::memory_order_acquire)) {
+         // either empty, or a producer has claimed the slot but has not finished writing it yet
+         break;
+      }
+      const size_t cChars = pSlot->m_cChars;
+      if(cCharsMax - iChar <= cChars) {
+         // no room for this message and its null terminator.  Leave it for the next drain
+         break;
+      }
+      memcpy(&charsOut[iChar], pSlot->m_chars, cChars + 1);
+      iChar += cChars + 1;
+      traceLevelsOut[iMessage] = pSlot->m_traceLevel;
+      ++iMessage;
+
+      pSlot->m_sequence.store(base + k_cLogSlots, std::memory_order_release);
+      ++iRead;
+   }
+   g_iLogRead.store(iRead, std::memory_order_relaxed);
+
+   const size_t cDropped = g_cLogDropped.exchange(0, std::memory_order_relaxed);
+   *countMessagesOut = static_cast<IntEbmType>(iMessage);
+   *countDroppedOut = IsConvertError<IntEbmType>(cDropped) ? std::numeric_limits<IntEbmType>::max() :
+      static_cast<IntEbmType>(cDropped);
+   return Error_None;
+}
+
+} // DEFINED_ZONE_NAME
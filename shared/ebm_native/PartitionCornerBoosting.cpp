@@ -0,0 +1,474 @@
+// Copyright (c) 2018 Microsoft Corporation
+// Licensed under the MIT license.
+// Author: Paul Koch <code@koch.ninja>
+
+#include "precompiled_header_cpp.hpp"
+
+#include <stddef.h> // size_t, ptrdiff_t
+
+#include "ebm_native.h"
+#include "logging.h"
+#include "zones.h"
+
+#include "ebm_internal.hpp"
+
+#include "CompressibleTensor.hpp"
+#include "ebm_stats.hpp"
+
+#include "Feature.hpp"
+#include "FeatureGroup.hpp"
+
+#include "HistogramTargetEntry.hpp"
+#include "HistogramBucket.hpp"
+
+#include "BoosterCore.hpp"
+#include "BoosterShell.hpp"
+
+#include "TensorTotalsSum.hpp"
+
+namespace DEFINED_ZONE_NAME {
+#ifndef DEFINED_ZONE_NAME
+#error DEFINED_ZONE_NAME must be defined
+#endif // DEFINED_ZONE_NAME
+
+// For terms with 3 or more significant dimensions we can't afford the pair algorithm's approach of sweeping each
+// dimension inside every other dimension since that grows with N! orderings.  Instead we look for the single
+// axis aligned box anchored at one of the 2^N corners of the tensor that best separates itself from the rest of the
+// tensor.  Every box anchored at a corner is fully described by one cell (the point) and the corner's direction
+// vector, and TensorTotalsSum gives us its totals from the TensorTotalsBuild prefix sums with at most 2^N lookups,
+// so we compute the gain while summing rather than materializing any partial tensors.  The rest of the tensor is the
+// total minus the box, which lets the resulting update be expressed as 1 split per significant dimension with the
+// box's update in one of the 2^N resulting cells and the rest's update in all the others.
+
+template<ptrdiff_t compilerLearningTypeOrCountTargetClasses>
+INLINE_ALWAYS static FloatBig SumPartialGains(
+   const HistogramBucket<FloatBig, IsClassification(compilerLearningTypeOrCountTargetClasses)> * const pHistogramBucket,
+   const size_t cVectorLength
+) {
+   constexpr bool bClassification = IsClassification(compilerLearningTypeOrCountTargetClasses);
+   constexpr bool bUseLogitBoost = k_bUseLogitboost && bClassification;
+
+   const FloatBig weight = pHistogramBucket->GetWeightInBucket();
+   const auto * const pHistogramTargetEntry = pHistogramBucket->GetHistogramTargetEntry();
+
+   FloatBig gain = 0;
+   for(size_t iVector = 0; iVector < cVectorLength; ++iVector) {
+      const FloatBig gainVector = EbmStats::CalcPartialGain(
+         pHistogramTargetEntry[iVector].m_sumGradients, bUseLogitBoost ? pHistogramTargetEntry[iVector].GetSumHessians() : weight);
+      EBM_ASSERT(std::isnan(gainVector) || 0 <= gainVector);
+      gain += gainVector;
+   }
+   return gain;
+}
+
+template<ptrdiff_t compilerLearningTypeOrCountTargetClasses>
+INLINE_ALWAYS static void ComputeUpdates(
+   const HistogramBucket<FloatBig, IsClassification(compilerLearningTypeOrCountTargetClasses)> * const pHistogramBucket,
+   const size_t cVectorLength,
+   FloatFast * const aUpdates
+) {
+   constexpr bool bClassification = IsClassification(compilerLearningTypeOrCountTargetClasses);
+
+   const auto * const pHistogramTargetEntry = pHistogramBucket->GetHistogramTargetEntry();
+
+#ifdef ZERO_FIRST_MULTICLASS_LOGIT
+   FloatBig zeroLogit = 0;
+#endif // ZERO_FIRST_MULTICLASS_LOGIT
+
+   for(size_t iVector = 0; iVector < cVectorLength; ++iVector) {
+      FloatBig update;
+      if(bClassification) {
+         update = EbmStats::ComputeSinglePartitionUpdate(
+            pHistogramTargetEntry[iVector].m_sumGradients,
+            pHistogramTargetEntry[iVector].GetSumHessians()
+         );
+
+#ifdef ZERO_FIRST_MULTICLASS_LOGIT
+         if(IsMulticlass(compilerLearningTypeOrCountTargetClasses)) {
+            if(size_t { 0 } == iVector) {
+               zeroLogit = update;
+            }
+            update -= zeroLogit;
+         }
+#endif // ZERO_FIRST_MULTICLASS_LOGIT
+
+      } else {
+         EBM_ASSERT(IsRegression(compilerLearningTypeOrCountTargetClasses));
+         update = EbmStats::ComputeSinglePartitionUpdate(
+            pHistogramTargetEntry[iVector].m_sumGradients,
+            pHistogramBucket->GetWeightInBucket()
+         );
+      }
+      aUpdates[iVector] = SafeConvertFloat<FloatFast>(update);
+   }
+}
+
+template<ptrdiff_t compilerLearningTypeOrCountTargetClasses>
+class PartitionCornerBoostingInternal final {
+public:
+
+   PartitionCornerBoostingInternal() = delete; // this is a static class.  Do not construct
+
+   static ErrorEbmType Func(
+      BoosterShell * const pBoosterShell,
+      const Term * const pTerm,
+      const size_t cSamplesRequiredForChildSplitMin,
+      HistogramBucketBase * pAuxiliaryBucketZoneBase,
+      double * const pTotalGain
+#ifndef NDEBUG
+      , const HistogramBucketBase * const aHistogramBucketsDebugCopyBase
+#endif // NDEBUG
+   ) {
+      constexpr bool bClassification = IsClassification(compilerLearningTypeOrCountTargetClasses);
+
+      ErrorEbmType error;
+      BoosterCore * const pBoosterCore = pBoosterShell->GetBoosterCore();
+
+      HistogramBucketBase * const aHistogramBucketBase = pBoosterShell->GetHistogramBucketBaseBig();
+      CompressibleTensor * const pInnerTermUpdate = pBoosterShell->GetInnerTermUpdate();
+
+      const ptrdiff_t runtimeLearningTypeOrCountTargetClasses = pBoosterCore->GetRuntimeLearningTypeOrCountTargetClasses();
+
+      const ptrdiff_t learningTypeOrCountTargetClasses = GET_LEARNING_TYPE_OR_COUNT_TARGET_CLASSES(
+         compilerLearningTypeOrCountTargetClasses,
+         runtimeLearningTypeOrCountTargetClasses
+      );
+
+      const size_t cVectorLength = GetVectorLength(learningTypeOrCountTargetClasses);
+      const size_t cBytesPerHistogramBucket = GetHistogramBucketSize<FloatBig>(bClassification, cVectorLength);
+
+      auto * const pAuxiliaryBucketZone = pAuxiliaryBucketZoneBase->GetHistogramBucket<FloatBig, bClassification>();
+      const auto * const aHistogramBuckets = aHistogramBucketBase->GetHistogramBucket<FloatBig, bClassification>();
+
+#ifndef NDEBUG
+      const auto * const aHistogramBucketsDebugCopy = aHistogramBucketsDebugCopyBase->GetHistogramBucket<FloatBig, bClassification>();
+#endif // NDEBUG
+
+      const size_t cSignificantDimensions = pTerm->GetCountSignificantDimensions();
+      EBM_ASSERT(3 <= cSignificantDimensions);
+      EBM_ASSERT(cSignificantDimensions <= k_cDimensionsCornerPartitionMax);
+
+      size_t aiDimensions[k_cDimensionsCornerPartitionMax];
+      size_t acBins[k_cDimensionsCornerPartitionMax];
+      size_t cSignificantDimensionsFound = 0;
+      size_t iDimensionLoop = 0;
+      const TermEntry * pTermEntry = pTerm->GetTermEntries();
+      const TermEntry * const pTermEntriesEnd = pTermEntry + pTerm->GetCountDimensions();
+      do {
+         const size_t cBins = pTermEntry->m_pFeature->GetCountBins();
+         EBM_ASSERT(size_t { 1 } <= cBins); // we don't boost on empty training sets
+         if(size_t { 1 } < cBins) {
+            EBM_ASSERT(cSignificantDimensionsFound < cSignificantDimensions);
+            aiDimensions[cSignificantDimensionsFound] = iDimensionLoop;
+            acBins[cSignificantDimensionsFound] = cBins;
+            ++cSignificantDimensionsFound;
+         }
+         ++iDimensionLoop;
+         ++pTermEntry;
+      } while(pTermEntriesEnd != pTermEntry);
+      EBM_ASSERT(cSignificantDimensions == cSignificantDimensionsFound);
+
+      // the bucket before the pAuxiliaryBucketZoneBase is the last summation bucket of aHistogramBucketsBase,
+      // which contains the totals of all buckets
+      const auto * const pTotal =
+         reinterpret_cast<const HistogramBucket<FloatBig, bClassification> *>(
+            reinterpret_cast<const char *>(pAuxiliaryBucketZoneBase) - cBytesPerHistogramBucket);
+
+      ASSERT_BINNED_BUCKET_OK(cBytesPerHistogramBucket, pTotal, pBoosterShell->GetHistogramBucketsEndDebugBig());
+
+      auto * const pTotalsCorner = GetHistogramBucketByIndex(cBytesPerHistogramBucket, pAuxiliaryBucketZone, 0);
+      ASSERT_BINNED_BUCKET_OK(cBytesPerHistogramBucket, pTotalsCorner, pBoosterShell->GetHistogramBucketsEndDebugBig());
+      auto * const pTotalsRest = GetHistogramBucketByIndex(cBytesPerHistogramBucket, pAuxiliaryBucketZone, 1);
+      ASSERT_BINNED_BUCKET_OK(cBytesPerHistogramBucket, pTotalsRest, pBoosterShell->GetHistogramBucketsEndDebugBig());
+      auto * const pTotalsCornerBest = GetHistogramBucketByIndex(cBytesPerHistogramBucket, pAuxiliaryBucketZone, 2);
+      ASSERT_BINNED_BUCKET_OK(cBytesPerHistogramBucket, pTotalsCornerBest, pBoosterShell->GetHistogramBucketsEndDebugBig());
+      auto * const pTotalsRestBest = GetHistogramBucketByIndex(cBytesPerHistogramBucket, pAuxiliaryBucketZone, 3);
+      ASSERT_BINNED_BUCKET_OK(cBytesPerHistogramBucket, pTotalsRestBest, pBoosterShell->GetHistogramBucketsEndDebugBig());
+
+      EBM_ASSERT(0 < cSamplesRequiredForChildSplitMin);
+
+      FloatBig bestGain = k_illegalGainFloat;
+      size_t directionVectorBest = 0;
+      size_t aiPointBest[k_cDimensionsCornerPartitionMax];
+
+      const size_t cCorners = size_t { 1 } << cSignificantDimensions;
+
+      LOG_0(TraceLevelVerbose, "PartitionCornerBoostingInternal Starting corner sweep loop");
+      size_t directionVector = 0;
+      do {
+         size_t aiPoint[k_cDimensionsCornerPartitionMax];
+         for(size_t iDimension = 0; iDimension < cSignificantDimensions; ++iDimension) {
+            aiPoint[iDimension] = 0;
+         }
+         while(true) {
+            TensorTotalsSum<compilerLearningTypeOrCountTargetClasses, k_dynamicDimensions>(
+               runtimeLearningTypeOrCountTargetClasses,
+               pTerm,
+               aHistogramBuckets,
+               aiPoint,
+               directionVector,
+               pTotalsCorner
+#ifndef NDEBUG
+               , aHistogramBucketsDebugCopy
+               , pBoosterShell->GetHistogramBucketsEndDebugBig()
+#endif // NDEBUG
+            );
+            if(LIKELY(cSamplesRequiredForChildSplitMin <= pTotalsCorner->GetCountSamplesInBucket())) {
+               pTotalsRest->Copy(*pTotal, cVectorLength);
+               pTotalsRest->Subtract(*pTotalsCorner, cVectorLength);
+               if(LIKELY(cSamplesRequiredForChildSplitMin <= pTotalsRest->GetCountSamplesInBucket())) {
+                  const FloatBig gain =
+                     SumPartialGains<compilerLearningTypeOrCountTargetClasses>(pTotalsCorner, cVectorLength) +
+                     SumPartialGains<compilerLearningTypeOrCountTargetClasses>(pTotalsRest, cVectorLength);
+                  EBM_ASSERT(std::isnan(gain) || 0 <= gain); // sumation of positive numbers should be positive
+
+                  if(UNLIKELY(/* NaN */ !LIKELY(gain <= bestGain))) {
+                     // propagate NaNs
+
+                     bestGain = gain;
+                     directionVectorBest = directionVector;
+                     for(size_t iDimension = 0; iDimension < cSignificantDimensions; ++iDimension) {
+                        aiPointBest[iDimension] = aiPoint[iDimension];
+                     }
+                     pTotalsCornerBest->Copy(*pTotalsCorner, cVectorLength);
+                     pTotalsRestBest->Copy(*pTotalsRest, cVectorLength);
+                  } else {
+                     EBM_ASSERT(!std::isnan(gain));
+                  }
+               }
+            }
+
+            // advance the point.  The last bin of each dimension is never a point since a box anchored there would
+            // span the entire dimension and have no split along it
+            size_t iDimensionIncrement = 0;
+            while(true) {
+               ++aiPoint[iDimensionIncrement];
+               if(LIKELY(aiPoint[iDimensionIncrement] < acBins[iDimensionIncrement] - 1)) {
+                  break;
+               }
+               aiPoint[iDimensionIncrement] = 0;
+               ++iDimensionIncrement;
+               if(UNLIKELY(cSignificantDimensions == iDimensionIncrement)) {
+                  goto next_corner;
+               }
+            }
+         }
+      next_corner:;
+         ++directionVector;
+      } while(cCorners != directionVector);
+      LOG_0(TraceLevelVerbose, "PartitionCornerBoostingInternal Done corner sweep loop");
+
+      EBM_ASSERT(std::isnan(bestGain) || k_illegalGainFloat == bestGain || 0 <= bestGain);
+
+      *pTotalGain = 0;
+      EBM_ASSERT(0 <= k_gainMin);
+      if(LIKELY(/* NaN */ !UNLIKELY(bestGain < k_gainMin))) {
+         EBM_ASSERT(std::isnan(bestGain) || 0 <= bestGain);
+
+         // signal that we've hit an overflow.  Use +inf here since our caller likes that and will flip to -inf
+         *pTotalGain = std::numeric_limits<double>::infinity();
+         if(LIKELY(/* NaN */ bestGain <= std::numeric_limits<FloatBig>::max())) {
+            EBM_ASSERT(!std::isnan(bestGain));
+            EBM_ASSERT(0 <= bestGain);
+            EBM_ASSERT(std::numeric_limits<FloatBig>::infinity() != bestGain);
+
+            // now subtract the parent partial gain
+            bestGain -= SumPartialGains<compilerLearningTypeOrCountTargetClasses>(pTotal, cVectorLength);
+
+            EBM_ASSERT(std::numeric_limits<FloatBig>::infinity() != bestGain);
+            EBM_ASSERT(std::isnan(bestGain) || -std::numeric_limits<FloatBig>::infinity() == bestGain ||
+               k_epsilonNegativeGainAllowed <= bestGain);
+
+            if(LIKELY(/* NaN */ std::numeric_limits<FloatBig>::lowest() <= bestGain)) {
+               EBM_ASSERT(!std::isnan(bestGain));
+               EBM_ASSERT(!std::isinf(bestGain));
+               EBM_ASSERT(k_epsilonNegativeGainAllowed <= bestGain);
+
+               *pTotalGain = 0;
+               if(LIKELY(k_gainMin <= bestGain)) {
+                  *pTotalGain = static_cast<double>(bestGain);
+
+                  for(size_t iDimension = 0; iDimension < cSignificantDimensions; ++iDimension) {
+                     error = pInnerTermUpdate->SetCountSplits(aiDimensions[iDimension], 1);
+                     if(Error_None != error) {
+                        // already logged
+                        return error;
+                     }
+                     pInnerTermUpdate->GetSplitPointer(aiDimensions[iDimension])[0] = aiPointBest[iDimension];
+                  }
+
+                  // cCorners can't overflow with cVectorLength since we have at least that many buckets allocated
+                  EBM_ASSERT(!IsMultiplyError(cVectorLength, cCorners));
+                  error = pInnerTermUpdate->EnsureScoreCapacity(cVectorLength * cCorners);
+                  if(Error_None != error) {
+                     // already logged
+                     return error;
+                  }
+
+                  // the lowest significant dimension varies fastest in the tensor, which matches the bit order
+                  // of our direction vectors, so the cell for the best corner is directionVectorBest
+                  FloatFast * const aUpdateScores = pInnerTermUpdate->GetScoresPointer();
+                  ComputeUpdates<compilerLearningTypeOrCountTargetClasses>(
+                     pTotalsRestBest, cVectorLength, aUpdateScores);
+                  for(size_t iCell = 1; iCell < cCorners; ++iCell) {
+                     for(size_t iVector = 0; iVector < cVectorLength; ++iVector) {
+                        aUpdateScores[iCell * cVectorLength + iVector] = aUpdateScores[iVector];
+                     }
+                  }
+                  ComputeUpdates<compilerLearningTypeOrCountTargetClasses>(
+                     pTotalsCornerBest, cVectorLength, &aUpdateScores[directionVectorBest * cVectorLength]);
+
+                  return Error_None;
+               }
+            } else {
+               EBM_ASSERT(std::isnan(bestGain) || -std::numeric_limits<FloatBig>::infinity() == bestGain);
+            }
+         } else {
+            EBM_ASSERT(std::isnan(bestGain) || std::numeric_limits<FloatBig>::infinity() == bestGain);
+         }
+      } else {
+         EBM_ASSERT(!std::isnan(bestGain));
+      }
+
+      // there were no good splits found
+      for(size_t iDimension = 0; iDimension < cSignificantDimensions; ++iDimension) {
+#ifndef NDEBUG
+         const ErrorEbmType errorDebug =
+#endif // NDEBUG
+            pInnerTermUpdate->SetCountSplits(aiDimensions[iDimension], 0);
+         // we can't fail since we're setting this to zero, so no allocations.  We don't in fact need the split array at all
+         EBM_ASSERT(Error_None == errorDebug);
+      }
+
+      // we don't need to call pInnerTermUpdate->EnsureScoreCapacity,
+      // since our value capacity would be 1, which is pre-allocated
+
+      ComputeUpdates<compilerLearningTypeOrCountTargetClasses>(pTotal, cVectorLength, pInnerTermUpdate->GetScoresPointer());
+      return Error_None;
+   }
+};
+
+template<ptrdiff_t compilerLearningTypeOrCountTargetClassesPossible>
+class PartitionCornerBoostingTarget final {
+public:
+
+   PartitionCornerBoostingTarget() = delete; // this is a static class.  Do not construct
+
+   INLINE_ALWAYS static ErrorEbmType Func(
+      BoosterShell * const pBoosterShell,
+      const Term * const pTerm,
+      const size_t cSamplesRequiredForChildSplitMin,
+      HistogramBucketBase * pAuxiliaryBucketZone,
+      double * const pTotalGain
+#ifndef NDEBUG
+      , const HistogramBucketBase * const aHistogramBucketsDebugCopy
+#endif // NDEBUG
+   ) {
+      static_assert(IsClassification(compilerLearningTypeOrCountTargetClassesPossible), "compilerLearningTypeOrCountTargetClassesPossible needs to be a classification");
+      static_assert(compilerLearningTypeOrCountTargetClassesPossible <= k_cCompilerOptimizedTargetClassesMax, "We can't have this many items in a data pack.");
+
+      BoosterCore * const pBoosterCore = pBoosterShell->GetBoosterCore();
+      const ptrdiff_t runtimeLearningTypeOrCountTargetClasses = pBoosterCore->GetRuntimeLearningTypeOrCountTargetClasses();
+      EBM_ASSERT(IsClassification(runtimeLearningTypeOrCountTargetClasses));
+      EBM_ASSERT(compilerLearningTypeOrCountTargetClassesPossible <= runtimeLearningTypeOrCountTargetClasses);
+
+      if(compilerLearningTypeOrCountTargetClassesPossible == runtimeLearningTypeOrCountTargetClasses) {
+         return PartitionCornerBoostingInternal<compilerLearningTypeOrCountTargetClassesPossible>::Func(
+            pBoosterShell,
+            pTerm,
+            cSamplesRequiredForChildSplitMin,
+            pAuxiliaryBucketZone,
+            pTotalGain
+#ifndef NDEBUG
+            , aHistogramBucketsDebugCopy
+#endif // NDEBUG
+         );
+      } else {
+         return PartitionCornerBoostingTarget<compilerLearningTypeOrCountTargetClassesPossible + 1>::Func(
+            pBoosterShell,
+            pTerm,
+            cSamplesRequiredForChildSplitMin,
+            pAuxiliaryBucketZone,
+            pTotalGain
+#ifndef NDEBUG
+            , aHistogramBucketsDebugCopy
+#endif // NDEBUG
+         );
+      }
+   }
+};
+
+template<>
+class PartitionCornerBoostingTarget<k_cCompilerOptimizedTargetClassesMax + 1> final {
+public:
+
+   PartitionCornerBoostingTarget() = delete; // this is a static class.  Do not construct
+
+   INLINE_ALWAYS static ErrorEbmType Func(
+      BoosterShell * const pBoosterShell,
+      const Term * const pTerm,
+      const size_t cSamplesRequiredForChildSplitMin,
+      HistogramBucketBase * pAuxiliaryBucketZone,
+      double * const pTotalGain
+#ifndef NDEBUG
+      , const HistogramBucketBase * const aHistogramBucketsDebugCopy
+#endif // NDEBUG
+   ) {
+      static_assert(IsClassification(k_cCompilerOptimizedTargetClassesMax), "k_cCompilerOptimizedTargetClassesMax needs to be a classification");
+
+      EBM_ASSERT(IsClassification(pBoosterShell->GetBoosterCore()->GetRuntimeLearningTypeOrCountTargetClasses()));
+      EBM_ASSERT(k_cCompilerOptimizedTargetClassesMax < pBoosterShell->GetBoosterCore()->GetRuntimeLearningTypeOrCountTargetClasses());
+
+      return PartitionCornerBoostingInternal<k_dynamicClassification>::Func(
+         pBoosterShell,
+         pTerm,
+         cSamplesRequiredForChildSplitMin,
+         pAuxiliaryBucketZone,
+         pTotalGain
+#ifndef NDEBUG
+         , aHistogramBucketsDebugCopy
+#endif // NDEBUG
+      );
+   }
+};
+
+extern ErrorEbmType PartitionCornerBoosting(
+   BoosterShell * const pBoosterShell,
+   const Term * const pTerm,
+   const size_t cSamplesRequiredForChildSplitMin,
+   HistogramBucketBase * pAuxiliaryBucketZone,
+   double * const pTotalGain
+#ifndef NDEBUG
+   , const HistogramBucketBase * const aHistogramBucketsDebugCopy
+#endif // NDEBUG
+) {
+   BoosterCore * const pBoosterCore = pBoosterShell->GetBoosterCore();
+   const ptrdiff_t runtimeLearningTypeOrCountTargetClasses = pBoosterCore->GetRuntimeLearningTypeOrCountTargetClasses();
+
+   if(IsClassification(runtimeLearningTypeOrCountTargetClasses)) {
+      return PartitionCornerBoostingTarget<2>::Func(
+         pBoosterShell,
+         pTerm,
+         cSamplesRequiredForChildSplitMin,
+         pAuxiliaryBucketZone,
+         pTotalGain
+#ifndef NDEBUG
+         , aHistogramBucketsDebugCopy
+#endif // NDEBUG
+      );
+   } else {
+      EBM_ASSERT(IsRegression(runtimeLearningTypeOrCountTargetClasses));
+      return PartitionCornerBoostingInternal<k_regression>::Func(
+         pBoosterShell,
+         pTerm,
+         cSamplesRequiredForChildSplitMin,
+         pAuxiliaryBucketZone,
+         pTotalGain
+#ifndef NDEBUG
+         , aHistogramBucketsDebugCopy
+#endif // NDEBUG
+      );
+   }
+}
+
+} // DEFINED_ZONE_NAME
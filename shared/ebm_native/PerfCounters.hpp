@@ -0,0 +1,81 @@
+// Copyright (c) 2018 Microsoft Corporation
+// Licensed under the MIT license.
+// Author: Paul Koch <code@koch.ninja>
+
+#ifndef PERF_COUNTERS_HPP
+#define PERF_COUNTERS_HPP
+
+#include <inttypes.h> // uint64_t
+#include <stddef.h> // size_t, ptrdiff_t
+#include <string.h> // memset
+#include <chrono> // steady_clock
+
+#include "ebm_native.h"
+#include "logging.h"
+#include "zones.h"
+
+#include "ebm_internal.hpp"
+
+namespace DEFINED_ZONE_NAME {
+#ifndef DEFINED_ZONE_NAME
+#error DEFINED_ZONE_NAME must be defined
+#endif // DEFINED_ZONE_NAME
+
+constexpr static size_t k_cPerfCounters = static_cast<size_t>(PerfCounter_Count);
+
+// PerfCounters are owned by a single BoosterShell or InteractionShell.  Shells are only ever used by one thread
+// at a time, so the counters don't need any synchronization.  Each measurement costs two reads of steady_clock,
+// which is negligible relative to the phases we time since each phase loops over the samples or the tensor bins.
+class PerfCounters final {
+   uint64_t m_aCountCalls[k_cPerfCounters];
+   uint64_t m_aNanoseconds[k_cPerfCounters];
+
+public:
+
+   PerfCounters() = default; // preserve our POD status
+   ~PerfCounters() = default; // preserve our POD status
+   void * operator new(std::size_t) = delete; // we only use malloc/free in this library
+   void operator delete (void *) = delete; // we only use malloc/free in this library
+
+   INLINE_ALWAYS void InitializeUnfailing() {
+      memset(m_aCountCalls, 0, sizeof(m_aCountCalls));
+      memset(m_aNanoseconds, 0, sizeof(m_aNanoseconds));
+   }
+
+   INLINE_ALWAYS static uint64_t GetTimestamp() {
+      return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+         std::chrono::steady_clock::now().time_since_epoch()).count());
+   }
+
+   INLINE_ALWAYS void Record(const IntEbmType perfCounter, const uint64_t timestampStart) {
+      EBM_ASSERT(IntEbmType { 0 } <= perfCounter);
+      EBM_ASSERT(static_cast<size_t>(perfCounter) < k_cPerfCounters);
+      const size_t iCounter = static_cast<size_t>(perfCounter);
+      ++m_aCountCalls[iCounter];
+      m_aNanoseconds[iCounter] += GetTimestamp() - timestampStart;
+   }
+
+   INLINE_ALWAYS void Fill(const size_t cCounters, IntEbmType * const aCallCountsOut, double * const aSecondsOut) const {
+      EBM_ASSERT(cCounters <= k_cPerfCounters);
+      for(size_t iCounter = 0; iCounter < cCounters; ++iCounter) {
+         if(nullptr != aCallCountsOut) {
+            const uint64_t cCalls = m_aCountCalls[iCounter];
+            aCallCountsOut[iCounter] = IsConvertError<IntEbmType>(cCalls) ?
+               std::numeric_limits<IntEbmType>::max() : static_cast<IntEbmType>(cCalls);
+         }
+         if(nullptr != aSecondsOut) {
+            aSecondsOut[iCounter] = static_cast<double>(m_aNanoseconds[iCounter]) * 1e-9;
+         }
+      }
+   }
+};
+static_assert(std::is_standard_layout<PerfCounters>::value,
+   "We use the struct hack in several places, so disallow non-standard_layout types in general");
+static_assert(std::is_trivial<PerfCounters>::value,
+   "We use memcpy in several places, so disallow non-trivial types in general");
+static_assert(std::is_pod<PerfCounters>::value,
+   "We use a lot of C constructs, so disallow non-POD types in general");
+
+} // DEFINED_ZONE_NAME
+
+#endif // PERF_COUNTERS_HPP
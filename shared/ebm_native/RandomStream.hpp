@@ -106,6 +106,21 @@ public:
       m_stateSeedConst = other.m_stateSeedConst;
    }
 
+   // booster snapshots are written as uint64_t so that the RNG stream can be resumed exactly where it left off
+   constexpr static size_t k_cStateItems = 3;
+
+   INLINE_ALWAYS void GetState(uint64_t * const aStateOut) const {
+      aStateOut[0] = static_cast<uint64_t>(m_state1);
+      aStateOut[1] = static_cast<uint64_t>(m_state2);
+      aStateOut[2] = static_cast<uint64_t>(m_stateSeedConst);
+   }
+
+   INLINE_ALWAYS void SetState(const uint64_t * const aState) {
+      m_state1 = static_cast<uint_fast64_t>(aState[0]);
+      m_state2 = static_cast<uint_fast64_t>(aState[1]);
+      m_stateSeedConst = static_cast<uint_fast64_t>(aState[2]);
+   }
+
    INLINE_ALWAYS SeedEbmType NextSeed() {
       static_assert(std::numeric_limits<SeedEbmType>::lowest() < SeedEbmType { 0 },
          "SeedEbmType must be signed");
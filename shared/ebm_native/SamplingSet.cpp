@@ -7,6 +7,9 @@
 #include <stdlib.h> // free
 #include <stddef.h> // size_t, ptrdiff_t
 #include <string.h> // memcpy
+#include <cmath> // std::abs, std::isnan
+#include <algorithm> // std::nth_element
+#include <functional> // std::greater
 
 #include "ebm_native.h"
 #include "logging.h"
@@ -172,12 +175,287 @@ SamplingSet * SamplingSet::GenerateFlatSamplingSet(
 void SamplingSet::Free() {
    free(m_aCountOccurrences);
    free(m_aWeights);
+   free(m_aiSelectedSamples);
+   free(m_aSelectedGradientsAndHessians);
    free(this);
 }
 
 void SamplingSet::InitializeUnfailing() {
    m_aCountOccurrences = nullptr;
    m_aWeights = nullptr;
+   m_cSelectedSamples = 0;
+   m_cSelectedOccurrences = 0;
+   m_aiSelectedSamples = nullptr;
+   m_aSelectedGradientsAndHessians = nullptr;
+   m_cSelectedCapacity = 0;
+}
+
+SamplingSet * SamplingSet::CreateCompactSamplingSet(
+   const DataSetBoosting * const pOriginDataSet,
+   const size_t cSelectedCapacity,
+   const size_t cFloatsPerSample
+) {
+   LOG_0(TraceLevelInfo, "Entered SamplingSet::CreateCompactSamplingSet");
+
+   EBM_ASSERT(nullptr != pOriginDataSet);
+   EBM_ASSERT(1 <= cSelectedCapacity);
+   EBM_ASSERT(cSelectedCapacity <= pOriginDataSet->GetCountSamples());
+   EBM_ASSERT(1 <= cFloatsPerSample);
+
+   if(IsMultiplyError(sizeof(FloatFast), cFloatsPerSample, cSelectedCapacity)) {
+      LOG_0(TraceLevelWarning, "WARNING SamplingSet::CreateCompactSamplingSet IsMultiplyError(sizeof(FloatFast), cFloatsPerSample, cSelectedCapacity)");
+      return nullptr;
+   }
+
+   SamplingSet * const pRet = EbmMalloc<SamplingSet>();
+   if(nullptr == pRet) {
+      LOG_0(TraceLevelWarning, "WARNING SamplingSet::CreateCompactSamplingSet nullptr == pRet");
+      return nullptr;
+   }
+   pRet->InitializeUnfailing();
+
+   pRet->m_aCountOccurrences = EbmMalloc<size_t>(cSelectedCapacity);
+   pRet->m_aWeights = EbmMalloc<FloatFast>(cSelectedCapacity);
+   pRet->m_aiSelectedSamples = EbmMalloc<size_t>(cSelectedCapacity);
+   pRet->m_aSelectedGradientsAndHessians = EbmMalloc<FloatFast>(cFloatsPerSample * cSelectedCapacity);
+   if(nullptr == pRet->m_aCountOccurrences || nullptr == pRet->m_aWeights || 
+      nullptr == pRet->m_aiSelectedSamples || nullptr == pRet->m_aSelectedGradientsAndHessians) 
+   {
+      pRet->Free();
+      LOG_0(TraceLevelWarning, "WARNING SamplingSet::CreateCompactSamplingSet out of memory");
+      return nullptr;
+   }
+   pRet->m_pOriginDataSet = pOriginDataSet;
+   pRet->m_weightTotal = 0;
+   pRet->m_cSelectedCapacity = cSelectedCapacity;
+
+   LOG_0(TraceLevelInfo, "Exited SamplingSet::CreateCompactSamplingSet");
+   return pRet;
+}
+
+ErrorEbmType SamplingSet::FillGradientSampling(
+   RandomDeterministic * const pRandomDeterministic,
+   const SamplingSet * const pBaseSamplingSet,
+   const size_t cFloatsPerSample,
+   const size_t cScores,
+   const double topRate,
+   const double otherRate,
+   FloatFast * const aMagnitudesTemp
+) {
+   LOG_0(TraceLevelVerbose, "Entered SamplingSet::FillGradientSampling");
+
+   EBM_ASSERT(nullptr != pRandomDeterministic);
+   EBM_ASSERT(nullptr != pBaseSamplingSet);
+   EBM_ASSERT(!pBaseSamplingSet->IsCompact());
+   EBM_ASSERT(m_pOriginDataSet == pBaseSamplingSet->GetDataSetBoosting());
+   EBM_ASSERT(nullptr != aMagnitudesTemp);
+   EBM_ASSERT(cScores <= cFloatsPerSample);
+
+   const size_t cSamples = m_pOriginDataSet->GetCountSamples();
+   const size_t * const aBaseCountOccurrences = pBaseSamplingSet->GetCountOccurrences();
+   const FloatFast * const aBaseWeights = pBaseSamplingSet->GetWeights();
+   const FloatFast * const aGradientsAndHessians = m_pOriginDataSet->GetGradientsAndHessiansPointer();
+
+   // samples that are not in the base set (inner bag) cannot be selected.  We mark them with a negative magnitude
+   FloatFast * const aMagnitudes = aMagnitudesTemp;
+   FloatFast * const aCandidateMagnitudes = aMagnitudesTemp + cSamples;
+   size_t cCandidates = 0;
+   for(size_t iSample = 0; iSample < cSamples; ++iSample) {
+      FloatFast magnitude = FloatFast { -1 };
+      if(size_t { 0 } != aBaseCountOccurrences[iSample]) {
+         // the gradients are stored first for each score, followed by the hessian for classification
+         const FloatFast * const pGradientAndHessian = &aGradientsAndHessians[iSample * cFloatsPerSample];
+         const size_t cFloatsPerScore = cFloatsPerSample / cScores;
+         magnitude = 0;
+         for(size_t iScore = 0; iScore < cScores; ++iScore) {
+            magnitude += std::abs(pGradientAndHessian[iScore * cFloatsPerScore]);
+         }
+         if(std::isnan(magnitude)) {
+            // keep samples with broken gradients at the top so that they surface instead of being sampled away
+            magnitude = std::numeric_limits<FloatFast>::max();
+         }
+         aCandidateMagnitudes[cCandidates] = magnitude;
+         ++cCandidates;
+      }
+      aMagnitudes[iSample] = magnitude;
+   }
+   EBM_ASSERT(1 <= cCandidates);
+
+   size_t cTop = static_cast<size_t>(topRate * static_cast<double>(cCandidates));
+   size_t cOther = static_cast<size_t>(otherRate * static_cast<double>(cCandidates));
+   cTop = std::min(cTop, cCandidates);
+   cOther = std::min(cOther, cCandidates - cTop);
+   if(size_t { 0 } == cTop + cOther) {
+      // always keep something to boost on
+      cTop = 1;
+   }
+   // the capacity is sized with the same rounding, but never write past it even if the two disagree
+   cTop = std::min(cTop, m_cSelectedCapacity);
+   cOther = std::min(cOther, m_cSelectedCapacity - cTop);
+   EBM_ASSERT(cTop + cOther <= m_cSelectedCapacity);
+
+   FloatFast threshold = std::numeric_limits<FloatFast>::max();
+   size_t cEqualTop = 0;
+   if(size_t { 0 } != cTop) {
+      std::nth_element(aCandidateMagnitudes, aCandidateMagnitudes + (cTop - 1), aCandidateMagnitudes + cCandidates, 
+         std::greater<FloatFast>());
+      threshold = aCandidateMagnitudes[cTop - 1];
+      // ties at the threshold are broken in favor of the lower sample indexes
+      size_t cAbove = 0;
+      for(size_t iCandidate = 0; iCandidate < cCandidates; ++iCandidate) {
+         if(threshold < aCandidateMagnitudes[iCandidate]) {
+            ++cAbove;
+         }
+      }
+      EBM_ASSERT(cAbove < cTop);
+      cEqualTop = cTop - cAbove;
+   }
+
+   // the remaining samples are picked by selection sampling, which visits them in order and gives each of them the
+   // same chance, so the selected list comes out sorted.  Their weights are scaled up to represent all of the 
+   // samples that were not kept
+   size_t cRest = cCandidates - cTop;
+   size_t cOtherNeeded = cOther;
+   const FloatFast otherMultiple = size_t { 0 } == cOther ? FloatFast { 0 } : 
+      static_cast<FloatFast>(static_cast<double>(cRest) / static_cast<double>(cOther));
+
+   size_t cSelected = 0;
+   size_t cSelectedOccurrences = 0;
+   FloatBig weightTotal = 0;
+   for(size_t iSample = 0; iSample < cSamples; ++iSample) {
+      const FloatFast magnitude = aMagnitudes[iSample];
+      if(magnitude < FloatFast { 0 }) {
+         continue;
+      }
+      FloatFast multiple;
+      if(threshold < magnitude) {
+         multiple = 1;
+      } else if(threshold == magnitude && size_t { 0 } != cEqualTop) {
+         --cEqualTop;
+         multiple = 1;
+      } else {
+         EBM_ASSERT(1 <= cRest);
+         const bool bSelect = size_t { 0 } != cOtherNeeded && pRandomDeterministic->NextFast(cRest) < cOtherNeeded;
+         --cRest;
+         if(!bSelect) {
+            continue;
+         }
+         --cOtherNeeded;
+         multiple = otherMultiple;
+      }
+
+      EBM_ASSERT(cSelected < m_cSelectedCapacity);
+      m_aiSelectedSamples[cSelected] = iSample;
+      m_aCountOccurrences[cSelected] = aBaseCountOccurrences[iSample];
+      const FloatFast weight = aBaseWeights[iSample] * multiple;
+      m_aWeights[cSelected] = weight;
+      memcpy(
+         &m_aSelectedGradientsAndHessians[cSelected * cFloatsPerSample], 
+         &aGradientsAndHessians[iSample * cFloatsPerSample], 
+         sizeof(FloatFast) * cFloatsPerSample
+      );
+      cSelectedOccurrences += aBaseCountOccurrences[iSample];
+      weightTotal += static_cast<FloatBig>(weight);
+      ++cSelected;
+   }
+   EBM_ASSERT(cTop + cOther == cSelected);
+   EBM_ASSERT(0 == cOtherNeeded);
+
+   if(std::isnan(weightTotal) || std::isinf(weightTotal) || weightTotal <= 0) {
+      LOG_0(TraceLevelWarning, "WARNING SamplingSet::FillGradientSampling std::isnan(weightTotal) || std::isinf(weightTotal) || weightTotal <= 0");
+      return Error_IllegalParamValue;
+   }
+
+   m_cSelectedSamples = cSelected;
+   m_cSelectedOccurrences = cSelectedOccurrences;
+   m_weightTotal = weightTotal;
+
+   LOG_0(TraceLevelVerbose, "Exited SamplingSet::FillGradientSampling");
+   return Error_None;
+}
+
+ErrorEbmType SamplingSet::FillRowSubsampling(
+   RandomDeterministic * const pRandomDeterministic,
+   const SamplingSet * const pBaseSamplingSet,
+   const size_t cFloatsPerSample,
+   const double rate
+) {
+   LOG_0(TraceLevelVerbose, "Entered SamplingSet::FillRowSubsampling");
+
+   EBM_ASSERT(nullptr != pRandomDeterministic);
+   EBM_ASSERT(nullptr != pBaseSamplingSet);
+   EBM_ASSERT(!pBaseSamplingSet->IsCompact());
+   EBM_ASSERT(m_pOriginDataSet == pBaseSamplingSet->GetDataSetBoosting());
+   EBM_ASSERT(0.0 < rate && rate < 1.0);
+
+   const size_t cSamples = m_pOriginDataSet->GetCountSamples();
+   const size_t * const aBaseCountOccurrences = pBaseSamplingSet->GetCountOccurrences();
+   const FloatFast * const aBaseWeights = pBaseSamplingSet->GetWeights();
+   const FloatFast * const aGradientsAndHessians = m_pOriginDataSet->GetGradientsAndHessiansPointer();
+
+   // samples that are not in the base set (inner bag) cannot be selected
+   size_t cCandidates = 0;
+   for(size_t iSample = 0; iSample < cSamples; ++iSample) {
+      if(size_t { 0 } != aBaseCountOccurrences[iSample]) {
+         ++cCandidates;
+      }
+   }
+   EBM_ASSERT(1 <= cCandidates);
+
+   // always keep something to boost on
+   size_t cSelect = std::max(size_t { 1 }, 
+      std::min(cCandidates, static_cast<size_t>(rate * static_cast<double>(cCandidates))));
+   EBM_ASSERT(cSelect <= m_cSelectedCapacity);
+   cSelect = std::min(cSelect, m_cSelectedCapacity);
+
+   // selection sampling visits the candidates in order and gives each of them the same chance, so the selected list
+   // comes out sorted.  Unlike GOSS we keep the original weights since every candidate is equally likely to be kept
+   size_t cRest = cCandidates;
+   size_t cNeeded = cSelect;
+   size_t cSelected = 0;
+   size_t cSelectedOccurrences = 0;
+   FloatBig weightTotal = 0;
+   for(size_t iSample = 0; size_t { 0 } != cNeeded; ++iSample) {
+      EBM_ASSERT(iSample < cSamples);
+      const size_t cOccurrences = aBaseCountOccurrences[iSample];
+      if(size_t { 0 } == cOccurrences) {
+         continue;
+      }
+      EBM_ASSERT(1 <= cRest);
+      const bool bSelect = pRandomDeterministic->NextFast(cRest) < cNeeded;
+      --cRest;
+      if(!bSelect) {
+         continue;
+      }
+      --cNeeded;
+
+      EBM_ASSERT(cSelected < m_cSelectedCapacity);
+      m_aiSelectedSamples[cSelected] = iSample;
+      m_aCountOccurrences[cSelected] = cOccurrences;
+      const FloatFast weight = aBaseWeights[iSample];
+      m_aWeights[cSelected] = weight;
+      memcpy(
+         &m_aSelectedGradientsAndHessians[cSelected * cFloatsPerSample], 
+         &aGradientsAndHessians[iSample * cFloatsPerSample], 
+         sizeof(FloatFast) * cFloatsPerSample
+      );
+      cSelectedOccurrences += cOccurrences;
+      weightTotal += static_cast<FloatBig>(weight);
+      ++cSelected;
+   }
+   EBM_ASSERT(cSelect == cSelected);
+
+   if(std::isnan(weightTotal) || std::isinf(weightTotal) || weightTotal <= 0) {
+      LOG_0(TraceLevelWarning, "WARNING SamplingSet::FillRowSubsampling std::isnan(weightTotal) || std::isinf(weightTotal) || weightTotal <= 0");
+      return Error_IllegalParamValue;
+   }
+
+   m_cSelectedSamples = cSelected;
+   m_cSelectedOccurrences = cSelectedOccurrences;
+   m_weightTotal = weightTotal;
+
+   LOG_0(TraceLevelVerbose, "Exited SamplingSet::FillRowSubsampling");
+   return Error_None;
 }
 
 WARNING_PUSH
@@ -35,6 +35,16 @@ class SamplingSet final {
    FloatFast * m_aWeights;
    FloatBig m_weightTotal;
 
+   // a compact SamplingSet only holds the samples it selected.  m_aiSelectedSamples is the sorted list of their
+   // indexes in the origin dataset, and m_aCountOccurrences, m_aWeights and m_aSelectedGradientsAndHessians are 
+   // indexed by the position in that list so that binning reads them contiguously.  Normal SamplingSet objects 
+   // leave m_aiSelectedSamples as nullptr and cover every sample in the origin dataset
+   size_t m_cSelectedSamples;
+   size_t m_cSelectedOccurrences;
+   size_t * m_aiSelectedSamples;
+   FloatFast * m_aSelectedGradientsAndHessians;
+   size_t m_cSelectedCapacity;
+
    // we take owernship of the aCounts array.  We do not take ownership of the pOriginDataSet since many 
    // SamplingSet objects will refer to the original one
    static SamplingSet * GenerateSingleSamplingSet(
@@ -46,7 +56,6 @@ class SamplingSet final {
       const DataSetBoosting * const pOriginDataSet,
       const FloatFast * const aWeights
    );
-   void Free();
    void InitializeUnfailing();
 
 public:
@@ -57,6 +66,9 @@ public:
    void operator delete (void *) = delete; // we only use malloc/free in this library
 
    size_t GetTotalCountSampleOccurrences() const {
+      if(nullptr != m_aiSelectedSamples) {
+         return m_cSelectedOccurrences;
+      }
       // for SamplingSet (bootstrap sampling), we have the same number of samples as our original dataset
       size_t cTotalCountSampleOccurrences = m_pOriginDataSet->GetCountSamples();
 #ifndef NDEBUG
@@ -83,6 +95,49 @@ public:
       return m_weightTotal;
    }
 
+   bool IsCompact() const {
+      return nullptr != m_aiSelectedSamples;
+   }
+   size_t GetCountSelectedSamples() const {
+      EBM_ASSERT(IsCompact());
+      return m_cSelectedSamples;
+   }
+   const size_t * GetSelectedSamples() const {
+      EBM_ASSERT(IsCompact());
+      return m_aiSelectedSamples;
+   }
+   const FloatFast * GetSelectedGradientsAndHessians() const {
+      EBM_ASSERT(IsCompact());
+      return m_aSelectedGradientsAndHessians;
+   }
+
+   static SamplingSet * CreateCompactSamplingSet(
+      const DataSetBoosting * const pOriginDataSet,
+      const size_t cSelectedCapacity,
+      const size_t cFloatsPerSample
+   );
+   void Free();
+
+   // keeps the samples with the largest gradients and a random part of the rest (GOSS), selecting only from the 
+   // samples that are in pBaseSamplingSet.  aMagnitudesTemp needs room for 2 * the samples in the origin dataset
+   ErrorEbmType FillGradientSampling(
+      RandomDeterministic * const pRandomDeterministic,
+      const SamplingSet * const pBaseSamplingSet,
+      const size_t cFloatsPerSample,
+      const size_t cScores,
+      const double topRate,
+      const double otherRate,
+      FloatFast * const aMagnitudesTemp
+   );
+
+   // keeps a uniformly random rate fraction of the samples in pBaseSamplingSet with their original weights
+   ErrorEbmType FillRowSubsampling(
+      RandomDeterministic * const pRandomDeterministic,
+      const SamplingSet * const pBaseSamplingSet,
+      const size_t cFloatsPerSample,
+      const double rate
+   );
+
    static SamplingSet ** GenerateSamplingSets(
       RandomDeterministic * const pRandomDeterministic,
       const DataSetBoosting * const pOriginDataSet, 
@@ -0,0 +1,423 @@
+// Copyright (c) 2018 Microsoft Corporation
+// Licensed under the MIT license.
+// Author: Paul Koch <code@koch.ninja>
+
+#include "precompiled_header_cpp.hpp"
+
+#include <stddef.h> // size_t, ptrdiff_t
+#include <string.h> // memcpy
+
+#include "ebm_native.h"
+#include "logging.h"
+#include "zones.h"
+
+#include "ebm_internal.hpp"
+
+#include "RandomStream.hpp"
+#include "CompressibleTensor.hpp"
+// FeatureGroup.hpp depends on FeatureInternal.h
+#include "FeatureGroup.hpp"
+#include "DataSetBoosting.hpp"
+
+#include "BoosterCore.hpp"
+#include "BoosterShell.hpp"
+
+namespace DEFINED_ZONE_NAME {
+#ifndef DEFINED_ZONE_NAME
+#error DEFINED_ZONE_NAME must be defined
+#endif // DEFINED_ZONE_NAME
+
+// A booster snapshot holds only the state that changes while boosting.  The dataset, bag, and term definitions
+// are not stored.  To resume, the caller re-creates the booster with CreateBooster using the same dataset, bag,
+// terms, inner bag count and random seed, and then calls DeserializeBooster.  Restoring the sample scores and
+// gradients directly is much cheaper than replaying the boosting rounds from the initial scores.
+//
+// The layout is native endian and only intended to be read by the same build that wrote it:
+//   SnapshotHeader
+//   for each term: current tensor scores, then best tensor scores
+//   training gradients and hessians (if allocated)
+//   training sample scores (if allocated)
+//   validation gradients (if allocated)
+//   validation sample scores (if allocated)
+//   term schedule entries (if SetTermScheduling is on for the handle)
+//
+// The term schedule belongs to the handle rather than the booster, and so do its settings.  To resume with 
+// scheduling, call SetTermScheduling with the same settings before DeserializeBooster, which restores the gain 
+// history and the round index.
+
+constexpr static uint64_t k_snapshotId = uint64_t { 0x5A37 }; // random 15 bit number
+constexpr static uint64_t k_snapshotVersion = uint64_t { 2 };
+
+struct SnapshotHeader {
+   uint64_t m_id;
+   uint64_t m_version;
+   int64_t m_runtimeLearningTypeOrCountTargetClasses;
+   uint64_t m_cTerms;
+   uint64_t m_cTermScores;
+   uint64_t m_cTrainingSamples;
+   uint64_t m_cValidationSamples;
+   uint64_t m_aRandomState[RandomDeterministic::k_cStateItems];
+   double m_bestModelMetric;
+   uint64_t m_cTermScheduleEntries;
+   uint64_t m_iTermScheduleRound;
+};
+static_assert(std::is_standard_layout<SnapshotHeader>::value,
+   "SnapshotHeader is written directly into the caller's buffer");
+static_assert(std::is_trivial<SnapshotHeader>::value,
+   "SnapshotHeader is written directly into the caller's buffer");
+
+struct SnapshotLayout {
+   size_t m_cTermScores;
+   size_t m_cTrainingGradientsAndHessians;
+   size_t m_cTrainingSampleScores;
+   size_t m_cValidationGradients;
+   size_t m_cValidationSampleScores;
+   size_t m_cTermScheduleEntries;
+   size_t m_cBytes;
+};
+
+static bool GetSnapshotLayout(BoosterShell * const pBoosterShell, SnapshotLayout * const pLayout) {
+   EBM_ASSERT(nullptr != pBoosterShell);
+   EBM_ASSERT(nullptr != pLayout);
+
+   BoosterCore * const pBoosterCore = pBoosterShell->GetBoosterCore();
+
+   const ptrdiff_t runtimeLearningTypeOrCountTargetClasses = pBoosterCore->GetRuntimeLearningTypeOrCountTargetClasses();
+   const bool bClassification = IsClassification(runtimeLearningTypeOrCountTargetClasses);
+   const size_t cVectorLength = GetVectorLength(runtimeLearningTypeOrCountTargetClasses);
+
+   size_t cTermScores = 0;
+   if(nullptr != pBoosterCore->GetCurrentModel()) {
+      const Term * const * ppTerm = pBoosterCore->GetTerms();
+      const Term * const * const ppTermsEnd = ppTerm + pBoosterCore->GetCountTerms();
+      while(ppTermsEnd != ppTerm) {
+         const size_t cTensorBins = (*ppTerm)->GetCountTensorBins();
+         // we allocated the tensors already, so these can't overflow
+         EBM_ASSERT(!IsMultiplyError(cVectorLength, cTensorBins));
+         const size_t cScores = cVectorLength * cTensorBins;
+         if(IsAddError(cTermScores, cScores)) {
+            return true;
+         }
+         cTermScores += cScores;
+         ++ppTerm;
+      }
+   }
+
+   // these mirror the allocations made for the training and validation sets in BoosterCore::Create
+   const size_t cTrainingSamples = pBoosterCore->GetTrainingSet()->GetCountSamples();
+   const size_t cValidationSamples = pBoosterCore->GetValidationSet()->GetCountSamples();
+   EBM_ASSERT(!IsMultiplyError(cVectorLength, cTrainingSamples, bClassification ? size_t { 2 } : size_t { 1 }));
+   EBM_ASSERT(!IsMultiplyError(cVectorLength, cValidationSamples));
+   const size_t cTrainingSampleScores = bClassification ? cVectorLength * cTrainingSamples : size_t { 0 };
+   const size_t cTrainingGradientsAndHessians = cVectorLength * cTrainingSamples * (bClassification ? size_t { 2 } : size_t { 1 });
+   const size_t cValidationSampleScores = bClassification ? cVectorLength * cValidationSamples : size_t { 0 };
+   const size_t cValidationGradients = bClassification ? size_t { 0 } : cVectorLength * cValidationSamples;
+
+   if(IsMultiplyError(size_t { 2 }, cTermScores)) {
+      return true;
+   }
+   const size_t cTensorItems = size_t { 2 } * cTermScores;
+   if(IsAddError(cTensorItems, cTrainingGradientsAndHessians, cTrainingSampleScores, cValidationGradients, cValidationSampleScores)) {
+      return true;
+   }
+   const size_t cItems = cTensorItems + cTrainingGradientsAndHessians + cTrainingSampleScores + cValidationGradients +
+      cValidationSampleScores;
+   if(IsMultiplyError(sizeof(FloatFast), cItems)) {
+      return true;
+   }
+   const size_t cBytesItems = sizeof(FloatFast) * cItems;
+
+   // SetTermScheduling already allocated one entry per term, so this can't overflow
+   const size_t cTermScheduleEntries = nullptr == pBoosterShell->GetTermSchedule() ? size_t { 0 } : 
+      pBoosterCore->GetCountTerms();
+   const size_t cBytesTermSchedule = sizeof(TermScheduleEntry) * cTermScheduleEntries;
+
+   if(IsAddError(sizeof(SnapshotHeader), cBytesItems, cBytesTermSchedule)) {
+      return true;
+   }
+
+   pLayout->m_cTermScores = cTermScores;
+   pLayout->m_cTrainingGradientsAndHessians = cTrainingGradientsAndHessians;
+   pLayout->m_cTrainingSampleScores = cTrainingSampleScores;
+   pLayout->m_cValidationGradients = cValidationGradients;
+   pLayout->m_cValidationSampleScores = cValidationSampleScores;
+   pLayout->m_cTermScheduleEntries = cTermScheduleEntries;
+   pLayout->m_cBytes = sizeof(SnapshotHeader) + cBytesItems + cBytesTermSchedule;
+   return false;
+}
+
+template<bool bSerialize>
+static unsigned char * CopyTensorScores(
+   const size_t cVectorLength,
+   const size_t cTerms,
+   const Term * const * const apTerms,
+   CompressibleTensor * const * const apTensors,
+   unsigned char * pBuffer
+) {
+   for(size_t iTerm = 0; iTerm < cTerms; ++iTerm) {
+      CompressibleTensor * const pTensor = apTensors[iTerm];
+      EBM_ASSERT(nullptr != pTensor);
+      EBM_ASSERT(pTensor->GetExpanded()); // the tensors are expanded at startup and stay that way
+      const size_t cBytes = sizeof(FloatFast) * cVectorLength * apTerms[iTerm]->GetCountTensorBins();
+      if(bSerialize) {
+         memcpy(pBuffer, pTensor->GetScoresPointer(), cBytes);
+      } else {
+         memcpy(pTensor->GetScoresPointer(), pBuffer, cBytes);
+      }
+      pBuffer += cBytes;
+   }
+   return pBuffer;
+}
+
+template<bool bSerialize>
+INLINE_ALWAYS static unsigned char * CopyFloats(const size_t cItems, FloatFast * const aFloats, unsigned char * pBuffer) {
+   if(0 != cItems) {
+      EBM_ASSERT(nullptr != aFloats);
+      const size_t cBytes = sizeof(FloatFast) * cItems;
+      if(bSerialize) {
+         memcpy(pBuffer, aFloats, cBytes);
+      } else {
+         memcpy(aFloats, pBuffer, cBytes);
+      }
+      pBuffer += cBytes;
+   }
+   return pBuffer;
+}
+
+template<bool bSerialize>
+static unsigned char * CopySnapshotBody(
+   BoosterShell * const pBoosterShell,
+   const SnapshotLayout * const pLayout,
+   unsigned char * pBuffer
+) {
+   BoosterCore * const pBoosterCore = pBoosterShell->GetBoosterCore();
+   const size_t cVectorLength = GetVectorLength(pBoosterCore->GetRuntimeLearningTypeOrCountTargetClasses());
+   if(nullptr != pBoosterCore->GetCurrentModel()) {
+      const size_t cTerms = pBoosterCore->GetCountTerms();
+      const Term * const * const apTerms = pBoosterCore->GetTerms();
+      pBuffer = CopyTensorScores<bSerialize>(cVectorLength, cTerms, apTerms, pBoosterCore->GetCurrentModel(), pBuffer);
+      pBuffer = CopyTensorScores<bSerialize>(cVectorLength, cTerms, apTerms, pBoosterCore->GetBestModel(), pBuffer);
+   }
+
+   DataSetBoosting * const pTrainingSet = pBoosterCore->GetTrainingSet();
+   DataSetBoosting * const pValidationSet = pBoosterCore->GetValidationSet();
+   pBuffer = CopyFloats<bSerialize>(pLayout->m_cTrainingGradientsAndHessians,
+      0 == pLayout->m_cTrainingGradientsAndHessians ? nullptr : pTrainingSet->GetGradientsAndHessiansPointer(), pBuffer);
+   pBuffer = CopyFloats<bSerialize>(pLayout->m_cTrainingSampleScores,
+      0 == pLayout->m_cTrainingSampleScores ? nullptr : pTrainingSet->GetSampleScores(), pBuffer);
+   pBuffer = CopyFloats<bSerialize>(pLayout->m_cValidationGradients,
+      0 == pLayout->m_cValidationGradients ? nullptr : pValidationSet->GetGradientsAndHessiansPointer(), pBuffer);
+   pBuffer = CopyFloats<bSerialize>(pLayout->m_cValidationSampleScores,
+      0 == pLayout->m_cValidationSampleScores ? nullptr : pValidationSet->GetSampleScores(), pBuffer);
+
+   if(0 != pLayout->m_cTermScheduleEntries) {
+      TermScheduleEntry * const aTermSchedule = pBoosterShell->GetTermSchedule();
+      EBM_ASSERT(nullptr != aTermSchedule);
+      const size_t cBytes = sizeof(TermScheduleEntry) * pLayout->m_cTermScheduleEntries;
+      if(bSerialize) {
+         memcpy(pBuffer, aTermSchedule, cBytes);
+      } else {
+         memcpy(aTermSchedule, pBuffer, cBytes);
+      }
+      pBuffer += cBytes;
+   }
+   return pBuffer;
+}
+
+EBM_NATIVE_IMPORT_EXPORT_BODY IntEbmType EBM_NATIVE_CALLING_CONVENTION SizeSerializedBooster(
+   BoosterHandle boosterHandle
+) {
+   LOG_N(TraceLevelInfo, "Entered SizeSerializedBooster: boosterHandle=%p", static_cast<void *>(boosterHandle));
+
+   BoosterShell * const pBoosterShell = BoosterShell::GetBoosterShellFromHandle(boosterHandle);
+   if(nullptr == pBoosterShell) {
+      // already logged
+      return Error_IllegalParamValue;
+   }
+
+   SnapshotLayout layout;
+   if(GetSnapshotLayout(pBoosterShell, &layout)) {
+      LOG_0(TraceLevelError, "ERROR SizeSerializedBooster GetSnapshotLayout overflow");
+      return Error_OutOfMemory;
+   }
+   if(IsConvertError<IntEbmType>(layout.m_cBytes)) {
+      LOG_0(TraceLevelError, "ERROR SizeSerializedBooster IsConvertError<IntEbmType>(layout.m_cBytes)");
+      return Error_OutOfMemory;
+   }
+
+   LOG_N(TraceLevelInfo, "Exited SizeSerializedBooster: %zu", layout.m_cBytes);
+   return static_cast<IntEbmType>(layout.m_cBytes);
+}
+
+EBM_NATIVE_IMPORT_EXPORT_BODY ErrorEbmType EBM_NATIVE_CALLING_CONVENTION SerializeBooster(
+   BoosterHandle boosterHandle,
+   IntEbmType countBytesAllocated,
+   void * fillMem
+) {
+   LOG_N(
+      TraceLevelInfo,
+      "Entered SerializeBooster: "
+      "boosterHandle=%p, "
+      "countBytesAllocated=%" IntEbmTypePrintf ", "
+      "fillMem=%p"
+      ,
+      static_cast<void *>(boosterHandle),
+      countBytesAllocated,
+      fillMem
+   );
+
+   BoosterShell * const pBoosterShell = BoosterShell::GetBoosterShellFromHandle(boosterHandle);
+   if(nullptr == pBoosterShell) {
+      // already logged
+      return Error_IllegalParamValue;
+   }
+
+   if(nullptr == fillMem) {
+      LOG_0(TraceLevelError, "ERROR SerializeBooster nullptr == fillMem");
+      return Error_IllegalParamValue;
+   }
+
+   if(IsConvertError<size_t>(countBytesAllocated)) {
+      LOG_0(TraceLevelError, "ERROR SerializeBooster countBytesAllocated is outside the range of a valid size");
+      return Error_IllegalParamValue;
+   }
+   const size_t cBytesAllocated = static_cast<size_t>(countBytesAllocated);
+
+   BoosterCore * const pBoosterCore = pBoosterShell->GetBoosterCore();
+
+   SnapshotLayout layout;
+   if(GetSnapshotLayout(pBoosterShell, &layout)) {
+      LOG_0(TraceLevelError, "ERROR SerializeBooster GetSnapshotLayout overflow");
+      return Error_OutOfMemory;
+   }
+   if(cBytesAllocated < layout.m_cBytes) {
+      LOG_0(TraceLevelError, "ERROR SerializeBooster cBytesAllocated < layout.m_cBytes");
+      return Error_IllegalParamValue;
+   }
+
+   unsigned char * pBuffer = static_cast<unsigned char *>(fillMem);
+
+   SnapshotHeader header;
+   header.m_id = k_snapshotId;
+   header.m_version = k_snapshotVersion;
+   header.m_runtimeLearningTypeOrCountTargetClasses = static_cast<int64_t>(pBoosterCore->GetRuntimeLearningTypeOrCountTargetClasses());
+   header.m_cTerms = static_cast<uint64_t>(pBoosterCore->GetCountTerms());
+   header.m_cTermScores = static_cast<uint64_t>(layout.m_cTermScores);
+   header.m_cTrainingSamples = static_cast<uint64_t>(pBoosterCore->GetTrainingSet()->GetCountSamples());
+   header.m_cValidationSamples = static_cast<uint64_t>(pBoosterCore->GetValidationSet()->GetCountSamples());
+   pBoosterShell->GetRandomDeterministic()->GetState(header.m_aRandomState);
+   header.m_bestModelMetric = pBoosterCore->GetBestModelMetric();
+   header.m_cTermScheduleEntries = static_cast<uint64_t>(layout.m_cTermScheduleEntries);
+   header.m_iTermScheduleRound = static_cast<uint64_t>(pBoosterShell->GetTermScheduleRound());
+   memcpy(pBuffer, &header, sizeof(header));
+   pBuffer += sizeof(header);
+
+   pBuffer = CopySnapshotBody<true>(pBoosterShell, &layout, pBuffer);
+   EBM_ASSERT(static_cast<unsigned char *>(fillMem) + layout.m_cBytes == pBuffer);
+
+   LOG_0(TraceLevelInfo, "Exited SerializeBooster");
+   return Error_None;
+}
+
+EBM_NATIVE_IMPORT_EXPORT_BODY ErrorEbmType EBM_NATIVE_CALLING_CONVENTION DeserializeBooster(
+   BoosterHandle boosterHandle,
+   IntEbmType countBytes,
+   const void * serialized
+) {
+   LOG_N(
+      TraceLevelInfo,
+      "Entered DeserializeBooster: "
+      "boosterHandle=%p, "
+      "countBytes=%" IntEbmTypePrintf ", "
+      "serialized=%p"
+      ,
+      static_cast<void *>(boosterHandle),
+      countBytes,
+      serialized
+   );
+
+   BoosterShell * const pBoosterShell = BoosterShell::GetBoosterShellFromHandle(boosterHandle);
+   if(nullptr == pBoosterShell) {
+      // already logged
+      return Error_IllegalParamValue;
+   }
+
+   if(nullptr == serialized) {
+      LOG_0(TraceLevelError, "ERROR DeserializeBooster nullptr == serialized");
+      return Error_IllegalParamValue;
+   }
+
+   if(IsConvertError<size_t>(countBytes)) {
+      LOG_0(TraceLevelError, "ERROR DeserializeBooster countBytes is outside the range of a valid size");
+      return Error_IllegalParamValue;
+   }
+   const size_t cBytes = static_cast<size_t>(countBytes);
+
+   if(cBytes < sizeof(SnapshotHeader)) {
+      LOG_0(TraceLevelError, "ERROR DeserializeBooster cBytes < sizeof(SnapshotHeader)");
+      return Error_IllegalParamValue;
+   }
+
+   const unsigned char * pBuffer = static_cast<const unsigned char *>(serialized);
+
+   SnapshotHeader header;
+   memcpy(&header, pBuffer, sizeof(header));
+   pBuffer += sizeof(header);
+
+   if(k_snapshotId != header.m_id) {
+      LOG_0(TraceLevelError, "ERROR DeserializeBooster k_snapshotId != header.m_id");
+      return Error_IllegalParamValue;
+   }
+   if(k_snapshotVersion != header.m_version) {
+      LOG_0(TraceLevelError, "ERROR DeserializeBooster k_snapshotVersion != header.m_version");
+      return Error_IllegalParamValue;
+   }
+
+   BoosterCore * const pBoosterCore = pBoosterShell->GetBoosterCore();
+
+   SnapshotLayout layout;
+   if(GetSnapshotLayout(pBoosterShell, &layout)) {
+      LOG_0(TraceLevelError, "ERROR DeserializeBooster GetSnapshotLayout overflow");
+      return Error_OutOfMemory;
+   }
+
+   // the snapshot is only valid for a booster created with the same dataset, bag, and terms.  We can't verify
+   // everything without storing the dataset, but we can catch the common mistakes cheaply
+   if(static_cast<int64_t>(pBoosterCore->GetRuntimeLearningTypeOrCountTargetClasses()) !=
+      header.m_runtimeLearningTypeOrCountTargetClasses ||
+      static_cast<uint64_t>(pBoosterCore->GetCountTerms()) != header.m_cTerms ||
+      static_cast<uint64_t>(layout.m_cTermScores) != header.m_cTermScores ||
+      static_cast<uint64_t>(pBoosterCore->GetTrainingSet()->GetCountSamples()) != header.m_cTrainingSamples ||
+      static_cast<uint64_t>(pBoosterCore->GetValidationSet()->GetCountSamples()) != header.m_cValidationSamples
+   ) {
+      LOG_0(TraceLevelError, "ERROR DeserializeBooster the snapshot was created from a booster with a different configuration");
+      return Error_IllegalParamValue;
+   }
+   if(static_cast<uint64_t>(layout.m_cTermScheduleEntries) != header.m_cTermScheduleEntries) {
+      LOG_0(TraceLevelError, "ERROR DeserializeBooster SetTermScheduling must be on for both handles or off for both");
+      return Error_IllegalParamValue;
+   }
+   if(IsConvertError<size_t>(header.m_iTermScheduleRound)) {
+      LOG_0(TraceLevelError, "ERROR DeserializeBooster IsConvertError<size_t>(header.m_iTermScheduleRound)");
+      return Error_IllegalParamValue;
+   }
+   if(cBytes != layout.m_cBytes) {
+      LOG_0(TraceLevelError, "ERROR DeserializeBooster cBytes != layout.m_cBytes");
+      return Error_IllegalParamValue;
+   }
+
+   pBuffer = CopySnapshotBody<false>(pBoosterShell, &layout, const_cast<unsigned char *>(pBuffer));
+   EBM_ASSERT(static_cast<const unsigned char *>(serialized) + layout.m_cBytes == pBuffer);
+
+   pBoosterCore->SetBestModelMetric(header.m_bestModelMetric);
+   pBoosterShell->GetRandomDeterministic()->SetState(header.m_aRandomState);
+   pBoosterShell->SetTermScheduleRound(static_cast<size_t>(header.m_iTermScheduleRound));
+
+   // any pending update was generated against the state we just replaced
+   pBoosterShell->SetTermIndex(BoosterShell::k_illegalTermIndex);
+
+   LOG_0(TraceLevelInfo, "Exited DeserializeBooster");
+   return Error_None;
+}
+
+} // DEFINED_ZONE_NAME
@@ -59,7 +59,7 @@ EBM_NATIVE_IMPORT_EXPORT_BODY const char * EBM_NATIVE_CALLING_CONVENTION GetTrac
 EBM_NATIVE_IMPORT_EXPORT_BODY void EBM_NATIVE_CALLING_CONVENTION SetLogMessageFunction(LOG_MESSAGE_FUNCTION logMessageFunction) {
    assert(NULL != logMessageFunction);
    assert(NULL == g_pLogMessageFunc); /* "SetLogMessageFunction should only be called once" */
-   assert(TraceLevelOff == g_traceLevel);
+   assert(TraceLevelOff == LOAD_TRACE_LEVEL());
 
    g_pLogMessageFunc = logMessageFunction;
 }
@@ -67,9 +67,9 @@ EBM_NATIVE_IMPORT_EXPORT_BODY void EBM_NATIVE_CALLING_CONVENTION SetLogMessageFu
 EBM_NATIVE_IMPORT_EXPORT_BODY void EBM_NATIVE_CALLING_CONVENTION SetTraceLevel(TraceEbmType traceLevel) {
    if(traceLevel < TraceLevelOff || TraceLevelVerbose < traceLevel || NULL == g_pLogMessageFunc) {
       // call SetLogMessageFunction before calling SetTraceLevel unless we're keeping tracing off
-      g_traceLevel = TraceLevelOff;
+      STORE_TRACE_LEVEL(TraceLevelOff);
    } else {
-      g_traceLevel = traceLevel;
+      STORE_TRACE_LEVEL(traceLevel);
 
       // this is not an actual error, but ensure that this message gets written to the log so that we know it was properly
       // set, and also test that the callback function works at this early stage instead of waiting for a real error
@@ -119,7 +119,7 @@ extern void LogAssertFailure(
    const char * const functionName,
    const char * const assertText
 ) LOGGING_ANALYZER_NORETURN {
-   if(TraceLevelError <= g_traceLevel) {
+   if(TraceLevelError <= LOAD_TRACE_LEVEL()) {
       InteralLogWithArguments(TraceLevelError, g_assertLogMessage, lineNumber, fileName, functionName, assertText);
    }
 }
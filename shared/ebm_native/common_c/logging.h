@@ -36,6 +36,27 @@ inline static const char * ObtainTruth(const BoolEbmType b) {
 
 extern TraceEbmType g_traceLevel;
 
+// g_traceLevel is read by every LOG_* macro, potentially on many threads while another thread calls SetTraceLevel.
+// This file is C99 so we do not have <stdatomic.h>, but aligned 32 bit loads and stores are indivisible on all the 
+// platforms we target, so we only need to stop the compiler from tearing, caching or reordering them.  The acquire 
+// load pairs with the release store so that a thread that sees a new trace level also sees g_pLogMessageFunc
+// The per-function LOG_COUNTED_* counters are thread_local (see below) and don't race.  LOAD_LOG_COUNT and 
+// STORE_LOG_COUNT are for the counters that live in objects instead, like the per-term counters that are shared by 
+// the views of a booster running on different threads.  Two threads can both read the same count there, which means 
+// a message gets logged once more than requested, but that's harmless and cheaper than a compare-exchange loop
+#if defined(__GNUC__) || defined(__clang__)
+#define LOAD_TRACE_LEVEL() (__atomic_load_n(&g_traceLevel, __ATOMIC_ACQUIRE))
+#define STORE_TRACE_LEVEL(traceLevel) (__atomic_store_n(&g_traceLevel, (traceLevel), __ATOMIC_RELEASE))
+#define LOAD_LOG_COUNT(pLogCount) (__atomic_load_n((pLogCount), __ATOMIC_RELAXED))
+#define STORE_LOG_COUNT(pLogCount, logCount) (__atomic_store_n((pLogCount), (logCount), __ATOMIC_RELAXED))
+#else // defined(__GNUC__) || defined(__clang__)
+// MSVC gives volatile accesses acquire/release semantics by default
+#define LOAD_TRACE_LEVEL() (*(volatile const TraceEbmType *)&g_traceLevel)
+#define STORE_TRACE_LEVEL(traceLevel) (*(volatile TraceEbmType *)&g_traceLevel = (traceLevel))
+#define LOAD_LOG_COUNT(pLogCount) (*(volatile const int *)(pLogCount))
+#define STORE_LOG_COUNT(pLogCount, logCount) (*(volatile int *)(pLogCount) = (logCount))
+#endif // defined(__GNUC__) || defined(__clang__)
+
 extern void InteralLogWithArguments(const TraceEbmType traceLevel, const char * const pOriginalMessage, ...);
 extern void InteralLogWithoutArguments(const TraceEbmType traceLevel, const char * const pOriginalMessage);
 extern void LogAssertFailure(
@@ -62,6 +83,9 @@ extern void LogAssertFailure(
 //   3) our variadic arguments won't be evaluated unless they are necessary (log level is set high enough).  If we had inlined them, they might have 
 //      needed to be evaluated, depending on the inputs
 
+// The per-function LOG_COUNTED_* counters are declared thread_local so that each thread gets its own budget of 
+// messages and so that threads calling the same function don't fight over the cache line holding the counter
+
 // MACRO notes for the below:
 // using a do loop below gives us a nice look to the macro where the caller needs to use a semi-colon to call it,
 // and it can be used after a single if statement without curly braces
@@ -77,7 +101,7 @@ extern void LogAssertFailure(
       const TraceEbmType LOG__traceLevel = (traceLevel); \
       static_assert(TraceLevelOff < LOG__traceLevel, "traceLevel can't be TraceLevelOff or lower for call to LOG_0(traceLevel, pLogMessage, ...)"); \
       static_assert(LOG__traceLevel <= TraceLevelVerbose, "traceLevel can't be higher than TraceLevelVerbose for call to LOG_0(traceLevel, pLogMessage, ...)"); \
-      if(LOG__traceLevel <= g_traceLevel) { \
+      if(LOG__traceLevel <= LOAD_TRACE_LEVEL()) { \
          const static char LOG__originalMessage[] = pLogMessage; \
          InteralLogWithoutArguments(LOG__traceLevel, LOG__originalMessage); \
       } \
@@ -89,7 +113,7 @@ extern void LogAssertFailure(
       static_assert(TraceLevelOff < LOG__traceLevel, "traceLevel can't be TraceLevelOff or lower for call to LOG_N(traceLevel, pLogMessage, ...)"); \
       static_assert(LOG__traceLevel <= TraceLevelVerbose, \
          "traceLevel can't be higher than TraceLevelVerbose for call to LOG_N(traceLevel, pLogMessage, ...)"); \
-      if(LOG__traceLevel <= g_traceLevel) { \
+      if(LOG__traceLevel <= LOAD_TRACE_LEVEL()) { \
          const static char LOG__originalMessage[] = pLogMessage; \
          InteralLogWithArguments(LOG__traceLevel, LOG__originalMessage, __VA_ARGS__); \
       } \
@@ -109,17 +133,17 @@ extern void LogAssertFailure(
          "traceLevelAfter can't be higher than TraceLevelVerbose for call to LOG_COUNTED_0(pLogCount, traceLevelBefore, traceLevelAfter, pLogMessage, ...)"); \
       static_assert(LOG__traceLevelBefore < LOG__traceLevelAfter, \
          "We only support increasing the required trace level after N iterations. It doesn't make sense to have equal values, otherwise just use LOG_0(..)"); \
-      const TraceEbmType LOG__traceLevel = g_traceLevel; \
+      const TraceEbmType LOG__traceLevel = LOAD_TRACE_LEVEL(); \
       if(LOG__traceLevelBefore <= LOG__traceLevel) { \
          do { \
             TraceEbmType LOG__traceLevelLogging; \
             if(LOG__traceLevel < LOG__traceLevelAfter) { \
                int * const LOG__pLogCountDecrement = (pLogCountDecrement); \
-               const int LOG__logCount = *LOG__pLogCountDecrement - 1; \
+               const int LOG__logCount = LOAD_LOG_COUNT(LOG__pLogCountDecrement) - 1; \
                if(LOG__logCount < 0) { \
                   break; \
                } \
-               *LOG__pLogCountDecrement = LOG__logCount; \
+               STORE_LOG_COUNT(LOG__pLogCountDecrement, LOG__logCount); \
                LOG__traceLevelLogging = LOG__traceLevelBefore; \
             } else { \
                LOG__traceLevelLogging = LOG__traceLevelAfter; \
@@ -144,17 +168,17 @@ extern void LogAssertFailure(
          "traceLevelAfter can't be higher than TraceLevelVerbose for call to LOG_COUNTED_N(pLogCount, traceLevelBefore, traceLevelAfter, pLogMessage, ...)"); \
       static_assert(LOG__traceLevelBefore < LOG__traceLevelAfter, \
          "We only support increasing the required trace level after N iterations and it doesn't make sense to have equal values, otherwise just use LOG_N(...)"); \
-      const TraceEbmType LOG__traceLevel = g_traceLevel; \
+      const TraceEbmType LOG__traceLevel = LOAD_TRACE_LEVEL(); \
       if(LOG__traceLevelBefore <= LOG__traceLevel) { \
          do { \
             TraceEbmType LOG__traceLevelLogging; \
             if(LOG__traceLevel < LOG__traceLevelAfter) { \
                int * const LOG__pLogCountDecrement = (pLogCountDecrement); \
-               const int LOG__logCount = *LOG__pLogCountDecrement - 1; \
+               const int LOG__logCount = LOAD_LOG_COUNT(LOG__pLogCountDecrement) - 1; \
                if(LOG__logCount < 0) { \
                   break; \
                } \
-               *LOG__pLogCountDecrement = LOG__logCount; \
+               STORE_LOG_COUNT(LOG__pLogCountDecrement, LOG__logCount); \
                LOG__traceLevelLogging = LOG__traceLevelBefore; \
             } else { \
                LOG__traceLevelLogging = LOG__traceLevelAfter; \
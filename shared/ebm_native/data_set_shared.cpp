@@ -565,12 +565,17 @@ static IntEbmType AppendFeature(
       bool bSparse = false;
       if(size_t { 0 } != cSamples) {
          if(nullptr == aBinnedData) {
-            LOG_0(TraceLevelError, "ERROR AppendFeature nullptr == aBinnedData");
-            goto return_bad;
+            if(nullptr != pFillMem) {
+               LOG_0(TraceLevelError, "ERROR AppendFeature nullptr == aBinnedData");
+               goto return_bad;
+            }
+            // SizeFeature without the binned data sizes the feature from the bin count alone, which lets callers
+            // allocate a dataset before discretizing.  Every feature is dense today, so this is exact.  If
+            // DecideIfSparse ever chooses sparse then this will need to return the dense size as an upper bound
+         } else {
+            // TODO: handle sparse data someday
+            bSparse = DecideIfSparse(cSamples, aBinnedData);
          }
-
-         // TODO: handle sparse data someday
-         bSparse = DecideIfSparse(cSamples, aBinnedData);
       }
 
       size_t iOffset = 0;
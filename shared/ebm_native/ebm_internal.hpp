@@ -96,6 +96,12 @@ static_assert(k_cCompilerOptimizedCountDimensionsMax <= k_cDimensionsMax,
 
 constexpr static size_t k_dynamicDimensions = 0;
 
+// terms with more significant dimensions than this are boosted with random splits since the corner partitioner
+// evaluates 2^N corners per cell
+constexpr static size_t k_cDimensionsCornerPartitionMax = 4;
+static_assert(k_cDimensionsCornerPartitionMax <= k_cDimensionsMax,
+   "k_cDimensionsCornerPartitionMax cannot be larger than the maximum number of dimensions.");
+
 #ifndef TODO_remove_this
 constexpr static size_t k_cItemsPerBitPackDynamic = 0;
 constexpr static size_t k_cItemsPerBitPackMax = 0; // if there are more than 16 (4 bits), then we should just use a loop since the code will be pretty big
@@ -0,0 +1,516 @@
+// Copyright (c) 2018 Microsoft Corporation
+// Licensed under the MIT license.
+// Author: Paul Koch <code@koch.ninja>
+
+// ebm_native_bench times the hot paths of ebm_native through the public C interface on synthetic data.
+// Each benchmark writes a single JSON object per line to stdout so that results can be collected and
+// compared across commits by scripts.  Run with -help to see the options.
+//
+// gb_per_second is computed from the bytes that each operation needs to stream through memory at a minimum:
+//   CutQuantile          -> the feature values (double)
+//   Discretize           -> the feature values (double) + the discretized output (IntEbmType)
+//   DataSetFill          -> the binned inputs (IntEbmType) + targets + the output dataset
+//   GenerateTermUpdate   -> the bit packed features + gradients (+ hessians for classification) of the training set
+//   ApplyTermUpdate      -> the bit packed features + sample scores/gradients of the training and validation sets
+//   CalcInteractionStrength -> the bit packed features + gradients (+ hessians) of the interaction set
+// These are lower bounds, so treat GB/s as a way to compare runs rather than an absolute memory bandwidth.
+
+#include <stdio.h> // printf
+#include <stdlib.h> // exit, strtoll
+#include <stdint.h> // uint64_t
+#include <string.h> // strcmp
+#include <stddef.h> // size_t
+#include <vector>
+#include <chrono>
+#include <random>
+#include <algorithm> // std::min, std::max
+
+#include "ebm_native.h"
+
+namespace {
+
+struct BenchConfig {
+   size_t cSamples;
+   size_t cFeatures;
+   size_t cBins;
+   IntEbmType cClasses; // less than 2 means regression
+   size_t cIterations;
+   SeedEbmType seed;
+};
+
+struct Timing {
+   double secondsMin;
+   double secondsTotal;
+   size_t cIterations;
+};
+
+class Stopwatch final {
+   std::chrono::steady_clock::time_point m_start;
+public:
+   Stopwatch() : m_start(std::chrono::steady_clock::now()) {
+   }
+   double Seconds() const {
+      return std::chrono::duration<double>(std::chrono::steady_clock::now() - m_start).count();
+   }
+};
+
+static void CheckError(const ErrorEbmType error, const char * const sFunction) {
+   if(Error_None != error) {
+      fprintf(stderr, "%s failed with error %d\n", sFunction, static_cast<int>(error));
+      exit(1);
+   }
+}
+
+static void AddTiming(Timing * const pTiming, const double seconds) {
+   pTiming->secondsMin = 0 == pTiming->cIterations ? seconds : std::min(pTiming->secondsMin, seconds);
+   pTiming->secondsTotal += seconds;
+   ++pTiming->cIterations;
+}
+
+static void Report(
+   const BenchConfig & config,
+   const char * const sBenchmark,
+   const Timing & timing,
+   const double cRowsPerIteration,
+   const double cBytesPerIteration
+) {
+   const double seconds = timing.secondsMin;
+   const double rowsPerSecond = 0.0 < seconds ? cRowsPerIteration / seconds : 0.0;
+   const double bytesPerSecond = 0.0 < seconds ? cBytesPerIteration / seconds : 0.0;
+   printf(
+      "{\"benchmark\":\"%s\",\"rows\":%zu,\"features\":%zu,\"bins\":%zu,\"classes\":%lld,\"iterations\":%zu,"
+      "\"seconds_min\":%.9g,\"seconds_mean\":%.9g,\"rows_per_second\":%.6g,\"gb_per_second\":%.6g}\n",
+      sBenchmark,
+      config.cSamples,
+      config.cFeatures,
+      config.cBins,
+      static_cast<long long>(config.cClasses < 2 ? 0 : config.cClasses),
+      timing.cIterations,
+      seconds,
+      0 == timing.cIterations ? 0.0 : timing.secondsTotal / static_cast<double>(timing.cIterations),
+      rowsPerSecond,
+      bytesPerSecond * 1e-9
+   );
+   fflush(stdout);
+}
+
+static size_t BitsRequired(const size_t cBins) {
+   size_t cBits = 1;
+   while(cBins - 1 >> cBits) {
+      ++cBits;
+   }
+   return cBits;
+}
+
+static double BytesPacked(const size_t cSamples, const size_t cBins) {
+   // features are packed into 64 bit words with as many items per word as will fit
+   const size_t cItemsPerPack = std::max(size_t { 1 }, size_t { 64 } / BitsRequired(cBins));
+   return static_cast<double>((cSamples + cItemsPerPack - 1) / cItemsPerPack * sizeof(uint64_t));
+}
+
+static size_t CountScores(const BenchConfig & config) {
+   return config.cClasses < 3 ? size_t { 1 } : static_cast<size_t>(config.cClasses);
+}
+
+static void PrintUsage() {
+   printf(
+      "ebm_native_bench [-rows N] [-features N] [-bins N] [-classes N] [-iterations N] [-seed N]\n"
+      "   -classes 0 benchmarks regression, 2 binary classification, and 3+ multiclass\n"
+   );
+}
+
+static BenchConfig ParseArgs(const int argc, char ** const argv) {
+   BenchConfig config;
+   config.cSamples = 100000;
+   config.cFeatures = 10;
+   config.cBins = 256;
+   config.cClasses = 2;
+   config.cIterations = 5;
+   config.seed = 42;
+
+   for(int iArg = 1; iArg < argc; ++iArg) {
+      const char * const sArg = argv[iArg];
+      if(0 == strcmp(sArg, "-help") || 0 == strcmp(sArg, "--help")) {
+         PrintUsage();
+         exit(0);
+      }
+      if(argc <= iArg + 1) {
+         PrintUsage();
+         exit(1);
+      }
+      const long long val = strtoll(argv[iArg + 1], nullptr, 10);
+      if(val < 0) {
+         PrintUsage();
+         exit(1);
+      }
+      if(0 == strcmp(sArg, "-rows")) {
+         config.cSamples = static_cast<size_t>(val);
+      } else if(0 == strcmp(sArg, "-features")) {
+         config.cFeatures = static_cast<size_t>(val);
+      } else if(0 == strcmp(sArg, "-bins")) {
+         config.cBins = static_cast<size_t>(val);
+      } else if(0 == strcmp(sArg, "-classes")) {
+         config.cClasses = static_cast<IntEbmType>(val);
+      } else if(0 == strcmp(sArg, "-iterations")) {
+         config.cIterations = static_cast<size_t>(val);
+      } else if(0 == strcmp(sArg, "-seed")) {
+         config.seed = static_cast<SeedEbmType>(val);
+      } else {
+         PrintUsage();
+         exit(1);
+      }
+      ++iArg;
+   }
+   if(config.cSamples < 2 || config.cFeatures < 2 || config.cBins < 2 || 0 == config.cIterations) {
+      PrintUsage();
+      exit(1);
+   }
+   return config;
+}
+
+static std::vector<double> MakeFeatureValues(const BenchConfig & config, std::mt19937_64 & rng) {
+   // mix a few distributions so that the cut algorithms see both smooth and lumpy data
+   std::normal_distribution<double> normal(0.0, 1.0);
+   std::uniform_int_distribution<int> lumpy(0, 31);
+   std::vector<double> values(config.cSamples * config.cFeatures);
+   for(size_t iFeature = 0; iFeature < config.cFeatures; ++iFeature) {
+      double * const pValues = &values[iFeature * config.cSamples];
+      for(size_t iSample = 0; iSample < config.cSamples; ++iSample) {
+         pValues[iSample] = 0 == (iFeature & 1) ? normal(rng) : static_cast<double>(lumpy(rng));
+      }
+   }
+   return values;
+}
+
+} // namespace
+
+int main(int argc, char ** argv) {
+   const BenchConfig config = ParseArgs(argc, argv);
+   const size_t cSamples = config.cSamples;
+   const size_t cFeatures = config.cFeatures;
+   const bool bClassification = 2 <= config.cClasses;
+   const size_t cScores = CountScores(config);
+
+   std::mt19937_64 rng(static_cast<uint64_t>(config.seed));
+   const std::vector<double> featureValues = MakeFeatureValues(config, rng);
+
+   // CutQuantile
+   std::vector<std::vector<double>> cuts(cFeatures);
+   {
+      Timing timing = {};
+      for(size_t iIteration = 0; iIteration < config.cIterations; ++iIteration) {
+         const Stopwatch stopwatch;
+         for(size_t iFeature = 0; iFeature < cFeatures; ++iFeature) {
+            std::vector<double> & featureCuts = cuts[iFeature];
+            featureCuts.resize(config.cBins - 1);
+            IntEbmType cCuts = static_cast<IntEbmType>(config.cBins - 1);
+            const ErrorEbmType error = CutQuantile(
+               static_cast<IntEbmType>(cSamples),
+               &featureValues[iFeature * cSamples],
+               IntEbmType { 1 },
+               EBM_FALSE,
+               &cCuts,
+               0 == featureCuts.size() ? nullptr : &featureCuts[0]
+            );
+            CheckError(error, "CutQuantile");
+            featureCuts.resize(static_cast<size_t>(cCuts));
+         }
+         AddTiming(&timing, stopwatch.Seconds());
+      }
+      const double cRows = static_cast<double>(cSamples * cFeatures);
+      Report(config, "CutQuantile", timing, cRows, cRows * sizeof(double));
+   }
+
+   // Discretize
+   std::vector<IntEbmType> binned(cSamples * cFeatures);
+   std::vector<IntEbmType> binCounts(cFeatures);
+   {
+      Timing timing = {};
+      for(size_t iIteration = 0; iIteration < config.cIterations; ++iIteration) {
+         const Stopwatch stopwatch;
+         for(size_t iFeature = 0; iFeature < cFeatures; ++iFeature) {
+            const std::vector<double> & featureCuts = cuts[iFeature];
+            const ErrorEbmType error = Discretize(
+               static_cast<IntEbmType>(cSamples),
+               &featureValues[iFeature * cSamples],
+               static_cast<IntEbmType>(featureCuts.size()),
+               0 == featureCuts.size() ? nullptr : &featureCuts[0],
+               &binned[iFeature * cSamples]
+            );
+            CheckError(error, "Discretize");
+         }
+         AddTiming(&timing, stopwatch.Seconds());
+      }
+      for(size_t iFeature = 0; iFeature < cFeatures; ++iFeature) {
+         // missing (0), the cut ranges, and unknown
+         binCounts[iFeature] = static_cast<IntEbmType>(cuts[iFeature].size() + 3);
+      }
+      const double cRows = static_cast<double>(cSamples * cFeatures);
+      Report(config, "Discretize", timing, cRows, cRows * (sizeof(double) + sizeof(IntEbmType)));
+   }
+
+   // targets are a noisy function of the first two features so that boosting finds real splits
+   std::vector<IntEbmType> targetsClassification;
+   std::vector<double> targetsRegression;
+   {
+      std::normal_distribution<double> noise(0.0, 0.5);
+      if(bClassification) {
+         targetsClassification.resize(cSamples);
+      } else {
+         targetsRegression.resize(cSamples);
+      }
+      for(size_t iSample = 0; iSample < cSamples; ++iSample) {
+         const double val = featureValues[iSample] + 0.1 * featureValues[cSamples + iSample] + noise(rng);
+         if(bClassification) {
+            const double scaled = (val + 2.0) * static_cast<double>(config.cClasses) / 4.0;
+            const IntEbmType iClass = static_cast<IntEbmType>(std::max(0.0, scaled));
+            targetsClassification[iSample] = std::min(iClass, config.cClasses - 1);
+         } else {
+            targetsRegression[iSample] = val;
+         }
+      }
+   }
+
+   // DataSetFill
+   std::vector<unsigned char> dataSet;
+   {
+      Timing timing = {};
+      for(size_t iIteration = 0; iIteration < config.cIterations; ++iIteration) {
+         const Stopwatch stopwatch;
+
+         IntEbmType cBytes = SizeDataSetHeader(static_cast<IntEbmType>(cFeatures), 0, 1);
+         for(size_t iFeature = 0; iFeature < cFeatures; ++iFeature) {
+            cBytes += SizeFeature(
+               binCounts[iFeature],
+               EBM_TRUE,
+               EBM_TRUE,
+               EBM_FALSE,
+               static_cast<IntEbmType>(cSamples),
+               &binned[iFeature * cSamples]
+            );
+         }
+         if(bClassification) {
+            cBytes += SizeClassificationTarget(config.cClasses, static_cast<IntEbmType>(cSamples), &targetsClassification[0]);
+         } else {
+            cBytes += SizeRegressionTarget(static_cast<IntEbmType>(cSamples), &targetsRegression[0]);
+         }
+         if(cBytes <= 0) {
+            fprintf(stderr, "dataset sizing failed\n");
+            exit(1);
+         }
+
+         dataSet.resize(static_cast<size_t>(cBytes));
+         CheckError(FillDataSetHeader(static_cast<IntEbmType>(cFeatures), 0, 1, cBytes, &dataSet[0]), "FillDataSetHeader");
+         for(size_t iFeature = 0; iFeature < cFeatures; ++iFeature) {
+            const ErrorEbmType error = FillFeature(
+               binCounts[iFeature],
+               EBM_TRUE,
+               EBM_TRUE,
+               EBM_FALSE,
+               static_cast<IntEbmType>(cSamples),
+               &binned[iFeature * cSamples],
+               cBytes,
+               &dataSet[0]
+            );
+            CheckError(error, "FillFeature");
+         }
+         if(bClassification) {
+            const ErrorEbmType error = FillClassificationTarget(
+               config.cClasses,
+               static_cast<IntEbmType>(cSamples),
+               &targetsClassification[0],
+               cBytes,
+               &dataSet[0]
+            );
+            CheckError(error, "FillClassificationTarget");
+         } else {
+            const ErrorEbmType error = FillRegressionTarget(
+               static_cast<IntEbmType>(cSamples),
+               &targetsRegression[0],
+               cBytes,
+               &dataSet[0]
+            );
+            CheckError(error, "FillRegressionTarget");
+         }
+
+         AddTiming(&timing, stopwatch.Seconds());
+      }
+      const double cBytesIn = static_cast<double>(cSamples * cFeatures * sizeof(IntEbmType) +
+         cSamples * (bClassification ? sizeof(IntEbmType) : sizeof(double)));
+      Report(config, "DataSetFill", timing, static_cast<double>(cSamples), cBytesIn + static_cast<double>(dataSet.size()));
+   }
+
+   // use 80% of the samples for training and 20% for validation, like the default EBM outer bag
+   const size_t cValidationSamples = cSamples / 5;
+   const size_t cTrainingSamples = cSamples - cValidationSamples;
+   std::vector<BagEbmType> bag(cSamples, BagEbmType { 1 });
+   CheckError(
+      SampleWithoutReplacement(
+         EBM_TRUE,
+         config.seed,
+         static_cast<IntEbmType>(cTrainingSamples),
+         static_cast<IntEbmType>(cValidationSamples),
+         &bag[0]
+      ),
+      "SampleWithoutReplacement"
+   );
+
+   // terms are every main followed by the pairs (0, 1), (2, 3), ...
+   const size_t cPairs = cFeatures / 2;
+   std::vector<IntEbmType> dimensionCounts;
+   std::vector<IntEbmType> featureIndexes;
+   for(size_t iFeature = 0; iFeature < cFeatures; ++iFeature) {
+      dimensionCounts.push_back(1);
+      featureIndexes.push_back(static_cast<IntEbmType>(iFeature));
+   }
+   for(size_t iPair = 0; iPair < cPairs; ++iPair) {
+      dimensionCounts.push_back(2);
+      featureIndexes.push_back(static_cast<IntEbmType>(iPair * 2));
+      featureIndexes.push_back(static_cast<IntEbmType>(iPair * 2 + 1));
+   }
+
+   BoosterHandle boosterHandle = nullptr;
+   CheckError(
+      CreateBooster(
+         config.seed,
+         &dataSet[0],
+         &bag[0],
+         nullptr,
+         static_cast<IntEbmType>(dimensionCounts.size()),
+         &dimensionCounts[0],
+         &featureIndexes[0],
+         IntEbmType { 0 },
+         CreateBoosterFlags_Default,
+         nullptr,
+         &boosterHandle
+      ),
+      "CreateBooster"
+   );
+
+   const double cBytesGradients = static_cast<double>(cScores * sizeof(double) * (bClassification ? 2 : 1));
+   double cBytesTrainingFeatures = 0.0;
+   double cBytesValidationFeatures = 0.0;
+   for(size_t iFeature = 0; iFeature < cFeatures; ++iFeature) {
+      cBytesTrainingFeatures += BytesPacked(cTrainingSamples, static_cast<size_t>(binCounts[iFeature]));
+      cBytesValidationFeatures += BytesPacked(cValidationSamples, static_cast<size_t>(binCounts[iFeature]));
+   }
+   const double cBytesTrainingMain = cBytesTrainingFeatures / static_cast<double>(cFeatures);
+   const double cBytesValidationMain = cBytesValidationFeatures / static_cast<double>(cFeatures);
+
+   const IntEbmType leavesMax[] = { 3, 3 };
+
+   struct BoostingBenchmark {
+      const char * sName;
+      size_t iTermStart;
+      size_t cTerms;
+      GenerateUpdateOptionsType options;
+   };
+   const BoostingBenchmark boostingBenchmarks[] = {
+      { "GenerateTermUpdate/mains", 0, cFeatures, GenerateUpdateOptions_Default },
+      { "GenerateTermUpdate/pairs", cFeatures, cPairs, GenerateUpdateOptions_Default },
+      { "GenerateTermUpdate/random_splits", 0, cFeatures, GenerateUpdateOptions_RandomSplits },
+   };
+
+   Timing timingApply = {};
+   size_t cApplyTerms = 0;
+   for(const BoostingBenchmark & benchmark : boostingBenchmarks) {
+      Timing timing = {};
+      for(size_t iIteration = 0; iIteration < config.cIterations; ++iIteration) {
+         double seconds = 0.0;
+         for(size_t iTerm = benchmark.iTermStart; iTerm < benchmark.iTermStart + benchmark.cTerms; ++iTerm) {
+            double gain;
+            const Stopwatch stopwatchGenerate;
+            CheckError(
+               GenerateTermUpdate(
+                  boosterHandle,
+                  static_cast<IntEbmType>(iTerm),
+                  benchmark.options,
+                  0.01,
+                  IntEbmType { 2 },
+                  leavesMax,
+                  &gain
+               ),
+               "GenerateTermUpdate"
+            );
+            seconds += stopwatchGenerate.Seconds();
+
+            double validationMetric;
+            const Stopwatch stopwatchApply;
+            CheckError(ApplyTermUpdate(boosterHandle, &validationMetric), "ApplyTermUpdate");
+            AddTiming(&timingApply, stopwatchApply.Seconds());
+            ++cApplyTerms;
+         }
+         AddTiming(&timing, seconds);
+      }
+      const double cDimensions = benchmark.iTermStart == cFeatures ? 2.0 : 1.0;
+      const double cTerms = static_cast<double>(benchmark.cTerms);
+      Report(
+         config,
+         benchmark.sName,
+         timing,
+         static_cast<double>(cTrainingSamples) * cTerms,
+         (cBytesTrainingMain * cDimensions + static_cast<double>(cTrainingSamples) * cBytesGradients) * cTerms
+      );
+   }
+
+   // ApplyTermUpdate timings are per call, so report per-call throughput
+   {
+      const double cBytesScores = static_cast<double>(cScores * sizeof(double));
+      Report(
+         config,
+         "ApplyTermUpdate",
+         timingApply,
+         static_cast<double>(cSamples),
+         cBytesTrainingMain + cBytesValidationMain + static_cast<double>(cSamples) * cBytesScores * 2.0
+      );
+   }
+
+   FreeBooster(boosterHandle);
+
+   // CalcInteractionStrength over all samples for the same pairs that we boosted on
+   if(0 != cPairs) {
+      std::vector<BagEbmType> bagInteraction(cSamples, BagEbmType { 1 });
+      InteractionHandle interactionHandle = nullptr;
+      CheckError(
+         CreateInteractionDetector(&dataSet[0], &bagInteraction[0], nullptr, nullptr, &interactionHandle),
+         "CreateInteractionDetector"
+      );
+
+      Timing timing = {};
+      for(size_t iIteration = 0; iIteration < config.cIterations; ++iIteration) {
+         const Stopwatch stopwatch;
+         for(size_t iPair = 0; iPair < cPairs; ++iPair) {
+            const IntEbmType pairIndexes[] = { static_cast<IntEbmType>(iPair * 2), static_cast<IntEbmType>(iPair * 2 + 1) };
+            double strength;
+            CheckError(
+               CalcInteractionStrength(
+                  interactionHandle,
+                  IntEbmType { 2 },
+                  pairIndexes,
+                  InteractionOptions_Default,
+                  IntEbmType { 2 },
+                  &strength
+               ),
+               "CalcInteractionStrength"
+            );
+         }
+         AddTiming(&timing, stopwatch.Seconds());
+      }
+
+      double cBytesFeatures = 0.0;
+      for(size_t iFeature = 0; iFeature < cPairs * 2; ++iFeature) {
+         cBytesFeatures += BytesPacked(cSamples, static_cast<size_t>(binCounts[iFeature]));
+      }
+      Report(
+         config,
+         "CalcInteractionStrength",
+         timing,
+         static_cast<double>(cSamples * cPairs),
+         cBytesFeatures + static_cast<double>(cSamples * cPairs) * cBytesGradients
+      );
+
+      FreeInteractionDetector(interactionHandle);
+   }
+
+   return 0;
+}
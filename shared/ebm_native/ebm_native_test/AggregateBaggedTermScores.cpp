@@ -0,0 +1,93 @@
+// Copyright (c) 2018 Microsoft Corporation
+// Licensed under the MIT license.
+// Author: Paul Koch <code@koch.ninja>
+
+#include "precompiled_header_test.hpp"
+
+#include <cmath> // std::sqrt
+
+#include "ebm_native.h"
+#include "ebm_native_test.hpp"
+
+static const TestPriority k_filePriority = TestPriority::AggregateBaggedTermScores;
+
+TEST_CASE("AggregateBaggedTermScores, main with zero weight missing bin") {
+   ErrorEbmType error;
+
+   UNUSED(testCaseHidden);
+   const double bagWeights[] { 5.0, 5.0 };
+   const IntEbmType binCounts[] { 3 };
+   const double binWeights[] { 0.0, 2.0, 2.0 };
+   double bagScores[] {
+      7.0, 1.0, 3.0,
+      9.0, 3.0, 5.0
+   };
+   double mean[3];
+   double stddev[3];
+   double intercept[] { 0.5 };
+
+   error = AggregateBaggedTermScores(2, bagWeights, 1, binCounts, 1, binWeights, 4.0, bagScores, mean, stddev, intercept);
+   CHECK(Error_None == error);
+
+   // the missing bin has no weight, so it is zeroed in every bag and stays zero after centering
+   CHECK(0.0 == bagScores[0] && 0.0 == bagScores[3]);
+   CHECK(1.0 == bagScores[1] && 5.0 == bagScores[5]);
+   CHECK(0.0 == mean[0] && 0.0 == stddev[0]);
+   CHECK_APPROX(mean[1], -1.0);
+   CHECK_APPROX(mean[2], 1.0);
+   CHECK_APPROX(stddev[1], 1.0);
+   CHECK_APPROX(stddev[2], 1.0);
+   CHECK_APPROX(intercept[0], 3.5);
+}
+
+TEST_CASE("AggregateBaggedTermScores, pair with weighted bags, multiclass") {
+   ErrorEbmType error;
+
+   UNUSED(testCaseHidden);
+   const double bagWeights[] { 1.0, 3.0 };
+   const IntEbmType binCounts[] { 2, 2 };
+   const double binWeights[] { 1.0, 1.0, 1.0, 1.0 };
+   double bagScores[] {
+      1.0, 0.0, 1.0, 0.0, 1.0, 0.0, 1.0, 0.0,
+      5.0, 2.0, 5.0, 2.0, 5.0, 2.0, 5.0, 2.0
+   };
+   double mean[8];
+   double stddev[8];
+   double intercept[] { 0.0, 0.0 };
+
+   // a zero centeringWeight leaves the means uncentered
+   error = AggregateBaggedTermScores(2, bagWeights, 2, binCounts, 2, binWeights, 0.0, bagScores, mean, stddev, intercept);
+   CHECK(Error_None == error);
+   for(size_t iCell = 0; iCell < 4; ++iCell) {
+      CHECK_APPROX(mean[iCell * 2 + 0], 4.0);
+      CHECK_APPROX(mean[iCell * 2 + 1], 1.5);
+      CHECK_APPROX(stddev[iCell * 2 + 0], std::sqrt(3.0));
+      CHECK_APPROX(stddev[iCell * 2 + 1], std::sqrt(0.75));
+   }
+   CHECK(0.0 == intercept[0] && 0.0 == intercept[1]);
+}
+
+TEST_CASE("AggregateBaggedTermScores, illegal parameters") {
+   ErrorEbmType error;
+
+   UNUSED(testCaseHidden);
+   const double bagWeights[] { 0.0 };
+   const IntEbmType binCounts[] { 1 };
+   const double binWeights[] { 1.0 };
+   double bagScores[] { 1.0 };
+   double mean[1];
+   double stddev[1];
+   double intercept[] { 0.0 };
+
+   error = AggregateBaggedTermScores(0, bagWeights, 1, binCounts, 1, binWeights, 1.0, bagScores, mean, stddev, intercept);
+   CHECK(Error_IllegalParamValue == error);
+
+   // equal bag weights are averaged without weights, even when they are zero
+   error = AggregateBaggedTermScores(1, bagWeights, 1, binCounts, 1, binWeights, 1.0, bagScores, mean, stddev, intercept);
+   CHECK(Error_None == error);
+   CHECK(1.0 == mean[0] + intercept[0]);
+
+   const double negativeBagWeights[] { -1.0 };
+   error = AggregateBaggedTermScores(1, negativeBagWeights, 1, binCounts, 1, binWeights, 1.0, bagScores, mean, stddev, intercept);
+   CHECK(Error_IllegalParamValue == error);
+}
@@ -0,0 +1,187 @@
+// Copyright (c) 2018 Microsoft Corporation
+// Licensed under the MIT license.
+// Author: Paul Koch <code@koch.ninja>
+
+#include "precompiled_header_test.hpp"
+
+#include "ebm_native.h"
+#include "ebm_native_test.hpp"
+
+static const TestPriority k_filePriority = TestPriority::CategoricalEncoder;
+
+TEST_CASE("EncodeCategorical, known, unknown and missing") {
+   ErrorEbmType error;
+
+   UNUSED(testCaseHidden);
+   const char categoryChars[] = "ab" "b" "" "\xc3\xa9";
+   const IntEbmType categoryOffsets[] { 0, 2, 3, 3, 5 };
+   const IntEbmType categoryBins[] { 1, 2, 3, 4 };
+
+   CategoricalEncoderHandle handle = nullptr;
+   error = CreateCategoricalEncoder(4, categoryOffsets, categoryChars, categoryBins, &handle);
+   CHECK(Error_None == error);
+   CHECK(nullptr != handle);
+
+   const char chars[] = "b" "a" "ab" "zz" "\xc3\xa9" "ab";
+   const IntEbmType offsets[] { 0, 1, 2, 4, 4, 6, 8, 10 };
+   // the 7th sample is missing, and its chars are ignored
+   const uint8_t validityBitmap[] { 0xBF };
+   IntEbmType binned[7];
+   IntEbmType countUnknowns = -1;
+
+   error = EncodeCategorical(handle, 7, offsets, chars, validityBitmap, binned, &countUnknowns);
+   CHECK(Error_None == error);
+   CHECK(2 == binned[0]);
+   CHECK(-1 == binned[1]);
+   CHECK(1 == binned[2]);
+   CHECK(3 == binned[3]);
+   CHECK(-1 == binned[4]);
+   CHECK(4 == binned[5]);
+   CHECK(0 == binned[6]);
+   CHECK(2 == countUnknowns);
+
+   error = EncodeCategorical(handle, 7, offsets, chars, nullptr, binned, nullptr);
+   CHECK(Error_None == error);
+   CHECK(1 == binned[6]);
+
+   FreeCategoricalEncoder(handle);
+}
+
+TEST_CASE("EncodeCategorical, many categories") {
+   ErrorEbmType error;
+
+   UNUSED(testCaseHidden);
+   constexpr size_t cCategories = 1000;
+   std::string categoryChars;
+   std::vector<IntEbmType> categoryOffsets;
+   std::vector<IntEbmType> categoryBins;
+   for(size_t i = 0; i < cCategories; ++i) {
+      categoryOffsets.push_back(static_cast<IntEbmType>(categoryChars.size()));
+      categoryChars += std::to_string(i * 7);
+      categoryBins.push_back(static_cast<IntEbmType>(i + 1));
+   }
+   categoryOffsets.push_back(static_cast<IntEbmType>(categoryChars.size()));
+
+   CategoricalEncoderHandle handle = nullptr;
+   error = CreateCategoricalEncoder(
+      static_cast<IntEbmType>(cCategories),
+      &categoryOffsets[0],
+      categoryChars.c_str(),
+      &categoryBins[0],
+      &handle
+   );
+   CHECK(Error_None == error);
+
+   std::string chars;
+   std::vector<IntEbmType> offsets;
+   constexpr size_t cSamples = cCategories * 7;
+   for(size_t i = 0; i < cSamples; ++i) {
+      offsets.push_back(static_cast<IntEbmType>(chars.size()));
+      chars += std::to_string(i);
+   }
+   offsets.push_back(static_cast<IntEbmType>(chars.size()));
+
+   std::vector<IntEbmType> binned(cSamples);
+   IntEbmType countUnknowns = -1;
+   error = EncodeCategorical(
+      handle,
+      static_cast<IntEbmType>(cSamples),
+      &offsets[0],
+      chars.c_str(),
+      nullptr,
+      &binned[0],
+      &countUnknowns
+   );
+   CHECK(Error_None == error);
+   CHECK(static_cast<IntEbmType>(cSamples - cCategories) == countUnknowns);
+   for(size_t i = 0; i < cSamples; ++i) {
+      CHECK((0 == i % 7 ? static_cast<IntEbmType>(i / 7 + 1) : IntEbmType { -1 }) == binned[i]);
+   }
+
+   FreeCategoricalEncoder(handle);
+}
+
+TEST_CASE("CreateCategoricalEncoder, duplicate category") {
+   ErrorEbmType error;
+
+   UNUSED(testCaseHidden);
+   const char categoryChars[] = "aba";
+   const IntEbmType categoryOffsets[] { 0, 1, 2, 3 };
+   const IntEbmType categoryBins[] { 1, 2, 3 };
+
+   CategoricalEncoderHandle handle = nullptr;
+   error = CreateCategoricalEncoder(3, categoryOffsets, categoryChars, categoryBins, &handle);
+   CHECK(Error_IllegalParamValue == error);
+   CHECK(nullptr == handle);
+}
+
+TEST_CASE("EncodeCategorical, illegal offsets") {
+   ErrorEbmType error;
+
+   UNUSED(testCaseHidden);
+   const char categoryChars[] = "a";
+   const IntEbmType categoryOffsets[] { 0, 1 };
+   const IntEbmType categoryBins[] { 1 };
+
+   CategoricalEncoderHandle handle = nullptr;
+   error = CreateCategoricalEncoder(1, categoryOffsets, categoryChars, categoryBins, &handle);
+   CHECK(Error_None == error);
+
+   const char chars[] = "aa";
+   const IntEbmType offsets[] { 0, 2, 1 };
+   IntEbmType binned[2];
+   error = EncodeCategorical(handle, 2, offsets, chars, nullptr, binned, nullptr);
+   CHECK(Error_IllegalParamValue == error);
+
+   FreeCategoricalEncoder(handle);
+}
+
+TEST_CASE("EncodeCategoricalDictionary, indexes and nulls") {
+   ErrorEbmType error;
+
+   UNUSED(testCaseHidden);
+   const char categoryChars[] = "redgreen";
+   const IntEbmType categoryOffsets[] { 0, 3, 8 };
+   const IntEbmType categoryBins[] { 1, 2 };
+
+   CategoricalEncoderHandle handle = nullptr;
+   error = CreateCategoricalEncoder(2, categoryOffsets, categoryChars, categoryBins, &handle);
+   CHECK(Error_None == error);
+
+   // the dictionary holds a string that was not fitted
+   const char dictionaryChars[] = "greenbluered";
+   const IntEbmType dictionaryOffsets[] { 0, 5, 9, 12 };
+   // the 3rd sample is null and its index is ignored
+   const uint8_t validityBitmap[] { 0xFB };
+   IntEbmType binned[5];
+   IntEbmType countUnknowns;
+
+   const int8_t indexes8[] { 2, 0, 99, 1, 0 };
+   error = EncodeCategoricalDictionary(handle, 3, dictionaryOffsets, dictionaryChars, 5, 1, indexes8,
+      validityBitmap, binned, &countUnknowns);
+   CHECK(Error_None == error);
+   CHECK(1 == binned[0]);
+   CHECK(2 == binned[1]);
+   CHECK(0 == binned[2]);
+   CHECK(-1 == binned[3]);
+   CHECK(2 == binned[4]);
+   CHECK(1 == countUnknowns);
+
+   const int32_t indexes32[] { 2, 0, 1, 1, 0 };
+   error = EncodeCategoricalDictionary(handle, 3, dictionaryOffsets, dictionaryChars, 5, 4, indexes32,
+      nullptr, binned, &countUnknowns);
+   CHECK(Error_None == error);
+   CHECK(-1 == binned[2]);
+   CHECK(2 == countUnknowns);
+
+   // without the bitmap the 3rd index is outside the dictionary
+   error = EncodeCategoricalDictionary(handle, 3, dictionaryOffsets, dictionaryChars, 5, 1, indexes8,
+      nullptr, binned, &countUnknowns);
+   CHECK(Error_IllegalParamValue == error);
+
+   error = EncodeCategoricalDictionary(handle, 3, dictionaryOffsets, dictionaryChars, 5, 3, indexes32,
+      nullptr, binned, &countUnknowns);
+   CHECK(Error_IllegalParamValue == error);
+
+   FreeCategoricalEncoder(handle);
+}
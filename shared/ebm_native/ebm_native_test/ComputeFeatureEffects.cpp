@@ -0,0 +1,90 @@
+// Copyright (c) 2018 Microsoft Corporation
+// Licensed under the MIT license.
+// Author: Paul Koch <code@koch.ninja>
+
+#include "precompiled_header_test.hpp"
+
+#include <cmath> // std::sqrt
+
+#include "ebm_native.h"
+#include "ebm_native_test.hpp"
+
+static const TestPriority k_filePriority = TestPriority::ComputeFeatureEffects;
+
+// a main on feature 0 with 3 bins, a main on feature 1 with 2 bins, and their pair
+static const IntEbmType k_dimensionCounts[] { 1, 1, 2 };
+static const IntEbmType k_binCounts[] { 3, 2, 3, 2 };
+static const IntEbmType k_dimensionFeatures[] { 0, 1, 0, 1 };
+static const IntEbmType k_binnedData[] {
+   0, 1, 2,
+   0, 1, -1,
+   0, 1, 2,
+   0, 1, -1
+};
+static const double k_termScores[] {
+   0.0, 1.0, 2.0,
+   10.0, 20.0,
+   100.0, 200.0, 300.0, 400.0, 500.0, 600.0
+};
+static const double k_sampleScores[] { 110.0, 421.0, 622.0 };
+
+TEST_CASE("ComputePermutedScores, main and pair") {
+   ErrorEbmType error;
+
+   UNUSED(testCaseHidden);
+   const IntEbmType permutation[] { 2, 0, 1 };
+   double scores[3];
+
+   error = ComputePermutedScores(3, 1, 3, k_dimensionCounts, k_binCounts, k_dimensionFeatures, k_binnedData,
+      k_termScores, 0, k_sampleScores, permutation, scores);
+   CHECK(Error_None == error);
+   CHECK_APPROX(scores[0], 512.0);
+   CHECK_APPROX(scores[1], 220.0);
+   CHECK_APPROX(scores[2], 421.0);
+
+   // a feature that no term uses leaves the scores alone
+   error = ComputePermutedScores(3, 1, 3, k_dimensionCounts, k_binCounts, k_dimensionFeatures, k_binnedData,
+      k_termScores, 5, k_sampleScores, permutation, scores);
+   CHECK(Error_None == error);
+   CHECK(110.0 == scores[0] && 421.0 == scores[1] && 622.0 == scores[2]);
+
+   const IntEbmType badPermutation[] { 2, 0, 3 };
+   error = ComputePermutedScores(3, 1, 3, k_dimensionCounts, k_binCounts, k_dimensionFeatures, k_binnedData,
+      k_termScores, 0, k_sampleScores, badPermutation, scores);
+   CHECK(Error_IllegalParamValue == error);
+}
+
+TEST_CASE("ComputePartialDependence, main and pair") {
+   ErrorEbmType error;
+
+   UNUSED(testCaseHidden);
+   // only the rows for feature 1 are read
+   const IntEbmType gridBinnedData[] {
+      0, 0,
+      0, 1,
+      0, 0,
+      0, -1
+   };
+   double partialDependence[2];
+   double stddev[2];
+   double ice[6];
+
+   error = ComputePartialDependence(3, 1, 3, k_dimensionCounts, k_binCounts, k_dimensionFeatures, k_binnedData,
+      k_termScores, 1, k_sampleScores, 2, gridBinnedData, nullptr, partialDependence, stddev, ice);
+   CHECK(Error_None == error);
+   CHECK_APPROX(partialDependence[0], 311.0);
+   CHECK_APPROX(partialDependence[1], 421.0);
+   CHECK_APPROX(stddev[0], std::sqrt(2.0 * 201.0 * 201.0 / 3.0));
+   CHECK_APPROX(stddev[1], std::sqrt(2.0 * 201.0 * 201.0 / 3.0));
+   CHECK_APPROX(ice[0], 110.0);
+   CHECK_APPROX(ice[1], 220.0);
+   CHECK_APPROX(ice[2], 311.0);
+   CHECK_APPROX(ice[5], 622.0);
+
+   const double sampleWeights[] { 1.0, 0.0, 3.0 };
+   error = ComputePartialDependence(3, 1, 3, k_dimensionCounts, k_binCounts, k_dimensionFeatures, k_binnedData,
+      k_termScores, 1, k_sampleScores, 2, gridBinnedData, sampleWeights, partialDependence, nullptr, nullptr);
+   CHECK(Error_None == error);
+   CHECK_APPROX(partialDependence[0], (110.0 + 3.0 * 512.0) / 4.0);
+   CHECK_APPROX(partialDependence[1], (220.0 + 3.0 * 622.0) / 4.0);
+}
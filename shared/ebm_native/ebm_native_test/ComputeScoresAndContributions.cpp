@@ -0,0 +1,163 @@
+// Copyright (c) 2018 Microsoft Corporation
+// Licensed under the MIT license.
+// Author: Paul Koch <code@koch.ninja>
+
+#include "precompiled_header_test.hpp"
+
+#include "ebm_native.h"
+#include "ebm_native_test.hpp"
+
+static const TestPriority k_filePriority = TestPriority::ComputeScoresAndContributions;
+
+// term 0 is a main with 3 bins, and term 1 is a pair with 2 x 3 bins in python order
+static const IntEbmType k_dimensionCounts[] { 1, 2 };
+static const IntEbmType k_binCounts[] { 3, 2, 3 };
+static const double k_termScores[] { 
+   0.5, -2.0, 9.0,
+   1.0, 2.0, 3.0, 4.0, 5.0, -6.0
+};
+// the -1 bins are unknowns, which use the last bin of their dimension
+static const IntEbmType k_binnedData[] {
+   0, 1, -1,
+   1, 0, 1,
+   2, 1, -1
+};
+constexpr IntEbmType k_cSamples = 3;
+
+TEST_CASE("ComputeScoresAndContributions, all terms") {
+   ErrorEbmType error;
+
+   UNUSED(testCaseHidden);
+   const double intercept[] { 0.25 };
+   double scores[k_cSamples];
+   double contributions[k_cSamples * 2];
+   IntEbmType termIndexes[k_cSamples * 2];
+
+   error = ComputeScoresAndContributions(
+      k_cSamples,
+      1,
+      2,
+      k_dimensionCounts,
+      k_binCounts,
+      k_binnedData,
+      k_termScores,
+      intercept,
+      0,
+      scores,
+      contributions,
+      termIndexes
+   );
+   CHECK(Error_None == error);
+   CHECK(0.5 == contributions[0] && -6.0 == contributions[1]);
+   CHECK(-2.0 == contributions[2] && 2.0 == contributions[3]);
+   CHECK(9.0 == contributions[4] && -6.0 == contributions[5]);
+   CHECK(-5.25 == scores[0]);
+   CHECK(0.25 == scores[1]);
+   CHECK(3.25 == scores[2]);
+   CHECK(0 == termIndexes[0] && 1 == termIndexes[1]);
+
+   error = ComputeScoresAndContributions(
+      k_cSamples,
+      1,
+      2,
+      k_dimensionCounts,
+      k_binCounts,
+      k_binnedData,
+      k_termScores,
+      nullptr,
+      0,
+      scores,
+      nullptr,
+      nullptr
+   );
+   CHECK(Error_None == error);
+   CHECK(-5.5 == scores[0]);
+}
+
+TEST_CASE("ComputeScoresAndContributions, top term") {
+   ErrorEbmType error;
+
+   UNUSED(testCaseHidden);
+   double scores[k_cSamples];
+   double contributions[k_cSamples];
+   IntEbmType termIndexes[k_cSamples];
+
+   error = ComputeScoresAndContributions(
+      k_cSamples,
+      1,
+      2,
+      k_dimensionCounts,
+      k_binCounts,
+      k_binnedData,
+      k_termScores,
+      nullptr,
+      1,
+      scores,
+      contributions,
+      termIndexes
+   );
+   CHECK(Error_None == error);
+   CHECK(1 == termIndexes[0] && -6.0 == contributions[0]);
+   // ties go to the lower term index
+   CHECK(0 == termIndexes[1] && -2.0 == contributions[1]);
+   CHECK(0 == termIndexes[2] && 9.0 == contributions[2]);
+   CHECK(3.0 == scores[2]);
+}
+
+TEST_CASE("ComputeScoresAndContributions, NaN contributions rank first") {
+   ErrorEbmType error;
+
+   UNUSED(testCaseHidden);
+   const IntEbmType dimensionCounts[] { 1, 1, 1 };
+   const IntEbmType binCounts[] { 1, 1, 1 };
+   const double termScores[] { 1.0, std::numeric_limits<double>::quiet_NaN(), 3.0 };
+   const IntEbmType binnedData[] { 0, 0, 0 };
+   double scores[1];
+   double contributions[2];
+   IntEbmType termIndexes[2];
+
+   error = ComputeScoresAndContributions(
+      1,
+      1,
+      3,
+      dimensionCounts,
+      binCounts,
+      binnedData,
+      termScores,
+      nullptr,
+      2,
+      scores,
+      contributions,
+      termIndexes
+   );
+   CHECK(Error_None == error);
+   CHECK(1 == termIndexes[0] && std::isnan(contributions[0]));
+   CHECK(2 == termIndexes[1] && 3.0 == contributions[1]);
+}
+
+TEST_CASE("ComputeScoresAndContributions, illegal bin index") {
+   ErrorEbmType error;
+
+   UNUSED(testCaseHidden);
+   const IntEbmType dimensionCounts[] { 1 };
+   const IntEbmType binCounts[] { 2 };
+   const double termScores[] { 1.0, 2.0 };
+   const IntEbmType binnedData[] { 0, 2 };
+   double scores[2];
+
+   error = ComputeScoresAndContributions(
+      2,
+      1,
+      1,
+      dimensionCounts,
+      binCounts,
+      binnedData,
+      termScores,
+      nullptr,
+      0,
+      scores,
+      nullptr,
+      nullptr
+   );
+   CHECK(Error_IllegalParamValue == error);
+}
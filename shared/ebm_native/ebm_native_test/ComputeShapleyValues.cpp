@@ -0,0 +1,161 @@
+// Copyright (c) 2018 Microsoft Corporation
+// Licensed under the MIT license.
+// Author: Paul Koch <code@koch.ninja>
+
+#include "precompiled_header_test.hpp"
+
+#include <vector>
+
+#include "ebm_native.h"
+#include "ebm_native_test.hpp"
+
+static const TestPriority k_filePriority = TestPriority::ComputeShapleyValues;
+
+TEST_CASE("ComputeShapleyValues, pair with uniform background") {
+   ErrorEbmType error;
+
+   UNUSED(testCaseHidden);
+   const IntEbmType dimensionCounts[] { 2 };
+   const IntEbmType binCounts[] { 2, 2 };
+   const IntEbmType dimensionFeatures[] { 0, 1 };
+   const IntEbmType binnedData[] {
+      1, 0,
+      1, -2
+   };
+   const double termScores[] { 0.0, 1.0, 2.0, 5.0 };
+   const double intercept[] { 10.0 };
+   double expectedValue[1];
+   double shapley[6];
+
+   error = ComputeShapleyValues(2, 1, 3, 1, dimensionCounts, binCounts, dimensionFeatures, binnedData, termScores,
+      nullptr, intercept, 1, expectedValue, shapley);
+   CHECK(Error_None == error);
+   CHECK_APPROX(expectedValue[0], 12.0);
+   CHECK_APPROX(shapley[0], 1.75);
+   CHECK_APPROX(shapley[1], 1.25);
+   CHECK(0.0 == shapley[2]);
+   CHECK_APPROX(shapley[3], -1.25);
+   CHECK_APPROX(shapley[4], -0.75);
+   CHECK(0.0 == shapley[5]);
+}
+
+TEST_CASE("ComputeShapleyValues, main and pair with bin weights") {
+   ErrorEbmType error;
+
+   UNUSED(testCaseHidden);
+   const IntEbmType dimensionCounts[] { 1, 2 };
+   const IntEbmType binCounts[] { 3, 2, 2 };
+   const IntEbmType dimensionFeatures[] { 2, 0, 1 };
+   const IntEbmType binnedData[] { 2, 1, 1 };
+   const double termScores[] { 1.0, 2.0, 6.0, 0.0, 1.0, 2.0, 5.0 };
+   const double binWeights[] { 1.0, 1.0, 2.0, 1.0, 0.0, 0.0, 1.0 };
+   double expectedValue[1];
+   double shapley[3];
+
+   error = ComputeShapleyValues(1, 1, 3, 2, dimensionCounts, binCounts, dimensionFeatures, binnedData, termScores,
+      binWeights, nullptr, 0, expectedValue, shapley);
+   CHECK(Error_None == error);
+   CHECK_APPROX(expectedValue[0], 6.25);
+   CHECK_APPROX(shapley[0], 1.5);
+   CHECK_APPROX(shapley[1], 1.0);
+   CHECK_APPROX(shapley[2], 2.25);
+}
+
+TEST_CASE("ComputeShapleyValues, triple multiclass") {
+   ErrorEbmType error;
+
+   UNUSED(testCaseHidden);
+   // score 0 is 4a + 2b + c, which is additive, so each feature gets its own part.  Score 1 is the negation
+   const IntEbmType dimensionCounts[] { 3 };
+   const IntEbmType binCounts[] { 2, 2, 2 };
+   const IntEbmType dimensionFeatures[] { 0, 1, 2 };
+   const IntEbmType binnedData[] { 1, 0, 1 };
+   double termScores[16];
+   for(int iCell = 0; iCell < 8; ++iCell) {
+      termScores[iCell * 2] = static_cast<double>(iCell);
+      termScores[iCell * 2 + 1] = -static_cast<double>(iCell);
+   }
+   // zero weights leave no background distribution, so all bins count equally
+   const double binWeights[8] {};
+   double expectedValue[2];
+   double shapley[6];
+
+   error = ComputeShapleyValues(1, 2, 3, 1, dimensionCounts, binCounts, dimensionFeatures, binnedData, termScores,
+      binWeights, nullptr, 1, expectedValue, shapley);
+   CHECK(Error_None == error);
+   CHECK_APPROX(expectedValue[0], 3.5);
+   CHECK_APPROX(expectedValue[1], -3.5);
+   CHECK_APPROX(shapley[0], 2.0);
+   CHECK_APPROX(shapley[1], -2.0);
+   CHECK_APPROX(shapley[2], -1.0);
+   CHECK_APPROX(shapley[3], 1.0);
+   CHECK_APPROX(shapley[4], 0.5);
+   CHECK_APPROX(shapley[5], -0.5);
+}
+
+TEST_CASE("ComputeShapleyValues, threaded rows sum to the scores") {
+   ErrorEbmType error;
+
+   UNUSED(testCaseHidden);
+   constexpr size_t cSamples = 10000;
+   const IntEbmType dimensionCounts[] { 1, 2 };
+   const IntEbmType binCounts[] { 3, 3, 2 };
+   const IntEbmType dimensionFeatures[] { 0, 0, 1 };
+   const double termScores[] { -1.0, 0.5, 3.0, 7.0, -2.0, 4.0, 0.25, 9.0, -6.0 };
+   const double binWeights[] { 5.0, 1.0, 2.0, 3.0, 1.0, 4.0, 1.0, 5.0, 9.0 };
+   std::vector<IntEbmType> binnedData(cSamples * 3);
+   for(size_t iSample = 0; iSample < cSamples; ++iSample) {
+      binnedData[iSample] = static_cast<IntEbmType>(iSample % 3);
+      binnedData[cSamples + iSample] = static_cast<IntEbmType>(iSample % 3);
+      binnedData[cSamples * 2 + iSample] = static_cast<IntEbmType>(iSample / 3 % 2);
+   }
+   double expectedValue[1];
+   std::vector<double> shapley(cSamples * 2);
+
+   error = ComputeShapleyValues(static_cast<IntEbmType>(cSamples), 1, 2, 2, dimensionCounts, binCounts,
+      dimensionFeatures, &binnedData[0], termScores, binWeights, nullptr, 0, expectedValue, &shapley[0]);
+   CHECK(Error_None == error);
+   for(size_t iSample = 0; iSample < cSamples; ++iSample) {
+      const size_t iBin0 = iSample % 3;
+      const size_t iBin1 = iSample / 3 % 2;
+      const double score = termScores[iBin0] + termScores[3 + iBin0 * 2 + iBin1];
+      CHECK_APPROX(expectedValue[0] + shapley[iSample * 2] + shapley[iSample * 2 + 1], score);
+   }
+}
+
+TEST_CASE("ComputeShapleyValues, illegal parameters") {
+   ErrorEbmType error;
+
+   UNUSED(testCaseHidden);
+   const IntEbmType dimensionCounts[] { 1 };
+   const IntEbmType binCounts[] { 2 };
+   const IntEbmType dimensionFeatures[] { 0 };
+   const IntEbmType binnedData[] { 2 };
+   const IntEbmType goodBinnedData[] { -2 };
+   const double termScores[] { 1.0, 2.0 };
+   const double badWeights[] { 1.0, -1.0 };
+   double expectedValue[1];
+   double shapley[1];
+
+   error = ComputeShapleyValues(1, 1, 1, 1, dimensionCounts, binCounts, dimensionFeatures, binnedData, termScores,
+      nullptr, nullptr, 1, expectedValue, shapley);
+   CHECK(Error_IllegalParamValue == error);
+
+   error = ComputeShapleyValues(1, 1, 1, 1, dimensionCounts, binCounts, dimensionFeatures, goodBinnedData, termScores,
+      badWeights, nullptr, 1, expectedValue, shapley);
+   CHECK(Error_IllegalParamValue == error);
+
+   error = ComputeShapleyValues(1, 1, 1, 1, dimensionCounts, binCounts, dimensionFeatures, goodBinnedData, termScores,
+      nullptr, nullptr, -1, expectedValue, shapley);
+   CHECK(Error_IllegalParamValue == error);
+
+   error = ComputeShapleyValues(1, 1, 0, 1, dimensionCounts, binCounts, dimensionFeatures, goodBinnedData, termScores,
+      nullptr, nullptr, 1, expectedValue, shapley);
+   CHECK(Error_IllegalParamValue == error);
+
+   error = ComputeShapleyValues(1, 1, 1, 1, dimensionCounts, binCounts, dimensionFeatures, goodBinnedData, termScores,
+      nullptr, nullptr, 1, expectedValue, shapley);
+   CHECK(Error_None == error);
+   CHECK_APPROX(expectedValue[0], 1.5);
+   CHECK_APPROX(shapley[0], -0.5);
+}
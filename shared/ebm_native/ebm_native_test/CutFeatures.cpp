@@ -0,0 +1,84 @@
+// Copyright (c) 2018 Microsoft Corporation
+// Licensed under the MIT license.
+// Author: Paul Koch <code@koch.ninja>
+
+#include "precompiled_header_test.hpp"
+
+#include <vector>
+
+#include "ebm_native.h"
+#include "ebm_native_test.hpp"
+
+static const TestPriority k_filePriority = TestPriority::CutFeatures;
+
+TEST_CASE("CutFeatures, matches the single feature cuts") {
+   ErrorEbmType error;
+
+   UNUSED(testCaseHidden);
+   constexpr size_t cFeatures = 8;
+   constexpr size_t cSamples = 20000;
+   constexpr IntEbmType countCutsMax = 10;
+   const IntEbmType cutMethods[cFeatures] {
+      CutMethod_Quantile, CutMethod_RoundedQuantile, CutMethod_Uniform, CutMethod_Winsorized,
+      CutMethod_Quantile, CutMethod_RoundedQuantile, CutMethod_Uniform, CutMethod_Winsorized
+   };
+
+   std::vector<double> values(cFeatures * cSamples);
+   const double * aFeatureValues[cFeatures];
+   for(size_t iFeature = 0; iFeature < cFeatures; ++iFeature) {
+      for(size_t iSample = 0; iSample < cSamples; ++iSample) {
+         // features with few and with many unique values
+         values[iFeature * cSamples + iSample] =
+            static_cast<double>((iSample * (iFeature * 7 + 3)) % (size_t { 5 } << (iFeature * 2)));
+      }
+      aFeatureValues[iFeature] = &values[iFeature * cSamples];
+   }
+
+   IntEbmType countCuts[cFeatures];
+   std::vector<double> cuts(cFeatures * static_cast<size_t>(countCutsMax));
+   error = CutFeatures(static_cast<IntEbmType>(cFeatures), static_cast<IntEbmType>(cSamples), aFeatureValues,
+      cutMethods, 3, countCutsMax, 0, countCuts, &cuts[0]);
+   CHECK(Error_None == error);
+
+   for(size_t iFeature = 0; iFeature < cFeatures; ++iFeature) {
+      double expectedCuts[countCutsMax];
+      IntEbmType countExpectedCuts = countCutsMax;
+      if(CutMethod_Uniform == cutMethods[iFeature]) {
+         countExpectedCuts = CutUniform(static_cast<IntEbmType>(cSamples), aFeatureValues[iFeature], countCutsMax,
+            expectedCuts);
+      } else if(CutMethod_Winsorized == cutMethods[iFeature]) {
+         error = CutWinsorized(static_cast<IntEbmType>(cSamples), aFeatureValues[iFeature], &countExpectedCuts,
+            expectedCuts);
+         CHECK(Error_None == error);
+      } else {
+         error = CutQuantile(static_cast<IntEbmType>(cSamples), aFeatureValues[iFeature], 3,
+            CutMethod_RoundedQuantile == cutMethods[iFeature] ? EBM_TRUE : EBM_FALSE, &countExpectedCuts, expectedCuts);
+         CHECK(Error_None == error);
+      }
+      CHECK(countExpectedCuts == countCuts[iFeature]);
+      for(IntEbmType iCut = 0; iCut < countExpectedCuts; ++iCut) {
+         CHECK(expectedCuts[iCut] == cuts[iFeature * static_cast<size_t>(countCutsMax) + static_cast<size_t>(iCut)]);
+      }
+   }
+}
+
+TEST_CASE("CutFeatures, illegal parameters") {
+   ErrorEbmType error;
+
+   UNUSED(testCaseHidden);
+   const double values[] { 1.0, 2.0, 3.0 };
+   const double * aFeatureValues[] { values };
+   const IntEbmType badMethods[] { IntEbmType { 4 } };
+   const IntEbmType cutMethods[] { CutMethod_Quantile };
+   IntEbmType countCuts[1];
+   double cuts[2];
+
+   error = CutFeatures(1, 3, aFeatureValues, badMethods, 1, 2, 1, countCuts, cuts);
+   CHECK(Error_IllegalParamValue == error);
+
+   error = CutFeatures(1, 3, aFeatureValues, cutMethods, 1, 2, -1, countCuts, cuts);
+   CHECK(Error_IllegalParamValue == error);
+
+   error = CutFeatures(0, 3, nullptr, nullptr, 1, 2, 1, nullptr, nullptr);
+   CHECK(Error_None == error);
+}
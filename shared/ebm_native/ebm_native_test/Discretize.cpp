@@ -4,6 +4,8 @@
 
 #include "precompiled_header_test.hpp"
 
+#include <thread>
+
 #include "ebm_native.h"
 #include "ebm_native_test.hpp"
 
@@ -126,3 +128,137 @@ TEST_CASE("Discretize, increasing lengths") {
    delete[] singleFeatureDiscretized;
 }
 
+
+TEST_CASE("DiscretizeArrow, all types with validity bitmap") {
+   ErrorEbmType error;
+
+   UNUSED(testCaseHidden);
+   const double cuts[] { 2.0, 4.0 };
+   // the 4th sample is null, so its value is ignored
+   const uint8_t validityBitmap[] { 0xF7 };
+   const IntEbmType expected[] { 1, 2, 3, 0, 3 };
+   const IntEbmType expectedNoBitmap[] { 1, 2, 3, 1, 3 };
+   IntEbmType discretized[5];
+
+   const double float64s[] { 1.0, 2.0, 5.0, 0.0, 9.0 };
+   error = DiscretizeArrow(5, ArrowType_Float64, float64s, validityBitmap, 2, cuts, discretized);
+   CHECK(Error_None == error);
+   for(size_t i = 0; i < 5; ++i) {
+      CHECK(expected[i] == discretized[i]);
+   }
+
+   const float float32s[] { 1.0f, 2.0f, 5.0f, 0.0f, 9.0f };
+   error = DiscretizeArrow(5, ArrowType_Float32, float32s, validityBitmap, 2, cuts, discretized);
+   CHECK(Error_None == error);
+   for(size_t i = 0; i < 5; ++i) {
+      CHECK(expected[i] == discretized[i]);
+   }
+
+   const int8_t int8s[] { 1, 2, 5, 0, 9 };
+   error = DiscretizeArrow(5, ArrowType_Int8, int8s, nullptr, 2, cuts, discretized);
+   CHECK(Error_None == error);
+   for(size_t i = 0; i < 5; ++i) {
+      CHECK(expectedNoBitmap[i] == discretized[i]);
+   }
+
+   const uint64_t uint64s[] { 1, 2, 5, 0, 9 };
+   error = DiscretizeArrow(5, ArrowType_UInt64, uint64s, validityBitmap, 2, cuts, discretized);
+   CHECK(Error_None == error);
+   for(size_t i = 0; i < 5; ++i) {
+      CHECK(expected[i] == discretized[i]);
+   }
+
+   error = DiscretizeArrow(5, IntEbmType { 99 }, int8s, nullptr, 2, cuts, discretized);
+   CHECK(Error_IllegalParamValue == error);
+}
+
+TEST_CASE("DiscretizeArrow, more samples than one chunk") {
+   ErrorEbmType error;
+
+   UNUSED(testCaseHidden);
+   constexpr size_t cSamples = 3000;
+   const double cuts[] { 1000.0 };
+   int32_t * const values = new int32_t[cSamples];
+   uint8_t * const validityBitmap = new uint8_t[(cSamples + 7) / 8];
+   IntEbmType * const discretized = new IntEbmType[cSamples];
+   for(size_t i = 0; i < cSamples; ++i) {
+      values[i] = static_cast<int32_t>(i);
+   }
+   for(size_t i = 0; i < (cSamples + 7) / 8; ++i) {
+      // every 8th sample is null
+      validityBitmap[i] = 0xFE;
+   }
+
+   error = DiscretizeArrow(static_cast<IntEbmType>(cSamples), ArrowType_Int32, values, validityBitmap, 1, cuts,
+      discretized);
+   CHECK(Error_None == error);
+   for(size_t i = 0; i < cSamples; ++i) {
+      CHECK((0 == i % 8 ? IntEbmType { 0 } : i < 1000 ? IntEbmType { 1 } : IntEbmType { 2 }) == discretized[i]);
+   }
+
+   delete[] discretized;
+   delete[] validityBitmap;
+   delete[] values;
+}
+
+TEST_CASE("CutQuantile and Discretize, concurrent callers") {
+   UNUSED(testCaseHidden);
+   constexpr size_t cSamples = 1000;
+   constexpr size_t cThreads = 8;
+   constexpr size_t cRepeats = 50;
+   constexpr IntEbmType countCutsMax = 10;
+
+   double * const featureValues = new double[cSamples];
+   for(size_t i = 0; i < cSamples; ++i) {
+      featureValues[i] = static_cast<double>((i * 7919) % 501);
+   }
+
+   // the tests run with verbose logging, so every call below also goes through the shared log counters
+   IntEbmType countCutsExpected = countCutsMax;
+   double cutsExpected[countCutsMax];
+   ErrorEbmType error = CutQuantile(static_cast<IntEbmType>(cSamples), featureValues, 3, EBM_FALSE,
+      &countCutsExpected, cutsExpected);
+   CHECK(Error_None == error);
+   IntEbmType * const discretizedExpected = new IntEbmType[cSamples];
+   error = Discretize(static_cast<IntEbmType>(cSamples), featureValues, countCutsExpected, cutsExpected,
+      discretizedExpected);
+   CHECK(Error_None == error);
+
+   bool abMatch[cThreads];
+   std::thread aThreads[cThreads];
+   for(size_t iThread = 0; iThread < cThreads; ++iThread) {
+      abMatch[iThread] = true;
+      aThreads[iThread] = std::thread([&, iThread]() {
+         IntEbmType * const discretized = new IntEbmType[cSamples];
+         for(size_t iRepeat = 0; iRepeat < cRepeats; ++iRepeat) {
+            IntEbmType countCuts = countCutsMax;
+            double cuts[countCutsMax];
+            if(Error_None != CutQuantile(static_cast<IntEbmType>(cSamples), featureValues, 3, EBM_FALSE, &countCuts,
+               cuts) || countCutsExpected != countCuts)
+            {
+               abMatch[iThread] = false;
+               break;
+            }
+            if(Error_None != Discretize(static_cast<IntEbmType>(cSamples), featureValues, countCuts, cuts,
+               discretized))
+            {
+               abMatch[iThread] = false;
+               break;
+            }
+            for(size_t i = 0; i < cSamples; ++i) {
+               if(discretizedExpected[i] != discretized[i]) {
+                  abMatch[iThread] = false;
+               }
+            }
+         }
+         delete[] discretized;
+      });
+   }
+   for(size_t iThread = 0; iThread < cThreads; ++iThread) {
+      aThreads[iThread].join();
+      CHECK(abMatch[iThread]);
+   }
+
+   delete[] discretizedExpected;
+   delete[] featureValues;
+}
@@ -0,0 +1,107 @@
+// Copyright (c) 2018 Microsoft Corporation
+// Licensed under the MIT license.
+// Author: Paul Koch <code@koch.ninja>
+
+#include "precompiled_header_test.hpp"
+
+#include "ebm_native.h"
+#include "ebm_native_test.hpp"
+
+static const TestPriority k_filePriority = TestPriority::HarmonizeTensors;
+
+TEST_CASE("HarmonizeCuts, split old bin and extended range") {
+   ErrorEbmType error;
+
+   UNUSED(testCaseHidden);
+   const double oldCuts[] { 2.0 };
+   const double newCuts[] { 1.0, 2.0, 5.0 };
+   IntEbmType lookup[6];
+   double percentages[6];
+
+   // old bins are [0, 2) and [2, 4).  New bins are [-2, 1), [1, 2), [2, 5), [5, 6)
+   error = HarmonizeCuts(1, oldCuts, 0.0, 4.0, 3, newCuts, -2.0, 6.0, lookup, percentages);
+   CHECK(Error_None == error);
+
+   CHECK(0 == lookup[0] && 1 == lookup[1] && 1 == lookup[2] && 2 == lookup[3] && 2 == lookup[4] && -1 == lookup[5]);
+   CHECK(1.0 == percentages[0]);
+   CHECK_APPROX(percentages[1], 0.5);
+   CHECK_APPROX(percentages[2], 0.5);
+   CHECK_APPROX(percentages[3], 1.0);
+   CHECK(0.0 == percentages[4]);
+   CHECK(1.0 == percentages[5]);
+}
+
+TEST_CASE("HarmonizeCuts, unsorted cuts") {
+   ErrorEbmType error;
+
+   UNUSED(testCaseHidden);
+   const double oldCuts[] { 2.0, 1.0 };
+   const double newCuts[] { 1.0 };
+   IntEbmType lookup[4];
+   double percentages[4];
+
+   error = HarmonizeCuts(2, oldCuts, 0.0, 4.0, 1, newCuts, 0.0, 4.0, lookup, percentages);
+   CHECK(Error_IllegalParamValue == error);
+}
+
+TEST_CASE("HarmonizeTensors, weights and scores on a pair, two tensors") {
+   ErrorEbmType error;
+
+   UNUSED(testCaseHidden);
+   // the first dimension splits old bin 1 into two new bins, and the second dimension merges both old bins
+   const IntEbmType oldBinCounts[] { 2, 2 };
+   const IntEbmType newBinCounts[] { 3, 1 };
+   const IntEbmType oldBinOffsets[] { 0, 1, 2, 3, 3, 5 };
+   const IntEbmType oldBins[] { 0, -1, 1, 0, 1 };
+   const double percentages[] { 1.0, 0.25, 0.75, 1.0 };
+   const double oldWeights[] { 1.0, 3.0, 2.0, 2.0 };
+   const double oldScores[] {
+      1.0, 5.0, 2.0, 4.0,
+      2.0, 2.0, 0.0, 0.0
+   };
+   double newWeights[3];
+   double newScores[6];
+
+   error = HarmonizeTensors(1, 2, oldBinCounts, newBinCounts, 5, oldBinOffsets, oldBins, percentages, 1, oldWeights,
+      nullptr, 0, newWeights);
+   CHECK(Error_None == error);
+   CHECK_APPROX(newWeights[0], 4.0);
+   CHECK_APPROX(newWeights[1], 1.0);
+   CHECK_APPROX(newWeights[2], 3.0);
+
+   error = HarmonizeTensors(2, 2, oldBinCounts, newBinCounts, 5, oldBinOffsets, oldBins, percentages, 1, oldScores,
+      oldWeights, 1, newScores);
+   CHECK(Error_None == error);
+   CHECK_APPROX(newScores[0], 4.0);
+   CHECK_APPROX(newScores[1], 3.0);
+   CHECK_APPROX(newScores[2], 3.0);
+   CHECK_APPROX(newScores[3], 2.0);
+   CHECK(0.0 == newScores[4] && 0.0 == newScores[5]);
+}
+
+TEST_CASE("HarmonizeTensors, multiclass single cell copies, many threads") {
+   ErrorEbmType error;
+
+   UNUSED(testCaseHidden);
+   const IntEbmType oldBinCounts[] { 2 };
+   const IntEbmType newBinCounts[] { 4 };
+   const IntEbmType oldBinOffsets[] { 0, 1, 2, 3, 4 };
+   const IntEbmType oldBins[] { 0, 1, 1, -1 };
+   const double percentages[] { 1.0, 0.5, 0.5, 1.0 };
+   const double oldWeights[] { 0.0, 0.0 };
+   const double oldScores[] { 1.0, -1.0, 7.0, -7.0 };
+   double newScores[8];
+
+   error = HarmonizeTensors(1, 1, oldBinCounts, newBinCounts, 4, oldBinOffsets, oldBins, percentages, 2, oldScores,
+      oldWeights, 16, newScores);
+   CHECK(Error_None == error);
+   CHECK(1.0 == newScores[0] && -1.0 == newScores[1]);
+   for(size_t iBin = 1; iBin < 4; ++iBin) {
+      CHECK(7.0 == newScores[iBin * 2 + 0] && -7.0 == newScores[iBin * 2 + 1]);
+   }
+
+   const IntEbmType badBins[] { 0, 1, 2, -1 };
+   error = HarmonizeTensors(1, 1, oldBinCounts, newBinCounts, 4, oldBinOffsets, badBins, percentages, 2, oldScores,
+      oldWeights, 16, newScores);
+   CHECK(Error_IllegalParamValue == error);
+}
@@ -0,0 +1,161 @@
+// Copyright (c) 2018 Microsoft Corporation
+// Licensed under the MIT license.
+// Author: Paul Koch <code@koch.ninja>
+
+#include "precompiled_header_test.hpp"
+
+#include <string.h>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "ebm_native.h"
+#include "ebm_native_test.hpp"
+
+static const TestPriority k_filePriority = TestPriority::LogBuffer;
+
+// the buffer is global, so every test starts by emptying whatever the previous test left in it
+static std::vector<std::string> DrainAll(IntEbmType * const pCountDroppedTotal, std::vector<TraceEbmType> * const pTraceLevels) {
+   std::vector<std::string> messages;
+   *pCountDroppedTotal = 0;
+   while(true) {
+      TraceEbmType traceLevels[100];
+      char chars[4096];
+      IntEbmType countMessages;
+      IntEbmType countDropped;
+      const ErrorEbmType error = DrainLogMessages(100, 4096, traceLevels, chars, &countMessages, &countDropped);
+      if(Error_None != error) {
+         break;
+      }
+      *pCountDroppedTotal += countDropped;
+      const char * pChars = chars;
+      for(IntEbmType iMessage = 0; iMessage < countMessages; ++iMessage) {
+         messages.push_back(std::string(pChars));
+         pChars += strlen(pChars) + 1;
+         if(nullptr != pTraceLevels) {
+            pTraceLevels->push_back(traceLevels[iMessage]);
+         }
+      }
+      if(0 == countMessages) {
+         break;
+      }
+   }
+   return messages;
+}
+
+TEST_CASE("LogBuffer, messages come out in order") {
+   UNUSED(testCaseHidden);
+   IntEbmType countDropped;
+   DrainAll(&countDropped, nullptr);
+
+   LogMessageToBuffer(TraceLevelError, "first");
+   LogMessageToBuffer(TraceLevelVerbose, "");
+   LogMessageToBuffer(TraceLevelInfo, "third");
+
+   std::vector<TraceEbmType> traceLevels;
+   const std::vector<std::string> messages = DrainAll(&countDropped, &traceLevels);
+   CHECK(0 == countDropped);
+   CHECK(3 == messages.size());
+   CHECK(3 == traceLevels.size());
+   if(3 == messages.size() && 3 == traceLevels.size()) {
+      CHECK("first" == messages[0]);
+      CHECK("" == messages[1]);
+      CHECK("third" == messages[2]);
+      CHECK(TraceLevelError == traceLevels[0]);
+      CHECK(TraceLevelVerbose == traceLevels[1]);
+      CHECK(TraceLevelInfo == traceLevels[2]);
+   }
+}
+
+TEST_CASE("LogBuffer, full buffer drops messages") {
+   UNUSED(testCaseHidden);
+   IntEbmType countDropped;
+   DrainAll(&countDropped, nullptr);
+
+   constexpr size_t cMessages = 1100;
+   for(size_t iMessage = 0; iMessage < cMessages; ++iMessage) {
+      LogMessageToBuffer(TraceLevelInfo, std::to_string(iMessage).c_str());
+   }
+
+   const std::vector<std::string> messages = DrainAll(&countDropped, nullptr);
+   CHECK(cMessages == messages.size() + static_cast<size_t>(countDropped));
+   CHECK(0 < countDropped);
+   for(size_t iMessage = 0; iMessage < messages.size(); ++iMessage) {
+      // the oldest messages are kept and the newest are dropped
+      CHECK(std::to_string(iMessage) == messages[iMessage]);
+   }
+
+   // after a drain there is room again
+   LogMessageToBuffer(TraceLevelInfo, "again");
+   const std::vector<std::string> messagesAgain = DrainAll(&countDropped, nullptr);
+   CHECK(0 == countDropped);
+   CHECK(1 == messagesAgain.size());
+}
+
+TEST_CASE("LogBuffer, long messages are clipped and drains stop at the char limit") {
+   UNUSED(testCaseHidden);
+   IntEbmType countDropped;
+   DrainAll(&countDropped, nullptr);
+
+   const std::string longMessage(2000, 'x');
+   LogMessageToBuffer(TraceLevelWarning, longMessage.c_str());
+   LogMessageToBuffer(TraceLevelWarning, "short");
+
+   TraceEbmType traceLevels[10];
+   char chars[100];
+   IntEbmType countMessages;
+   ErrorEbmType error = DrainLogMessages(10, 100, traceLevels, chars, &countMessages, &countDropped);
+   CHECK(Error_None == error);
+   // the clipped message does not fit in 100 chars, so nothing is drained and nothing is lost
+   CHECK(0 == countMessages);
+
+   const std::vector<std::string> messages = DrainAll(&countDropped, nullptr);
+   CHECK(2 == messages.size());
+   if(2 == messages.size()) {
+      CHECK(longMessage.substr(0, messages[0].size()) == messages[0]);
+      CHECK(messages[0].size() < longMessage.size());
+      CHECK("short" == messages[1]);
+   }
+
+   error = DrainLogMessages(10, 100, nullptr, chars, &countMessages, &countDropped);
+   CHECK(Error_IllegalParamValue == error);
+   error = DrainLogMessages(-1, 100, traceLevels, chars, &countMessages, &countDropped);
+   CHECK(Error_IllegalParamValue == error);
+}
+
+TEST_CASE("LogBuffer, concurrent producers") {
+   UNUSED(testCaseHidden);
+   IntEbmType countDropped;
+   DrainAll(&countDropped, nullptr);
+
+   constexpr size_t cThreads = 4;
+   constexpr size_t cMessagesPerThread = 200;
+   std::thread aThreads[cThreads];
+   for(size_t iThread = 0; iThread < cThreads; ++iThread) {
+      aThreads[iThread] = std::thread([iThread]() {
+         for(size_t iMessage = 0; iMessage < cMessagesPerThread; ++iMessage) {
+            LogMessageToBuffer(TraceLevelVerbose, (std::to_string(iThread) + " " + std::to_string(iMessage)).c_str());
+         }
+      });
+   }
+   for(size_t iThread = 0; iThread < cThreads; ++iThread) {
+      aThreads[iThread].join();
+   }
+
+   const std::vector<std::string> messages = DrainAll(&countDropped, nullptr);
+   CHECK(0 == countDropped);
+   CHECK(cThreads * cMessagesPerThread == messages.size());
+
+   // messages from any one thread stay in the order that thread wrote them
+   size_t aiNext[cThreads] {};
+   for(const std::string & message : messages) {
+      const size_t iSpace = message.find(' ');
+      const size_t iThread = static_cast<size_t>(std::stoul(message.substr(0, iSpace)));
+      const size_t iMessage = static_cast<size_t>(std::stoul(message.substr(iSpace + 1)));
+      CHECK(iThread < cThreads);
+      if(iThread < cThreads) {
+         CHECK(aiNext[iThread] == iMessage);
+         aiNext[iThread] = iMessage + 1;
+      }
+   }
+}
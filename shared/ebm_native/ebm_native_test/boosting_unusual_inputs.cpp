@@ -1593,3 +1593,390 @@ TEST_CASE("pair and main gain identical, boosting, regression") {
 
    CHECK_APPROX(gainAvg1, gainAvg2);
 }
+
+TEST_CASE("perf counters, boosting, regression") {
+   TestApi test = TestApi(k_learningTypeRegression);
+   test.AddFeatures({ FeatureTest(2) });
+   test.AddTerms({ { 0 } });
+   test.AddTrainingSamples({ TestSample({ 0 }, 10), TestSample({ 1 }, 12) });
+   test.AddValidationSamples({ TestSample({ 0 }, 11) });
+   test.InitializeBoosting();
+
+   CHECK(0 == test.GetBoosterPerfCallCount(PerfCounter_BinBoosting));
+
+   for(int iEpoch = 0; iEpoch < 3; ++iEpoch) {
+      test.Boost(0);
+   }
+
+   CHECK(3 == test.GetBoosterPerfCallCount(PerfCounter_BinBoosting));
+   CHECK(3 == test.GetBoosterPerfCallCount(PerfCounter_PartitionOneDimensionalBoosting));
+   CHECK(3 == test.GetBoosterPerfCallCount(PerfCounter_ApplyTermUpdateTraining));
+   CHECK(3 == test.GetBoosterPerfCallCount(PerfCounter_ApplyTermUpdateValidation));
+   CHECK(0 == test.GetBoosterPerfCallCount(PerfCounter_PartitionTwoDimensionalBoosting));
+}
+
+TEST_CASE("ApplyTermUpdates matches ApplyTermUpdate on views, multiclass") {
+   // all views generate their updates from the same gradients, so applying them in one batch or one at a time must 
+   // give the same sample scores and the same final validation metric
+   TestApi test1 = TestApi(3);
+   TestApi test2 = TestApi(3);
+   for(TestApi * pTest : { &test1, &test2 }) {
+      pTest->AddFeatures({ FeatureTest(3), FeatureTest(2) });
+      pTest->AddTerms({ { 0 }, { 1 }, { 0, 1 }, {} });
+      pTest->AddTrainingSamples({
+         TestSample({ 0, 0 }, 0),
+         TestSample({ 1, 0 }, 1),
+         TestSample({ 2, 1 }, 2),
+         TestSample({ 1, 1 }, 0),
+         TestSample({ 0, 1 }, 2),
+      });
+      pTest->AddValidationSamples({ TestSample({ 2, 0 }, 1), TestSample({ 0, 1 }, 2) });
+      pTest->InitializeBoosting();
+   }
+
+   for(int iEpoch = 0; iEpoch < 5; ++iEpoch) {
+      const double metric1 = test1.BoostViews({ 0, 1, 2, 3 }, true);
+      const double metric2 = test2.BoostViews({ 0, 1, 2, 3 }, false);
+      CHECK_APPROX(metric1, metric2);
+   }
+   for(size_t iScore = 0; iScore < 3; ++iScore) {
+      CHECK_APPROX(test1.GetCurrentTermScore(0, { 2 }, iScore), test2.GetCurrentTermScore(0, { 2 }, iScore));
+      CHECK_APPROX(test1.GetCurrentTermScore(2, { 1, 1 }, iScore), test2.GetCurrentTermScore(2, { 1, 1 }, iScore));
+   }
+}
+
+TEST_CASE("ApplyTermUpdates matches ApplyTermUpdate on views, regression") {
+   TestApi test1 = TestApi(k_learningTypeRegression);
+   TestApi test2 = TestApi(k_learningTypeRegression);
+   for(TestApi * pTest : { &test1, &test2 }) {
+      pTest->AddFeatures({ FeatureTest(2), FeatureTest(2) });
+      pTest->AddTerms({ { 0 }, { 1 } });
+      pTest->AddTrainingSamples({
+         TestSample({ 0, 0 }, 10),
+         TestSample({ 0, 1 }, 12),
+         TestSample({ 1, 0 }, 15),
+         TestSample({ 1, 1 }, 17),
+      });
+      pTest->AddValidationSamples({ TestSample({ 1, 0 }, 14), TestSample({ 0, 1 }, 11) });
+      pTest->InitializeBoosting();
+   }
+
+   for(int iEpoch = 0; iEpoch < 5; ++iEpoch) {
+      const double metric1 = test1.BoostViews({ 1, 0 }, true);
+      const double metric2 = test2.BoostViews({ 1, 0 }, false);
+      CHECK_APPROX(metric1, metric2);
+   }
+   CHECK_APPROX(test1.GetCurrentTermScore(0, { 1 }, 0), test2.GetCurrentTermScore(0, { 1 }, 0));
+   CHECK_APPROX(test1.GetCurrentTermScore(1, { 1 }, 0), test2.GetCurrentTermScore(1, { 1 }, 0));
+}
+
+TEST_CASE("many classes, boosting, multiclass") {
+   // with this many classes the histograms are built one block of classes at a time, so check classes from
+   // different blocks against the update computed from the zero initial scores
+   constexpr size_t cClasses = 40;
+   TestApi test = TestApi(cClasses);
+   test.AddFeatures({ FeatureTest(2) });
+   test.AddTerms({ { 0 } });
+   test.AddTrainingSamples({
+      TestSample({ 0 }, 5),
+      TestSample({ 0 }, 5),
+      TestSample({ 1 }, 33),
+      TestSample({ 1 }, 33),
+   });
+   test.AddValidationSamples({ TestSample({ 0 }, 5), TestSample({ 1 }, 33) });
+   test.InitializeBoosting();
+
+   test.Boost(0);
+
+   // all classes start with probability 1/40, so the target class has gradient 1/40 - 1 and the others 1/40, and
+   // every class has hessian 1/40 * 39/40
+   const double hessian = 1.0 / cClasses * (cClasses - 1) / cClasses;
+   const double updateTarget = -k_learningRateDefault * (1.0 / cClasses - 1.0) / hessian;
+   const double updateOther = -k_learningRateDefault * (1.0 / cClasses) / hessian;
+   CHECK_APPROX(test.GetCurrentTermScore(0, { 0 }, 5), updateTarget);
+   CHECK_APPROX(test.GetCurrentTermScore(0, { 0 }, 33), updateOther);
+   CHECK_APPROX(test.GetCurrentTermScore(0, { 0 }, 39), updateOther);
+   CHECK_APPROX(test.GetCurrentTermScore(0, { 1 }, 33), updateTarget);
+   CHECK_APPROX(test.GetCurrentTermScore(0, { 1 }, 5), updateOther);
+   CHECK_APPROX(test.GetCurrentTermScore(0, { 1 }, 0), updateOther);
+}
+
+TEST_CASE("gradient sampling keeps only the largest gradients, regression") {
+   TestApi test = TestApi(k_learningTypeRegression);
+   test.AddFeatures({ FeatureTest(2) });
+   test.AddTerms({ { 0 } });
+   test.AddTrainingSamples({
+      TestSample({ 0 }, 1),
+      TestSample({ 0 }, 1),
+      TestSample({ 1 }, 40),
+      TestSample({ 1 }, 40),
+   });
+   test.AddValidationSamples({ TestSample({ 0 }, 1), TestSample({ 1 }, 40) });
+   test.InitializeBoosting(0);
+
+   CHECK(Error_None == test.SetGradientSampling(0.5, 0.0));
+   test.Boost(0);
+   // only the two samples in bin 1 have the largest gradients, so there is nothing to split on and the whole 
+   // tensor moves toward their target
+   CHECK_APPROX(test.GetCurrentTermScore(0, { 0 }, 0), k_learningRateDefault * 40);
+   CHECK_APPROX(test.GetCurrentTermScore(0, { 1 }, 0), k_learningRateDefault * 40);
+
+   // a combined rate of 1 turns gradient sampling back off
+   CHECK(Error_None == test.SetGradientSampling(0.5, 0.5));
+   test.Boost(0);
+   CHECK(test.GetCurrentTermScore(0, { 0 }, 0) < test.GetCurrentTermScore(0, { 1 }, 0));
+}
+
+TEST_CASE("gradient sampling, boosting, binary") {
+   TestApi test = TestApi(2);
+   test.AddFeatures({ FeatureTest(4) });
+   test.AddTerms({ { 0 } });
+   std::vector<TestSample> samples;
+   for(size_t i = 0; i < 100; ++i) {
+      samples.push_back(TestSample({ static_cast<IntEbmType>(i % 4) }, 0 == i % 4 || 1 == i % 7 ? 1 : 0));
+   }
+   test.AddTrainingSamples(samples);
+   test.AddValidationSamples({ TestSample({ 0 }, 1), TestSample({ 1 }, 0), TestSample({ 2 }, 0), TestSample({ 3 }, 0) });
+   test.InitializeBoosting();
+
+   CHECK(Error_IllegalParamValue == test.SetGradientSampling(-0.1, 0.1));
+   CHECK(Error_IllegalParamValue == test.SetGradientSampling(0.2, 1.5));
+   CHECK(Error_IllegalParamValue == test.SetGradientSampling(std::numeric_limits<double>::quiet_NaN(), 0.1));
+   CHECK(Error_None == test.SetGradientSampling(0.2, 0.1));
+
+   double validationMetric = std::numeric_limits<double>::infinity();
+   for(int iEpoch = 0; iEpoch < 50; ++iEpoch) {
+      const double metric = test.Boost(0).validationMetric;
+      CHECK(!std::isnan(metric));
+      validationMetric = metric;
+   }
+   // sampled rows are reweighted, so boosting still pulls the positive bin upward and the others downward
+   CHECK(validationMetric < 0.6931471805599453);
+   CHECK(0 < test.GetCurrentTermScore(0, { 0 }, 1));
+   CHECK(test.GetCurrentTermScore(0, { 2 }, 1) < 0);
+}
+
+TEST_CASE("gradient sampling capacity matches the rounding of the sampled counts, regression") {
+   TestApi test = TestApi(k_learningTypeRegression);
+   test.AddFeatures({ FeatureTest(2) });
+   test.AddTerms({ { 0 } });
+   std::vector<TestSample> samples;
+   for(size_t i = 0; i < 1430; ++i) {
+      samples.push_back(TestSample({ static_cast<IntEbmType>(i % 2) }, static_cast<double>(i % 13)));
+   }
+   test.AddTrainingSamples(samples);
+   test.AddValidationSamples({ TestSample({ 0 }, 6), TestSample({ 1 }, 6) });
+   test.InitializeBoosting(0);
+
+   // (0.2 + 0.5) * 1430 rounds down to 1000, but 0.2 * 1430 + 0.5 * 1430 keeps 286 + 715 = 1001 samples
+   CHECK(Error_None == test.SetGradientSampling(0.2, 0.5));
+   for(int iEpoch = 0; iEpoch < 10; ++iEpoch) {
+      CHECK(!std::isnan(test.Boost(0).validationMetric));
+   }
+}
+
+TEST_CASE("row subsampling, boosting, regression") {
+   TestApi test = TestApi(k_learningTypeRegression);
+   test.AddFeatures({ FeatureTest(2) });
+   test.AddTerms({ { 0 } });
+   std::vector<TestSample> samples;
+   for(size_t i = 0; i < 40; ++i) {
+      samples.push_back(TestSample({ static_cast<IntEbmType>(i % 2) }, 0 == i % 2 ? 10 : 20));
+   }
+   test.AddTrainingSamples(samples);
+   test.AddValidationSamples({ TestSample({ 0 }, 10), TestSample({ 1 }, 20) });
+   test.InitializeBoosting(0);
+
+   CHECK(Error_IllegalParamValue == test.SetRowSubsampling(-0.5));
+   CHECK(Error_IllegalParamValue == test.SetRowSubsampling(1.5));
+   CHECK(Error_IllegalParamValue == test.SetRowSubsampling(std::numeric_limits<double>::quiet_NaN()));
+   CHECK(Error_None == test.SetRowSubsampling(0.5));
+
+   // every round sees a different half of the samples, but all samples in a bin share the same target
+   for(int iEpoch = 0; iEpoch < 200; ++iEpoch) {
+      test.Boost(0, GenerateUpdateOptions_Default, 0.1);
+   }
+   CHECK(std::abs(test.GetCurrentTermScore(0, { 0 }, 0) - 10) < 0.01);
+   CHECK(std::abs(test.GetCurrentTermScore(0, { 1 }, 0) - 20) < 0.01);
+}
+
+TEST_CASE("row subsampling with a rate of 1 matches regular boosting, multiclass") {
+   TestApi test1 = TestApi(3);
+   TestApi test2 = TestApi(3);
+   for(TestApi * pTest : { &test1, &test2 }) {
+      pTest->AddFeatures({ FeatureTest(3) });
+      pTest->AddTerms({ { 0 } });
+      pTest->AddTrainingSamples({
+         TestSample({ 0 }, 0),
+         TestSample({ 1 }, 1),
+         TestSample({ 2 }, 2),
+         TestSample({ 0 }, 1),
+      });
+      pTest->AddValidationSamples({ TestSample({ 0 }, 0), TestSample({ 1 }, 1), TestSample({ 2 }, 2) });
+      pTest->InitializeBoosting();
+   }
+   CHECK(Error_None == test2.SetRowSubsampling(0.25));
+   CHECK(Error_None == test2.SetRowSubsampling(1.0));
+
+   for(int iEpoch = 0; iEpoch < 10; ++iEpoch) {
+      const double metric1 = test1.Boost(0).validationMetric;
+      const double metric2 = test2.Boost(0).validationMetric;
+      CHECK_APPROX(metric1, metric2);
+   }
+   CHECK_APPROX(test1.GetCurrentTermScore(0, { 1 }, 2), test2.GetCurrentTermScore(0, { 1 }, 2));
+}
+
+TEST_CASE("bin sorted layout matches regular boosting, multiclass") {
+   // inner bags leave some samples out, which the bin sorted layout still visits with zero counts and weights
+   TestApi test1 = TestApi(3);
+   TestApi test2 = TestApi(3);
+   const CreateBoosterFlagsType aFlags[] = { CreateBoosterFlags_Default, CreateBoosterFlags_BinSortedLayout };
+   TestApi * const apTests[] = { &test1, &test2 };
+   for(size_t iTest = 0; iTest < 2; ++iTest) {
+      TestApi * const pTest = apTests[iTest];
+      pTest->AddFeatures({ FeatureTest(5), FeatureTest(3) });
+      pTest->AddTerms({ { 0 }, { 1 }, { 0, 1 } });
+      std::vector<TestSample> samples;
+      for(size_t i = 0; i < 50; ++i) {
+         samples.push_back(TestSample(
+            { static_cast<IntEbmType>(i * 7 % 5), static_cast<IntEbmType>(i % 3) }, 
+            static_cast<IntEbmType>(i * 11 % 3)
+         ));
+      }
+      pTest->AddTrainingSamples(samples);
+      pTest->AddValidationSamples({ TestSample({ 0, 1 }, 0), TestSample({ 3, 2 }, 1), TestSample({ 4, 0 }, 2) });
+      pTest->InitializeBoosting(2, aFlags[iTest]);
+   }
+
+   for(int iEpoch = 0; iEpoch < 10; ++iEpoch) {
+      for(IntEbmType iTerm = 0; iTerm < 3; ++iTerm) {
+         const double metric1 = test1.Boost(iTerm).validationMetric;
+         const double metric2 = test2.Boost(iTerm).validationMetric;
+         CHECK_APPROX(metric1, metric2);
+      }
+   }
+   CHECK_APPROX(test1.GetCurrentTermScore(0, { 3 }, 1), test2.GetCurrentTermScore(0, { 3 }, 1));
+   CHECK_APPROX(test1.GetCurrentTermScore(1, { 2 }, 2), test2.GetCurrentTermScore(1, { 2 }, 2));
+}
+
+TEST_CASE("bin sorted layout matches regular boosting, regression") {
+   TestApi test1 = TestApi(k_learningTypeRegression);
+   TestApi test2 = TestApi(k_learningTypeRegression);
+   const CreateBoosterFlagsType aFlags[] = { CreateBoosterFlags_Default, CreateBoosterFlags_BinSortedLayout };
+   TestApi * const apTests[] = { &test1, &test2 };
+   for(size_t iTest = 0; iTest < 2; ++iTest) {
+      TestApi * const pTest = apTests[iTest];
+      pTest->AddFeatures({ FeatureTest(4) });
+      pTest->AddTerms({ { 0 } });
+      std::vector<TestSample> samples;
+      for(size_t i = 0; i < 30; ++i) {
+         samples.push_back(TestSample({ static_cast<IntEbmType>(i * 3 % 4) }, static_cast<double>(i % 7), 1.0 + static_cast<double>(i % 2)));
+      }
+      pTest->AddTrainingSamples(samples);
+      pTest->AddValidationSamples({ TestSample({ 0 }, 1, 1.0), TestSample({ 3 }, 5, 2.0) });
+      pTest->InitializeBoosting(0, aFlags[iTest]);
+   }
+
+   for(int iEpoch = 0; iEpoch < 10; ++iEpoch) {
+      const double metric1 = test1.Boost(0).validationMetric;
+      const double metric2 = test2.Boost(0).validationMetric;
+      CHECK_APPROX(metric1, metric2);
+   }
+   CHECK_APPROX(test1.GetCurrentTermScore(0, { 2 }, 0), test2.GetCurrentTermScore(0, { 2 }, 0));
+}
+
+TEST_CASE("corner partition isolates one cell, 3 dimensions, regression") {
+   TestApi test = TestApi(k_learningTypeRegression);
+   test.AddFeatures({ FeatureTest(2), FeatureTest(2), FeatureTest(2) });
+   test.AddTerms({ { 0, 1, 2 } });
+   std::vector<TestSample> samples;
+   for(IntEbmType i0 = 0; i0 < 2; ++i0) {
+      for(IntEbmType i1 = 0; i1 < 2; ++i1) {
+         for(IntEbmType i2 = 0; i2 < 2; ++i2) {
+            samples.push_back(TestSample({ i0, i1, i2 }, 1 == i0 && 1 == i1 && 1 == i2 ? 10 : 0));
+         }
+      }
+   }
+   test.AddTrainingSamples(samples);
+   test.AddValidationSamples({ TestSample({ 1, 1, 1 }, 10) });
+   test.InitializeBoosting();
+
+   test.Boost(0, GenerateUpdateOptions_Default, k_learningRateDefault, 1);
+
+   CHECK(1 == test.GetBoosterPerfCallCount(PerfCounter_PartitionCornerBoosting));
+   CHECK(0 == test.GetBoosterPerfCallCount(PerfCounter_PartitionRandomBoosting));
+
+   CHECK_APPROX(test.GetCurrentTermScore(0, { 1, 1, 1 }, 0), k_learningRateDefault * 10);
+   CHECK_APPROX(test.GetCurrentTermScore(0, { 0, 0, 0 }, 0), 0);
+   CHECK_APPROX(test.GetCurrentTermScore(0, { 1, 1, 0 }, 0), 0);
+   CHECK_APPROX(test.GetCurrentTermScore(0, { 0, 1, 1 }, 0), 0);
+}
+
+TEST_CASE("corner partition isolates one cell, 4 dimensions, multiclass") {
+   TestApi test = TestApi(3);
+   test.AddFeatures({ FeatureTest(2), FeatureTest(2), FeatureTest(2), FeatureTest(2) });
+   test.AddTerms({ { 0, 1, 2, 3 } });
+   std::vector<TestSample> samples;
+   for(IntEbmType i = 0; i < 16; ++i) {
+      samples.push_back(TestSample({ i & 1, (i >> 1) & 1, (i >> 2) & 1, (i >> 3) & 1 }, 0 == i ? 2 : 0));
+   }
+   test.AddTrainingSamples(samples);
+   test.AddValidationSamples({ TestSample({ 0, 0, 0, 0 }, 2), TestSample({ 1, 1, 1, 1 }, 0) });
+   test.InitializeBoosting();
+
+   double validationMetricPrev = std::numeric_limits<double>::infinity();
+   for(int iEpoch = 0; iEpoch < 10; ++iEpoch) {
+      const double validationMetric = test.Boost(0, GenerateUpdateOptions_Default, k_learningRateDefault, 1).validationMetric;
+      CHECK(validationMetric < validationMetricPrev);
+      validationMetricPrev = validationMetric;
+   }
+
+   CHECK(10 == test.GetBoosterPerfCallCount(PerfCounter_PartitionCornerBoosting));
+
+   const double scoreCorner = test.GetCurrentTermScore(0, { 0, 0, 0, 0 }, 2);
+   const double scoreRest = test.GetCurrentTermScore(0, { 1, 1, 1, 1 }, 2);
+   CHECK(scoreRest < scoreCorner);
+   CHECK_APPROX(test.GetCurrentTermScore(0, { 1, 0, 0, 0 }, 2), scoreRest);
+   CHECK_APPROX(test.GetCurrentTermScore(0, { 0, 1, 1, 0 }, 2), scoreRest);
+}
+
+TEST_CASE("term scheduling skips exhausted terms and re-checks them, regression") {
+   TestApi test = TestApi(k_learningTypeRegression);
+   test.AddFeatures({ FeatureTest(2), FeatureTest(2) });
+   test.AddTerms({ { 0 }, { 1 } });
+   // feature 1 has the same bin for every sample, so its term can never gain anything
+   test.AddTrainingSamples({
+      TestSample({ 0, 0 }, 1),
+      TestSample({ 0, 0 }, 1),
+      TestSample({ 1, 0 }, 40),
+      TestSample({ 1, 0 }, 40),
+   });
+   test.AddValidationSamples({ TestSample({ 0, 0 }, 1), TestSample({ 1, 0 }, 40) });
+   test.InitializeBoosting(0);
+
+   // without scheduling every term is boosted every round
+   CHECK((std::vector<IntEbmType> { 0, 1 }) == test.ScheduleTerms());
+
+   CHECK(Error_IllegalParamValue == test.SetTermScheduling(-0.1, 4));
+   CHECK(Error_IllegalParamValue == test.SetTermScheduling(1.5, 4));
+   CHECK(Error_IllegalParamValue == test.SetTermScheduling(std::numeric_limits<double>::quiet_NaN(), 4));
+   CHECK(Error_IllegalParamValue == test.SetTermScheduling(0.01, 0));
+   CHECK(Error_None == test.SetTermScheduling(0.01, 4));
+
+   for(size_t iRound = 0; iRound < 8; ++iRound) {
+      const std::vector<IntEbmType> termIndexes = test.ScheduleTerms();
+      if(0 == iRound || 3 == iRound || 7 == iRound) {
+         // the first round has no history, and after that term 1 is re-checked every 4th round
+         CHECK((std::vector<IntEbmType> { 0, 1 }) == termIndexes);
+      } else {
+         CHECK(std::vector<IntEbmType> { 0 } == termIndexes);
+      }
+      for(const IntEbmType indexTerm : termIndexes) {
+         test.Boost(indexTerm);
+      }
+   }
+
+   // turning it off boosts everything again
+   CHECK(Error_None == test.SetTermScheduling(0.0, 1));
+   CHECK((std::vector<IntEbmType> { 0, 1 }) == test.ScheduleTerms());
+}
@@ -569,3 +569,128 @@ TEST_CASE("data_set_shared, two features, 3 samples, weights, classification") {
 
    CHECK(99 == buffer[static_cast<size_t>(sum)]);
 }
+
+TEST_CASE("ComputeScoresFromDataSet, main and pair, 3 classes") {
+   IntEbmType sum = 0;
+   ErrorEbmType error;
+   constexpr IntEbmType k_cSamples = 3;
+   IntEbmType binnedData0[k_cSamples] { 2, 1, 0 };
+   IntEbmType binnedData1[k_cSamples] { 0, 1, 1 };
+   IntEbmType targets[k_cSamples] { 2, 1, 0 };
+
+   sum += SizeDataSetHeader(2, 0, 1);
+   sum += SizeFeature(3, EBM_TRUE, EBM_TRUE, EBM_FALSE, k_cSamples, &binnedData0[0]);
+   sum += SizeFeature(2, EBM_TRUE, EBM_TRUE, EBM_FALSE, k_cSamples, &binnedData1[0]);
+   sum += SizeClassificationTarget(3, k_cSamples, &targets[0]);
+
+   std::vector<char> buffer(static_cast<size_t>(sum));
+   error = FillDataSetHeader(2, 0, 1, sum, &buffer[0]);
+   CHECK(Error_None == error);
+   error = FillFeature(3, EBM_TRUE, EBM_TRUE, EBM_FALSE, k_cSamples, &binnedData0[0], sum, &buffer[0]);
+   CHECK(Error_None == error);
+   error = FillFeature(2, EBM_TRUE, EBM_TRUE, EBM_FALSE, k_cSamples, &binnedData1[0], sum, &buffer[0]);
+   CHECK(Error_None == error);
+   error = FillClassificationTarget(3, k_cSamples, &targets[0], sum, &buffer[0]);
+   CHECK(Error_None == error);
+
+   const IntEbmType dimensionCounts[] { 1, 2 };
+   const IntEbmType featureIndexes[] { 0, 0, 1 };
+   // 3 bins x 3 scores for the main, then 3 x 2 bins x 3 scores for the pair with feature 0 in the lowest stride
+   std::vector<double> termScores;
+   for(size_t i = 0; i < 3 * 3 + 3 * 2 * 3; ++i) {
+      termScores.push_back(static_cast<double>(i));
+   }
+   const double intercept[] { 0.5, -0.5, 1.0 };
+
+   std::vector<double> scores(static_cast<size_t>(k_cSamples) * 3);
+   error = ComputeScoresFromDataSet(
+      &buffer[0],
+      2,
+      dimensionCounts,
+      featureIndexes,
+      &termScores[0],
+      intercept,
+      0,
+      &scores[0]
+   );
+   CHECK(Error_None == error);
+
+   for(size_t iSample = 0; iSample < static_cast<size_t>(k_cSamples); ++iSample) {
+      const size_t iMain = static_cast<size_t>(binnedData0[iSample]);
+      const size_t iPair = static_cast<size_t>(binnedData0[iSample] + 3 * binnedData1[iSample]);
+      for(size_t iScore = 0; iScore < 3; ++iScore) {
+         const double expected = intercept[iScore] + termScores[iMain * 3 + iScore] + 
+            termScores[3 * 3 + iPair * 3 + iScore];
+         CHECK(expected == scores[iSample * 3 + iScore]);
+      }
+   }
+}
+
+TEST_CASE("ComputeScoresFromDataSet, threads, regression") {
+   IntEbmType sum = 0;
+   ErrorEbmType error;
+   constexpr IntEbmType k_cSamples = 100003;
+   constexpr IntEbmType k_cBins = 7;
+   std::vector<IntEbmType> binnedData(static_cast<size_t>(k_cSamples));
+   std::vector<double> targets(static_cast<size_t>(k_cSamples));
+   for(size_t iSample = 0; iSample < static_cast<size_t>(k_cSamples); ++iSample) {
+      binnedData[iSample] = static_cast<IntEbmType>(iSample * 5 % static_cast<size_t>(k_cBins));
+      targets[iSample] = static_cast<double>(iSample);
+   }
+
+   sum += SizeDataSetHeader(1, 0, 1);
+   sum += SizeFeature(k_cBins, EBM_TRUE, EBM_TRUE, EBM_FALSE, k_cSamples, &binnedData[0]);
+   sum += SizeRegressionTarget(k_cSamples, &targets[0]);
+
+   std::vector<char> buffer(static_cast<size_t>(sum));
+   error = FillDataSetHeader(1, 0, 1, sum, &buffer[0]);
+   CHECK(Error_None == error);
+   error = FillFeature(k_cBins, EBM_TRUE, EBM_TRUE, EBM_FALSE, k_cSamples, &binnedData[0], sum, &buffer[0]);
+   CHECK(Error_None == error);
+   error = FillRegressionTarget(k_cSamples, &targets[0], sum, &buffer[0]);
+   CHECK(Error_None == error);
+
+   const IntEbmType dimensionCounts[] { 1 };
+   const IntEbmType featureIndexes[] { 0 };
+   const double termScores[k_cBins] { -3.0, -2.0, -1.0, 0.0, 1.0, 2.0, 3.0 };
+
+   std::vector<double> scoresSingle(static_cast<size_t>(k_cSamples));
+   error = ComputeScoresFromDataSet(
+      &buffer[0], 1, dimensionCounts, featureIndexes, termScores, nullptr, 1, &scoresSingle[0]);
+   CHECK(Error_None == error);
+
+   std::vector<double> scoresThreaded(static_cast<size_t>(k_cSamples));
+   error = ComputeScoresFromDataSet(
+      &buffer[0], 1, dimensionCounts, featureIndexes, termScores, nullptr, 4, &scoresThreaded[0]);
+   CHECK(Error_None == error);
+
+   for(size_t iSample = 0; iSample < static_cast<size_t>(k_cSamples); ++iSample) {
+      CHECK(termScores[binnedData[iSample]] == scoresSingle[iSample]);
+      CHECK(scoresSingle[iSample] == scoresThreaded[iSample]);
+   }
+
+   const IntEbmType badFeatureIndexes[] { 1 };
+   error = ComputeScoresFromDataSet(
+      &buffer[0], 1, dimensionCounts, badFeatureIndexes, termScores, nullptr, 0, &scoresSingle[0]);
+   CHECK(Error_IllegalParamValue == error);
+}
+
+TEST_CASE("data_set_shared, SizeFeature without binned data, regression") {
+   constexpr IntEbmType k_cSamples = 3;
+   IntEbmType binnedData[k_cSamples] { 2, 1, 0 };
+
+   const IntEbmType sizeWithData = SizeFeature(3, EBM_TRUE, EBM_TRUE, EBM_FALSE, k_cSamples, &binnedData[0]);
+   CHECK(0 <= sizeWithData);
+   const IntEbmType sizeWithoutData = SizeFeature(3, EBM_TRUE, EBM_TRUE, EBM_FALSE, k_cSamples, nullptr);
+   CHECK(sizeWithData == sizeWithoutData);
+
+   double targets[k_cSamples] { 0.3, 0.2, 0.1 };
+   const IntEbmType sum = SizeDataSetHeader(1, 0, 1) + sizeWithoutData + SizeRegressionTarget(k_cSamples, targets);
+   std::vector<char> buffer(static_cast<size_t>(sum));
+
+   ErrorEbmType error = FillDataSetHeader(1, 0, 1, sum, &buffer[0]);
+   CHECK(Error_None == error);
+   // FillFeature still needs the data
+   error = FillFeature(3, EBM_TRUE, EBM_TRUE, EBM_FALSE, k_cSamples, nullptr, sum, &buffer[0]);
+   CHECK(Error_IllegalParamValue == error);
+}
@@ -580,7 +580,7 @@ void TestApi::AddValidationSamples(const std::vector<TestSample> samples) {
    m_stage = Stage::ValidationAdded;
 }
 
-void TestApi::InitializeBoosting(const IntEbmType countInnerBags) {
+void TestApi::InitializeBoosting(const IntEbmType countInnerBags, const CreateBoosterFlagsType flags) {
    ErrorEbmType error;
 
    if(Stage::ValidationAdded != m_stage) {
@@ -675,6 +675,7 @@ void TestApi::InitializeBoosting(const IntEbmType countInnerBags) {
       0 == m_dimensionCounts.size() ? nullptr : &m_dimensionCounts[0],
       0 == m_featureIndexes.size() ? nullptr : &m_featureIndexes[0],
       countInnerBags,
+      flags,
       nullptr,
       &m_boosterHandle
    );
@@ -870,6 +871,126 @@ void TestApi::GetCurrentTermScoresRaw(const size_t iTerm, double * const aTermSc
    }
 }
 
+std::vector<unsigned char> TestApi::SerializeBoosterState() const {
+   if(Stage::InitializedBoosting != m_stage) {
+      exit(1);
+   }
+   const IntEbmType countBytes = SizeSerializedBooster(m_boosterHandle);
+   if(countBytes <= 0) {
+      exit(1);
+   }
+   std::vector<unsigned char> serialized(static_cast<size_t>(countBytes));
+   const ErrorEbmType error = SerializeBooster(m_boosterHandle, countBytes, &serialized[0]);
+   if(Error_None != error) {
+      exit(1);
+   }
+   return serialized;
+}
+
+void TestApi::DeserializeBoosterState(const std::vector<unsigned char> & serialized) {
+   if(Stage::InitializedBoosting != m_stage) {
+      exit(1);
+   }
+   const ErrorEbmType error = DeserializeBooster(m_boosterHandle, static_cast<IntEbmType>(serialized.size()), &serialized[0]);
+   if(Error_None != error) {
+      exit(1);
+   }
+}
+
+IntEbmType TestApi::GetBoosterPerfCallCount(const IntEbmType perfCounter) const {
+   if(Stage::InitializedBoosting != m_stage) {
+      exit(1);
+   }
+   IntEbmType aCallCounts[PerfCounter_Count];
+   const ErrorEbmType error = GetBoosterPerfCounters(m_boosterHandle, PerfCounter_Count, aCallCounts, nullptr);
+   if(Error_None != error) {
+      exit(1);
+   }
+   return aCallCounts[perfCounter];
+}
+
+ErrorEbmType TestApi::SetGradientSampling(const double topRate, const double otherRate) {
+   if(Stage::InitializedBoosting != m_stage) {
+      exit(1);
+   }
+   return ::SetGradientSampling(m_boosterHandle, topRate, otherRate);
+}
+
+ErrorEbmType TestApi::SetRowSubsampling(const double rate) {
+   if(Stage::InitializedBoosting != m_stage) {
+      exit(1);
+   }
+   return ::SetRowSubsampling(m_boosterHandle, rate);
+}
+
+ErrorEbmType TestApi::SetTermScheduling(const double gainRelativeMin, const IntEbmType recheckRounds) {
+   if(Stage::InitializedBoosting != m_stage) {
+      exit(1);
+   }
+   return ::SetTermScheduling(m_boosterHandle, gainRelativeMin, recheckRounds);
+}
+
+std::vector<IntEbmType> TestApi::ScheduleTerms() {
+   if(Stage::InitializedBoosting != m_stage) {
+      exit(1);
+   }
+   std::vector<IntEbmType> termIndexes(GetCountTerms() + 1);
+   IntEbmType countTerms;
+   const ErrorEbmType error = ::ScheduleTerms(m_boosterHandle, &countTerms, &termIndexes[0]);
+   if(Error_None != error) {
+      exit(1);
+   }
+   termIndexes.resize(static_cast<size_t>(countTerms));
+   return termIndexes;
+}
+
+double TestApi::BoostViews(const std::vector<IntEbmType> & indexTerms, const bool bBatch, const double learningRate) {
+   // generate every update against the same gradients using one view per term, then apply them either all 
+   // together through ApplyTermUpdates, or one at a time through ApplyTermUpdate
+   if(Stage::InitializedBoosting != m_stage) {
+      exit(1);
+   }
+   std::vector<BoosterHandle> views;
+   for(size_t iView = 0; iView < indexTerms.size(); ++iView) {
+      BoosterHandle view = nullptr;
+      if(Error_None != CreateBoosterView(m_boosterHandle, &view)) {
+         exit(1);
+      }
+      views.push_back(view);
+
+      double gainAvg;
+      const ErrorEbmType error = GenerateTermUpdate(
+         view,
+         indexTerms[iView],
+         GenerateUpdateOptions_Default,
+         learningRate,
+         k_countSamplesRequiredForChildSplitMinDefault,
+         &k_leavesMaxDefault[0],
+         &gainAvg
+      );
+      if(Error_None != error) {
+         exit(1);
+      }
+   }
+
+   double validationMetric = std::numeric_limits<double>::quiet_NaN();
+   if(bBatch) {
+      if(Error_None != ApplyTermUpdates(views.size(), &views[0], &validationMetric)) {
+         exit(1);
+      }
+   } else {
+      for(BoosterHandle view : views) {
+         if(Error_None != ApplyTermUpdate(view, &validationMetric)) {
+            exit(1);
+         }
+      }
+   }
+   for(BoosterHandle view : views) {
+      FreeBooster(view);
+   }
+   return validationMetric;
+}
+
 void TestApi::AddInteractionSamples(const std::vector<TestSample> samples) {
    if(Stage::FeaturesAdded != m_stage) {
       exit(1);
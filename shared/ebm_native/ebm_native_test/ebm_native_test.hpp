@@ -19,7 +19,15 @@ enum class TestPriority {
    CutUniform,
    CutWinsorized,
    CutQuantile,
-   Discretize
+   Discretize,
+   CategoricalEncoder,
+   ComputeScoresAndContributions,
+   AggregateBaggedTermScores,
+   HarmonizeTensors,
+   ComputeFeatureEffects,
+   ComputeShapleyValues,
+   CutFeatures,
+   LogBuffer
 };
 
 
@@ -374,7 +382,10 @@ public:
    void AddTerms(const std::vector<std::vector<size_t>> termFeatures);
    void AddTrainingSamples(const std::vector<TestSample> samples);
    void AddValidationSamples(const std::vector<TestSample> samples);
-   void InitializeBoosting(const IntEbmType countInnerBags = k_countInnerBagsDefault);
+   void InitializeBoosting(
+      const IntEbmType countInnerBags = k_countInnerBagsDefault, 
+      const CreateBoosterFlagsType flags = CreateBoosterFlags_Default
+   );
    
    BoostRet Boost(
       const IntEbmType indexTerm,
@@ -400,6 +411,15 @@ public:
 
    void GetCurrentTermScoresRaw(const size_t iTerm, double * const aTermScores) const;
 
+   std::vector<unsigned char> SerializeBoosterState() const;
+   void DeserializeBoosterState(const std::vector<unsigned char> & serialized);
+   IntEbmType GetBoosterPerfCallCount(const IntEbmType perfCounter) const;
+   ErrorEbmType SetGradientSampling(const double topRate, const double otherRate);
+   ErrorEbmType SetRowSubsampling(const double rate);
+   ErrorEbmType SetTermScheduling(const double gainRelativeMin, const IntEbmType recheckRounds);
+   std::vector<IntEbmType> ScheduleTerms();
+   double BoostViews(const std::vector<IntEbmType> & indexTerms, const bool bBatch, const double learningRate = k_learningRateDefault);
+
    void AddInteractionSamples(const std::vector<TestSample> samples);
 
    void InitializeInteraction();
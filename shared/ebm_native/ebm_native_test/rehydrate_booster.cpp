@@ -117,3 +117,107 @@ TEST_CASE("Test Rehydration, boosting, multiclass") {
    }
 }
 
+
+TEST_CASE("Test Rehydration, serialize and resume, multiclass") {
+   const std::vector<TestSample> trainingSamples = {
+      TestSample({ 0, 1 }, 0),
+      TestSample({ 1, 0 }, 1),
+      TestSample({ 2, 1 }, 2),
+      TestSample({ 3, 0 }, 0),
+      TestSample({ 1, 1 }, 2),
+      TestSample({ 2, 0 }, 1),
+   };
+   const std::vector<TestSample> validationSamples = {
+      TestSample({ 0, 0 }, 0),
+      TestSample({ 2, 1 }, 1),
+      TestSample({ 3, 1 }, 2),
+   };
+
+   TestApi testContinuous = TestApi(3);
+   testContinuous.AddFeatures({ FeatureTest(4), FeatureTest(2) });
+   testContinuous.AddTerms({ { 0 }, { 1 }, { 0, 1 } });
+   testContinuous.AddTrainingSamples(trainingSamples);
+   testContinuous.AddValidationSamples(validationSamples);
+   testContinuous.InitializeBoosting(2);
+
+   for(int iEpoch = 0; iEpoch < 20; ++iEpoch) {
+      for(size_t iTerm = 0; iTerm < testContinuous.GetCountTerms(); ++iTerm) {
+         testContinuous.Boost(iTerm, GenerateUpdateOptions_RandomSplits);
+      }
+   }
+
+   const std::vector<unsigned char> serialized = testContinuous.SerializeBoosterState();
+
+   TestApi testResume = TestApi(3);
+   testResume.AddFeatures({ FeatureTest(4), FeatureTest(2) });
+   testResume.AddTerms({ { 0 }, { 1 }, { 0, 1 } });
+   testResume.AddTrainingSamples(trainingSamples);
+   testResume.AddValidationSamples(validationSamples);
+   testResume.InitializeBoosting(2);
+   testResume.DeserializeBoosterState(serialized);
+
+   for(int iEpoch = 0; iEpoch < 20; ++iEpoch) {
+      for(size_t iTerm = 0; iTerm < testContinuous.GetCountTerms(); ++iTerm) {
+         const BoostRet retContinuous = testContinuous.Boost(iTerm, GenerateUpdateOptions_RandomSplits);
+         const BoostRet retResume = testResume.Boost(iTerm, GenerateUpdateOptions_RandomSplits);
+         CHECK(retContinuous.gainAvg == retResume.gainAvg);
+         CHECK(retContinuous.validationMetric == retResume.validationMetric);
+      }
+   }
+
+   for(size_t iBin = 0; iBin < 4; ++iBin) {
+      for(size_t iClass = 0; iClass < 3; ++iClass) {
+         CHECK(testContinuous.GetCurrentTermScore(0, { iBin }, iClass) == testResume.GetCurrentTermScore(0, { iBin }, iClass));
+         CHECK(testContinuous.GetBestTermScore(0, { iBin }, iClass) == testResume.GetBestTermScore(0, { iBin }, iClass));
+         CHECK(testContinuous.GetCurrentTermScore(2, { iBin, 1 }, iClass) == testResume.GetCurrentTermScore(2, { iBin, 1 }, iClass));
+      }
+   }
+}
+
+TEST_CASE("Test Rehydration, serialize and resume the term schedule, regression") {
+   // feature 1 has the same bin for every sample, so its term can never gain anything
+   const std::vector<TestSample> trainingSamples = {
+      TestSample({ 0, 0 }, 1),
+      TestSample({ 0, 0 }, 1),
+      TestSample({ 1, 0 }, 40),
+      TestSample({ 1, 0 }, 40),
+   };
+   const std::vector<TestSample> validationSamples = { TestSample({ 0, 0 }, 1), TestSample({ 1, 0 }, 40) };
+
+   TestApi testContinuous = TestApi(k_learningTypeRegression);
+   testContinuous.AddFeatures({ FeatureTest(2), FeatureTest(2) });
+   testContinuous.AddTerms({ { 0 }, { 1 } });
+   testContinuous.AddTrainingSamples(trainingSamples);
+   testContinuous.AddValidationSamples(validationSamples);
+   testContinuous.InitializeBoosting(0);
+   CHECK(Error_None == testContinuous.SetTermScheduling(0.01, 4));
+
+   for(int iRound = 0; iRound < 2; ++iRound) {
+      for(const IntEbmType indexTerm : testContinuous.ScheduleTerms()) {
+         testContinuous.Boost(indexTerm);
+      }
+   }
+
+   const std::vector<unsigned char> serialized = testContinuous.SerializeBoosterState();
+
+   TestApi testResume = TestApi(k_learningTypeRegression);
+   testResume.AddFeatures({ FeatureTest(2), FeatureTest(2) });
+   testResume.AddTerms({ { 0 }, { 1 } });
+   testResume.AddTrainingSamples(trainingSamples);
+   testResume.AddValidationSamples(validationSamples);
+   testResume.InitializeBoosting(0);
+   CHECK(Error_None == testResume.SetTermScheduling(0.01, 4));
+   testResume.DeserializeBoosterState(serialized);
+
+   // without the gain history the resumed booster would boost term 1 again in the next round, and without the round 
+   // index it would re-check term 1 in a different round
+   for(int iRound = 2; iRound < 8; ++iRound) {
+      const std::vector<IntEbmType> termIndexes = testContinuous.ScheduleTerms();
+      CHECK(termIndexes == testResume.ScheduleTerms());
+      for(const IntEbmType indexTerm : termIndexes) {
+         const BoostRet retContinuous = testContinuous.Boost(indexTerm);
+         const BoostRet retResume = testResume.Boost(indexTerm);
+         CHECK(retContinuous.validationMetric == retResume.validationMetric);
+      }
+   }
+}
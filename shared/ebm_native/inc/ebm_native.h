@@ -21,6 +21,7 @@ extern "C" {
 #define EBM_TRACE_CAST(EBM_VAL)                    (STATIC_CAST(TraceEbmType, (EBM_VAL)))
 #define EBM_GENERATE_UPDATE_OPTIONS_CAST(EBM_VAL)  (STATIC_CAST(GenerateUpdateOptionsType, (EBM_VAL)))
 #define EBM_INTERACTION_OPTIONS_CAST(EBM_VAL)      (STATIC_CAST(InteractionOptionsType, (EBM_VAL)))
+#define EBM_CREATE_BOOSTER_FLAGS_CAST(EBM_VAL)     (STATIC_CAST(CreateBoosterFlagsType, (EBM_VAL)))
 
 //#define EXPAND_BINARY_LOGITS
 // TODO: implement REDUCE_MULTICLASS_LOGITS
@@ -95,6 +96,12 @@ typedef struct _InteractionHandle {
    char unused;
 } * InteractionHandle;
 
+typedef struct _CategoricalEncoderHandle {
+   // this struct exists to enforce that our caller doesn't mix handle types.
+   // In C/C++ languages the caller will get an error if they try to mix these pointer types.
+   char unused;
+} * CategoricalEncoderHandle;
+
 #ifndef PRId32
 // this should really be defined, but some compilers aren't compliant
 #define PRId32 "d"
@@ -154,6 +161,10 @@ typedef int64_t InteractionOptionsType;
 // technically printf hexidecimals are unsigned, so convert it first to unsigned before calling printf
 typedef uint64_t UInteractionOptionsType;
 #define UInteractionOptionsTypePrintf PRIx64
+typedef int64_t CreateBoosterFlagsType;
+// technically printf hexidecimals are unsigned, so convert it first to unsigned before calling printf
+typedef uint64_t UCreateBoosterFlagsType;
+#define UCreateBoosterFlagsTypePrintf PRIx64
 
 #define EBM_FALSE          (EBM_BOOL_CAST(0))
 #define EBM_TRUE           (EBM_BOOL_CAST(1))
@@ -187,6 +198,42 @@ typedef uint64_t UInteractionOptionsType;
 #define InteractionOptions_Default                 (EBM_INTERACTION_OPTIONS_CAST(0x0000000000000000))
 #define InteractionOptions_Pure                    (EBM_INTERACTION_OPTIONS_CAST(0x0000000000000001))
 
+#define CreateBoosterFlags_Default                 (EBM_CREATE_BOOSTER_FLAGS_CAST(0x0000000000000000))
+// keep the training sample indexes of single feature terms grouped by bin so histograms are summed one bin at a time
+#define CreateBoosterFlags_BinSortedLayout         (EBM_CREATE_BOOSTER_FLAGS_CAST(0x0000000000000001))
+
+// the Arrow C Data Interface value types that DiscretizeArrow reads directly
+#define ArrowType_Float64                          (STATIC_CAST(IntEbmType, 0))
+#define ArrowType_Float32                          (STATIC_CAST(IntEbmType, 1))
+#define ArrowType_Int64                            (STATIC_CAST(IntEbmType, 2))
+#define ArrowType_Int32                            (STATIC_CAST(IntEbmType, 3))
+#define ArrowType_Int16                            (STATIC_CAST(IntEbmType, 4))
+#define ArrowType_Int8                             (STATIC_CAST(IntEbmType, 5))
+#define ArrowType_UInt64                           (STATIC_CAST(IntEbmType, 6))
+#define ArrowType_UInt32                           (STATIC_CAST(IntEbmType, 7))
+#define ArrowType_UInt16                           (STATIC_CAST(IntEbmType, 8))
+#define ArrowType_UInt8                            (STATIC_CAST(IntEbmType, 9))
+
+// the cutting algorithms that CutFeatures can apply to each feature
+#define CutMethod_Quantile                         (STATIC_CAST(IntEbmType, 0))
+#define CutMethod_RoundedQuantile                  (STATIC_CAST(IntEbmType, 1))
+#define CutMethod_Uniform                          (STATIC_CAST(IntEbmType, 2))
+#define CutMethod_Winsorized                       (STATIC_CAST(IntEbmType, 3))
+
+// indexes into the arrays filled by GetBoosterPerfCounters and GetInteractionPerfCounters
+#define PerfCounter_BinBoosting                         (STATIC_CAST(IntEbmType, 0))
+#define PerfCounter_SumHistogramBuckets                 (STATIC_CAST(IntEbmType, 1))
+#define PerfCounter_TensorTotalsBuild                   (STATIC_CAST(IntEbmType, 2))
+#define PerfCounter_PartitionOneDimensionalBoosting     (STATIC_CAST(IntEbmType, 3))
+#define PerfCounter_PartitionTwoDimensionalBoosting     (STATIC_CAST(IntEbmType, 4))
+#define PerfCounter_PartitionRandomBoosting             (STATIC_CAST(IntEbmType, 5))
+#define PerfCounter_ApplyTermUpdateTraining             (STATIC_CAST(IntEbmType, 6))
+#define PerfCounter_ApplyTermUpdateValidation           (STATIC_CAST(IntEbmType, 7))
+#define PerfCounter_BinInteraction                      (STATIC_CAST(IntEbmType, 8))
+#define PerfCounter_CalculateInteractionScore           (STATIC_CAST(IntEbmType, 9))
+#define PerfCounter_PartitionCornerBoosting             (STATIC_CAST(IntEbmType, 10))
+#define PerfCounter_Count                               (STATIC_CAST(IntEbmType, 11))
+
  // no messages will be output
 #define TraceLevelOff      (EBM_TRACE_CAST(0))
 // invalid inputs to the C library or assert failure before exit
@@ -201,13 +248,42 @@ typedef uint64_t UInteractionOptionsType;
 // all our logging messages are pure ASCII (127 values), and therefore also conform to UTF-8
 typedef void (EBM_NATIVE_CALLING_CONVENTION * LOG_MESSAGE_FUNCTION)(TraceEbmType traceLevel, const char * message);
 
-// SetLogMessageFunction does not need to be called if the level is left at TraceLevelOff
+// THREADING: every function in this API can be called concurrently from multiple threads, except DrainLogMessages 
+// which has a single reader and must not be called from two threads at once.  The only state shared between calls is 
+// the logging callback, the trace level and the buffer behind LogMessageToBuffer.  A handle (booster, interaction 
+// detector) must only be used by one thread at a time, but different handles are independent of each other, except 
+// that the views from CreateBoosterView share their booster as described at ApplyTermUpdates.  
+// CategoricalEncoderHandle is not modified after creation, so one encoder can be used by many threads until it is 
+// freed.  The logging callback can be called concurrently from any thread, including the threads that are started 
+// internally by functions that take a countThreads parameter, so it needs to be thread safe.
+
+// SetLogMessageFunction does not need to be called if the level is left at TraceLevelOff.  It must be called once,
+// before any thread can log.  SetTraceLevel can be called at any time from any thread.
 EBM_NATIVE_IMPORT_EXPORT_INCLUDE void EBM_NATIVE_CALLING_CONVENTION SetLogMessageFunction(
    LOG_MESSAGE_FUNCTION logMessageFunction
 );
 EBM_NATIVE_IMPORT_EXPORT_INCLUDE void EBM_NATIVE_CALLING_CONVENTION SetTraceLevel(TraceEbmType traceLevel);
 EBM_NATIVE_IMPORT_EXPORT_INCLUDE const char * EBM_NATIVE_CALLING_CONVENTION GetTraceLevelString(TraceEbmType traceLevel);
 
+// LogMessageToBuffer can be given to SetLogMessageFunction in place of a callback into the host.  It never blocks: it
+// copies each message (clipped to 511 chars) into a fixed size lock-free ring buffer shared by all threads, or drops
+// the message if the buffer is full.  The host empties the buffer in batches by calling DrainLogMessages, which 
+// copies up to countMessagesMax messages into traceLevelsOut and charsOut.  The messages are null terminated and 
+// stored back to back in charsOut, and draining stops early at the first message that does not fit in countCharsMax.
+// countDroppedOut receives the number of messages dropped since the previous drain.  Only one thread may drain at a time.
+EBM_NATIVE_IMPORT_EXPORT_INCLUDE void EBM_NATIVE_CALLING_CONVENTION LogMessageToBuffer(
+   TraceEbmType traceLevel, 
+   const char * message
+);
+EBM_NATIVE_IMPORT_EXPORT_INCLUDE ErrorEbmType EBM_NATIVE_CALLING_CONVENTION DrainLogMessages(
+   IntEbmType countMessagesMax,
+   IntEbmType countCharsMax,
+   TraceEbmType * traceLevelsOut,
+   char * charsOut,
+   IntEbmType * countMessagesOut,
+   IntEbmType * countDroppedOut
+);
+
 EBM_NATIVE_IMPORT_EXPORT_INCLUDE void EBM_NATIVE_CALLING_CONVENTION CleanFloats(IntEbmType count, double * valsInOut);
 
 EBM_NATIVE_IMPORT_EXPORT_INCLUDE SeedEbmType EBM_NATIVE_CALLING_CONVENTION GenerateDeterministicSeed(
@@ -253,6 +329,21 @@ EBM_NATIVE_IMPORT_EXPORT_INCLUDE ErrorEbmType EBM_NATIVE_CALLING_CONVENTION CutW
    IntEbmType * countCutsInOut,
    double * cutsLowerBoundInclusiveOut
 );
+// CutFeatures cuts countFeatures features of countSamples values each on countThreads threads (0 for all cores).  Each
+// feature is cut with its cutMethods item exactly as CutQuantile, CutUniform or CutWinsorized would, asking for at
+// most countCutsMax cuts.  Feature i's cuts are written to cutsLowerBoundInclusiveOut[i * countCutsMax] onwards and
+// their number to countCutsOut[i].
+EBM_NATIVE_IMPORT_EXPORT_INCLUDE ErrorEbmType EBM_NATIVE_CALLING_CONVENTION CutFeatures(
+   IntEbmType countFeatures,
+   IntEbmType countSamples,
+   const double * const * featureValues,
+   const IntEbmType * cutMethods,
+   IntEbmType countSamplesPerBinMin,
+   IntEbmType countCutsMax,
+   IntEbmType countThreads,
+   IntEbmType * countCutsOut,
+   double * cutsLowerBoundInclusiveOut
+);
 
 EBM_NATIVE_IMPORT_EXPORT_INCLUDE ErrorEbmType EBM_NATIVE_CALLING_CONVENTION SuggestGraphBounds(
    IntEbmType countCuts,
@@ -271,6 +362,18 @@ EBM_NATIVE_IMPORT_EXPORT_INCLUDE ErrorEbmType EBM_NATIVE_CALLING_CONVENTION Disc
    const double * cutsLowerBoundInclusive,
    IntEbmType * discretizedOut
 );
+// DiscretizeArrow bins an Arrow C Data Interface numeric buffer of arrowType values without first converting it to
+// doubles.  If validityBitmap is not null, samples whose bit is clear (least significant bit first) get the missing
+// bin 0.  Both buffers start at sample 0, so the caller applies any Arrow array offset before calling.
+EBM_NATIVE_IMPORT_EXPORT_INCLUDE ErrorEbmType EBM_NATIVE_CALLING_CONVENTION DiscretizeArrow(
+   IntEbmType countSamples,
+   IntEbmType arrowType,
+   const void * values,
+   const uint8_t * validityBitmap,
+   IntEbmType countCuts,
+   const double * cutsLowerBoundInclusive,
+   IntEbmType * discretizedOut
+);
 
 EBM_NATIVE_IMPORT_EXPORT_INCLUDE IntEbmType EBM_NATIVE_CALLING_CONVENTION SizeDataSetHeader(
    IntEbmType countFeatures,
@@ -285,6 +388,7 @@ EBM_NATIVE_IMPORT_EXPORT_INCLUDE ErrorEbmType EBM_NATIVE_CALLING_CONVENTION Fill
    void * fillMem
 );
 
+// binnedData can be null in SizeFeature, in which case the size is determined from countBins and countSamples alone
 EBM_NATIVE_IMPORT_EXPORT_INCLUDE IntEbmType EBM_NATIVE_CALLING_CONVENTION SizeFeature(
    IntEbmType countBins,
    BoolEbmType missing,
@@ -358,6 +462,206 @@ EBM_NATIVE_IMPORT_EXPORT_INCLUDE ErrorEbmType EBM_NATIVE_CALLING_CONVENTION Extr
    IntEbmType countTargetsVerify,
    IntEbmType * classCountsOut
 );
+// ComputeScoresFromDataSet sums the term tensors over the binned features already inside dataSet and writes one set of
+// scores per sample into scoresOut.  termScores holds the tensors back to back in the layout GetBestTermScores uses,
+// so each term's features must be binned in dataSet the same way they were for boosting.  intercept can be null.
+// countThreads of zero uses all the cores
+EBM_NATIVE_IMPORT_EXPORT_INCLUDE ErrorEbmType EBM_NATIVE_CALLING_CONVENTION ComputeScoresFromDataSet(
+   const void * dataSet,
+   IntEbmType countTerms,
+   const IntEbmType * dimensionCounts,
+   const IntEbmType * featureIndexes,
+   const double * termScores,
+   const double * intercept,
+   IntEbmType countThreads,
+   double * scoresOut
+);
+
+// ComputeScoresAndContributions sums the term tensors for samples that were binned in python.  binnedData holds one
+// row of countSamples bin indexes for each dimension of each term, and negative indexes count back from the end of the
+// dimension like in python.  termScores holds the tensors back to back in python order, so the first dimension has the
+// highest stride.  If contributionsOut is not null it receives the score of each term for each sample.  If
+// countTopTerms is between 1 and countTerms - 1, only that many terms are kept per sample, largest absolute score
+// first, and termIndexesOut receives the term of each kept contribution.
+EBM_NATIVE_IMPORT_EXPORT_INCLUDE ErrorEbmType EBM_NATIVE_CALLING_CONVENTION ComputeScoresAndContributions(
+   IntEbmType countSamples,
+   IntEbmType countScores,
+   IntEbmType countTerms,
+   const IntEbmType * dimensionCounts,
+   const IntEbmType * binCounts,
+   const IntEbmType * binnedData,
+   const double * termScores,
+   const double * intercept,
+   IntEbmType countTopTerms,
+   double * scoresOut,
+   double * contributionsOut,
+   IntEbmType * termIndexesOut
+);
+
+// AggregateBaggedTermScores combines the tensors that the outer bags generated for one term.  bagScores holds countBags
+// tensors back to back in python order, so the first dimension has the highest stride and the scores are innermost.
+// binWeights holds one weight per tensor bin.  Cells in a first or last bin slice with zero total weight are zeroed in
+// bagScores in place, then the bagWeights weighted mean and standard deviation over the bags go to meanOut and
+// stddevOut.  If centeringWeight is not zero, the binWeights weighted sum of each mean score divided by
+// centeringWeight is moved from meanOut into interceptInOut, leaving the zeroed cells at zero.
+EBM_NATIVE_IMPORT_EXPORT_INCLUDE ErrorEbmType EBM_NATIVE_CALLING_CONVENTION AggregateBaggedTermScores(
+   IntEbmType countBags,
+   const double * bagWeights,
+   IntEbmType countDimensions,
+   const IntEbmType * binCounts,
+   IntEbmType countScores,
+   const double * binWeights,
+   double centeringWeight,
+   double * bagScores,
+   double * meanOut,
+   double * stddevOut,
+   double * interceptInOut
+);
+
+// HarmonizeCuts maps the bins of a feature cut with newCuts onto the bins of the same feature cut with oldCuts.  Both
+// cut arrays must be sorted, and they are walked together in a single pass.  lookupOut and percentagesOut each receive
+// countNewCuts + 3 items.  The first item is the missing bin, which maps to old bin 0, and the last item is the unknown
+// bin, which maps to -1.  Every other new bin maps to the old bin that holds its upper end, and its percentage is the
+// fraction of that old bin's range that it covers, using oldMin/oldMax and newMin/newMax as the outer bounds.
+EBM_NATIVE_IMPORT_EXPORT_INCLUDE ErrorEbmType EBM_NATIVE_CALLING_CONVENTION HarmonizeCuts(
+   IntEbmType countOldCuts,
+   const double * oldCuts,
+   double oldMin,
+   double oldMax,
+   IntEbmType countNewCuts,
+   const double * newCuts,
+   double newMin,
+   double newMax,
+   IntEbmType * lookupOut,
+   double * percentagesOut
+);
+
+// HarmonizeTensors rebins countTensors tensors that share the same layout, like the outer bags of one term, from
+// oldBinCounts onto newBinCounts.  For each dimension, oldBinOffsets holds newBinCounts[dimension] + 1 offsets into
+// oldBins marking the old bins that feed each new bin, and negative old bins count back from the end of the dimension.
+// percentages holds one fraction per new bin per dimension.  The tensors are in python order with countScores scores
+// innermost.  If oldWeights is null the tensors hold weights, and each new cell gets the sum of its old cells times the
+// product of the percentages.  Otherwise the tensors hold scores, and each new cell gets the oldWeights weighted average
+// of its old cells.  countThreads of 0 uses all the cores.
+EBM_NATIVE_IMPORT_EXPORT_INCLUDE ErrorEbmType EBM_NATIVE_CALLING_CONVENTION HarmonizeTensors(
+   IntEbmType countTensors,
+   IntEbmType countDimensions,
+   const IntEbmType * oldBinCounts,
+   const IntEbmType * newBinCounts,
+   IntEbmType countOldBins,
+   const IntEbmType * oldBinOffsets,
+   const IntEbmType * oldBins,
+   const double * percentages,
+   IntEbmType countScores,
+   const double * oldTensors,
+   const double * oldWeights,
+   IntEbmType countThreads,
+   double * newTensorsOut
+);
+
+// ComputePermutedScores and ComputePartialDependence take the terms in the same layout as
+// ComputeScoresAndContributions, plus dimensionFeatures which holds the feature index of each dimension.  sampleScores
+// holds the unaltered score of each sample.  Only the terms that contain feature are looked up, since they are the only
+// ones that change.  ComputePermutedScores gives each sample the bins of feature from sample permutation[sample].
+EBM_NATIVE_IMPORT_EXPORT_INCLUDE ErrorEbmType EBM_NATIVE_CALLING_CONVENTION ComputePermutedScores(
+   IntEbmType countSamples,
+   IntEbmType countScores,
+   IntEbmType countTerms,
+   const IntEbmType * dimensionCounts,
+   const IntEbmType * binCounts,
+   const IntEbmType * dimensionFeatures,
+   const IntEbmType * binnedData,
+   const double * termScores,
+   IntEbmType feature,
+   const double * sampleScores,
+   const IntEbmType * permutation,
+   double * scoresOut
+);
+// ComputePartialDependence sets feature to each of countGridPoints values in every sample.  gridBinnedData holds one row
+// of countGridPoints bins for each dimension in the same order as binnedData, and only the rows for feature are read.
+// partialDependenceOut receives the sampleWeights weighted mean score at each grid point, and stddevOut and iceOut,
+// if not null, receive the weighted standard deviation and the (sample, grid point) scores.
+EBM_NATIVE_IMPORT_EXPORT_INCLUDE ErrorEbmType EBM_NATIVE_CALLING_CONVENTION ComputePartialDependence(
+   IntEbmType countSamples,
+   IntEbmType countScores,
+   IntEbmType countTerms,
+   const IntEbmType * dimensionCounts,
+   const IntEbmType * binCounts,
+   const IntEbmType * dimensionFeatures,
+   const IntEbmType * binnedData,
+   const double * termScores,
+   IntEbmType feature,
+   const double * sampleScores,
+   IntEbmType countGridPoints,
+   const IntEbmType * gridBinnedData,
+   const double * sampleWeights,
+   double * partialDependenceOut,
+   double * stddevOut,
+   double * iceOut
+);
+// ComputeShapleyValues gives the exact Shapley values of each sample, with the terms in the same layout as
+// ComputePermutedScores.  binWeights, if not null, holds the weight of each tensor bin without the scores dimension
+// and is the background distribution, otherwise all bins are equally likely.  expectedValueOut receives intercept plus
+// the expected score of each term, and shapleyOut receives (sample, feature, score) values that sum to the sample's
+// score minus the expected value.
+EBM_NATIVE_IMPORT_EXPORT_INCLUDE ErrorEbmType EBM_NATIVE_CALLING_CONVENTION ComputeShapleyValues(
+   IntEbmType countSamples,
+   IntEbmType countScores,
+   IntEbmType countFeatures,
+   IntEbmType countTerms,
+   const IntEbmType * dimensionCounts,
+   const IntEbmType * binCounts,
+   const IntEbmType * dimensionFeatures,
+   const IntEbmType * binnedData,
+   const double * termScores,
+   const double * binWeights,
+   const double * intercept,
+   IntEbmType countThreads,
+   double * expectedValueOut,
+   double * shapleyOut
+);
+
+// CreateCategoricalEncoder builds a hash map from the fitted categories to their bins.  The categories are given in
+// the Arrow string layout: category i is the UTF-8 bytes categoryChars[categoryOffsets[i]..categoryOffsets[i + 1]),
+// so categoryOffsets has countCategories + 1 items.  Each category must be unique and each bin must be positive.
+EBM_NATIVE_IMPORT_EXPORT_INCLUDE ErrorEbmType EBM_NATIVE_CALLING_CONVENTION CreateCategoricalEncoder(
+   IntEbmType countCategories,
+   const IntEbmType * categoryOffsets,
+   const char * categoryChars,
+   const IntEbmType * categoryBins,
+   CategoricalEncoderHandle * categoricalEncoderHandleOut
+);
+// EncodeCategorical bins countSamples strings given in the same Arrow layout as CreateCategoricalEncoder.  If
+// validityBitmap is not null, samples whose bit is clear (least significant bit first, as in Arrow) are missing and
+// get bin 0.  Strings that were not fitted get bin -1 and are counted in countUnknownsOut, which can be null.
+EBM_NATIVE_IMPORT_EXPORT_INCLUDE ErrorEbmType EBM_NATIVE_CALLING_CONVENTION EncodeCategorical(
+   CategoricalEncoderHandle categoricalEncoderHandle,
+   IntEbmType countSamples,
+   const IntEbmType * offsets,
+   const char * chars,
+   const uint8_t * validityBitmap,
+   IntEbmType * binnedOut,
+   IntEbmType * countUnknownsOut
+);
+// EncodeCategoricalDictionary bins an Arrow dictionary encoded string column.  The countDictionary dictionary strings
+// are in the same layout as CreateCategoricalEncoder and are each hashed once, then every sample's index, a signed
+// integer of indexBytes (1, 2, 4 or 8) bytes, is looked up in them.  validityBitmap and the unknowns are handled as in
+// EncodeCategorical, except that countUnknownsOut counts samples rather than dictionary strings.
+EBM_NATIVE_IMPORT_EXPORT_INCLUDE ErrorEbmType EBM_NATIVE_CALLING_CONVENTION EncodeCategoricalDictionary(
+   CategoricalEncoderHandle categoricalEncoderHandle,
+   IntEbmType countDictionary,
+   const IntEbmType * dictionaryOffsets,
+   const char * dictionaryChars,
+   IntEbmType countSamples,
+   IntEbmType indexBytes,
+   const void * indexes,
+   const uint8_t * validityBitmap,
+   IntEbmType * binnedOut,
+   IntEbmType * countUnknownsOut
+);
+EBM_NATIVE_IMPORT_EXPORT_INCLUDE void EBM_NATIVE_CALLING_CONVENTION FreeCategoricalEncoder(
+   CategoricalEncoderHandle categoricalEncoderHandle
+);
 
 
 EBM_NATIVE_IMPORT_EXPORT_INCLUDE ErrorEbmType EBM_NATIVE_CALLING_CONVENTION SampleWithoutReplacement(
@@ -386,6 +690,7 @@ EBM_NATIVE_IMPORT_EXPORT_INCLUDE ErrorEbmType EBM_NATIVE_CALLING_CONVENTION Crea
    const IntEbmType * dimensionCounts,
    const IntEbmType * featureIndexes,
    IntEbmType countInnerBags,
+   CreateBoosterFlagsType flags,
    const double * optionalTempParams,
    BoosterHandle * boosterHandleOut
 );
@@ -423,6 +728,16 @@ EBM_NATIVE_IMPORT_EXPORT_INCLUDE ErrorEbmType EBM_NATIVE_CALLING_CONVENTION Appl
    BoosterHandle boosterHandle,
    double * validationMetricOut
 );
+// ApplyTermUpdates applies the pending updates of several views of the same booster (see CreateBoosterView).  It 
+// makes two passes over the samples no matter how many views there are, and recomputes the gradients only once.  
+// Each view must have an update pending for a different term.  GenerateTermUpdate only reads the shared sample 
+// gradients, so the views can generate their updates concurrently on separate threads as long as nothing modifies 
+// the gradients (ApplyTermUpdate/ApplyTermUpdates) until they have all finished.
+EBM_NATIVE_IMPORT_EXPORT_INCLUDE ErrorEbmType EBM_NATIVE_CALLING_CONVENTION ApplyTermUpdates(
+   IntEbmType countBoosterHandles,
+   const BoosterHandle * boosterHandles,
+   double * validationMetricOut
+);
 EBM_NATIVE_IMPORT_EXPORT_INCLUDE ErrorEbmType EBM_NATIVE_CALLING_CONVENTION GetBestTermScores(
    BoosterHandle boosterHandle, 
    IntEbmType indexTerm,
@@ -433,6 +748,64 @@ EBM_NATIVE_IMPORT_EXPORT_INCLUDE ErrorEbmType EBM_NATIVE_CALLING_CONVENTION GetC
    IntEbmType indexTerm,
    double * termScoresTensorOut
 );
+// SerializeBooster captures the mutable boosting state (current and best term tensors, sample scores, gradients, 
+// the booster's random state, and the handle's term schedule if SetTermScheduling is on) so that training can be 
+// resumed later by calling DeserializeBooster on a booster that was created via CreateBooster with identical dataSet, 
+// bag, initScores, terms, countInnerBags, and randomSeed.  Call SetTermScheduling with the same settings before 
+// DeserializeBooster to resume the term schedule
+EBM_NATIVE_IMPORT_EXPORT_INCLUDE IntEbmType EBM_NATIVE_CALLING_CONVENTION SizeSerializedBooster(
+   BoosterHandle boosterHandle
+);
+EBM_NATIVE_IMPORT_EXPORT_INCLUDE ErrorEbmType EBM_NATIVE_CALLING_CONVENTION SerializeBooster(
+   BoosterHandle boosterHandle,
+   IntEbmType countBytesAllocated,
+   void * fillMem
+);
+EBM_NATIVE_IMPORT_EXPORT_INCLUDE ErrorEbmType EBM_NATIVE_CALLING_CONVENTION DeserializeBooster(
+   BoosterHandle boosterHandle,
+   IntEbmType countBytes,
+   const void * serialized
+);
+// SetGradientSampling turns on gradient-based one-side sampling (GOSS) for this handle (views have their own).  Each
+// GenerateTermUpdate then boosts on the topRate fraction of the inner bag with the largest gradients plus otherRate 
+// times the inner bag's count of samples picked randomly from the rest.  Both rates are fractions of the whole inner 
+// bag.  The random samples have their weights scaled up to stand in for the rest.  Rates that add up to 0 or to 1 or 
+// more turn it off
+EBM_NATIVE_IMPORT_EXPORT_INCLUDE ErrorEbmType EBM_NATIVE_CALLING_CONVENTION SetGradientSampling(
+   BoosterHandle boosterHandle,
+   double topRate,
+   double otherRate
+);
+// SetRowSubsampling makes each GenerateTermUpdate on this handle boost on a new uniformly random rate fraction of the 
+// samples in the inner bag, keeping their weights.  A rate of 0 or 1 turns it off.  SetGradientSampling takes 
+// precedence when both are on
+EBM_NATIVE_IMPORT_EXPORT_INCLUDE ErrorEbmType EBM_NATIVE_CALLING_CONVENTION SetRowSubsampling(
+   BoosterHandle boosterHandle,
+   double rate
+);
+// SetTermScheduling makes this handle (views have their own) keep a smoothed history of the avgGain from each 
+// GenerateTermUpdate.  ScheduleTerms then leaves out the terms whose history has fallen below gainRelativeMin times 
+// the best term's, except that each such term is re-checked once every recheckRounds rounds, and a re-check replaces 
+// its stale history with the new gain.  A gainRelativeMin of 0 turns it off.
+EBM_NATIVE_IMPORT_EXPORT_INCLUDE ErrorEbmType EBM_NATIVE_CALLING_CONVENTION SetTermScheduling(
+   BoosterHandle boosterHandle,
+   double gainRelativeMin,
+   IntEbmType recheckRounds
+);
+// ScheduleTerms starts a new boosting round and fills termIndexesOut, which needs room for every term, with the terms 
+// to boost in increasing order.  Without SetTermScheduling every term is scheduled
+EBM_NATIVE_IMPORT_EXPORT_INCLUDE ErrorEbmType EBM_NATIVE_CALLING_CONVENTION ScheduleTerms(
+   BoosterHandle boosterHandle,
+   IntEbmType * countTermsOut,
+   IntEbmType * termIndexesOut
+);
+// perf counters accumulate per handle (views have their own) for the lifetime of the handle.  Either output can be null
+EBM_NATIVE_IMPORT_EXPORT_INCLUDE ErrorEbmType EBM_NATIVE_CALLING_CONVENTION GetBoosterPerfCounters(
+   BoosterHandle boosterHandle,
+   IntEbmType countPerfCounters,
+   IntEbmType * callCountsOut,
+   double * secondsOut
+);
 EBM_NATIVE_IMPORT_EXPORT_INCLUDE void EBM_NATIVE_CALLING_CONVENTION FreeBooster(
    BoosterHandle boosterHandle
 );
@@ -452,6 +825,12 @@ EBM_NATIVE_IMPORT_EXPORT_INCLUDE ErrorEbmType EBM_NATIVE_CALLING_CONVENTION Calc
    IntEbmType countSamplesRequiredForChildSplitMin,
    double * avgInteractionStrengthOut
 );
+EBM_NATIVE_IMPORT_EXPORT_INCLUDE ErrorEbmType EBM_NATIVE_CALLING_CONVENTION GetInteractionPerfCounters(
+   InteractionHandle interactionHandle,
+   IntEbmType countPerfCounters,
+   IntEbmType * callCountsOut,
+   double * secondsOut
+);
 EBM_NATIVE_IMPORT_EXPORT_INCLUDE void EBM_NATIVE_CALLING_CONVENTION FreeInteractionDetector(
    InteractionHandle interactionHandle
 );
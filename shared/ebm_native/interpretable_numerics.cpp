@@ -1327,9 +1327,9 @@ static double Mean(const size_t cSamples, const double * const aFeatureValues, c
    return mean;
 }
 
-// we don't care if an extra log message is outputted due to the non-atomic nature of the decrement to this value
-static int g_cLogEnterGetHistogramCutCountParametersMessages = 25;
-static int g_cLogExitGetHistogramCutCountParametersMessages = 25;
+// these counts are thread_local, so each thread logs its own first messages without racing on the decrement
+static thread_local int g_cLogEnterGetHistogramCutCountParametersMessages = 25;
+static thread_local int g_cLogExitGetHistogramCutCountParametersMessages = 25;
 
 EBM_NATIVE_IMPORT_EXPORT_BODY IntEbmType EBM_NATIVE_CALLING_CONVENTION GetHistogramCutCount(
    IntEbmType countSamples,
@@ -70,9 +70,9 @@ EBM_NATIVE_IMPORT_EXPORT_BODY ErrorEbmType EBM_NATIVE_CALLING_CONVENTION Generat
 }
 
 
-// we don't care if an extra log message is outputted due to the non-atomic nature of the decrement to this value
-static int g_cLogEnterSampleWithoutReplacementParametersMessages = 5;
-static int g_cLogExitSampleWithoutReplacementParametersMessages = 5;
+// these counts are thread_local, so each thread logs its own first messages without racing on the decrement
+static thread_local int g_cLogEnterSampleWithoutReplacementParametersMessages = 5;
+static thread_local int g_cLogExitSampleWithoutReplacementParametersMessages = 5;
 
 EBM_NATIVE_IMPORT_EXPORT_BODY ErrorEbmType EBM_NATIVE_CALLING_CONVENTION SampleWithoutReplacement(
    BoolEbmType isDeterministic,
@@ -183,8 +183,8 @@ EBM_NATIVE_IMPORT_EXPORT_BODY ErrorEbmType EBM_NATIVE_CALLING_CONVENTION SampleW
 }
 
 
-static int g_cLogEnterStratifiedSamplingWithoutReplacementParametersMessages = 5;
-static int g_cLogExitStratifiedSamplingWithoutReplacementParametersMessages = 5;
+static thread_local int g_cLogEnterStratifiedSamplingWithoutReplacementParametersMessages = 5;
+static thread_local int g_cLogExitStratifiedSamplingWithoutReplacementParametersMessages = 5;
 
 WARNING_PUSH
 WARNING_DISABLE_POTENTIAL_DIVIDE_BY_ZERO